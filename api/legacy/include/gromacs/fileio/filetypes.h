@@ -85,6 +85,10 @@ enum GromacsFileType
     efRND,
     efCSV,
     efQMI,
+    efH5MD,
+    efJSON,
+    efMDRUNTRN,        /* As efTRN, but also allows H5MD */
+    efMDRUNCOMPRESSED, /* As efCOMPRESSED, but also allows H5MD */
     efNR
 };
 
@@ -148,6 +148,20 @@ void write_tpx_state(const std::filesystem::path& fn,
 /* Write a file, and close it again.
  */
 
+/*! \brief
+ * Serializes \p ir and \p mtop into the body of \p partialDeserializedTpr.
+ *
+ * read_tpx_state() leaves the body empty, so this needs to be called on
+ * the main rank before the body is communicated to other ranks.
+ *
+ * \param[in,out] partialDeserializedTpr Struct with the header returned by read_tpx_state().
+ * \param[in] ir Input rec to serialize.
+ * \param[in] mtop Global topology to serialize.
+ */
+void serializeTprBodyForCommunication(PartialDeserializedTprFile* partialDeserializedTpr,
+                                      const t_inputrec*           ir,
+                                      const gmx_mtop_t*           mtop);
+
 /*! \brief
  * Complete deserialization of TPR file into the individual data structures.
  *
@@ -181,13 +195,15 @@ PbcType completeTprDeserialization(PartialDeserializedTprFile* partialDeserializ
  * to populate the \p state, \p ir and \p mtop needed to run a simulations.
  *
  * This function returns the partial deserialized TPR file
- * that can then be communicated to set up non-main nodes to run simulations.
+ * that can then be communicated to set up non-main nodes to run simulations,
+ * after serializeTprBodyForCommunication() has filled its body.
+ * When possible, the file is memory mapped instead of read into a buffer.
  *
  * \param[in] fn Input file name.
  * \param[out] ir Input parameters to be set, or nullptr.
  * \param[out] state State variables for the simulation.
  * \param[out] mtop Global simulation topolgy.
- * \returns Struct with header and body in char vector.
+ * \returns Struct with header and an empty body.
  */
 PartialDeserializedTprFile
 read_tpx_state(const std::filesystem::path& fn, t_inputrec* ir, t_state* state, gmx_mtop_t* mtop);
@@ -174,7 +174,12 @@ t_trxstatus* open_trx(const std::filesystem::path& outfile, const char* filemode
 /* Open a TRX file and return an allocated status pointer */
 
 struct t_fileio* trx_get_fileio(t_trxstatus* status);
-/* get a fileio from a trxstatus */
+/* Get a fileio from a trxstatus for direct access to the file.
+ * This stops XTC read-ahead, so the file position is that after the
+ * last frame returned. The next frame read can restart read-ahead,
+ * which moves the file position. So the handle and its position are
+ * only valid until the next read; call this again after reading.
+ */
 
 float trx_get_time_of_final_frame(t_trxstatus* status);
 /* get time of final frame. Only supported for TNG and XTC */
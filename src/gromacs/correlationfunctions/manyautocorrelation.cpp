@@ -84,14 +84,18 @@ int many_auto_correl(std::vector<std::vector<real>>* c)
     {
         i.resize(nfft, 0);
     }
-#pragma omp parallel
+    // Each thread sets up its own FFT plan, so do not use more threads
+    // than there are functions. This matters in particular for the common
+    // case of a single function per call.
+    const int nthreads =
+            static_cast<int>(std::min(static_cast<size_t>(gmx_omp_get_max_threads()), nfunc));
+#pragma omp parallel num_threads(nthreads)
     {
         try
         {
             gmx_fft_t         fft1;
             std::vector<real> in, out;
 
-            int nthreads  = gmx_omp_get_max_threads();
             int thread_id = gmx_omp_get_thread_num();
             int i0        = (thread_id * nfunc) / nthreads;
 // nvc++ 24.1+ version has bug due to which it generates incorrect OMP code for this region
@@ -111,7 +115,9 @@ int many_auto_correl(std::vector<std::vector<real>>* c)
             out.resize(2 * nfft, 0);
             for (int i = i0; (i < i1); i++)
             {
-                for (size_t j = 0; j < ndata; j++)
+                // Copy including the zero padding, since the previous
+                // function left its power spectrum in the input array.
+                for (size_t j = 0; j < nfft; j++)
                 {
                     in[2 * j + 0] = (*c)[i][j];
                     in[2 * j + 1] = 0;
@@ -51,6 +51,7 @@
 #include <gtest/gtest.h>
 
 #include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/real.h"
 
 #include "testutils/testasserts.h"
@@ -85,6 +86,30 @@ TEST_F(ManyAutocorrelationTest, DifferentLength)
 }
 #endif
 
+TEST_F(ManyAutocorrelationTest, IdenticalFunctionsGiveIdenticalResults)
+{
+    // Use more functions than threads, so threads handle multiple and uneven numbers of functions
+    const size_t                   ndata      = 20;
+    const int                      nfunctions = 2 * gmx_omp_get_max_threads() + 1;
+    std::vector<std::vector<real>> c(nfunctions, std::vector<real>(ndata));
+    for (auto& function : c)
+    {
+        for (size_t i = 0; i < ndata; i++)
+        {
+            function[i] = std::cos(0.3 * i);
+        }
+    }
+    many_auto_correl(&c);
+    for (const auto& function : c)
+    {
+        ASSERT_EQ(ndata, function.size());
+        for (size_t i = 0; i < ndata; i++)
+        {
+            EXPECT_REAL_EQ_TOL(c[0][i], function[i], defaultRealTolerance());
+        }
+    }
+}
+
 } // namespace
 } // namespace test
 } // namespace gmx
@@ -68,6 +68,24 @@
 
 enum class FreeEnergyPerturbationCouplingType : int;
 
+gmx::ArrayRef<const int> dd_localStateGlobalAtomIndices(const gmx_domdec_t&      dd,
+                                                        const int                ddpCount,
+                                                        const int                ddpCountCgGl,
+                                                        gmx::ArrayRef<const int> localCGNumbers)
+{
+    if (ddpCount == dd.ddp_count)
+    {
+        /* The local state and DD are in sync, use the DD indices */
+        return gmx::constArrayRefFromArray(dd.globalAtomIndices.data(), dd.numHomeAtoms);
+    }
+    else if (ddpCountCgGl == ddpCount)
+    {
+        /* The DD is out of sync with the local state, use the indices stored with the state */
+        return localCGNumbers;
+    }
+    gmx_incons("Requested the atom indices of a state for which the atom distribution is unknown");
+}
+
 static void dd_collect_cg(gmx_domdec_t*            dd,
                           const int                ddpCount,
                           const int                ddpCountCgGl,
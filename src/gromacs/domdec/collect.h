@@ -52,6 +52,16 @@ class ArrayRef;
 struct gmx_domdec_t;
 class t_state;
 
+/*! \brief Returns the global atom indices of the home atoms of a local state
+ *
+ * \p ddpCount is the partitioning count of the local state and \p ddpCountCgGl that of
+ * \p localCGNumbers, the home atom indices stored with the state.
+ */
+gmx::ArrayRef<const int> dd_localStateGlobalAtomIndices(const gmx_domdec_t&      dd,
+                                                        int                      ddpCount,
+                                                        int                      ddpCountCgGl,
+                                                        gmx::ArrayRef<const int> localCGNumbers);
+
 /*! \brief Gathers rvec arrays \p localVector to \p globalVector on the main rank */
 void dd_collect_vec(gmx_domdec_t*                  dd,
                     int                            ddpCount,
@@ -481,6 +481,9 @@ struct DDSettings
     //! Whether to order the DD dimensions from z to x
     bool useDDOrderZYX = false;
 
+    //! Whether to include the load imbalance due to the atom distribution in the DD grid choice
+    bool useDensityAwareGrid = false;
+
     //! Whether to use MPI Cartesian reordering of communicators, when supported (almost never)
     bool useCartesianReorder = true;
 
@@ -653,6 +656,9 @@ struct gmx_domdec_comm_t // NOLINT (clang-analyzer-optin.performance.Padding)
     /** Array for signalling if atoms have moved to another domain */
     std::vector<int> movedBuffer;
 
+    /** Local indices of the home atoms that move to another domain */
+    std::vector<int> movingHomeAtoms;
+
     /** Communication int buffer for general use */
     DDBuffer<int> intBuffer;
 
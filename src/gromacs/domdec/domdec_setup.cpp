@@ -50,8 +50,11 @@
 #include <cmath>
 #include <cstdio>
 
+#include <algorithm>
+#include <array>
 #include <filesystem>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -323,16 +326,111 @@ static float comm_pme_cost_vol(int npme, int a, int b, int c)
     return comm_vol;
 }
 
+/*! \brief Sorted fractional coordinates of all atoms along the three box vectors
+ *
+ * Used for estimating the static load imbalance of DD grids
+ * for inhomogeneous atom distributions.
+ */
+struct AtomDensityProfile
+{
+    //! For each dimension the sorted fractional coordinates in [0,1)
+    std::array<std::vector<real>, DIM> sortedFractions;
+};
+
+/*! \brief Returns the atom density profile for coordinates \p x
+ *
+ * Along periodic dimensions the fractional coordinates are computed
+ * in the, possibly triclinic, unit cell, which matches the DD cell
+ * boundaries in the absence of DLB. Along non-periodic dimensions
+ * the bounding box stored in \p ddbox is used.
+ */
+static AtomDensityProfile makeAtomDensityProfile(const matrix                   box,
+                                                 const gmx_ddbox_t&             ddbox,
+                                                 gmx::ArrayRef<const gmx::RVec> x)
+{
+    AtomDensityProfile profile;
+
+    for (auto& fractions : profile.sortedFractions)
+    {
+        fractions.resize(x.size());
+    }
+    for (gmx::Index a = 0; a < x.ssize(); a++)
+    {
+        rvec xa;
+        copy_rvec(x[a], xa);
+        for (int d = DIM - 1; d >= 0; d--)
+        {
+            real fraction;
+            if (d < ddbox.npbcdim)
+            {
+                fraction = xa[d] / box[d][d];
+                /* Remove the contribution of this box vector, for triclinic boxes */
+                for (int e = 0; e <= d; e++)
+                {
+                    xa[e] -= fraction * box[d][e];
+                }
+                fraction -= std::floor(fraction);
+            }
+            else
+            {
+                fraction = (xa[d] - ddbox.box0[d]) / ddbox.box_size[d];
+            }
+            profile.sortedFractions[d][a] = std::clamp(fraction, real(0), real(1));
+        }
+    }
+    for (auto& fractions : profile.sortedFractions)
+    {
+        std::sort(fractions.begin(), fractions.end());
+    }
+
+    return profile;
+}
+
+/*! \brief Estimates the relative load imbalance of DD grid \p nc due to the atom distribution
+ *
+ * Uses the maximum number of atoms in a slab of uniform cells along
+ * each dimension and assumes the density is separable over dimensions.
+ * Returns the estimated fraction of additional time the most loaded
+ * cell takes compared to the average cell, before DLB.
+ */
+static float estimateStaticImbalance(const AtomDensityProfile& profile, const gmx::IVec& nc)
+{
+    float maxRelativeLoad = 1;
+    for (int d = 0; d < DIM; d++)
+    {
+        const std::vector<real>& fractions = profile.sortedFractions[d];
+        if (nc[d] == 1 || fractions.empty())
+        {
+            continue;
+        }
+
+        gmx::Index maxCount = 0;
+        auto       begin    = fractions.begin();
+        for (int i = 1; i <= nc[d]; i++)
+        {
+            const real boundary = real(i) / nc[d];
+            const auto end      = (i == nc[d]) ? fractions.end()
+                                               : std::lower_bound(begin, fractions.end(), boundary);
+            maxCount            = std::max(maxCount, static_cast<gmx::Index>(end - begin));
+            begin               = end;
+        }
+        maxRelativeLoad *= static_cast<float>(maxCount * nc[d]) / fractions.size();
+    }
+
+    return maxRelativeLoad - 1;
+}
+
 /*! \brief Estimate cost of communication for a possible domain decomposition. */
-static float comm_cost_est(real               limit,
-                           real               cutoff,
-                           const matrix       box,
-                           const gmx_ddbox_t& ddbox,
-                           const int64_t      natoms,
-                           const t_inputrec&  ir,
-                           float              pbcdxr,
-                           int                npme_tot,
-                           const gmx::IVec&   nc)
+static float comm_cost_est(real                      limit,
+                           real                      cutoff,
+                           const matrix              box,
+                           const gmx_ddbox_t&        ddbox,
+                           const int64_t             natoms,
+                           const t_inputrec&         ir,
+                           float                     pbcdxr,
+                           int                       npme_tot,
+                           const AtomDensityProfile* densityProfile,
+                           const gmx::IVec&          nc)
 {
     gmx::IVec npme = { 1, 1, 1 };
     rvec      bt;
@@ -524,10 +622,21 @@ static float comm_cost_est(real               limit,
         }
     }
 
+    /* Add the cost of the static load imbalance due to an inhomogeneous
+     * atom distribution. We (roughly) assume that the cost of a fraction
+     * of time lost to imbalance equals the cost of communicating
+     * the same fraction of all atoms.
+     */
+    float cost_imbalance = 0;
+    if (densityProfile != nullptr)
+    {
+        cost_imbalance = estimateStaticImbalance(*densityProfile, nc);
+    }
+
     if (debug)
     {
         fprintf(debug,
-                "nc %2d %2d %2d %2d %2d vol pp %6.4f pbcdx %6.4f pme %9.3e tot %9.3e\n",
+                "nc %2d %2d %2d %2d %2d vol pp %6.4f pbcdx %6.4f imb %6.4f pme %9.3e tot %9.3e\n",
                 nc[XX],
                 nc[YY],
                 nc[ZZ],
@@ -535,38 +644,50 @@ static float comm_cost_est(real               limit,
                 npme[YY],
                 comm_vol,
                 cost_pbcdx,
+                cost_imbalance,
                 comm_pme / (3 * natoms),
-                comm_vol + cost_pbcdx + comm_pme / (3 * natoms));
+                comm_vol + cost_pbcdx + cost_imbalance + comm_pme / (3 * natoms));
     }
 
-    return 3 * natoms * (comm_vol + cost_pbcdx) + comm_pme;
+    return 3 * natoms * (comm_vol + cost_pbcdx + cost_imbalance) + comm_pme;
 }
 
 /*! \brief Assign penalty factors to possible domain decompositions,
  * based on the estimated communication costs. */
-static void assign_factors(const real         limit,
-                           const real         cutoff,
-                           const matrix       box,
-                           const gmx_ddbox_t& ddbox,
-                           int                natoms,
-                           const t_inputrec&  ir,
-                           float              pbcdxr,
-                           int                npme,
-                           int                ndiv,
-                           const int*         div,
-                           const int*         mdiv,
-                           gmx::IVec*         irTryPtr,
-                           gmx::IVec*         opt)
+static void assign_factors(const real                limit,
+                           const real                cutoff,
+                           const matrix              box,
+                           const gmx_ddbox_t&        ddbox,
+                           int                       natoms,
+                           const t_inputrec&         ir,
+                           float                     pbcdxr,
+                           int                       npme,
+                           const AtomDensityProfile* densityProfile,
+                           int                       ndiv,
+                           const int*                div,
+                           const int*                mdiv,
+                           gmx::IVec*                irTryPtr,
+                           gmx::IVec*                opt)
 {
     gmx::IVec& ir_try = *irTryPtr;
 
     if (ndiv == 0)
     {
 
-        const float ce = comm_cost_est(limit, cutoff, box, ddbox, natoms, ir, pbcdxr, npme, ir_try);
+        const float ce = comm_cost_est(
+                limit, cutoff, box, ddbox, natoms, ir, pbcdxr, npme, densityProfile, ir_try);
         if (ce >= 0
             && ((*opt)[XX] == 0
-                || ce < comm_cost_est(limit, cutoff, box, ddbox, natoms, ir, pbcdxr, npme, *opt)))
+                || ce < comm_cost_est(limit,
+                                      cutoff,
+                                      box,
+                                      ddbox,
+                                      natoms,
+                                      ir,
+                                      pbcdxr,
+                                      npme,
+                                      densityProfile,
+                                      *opt)))
         {
             *opt = ir_try;
         }
@@ -592,8 +713,20 @@ static void assign_factors(const real         limit,
             }
 
             /* recurse */
-            assign_factors(
-                    limit, cutoff, box, ddbox, natoms, ir, pbcdxr, npme, ndiv - 1, div + 1, mdiv + 1, irTryPtr, opt);
+            assign_factors(limit,
+                           cutoff,
+                           box,
+                           ddbox,
+                           natoms,
+                           ir,
+                           pbcdxr,
+                           npme,
+                           densityProfile,
+                           ndiv - 1,
+                           div + 1,
+                           mdiv + 1,
+                           irTryPtr,
+                           opt);
 
             for (int i = 0; i < mdiv[0] - x - y; i++)
             {
@@ -616,15 +749,17 @@ static void assign_factors(const real         limit,
  *
  * \returns The optimal grid cell choice. The latter will contain all
  *          zeros if no valid cell choice exists. */
-static gmx::IVec optimizeDDCells(const gmx::MDLogger& mdlog,
-                                 const int            numRanksRequested,
-                                 const int            numPmeOnlyRanks,
-                                 const real           cellSizeLimit,
-                                 const gmx_mtop_t&    mtop,
-                                 const matrix         box,
-                                 const gmx_ddbox_t&   ddbox,
-                                 const t_inputrec&    ir,
-                                 const DDSystemInfo&  systemInfo)
+static gmx::IVec optimizeDDCells(const gmx::MDLogger&           mdlog,
+                                 const int                      numRanksRequested,
+                                 const int                      numPmeOnlyRanks,
+                                 const real                     cellSizeLimit,
+                                 const gmx_mtop_t&              mtop,
+                                 const matrix                   box,
+                                 const gmx_ddbox_t&             ddbox,
+                                 const t_inputrec&              ir,
+                                 const DDSystemInfo&            systemInfo,
+                                 const bool                     useDensityAwareGrid,
+                                 gmx::ArrayRef<const gmx::RVec> xGlobal)
 {
     double pbcdxr = 0;
 
@@ -690,6 +825,16 @@ static gmx::IVec optimizeDDCells(const gmx::MDLogger& mdlog,
         fprintf(debug, "Average nr of pbc_dx calls per atom %.2f\n", pbcdxr);
     }
 
+    std::optional<AtomDensityProfile> densityProfile;
+    if (useDensityAwareGrid && !xGlobal.empty())
+    {
+        GMX_LOG(mdlog.info)
+                .appendText(
+                        "Taking the load imbalance due to the atom distribution into account "
+                        "for optimizing the DD grid");
+        densityProfile = makeAtomDensityProfile(box, ddbox, xGlobal);
+    }
+
     /* Decompose numPPRanks in factors */
     std::vector<int> div;
     std::vector<int> mdiv;
@@ -705,12 +850,22 @@ static gmx::IVec optimizeDDCells(const gmx::MDLogger& mdlog,
                    ir,
                    pbcdxr,
                    numRanksDoingPmeWork,
+                   densityProfile ? &densityProfile.value() : nullptr,
                    div.size(),
                    div.data(),
                    mdiv.data(),
                    &itry,
                    &numDomains);
 
+    if (densityProfile && numDomains[XX] > 0)
+    {
+        GMX_LOG(mdlog.info)
+                .appendTextFormatted(
+                        "Estimated load imbalance due to the atom distribution without DLB: "
+                        "%.1f%%",
+                        100 * estimateStaticImbalance(*densityProfile, numDomains));
+    }
+
     return numDomains;
 }
 
@@ -987,8 +1142,17 @@ DDGridSetup getDDGridSetup(const gmx::MDLogger&                  mdlog,
 
         if (ddRole == DDRole::Main)
         {
-            numDomains = optimizeDDCells(
-                    mdlog, numRanksRequested, numPmeOnlyRanks, cellSizeLimit, mtop, box, *ddbox, ir, systemInfo);
+            numDomains = optimizeDDCells(mdlog,
+                                         numRanksRequested,
+                                         numPmeOnlyRanks,
+                                         cellSizeLimit,
+                                         mtop,
+                                         box,
+                                         *ddbox,
+                                         ir,
+                                         systemInfo,
+                                         ddSettings.useDensityAwareGrid,
+                                         xGlobal);
         }
     }
 
@@ -93,6 +93,7 @@
 #include "gromacs/mdtypes/state.h"
 #include "gromacs/nbnxm/nbnxm.h"
 #include "gromacs/pulling/pull.h"
+#include "gromacs/timing/performancereport.h"
 #include "gromacs/timing/wallcycle.h"
 #include "gromacs/topology/idef.h"
 #include "gromacs/topology/mtop_util.h"
@@ -103,6 +104,7 @@
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/keyvaluetreebuilder.h"
 #include "gromacs/utility/listoflists.h"
 #include "gromacs/utility/logger.h"
 #include "gromacs/utility/range.h"
@@ -1001,6 +1003,28 @@ static float dd_force_imb_perf_loss(gmx_domdec_t* dd)
     }
 }
 
+/*! \brief Return the relative performance loss on the total run time
+ * due to the load imbalance between PP and \p numPmeRanks separate PME ranks.
+ *
+ * A negative value means that the PME ranks had less work to do.
+ */
+static float dd_pme_imb_perf_loss(gmx_domdec_t* dd, int numPmeRanks)
+{
+    const gmx_domdec_comm_t* comm     = dd->comm.get();
+    const int                numRanks = dd->nnodes + numPmeRanks;
+
+    float lossFractionPme = (comm->load_pme - comm->load_mdf) / comm->load_step;
+    if (lossFractionPme <= 0)
+    {
+        lossFractionPme *= numPmeRanks / static_cast<float>(numRanks);
+    }
+    else
+    {
+        lossFractionPme *= dd->nnodes / static_cast<float>(numRanks);
+    }
+    return lossFractionPme;
+}
+
 //! Print load-balance report e.g. at the end of a run.
 static void print_dd_load_av(FILE* fplog, gmx_domdec_t* dd)
 {
@@ -1015,7 +1039,6 @@ static void print_dd_load_av(FILE* fplog, gmx_domdec_t* dd)
     char buf[STRLEN];
     int  numPpRanks  = dd->nnodes;
     int  numPmeRanks = (comm->ddRankSetup.usePmeOnlyRanks ? comm->ddRankSetup.numRanksDoingPme : 0);
-    int  numRanks    = numPpRanks + numPmeRanks;
     float lossFraction = 0;
 
     /* Print the average load imbalance and performance loss */
@@ -1092,15 +1115,7 @@ static void print_dd_load_av(FILE* fplog, gmx_domdec_t* dd)
     if (numPmeRanks > 0 && comm->load_mdf > 0 && comm->load_step > 0)
     {
         float pmeForceRatio = comm->load_pme / comm->load_mdf;
-        lossFractionPme     = (comm->load_pme - comm->load_mdf) / comm->load_step;
-        if (lossFractionPme <= 0)
-        {
-            lossFractionPme *= numPmeRanks / static_cast<float>(numRanks);
-        }
-        else
-        {
-            lossFractionPme *= numPpRanks / static_cast<float>(numRanks);
-        }
+        lossFractionPme     = dd_pme_imb_perf_loss(dd, numPmeRanks);
         sprintf(buf, " Average PME mesh/force load: %5.3f\n", pmeForceRatio);
         fprintf(fplog, "%s", buf);
         fprintf(stderr, "%s", buf);
@@ -2488,6 +2503,81 @@ void print_dd_statistics(const t_commrec* cr, const t_inputrec& inputrec, FILE*
     }
 }
 
+void report_dd_statistics(const t_commrec*        cr,
+                          const t_inputrec&       inputrec,
+                          gmx::PerformanceReport* report)
+{
+    gmx_domdec_t*      dd   = cr->dd;
+    gmx_domdec_comm_t* comm = dd->comm.get();
+
+    static constexpr gmx::EnumerationArray<DlbState, const char*> c_dlbStateNames = {
+        "off_user", "off_forever", "off_can_turn_on", "off_temporarily_locked",
+        "on_can_turn_off", "on_user"
+    };
+
+    const int numPmeRanks =
+            (comm->ddRankSetup.usePmeOnlyRanks ? comm->ddRankSetup.numRanksDoingPme : 0);
+
+    gmx::KeyValueTreeObjectBuilder section = report->section("domain_decomposition");
+    section.addValue<int>("pp_ranks", dd->nnodes);
+    section.addValue<int>("pme_ranks", numPmeRanks);
+    section.addUniformArray<int>("grid", { dd->numCells[XX], dd->numCells[YY], dd->numCells[ZZ] });
+    section.addValue<std::string>("dlb_state", c_dlbStateNames[comm->dlbState]);
+
+    /* The average number of atoms communicated per step, times the number
+     * of communications per step, for each of the atom ranges */
+    gmx::KeyValueTreeObjectBuilder communication = section.addObject("atoms_communicated_per_step");
+    const auto addRange =
+            [&communication, comm](const char* name, DDAtomRanges::Type range, int count)
+    {
+        const double average = comm->sum_nat[static_cast<int>(range)] / comm->ndecomp;
+        gmx::KeyValueTreeObjectBuilder rangeBuilder = communication.addObject(name);
+        rangeBuilder.addValue<int>("count", count);
+        rangeBuilder.addValue<double>("atoms", average);
+    };
+    addRange("force", DDAtomRanges::Type::Zones, 2);
+    if (dd->vsite_comm)
+    {
+        addRange("vsites",
+                 DDAtomRanges::Type::Vsites,
+                 (usingPme(inputrec.coulombtype)
+                  || inputrec.coulombtype == CoulombInteractionType::Ewald)
+                         ? 3
+                         : 2);
+    }
+    if (dd->constraint_comm)
+    {
+        addRange("constraints", DDAtomRanges::Type::Constraints, 1 + inputrec.nLincsIter);
+    }
+
+    if (!comm->ddSettings.recordLoad || !EI_DYNAMICS(inputrec.eI) || comm->nload == 0)
+    {
+        return;
+    }
+    gmx::KeyValueTreeObjectBuilder load = section.addObject("load_balance");
+    if (dd->nnodes > 1 && comm->load_sum > 0)
+    {
+        load.addValue<double>("average_imbalance",
+                              comm->load_max * dd->nnodes / comm->load_sum - 1);
+        load.addValue<double>("balanceable_fraction", dd_force_load_fraction(dd));
+        load.addValue<double>("imbalance_loss_fraction", dd_force_imb_perf_loss(dd));
+    }
+    if (isDlbOn(comm->dlbState))
+    {
+        auto limited = load.addUniformArray<double>("dlb_limited_fraction_per_dim");
+        for (int d = 0; d < dd->ndim; d++)
+        {
+            limited.addValue(comm->load_lim[d] / static_cast<double>(comm->nload));
+        }
+    }
+    if (numPmeRanks > 0 && comm->load_mdf > 0 && comm->load_step > 0)
+    {
+        load.addValue<double>("pme_mesh_force_load_ratio", comm->load_pme / comm->load_mdf);
+        load.addValue<double>("pp_pme_imbalance_loss_fraction",
+                              dd_pme_imb_perf_loss(dd, numPmeRanks));
+    }
+}
+
 //!\brief TODO Remove fplog when group scheme and charge groups are gone
 void dd_partition_system(FILE*                     fplog,
                          const gmx::MDLogger&      mdlog,
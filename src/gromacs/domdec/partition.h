@@ -72,6 +72,7 @@ class ImdSession;
 class MDAtoms;
 class MDLogger;
 struct MDModulesNotifiers;
+class PerformanceReport;
 class VirtualSitesHandler;
 
 //! Check whether the DD grid has moved too far for correctness.
@@ -80,6 +81,15 @@ bool check_grid_jump(int64_t step, const gmx_domdec_t* dd, real cutoff, const gm
 /*! \brief Print statistics for domain decomposition communication */
 void print_dd_statistics(const t_commrec* cr, const t_inputrec& inputrec, FILE* fplog);
 
+/*! \brief Add the statistics for domain decomposition communication
+ * and load balancing to \p report
+ *
+ * Should only be called on the main rank, after print_dd_statistics().
+ */
+void report_dd_statistics(const t_commrec*        cr,
+                          const t_inputrec&       inputrec,
+                          gmx::PerformanceReport* report);
+
 /*! \brief Partition the system over the nodes.
  *
  * step is only used for printing error messages.
@@ -99,6 +99,7 @@ static inline int DD_FLAG_BW(int d)
 }
 
 static void copyMovedAtomsToBufferPerAtom(gmx::ArrayRef<const int> move,
+                                          gmx::ArrayRef<const int> movingAtoms,
                                           int                      nvec,
                                           int                      vec,
                                           rvec*                    src,
@@ -106,60 +107,50 @@ static void copyMovedAtomsToBufferPerAtom(gmx::ArrayRef<const int> move,
 {
     int pos_vec[DIM * 2] = { 0 };
 
-    for (gmx::Index i = 0; i < move.ssize(); i++)
+    for (const int i : movingAtoms)
     {
-        /* Skip moved atoms */
+        /* Copy to the communication buffer */
         const int m = move[i];
-        if (m >= 0)
-        {
-            /* Copy to the communication buffer */
-            pos_vec[m] += 1 + vec;
-            copy_rvec(src[i], comm->cgcm_state[m][pos_vec[m]++]);
-            pos_vec[m] += nvec - vec - 1;
-        }
+        pos_vec[m] += 1 + vec;
+        copy_rvec(src[i], comm->cgcm_state[m][pos_vec[m]++]);
+        pos_vec[m] += nvec - vec - 1;
     }
 }
 
 static void copyMovedUpdateGroupCogs(gmx::ArrayRef<const int>       move,
+                                     gmx::ArrayRef<const int>       movingAtoms,
                                      int                            nvec,
                                      gmx::ArrayRef<const gmx::RVec> coordinates,
                                      gmx_domdec_comm_t*             comm)
 {
     int pos_vec[DIM * 2] = { 0 };
 
-    for (gmx::Index g = 0; g < move.ssize(); g++)
+    for (const int g : movingAtoms)
     {
-        /* Skip moved atoms */
-        const int m = move[g];
-        if (m >= 0)
-        {
-            /* Copy to the communication buffer */
-            const gmx::RVec& cog =
-                    (comm->systemInfo.useUpdateGroups ? comm->updateGroupsCog->cogForAtom(g)
-                                                      : coordinates[g]);
-            copy_rvec(cog, comm->cgcm_state[m][pos_vec[m]]);
-            pos_vec[m] += 1 + nvec;
-        }
+        /* Copy to the communication buffer */
+        const int        m = move[g];
+        const gmx::RVec& cog =
+                (comm->systemInfo.useUpdateGroups ? comm->updateGroupsCog->cogForAtom(g)
+                                                  : coordinates[g]);
+        copy_rvec(cog, comm->cgcm_state[m][pos_vec[m]]);
+        pos_vec[m] += 1 + nvec;
     }
 }
 
-static void clear_and_mark_ind(gmx::ArrayRef<const int> move,
+static void clear_and_mark_ind(gmx::ArrayRef<const int> movingAtoms,
                                gmx::ArrayRef<const int> globalAtomIndices,
                                gmx_ga2la_t*             ga2la,
                                int*                     cell_index)
 {
-    for (gmx::Index a = 0; a < move.ssize(); a++)
+    for (const int a : movingAtoms)
     {
-        if (move[a] >= 0)
-        {
-            /* Clear the global indices */
-            ga2la->erase(globalAtomIndices[a]);
-            /* Signal that this atom has moved using the ns cell index.
-             * Here we set it to -1. fill_grid will change it
-             * from -1 to NSGRID_SIGNAL_MOVED_FAC*grid->ncells.
-             */
-            cell_index[a] = -1;
-        }
+        /* Clear the global indices */
+        ga2la->erase(globalAtomIndices[a]);
+        /* Signal that this atom has moved using the ns cell index.
+         * Here we set it to -1. fill_grid will change it
+         * from -1 to NSGRID_SIGNAL_MOVED_FAC*grid->ncells.
+         */
+        cell_index[a] = -1;
     }
 }
 
@@ -696,10 +687,15 @@ void dd_redistribute_cg(FILE*         fplog,
     // The counts of atoms to move, forward or backward, over the
     // possible DIM dimensions.
     int nat[DIM * 2] = { 0 };
+    // We store the indices of the moving atoms, so the buffer packing
+    // below only needs to loop over these instead of over all home atoms.
+    std::vector<int>& movingAtoms = comm->movingHomeAtoms;
+    movingAtoms.clear();
     for (int cg = 0; cg < dd->numHomeAtoms; cg++)
     {
         if (move[cg] >= 0)
         {
+            movingAtoms.push_back(cg);
             // The value in move[cg] was computed by computeMoveFlags
             // and describes how this atom should move between domains.
             const int flag = move[cg] & ~DD_FLAG_NRCG;
@@ -758,22 +754,25 @@ void dd_redistribute_cg(FILE*         fplog,
      * over twice. This is so the code further down can be used
      * without many conditionals both with and without update groups.
      */
-    copyMovedUpdateGroupCogs(move, nvec, state->x, comm);
+    copyMovedUpdateGroupCogs(move, movingAtoms, nvec, state->x, comm);
 
     int vectorIndex = 0;
-    copyMovedAtomsToBufferPerAtom(move, nvec, vectorIndex++, state->x.rvec_array(), comm);
+    copyMovedAtomsToBufferPerAtom(
+            move, movingAtoms, nvec, vectorIndex++, state->x.rvec_array(), comm);
     if (bV)
     {
-        copyMovedAtomsToBufferPerAtom(move, nvec, vectorIndex++, state->v.rvec_array(), comm);
+        copyMovedAtomsToBufferPerAtom(
+                move, movingAtoms, nvec, vectorIndex++, state->v.rvec_array(), comm);
     }
     if (bCGP)
     {
-        copyMovedAtomsToBufferPerAtom(move, nvec, vectorIndex++, state->cg_p.rvec_array(), comm);
+        copyMovedAtomsToBufferPerAtom(
+                move, movingAtoms, nvec, vectorIndex++, state->cg_p.rvec_array(), comm);
     }
 
     int* moved = getMovedBuffer(comm, 0, dd->numHomeAtoms);
 
-    clear_and_mark_ind(move, dd->globalAtomIndices, dd->ga2la.get(), moved);
+    clear_and_mark_ind(movingAtoms, dd->globalAtomIndices, dd->ga2la.get(), moved);
 
     /* Now we can remove the excess global atom indices from the list */
     dd->globalAtomIndices.resize(dd->numHomeAtoms);
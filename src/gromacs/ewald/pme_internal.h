@@ -187,6 +187,8 @@ struct splinedata_t
     SplineCoefficients theta;
     SplineCoefficients dtheta;
     int                nalloc = 0;
+    //! Work buffers for sorting ind on grid plane
+    std::vector<int> planeCount, sortedInd;
 };
 
 /*! \brief PME slab MPI communication setup */
@@ -48,6 +48,7 @@
 #include <cmath>
 
 #include <algorithm>
+#include <string>
 
 #include "gromacs/domdec/dlb.h"
 #include "gromacs/domdec/domdec.h"
@@ -71,12 +72,14 @@
 #include "gromacs/nbnxm/gpu_data_mgmt.h"
 #include "gromacs/nbnxm/nbnxm.h"
 #include "gromacs/pbcutil/pbc.h"
+#include "gromacs/timing/performancereport.h"
 #include "gromacs/timing/wallcycle.h"
 #include "gromacs/timing/walltime_accounting.h"
 #include "gromacs/utility/cstringutil.h"
 #include "gromacs/utility/enumerationhelpers.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/keyvaluetreebuilder.h"
 #include "gromacs/utility/logger.h"
 #include "gromacs/utility/strconvert.h"
 
@@ -825,6 +828,7 @@ static void pme_load_balance(pme_load_balancing_t*          pme_lb,
 
     ic->rcoulomb = set->rcut_coulomb;
     nbv->changePairlistRadii(set->rlistOuter, set->rlistInner);
+    nbv->changeInteractionCutoff(std::max(ic->rcoulomb, ic->rvdw));
     ic->ewaldcoeff_q = set->ewaldcoeff_q;
     /* TODO: centralize the code that sets the potentials shifts */
     if (ic->coulomb_modifier == InteractionModifiers::PotShift)
@@ -1178,12 +1182,50 @@ static void print_pme_loadbal_settings(pme_load_balancing_t* pme_lb,
     }
 }
 
-void pme_loadbal_done(pme_load_balancing_t* pme_lb, FILE* fplog, const gmx::MDLogger& mdlog, gmx_bool bNonBondedOnGPU)
+/*! \brief Add a load-balancing setting to \p setups */
+static void report_pme_loadbal_setting(gmx::KeyValueTreeObjectArrayBuilder* setups,
+                                       const pme_setup_t&                   setup)
+{
+    gmx::KeyValueTreeObjectBuilder builder = setups->addObject();
+    builder.addValue<double>("rcoulomb_nm", setup.rcut_coulomb);
+    builder.addValue<double>("rlist_nm", setup.rlistInner);
+    builder.addUniformArray<int>("grid", { setup.grid[XX], setup.grid[YY], setup.grid[ZZ] });
+    builder.addValue<double>("spacing_nm", setup.spacing);
+    builder.addValue<double>("ewald_beta_inverse_nm", 1 / setup.ewaldcoeff_q);
+    builder.addValue<int>("times_measured", setup.count);
+    builder.addValue<double>("fastest_giga_cycles", setup.cycles * 1e-9);
+}
+
+/*! \brief Add all load-balancing settings and the outcome to \p report */
+static void report_pme_loadbal_settings(const pme_load_balancing_t* pme_lb,
+                                        gmx::PerformanceReport*     report)
+{
+    gmx::KeyValueTreeObjectBuilder section = report->section("pme_load_balancing");
+    section.addValue<bool>("changed_setup", pme_lb->cur > 0);
+    section.addValue<std::string>("limited_by", enumValueToString(pme_lb->elimited));
+    section.addValue<int>("initial_setup", 0);
+    section.addValue<int>("final_setup", pme_lb->cur);
+    gmx::KeyValueTreeObjectArrayBuilder setups = section.addObjectArray("setups");
+    for (const pme_setup_t& setup : pme_lb->setup)
+    {
+        report_pme_loadbal_setting(&setups, setup);
+    }
+}
+
+void pme_loadbal_done(pme_load_balancing_t*   pme_lb,
+                      FILE*                   fplog,
+                      const gmx::MDLogger&    mdlog,
+                      gmx_bool                bNonBondedOnGPU,
+                      gmx::PerformanceReport* performanceReport)
 {
     if (fplog != nullptr && (pme_lb->cur > 0 || pme_lb->elimited != PmeLoadBalancingLimit::No))
     {
         print_pme_loadbal_settings(pme_lb, fplog, mdlog, bNonBondedOnGPU);
     }
+    if (performanceReport != nullptr)
+    {
+        report_pme_loadbal_settings(pme_lb, performanceReport);
+    }
     for (int i = 0; i < gmx::ssize(pme_lb->setup); i++)
     {
         // current element is stored in forcerec and free'd in Mdrunner::mdruner, together with shared data
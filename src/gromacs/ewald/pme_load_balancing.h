@@ -37,6 +37,13 @@
  * managing automatic load balance of PME calculations (Coulomb and
  * LJ).
  *
+ * The tuning scales the cut-off and the PME grid spacing together, which
+ * keeps the Ewald splitting accuracy constant. The PME interpolation order
+ * and the division of ranks over PP and PME are kept fixed, since changing
+ * them requires re-initializing the PME and domain decomposition setups,
+ * and with GPUs only order 4 is supported. Use gmx tune_pme to optimize
+ * the number of separate PME ranks.
+ *
  * \author Berk Hess <hess@kth.se>
  * \inlibraryapi
  * \ingroup module_ewald
@@ -60,6 +67,7 @@ namespace gmx
 {
 struct nonbonded_verlet_t;
 class MDLogger;
+class PerformanceReport;
 template<typename T>
 class ArrayRef;
 } // namespace gmx
@@ -109,7 +117,15 @@ void pme_loadbal_do(pme_load_balancing_t*          pme_lb,
                     gmx_bool*                      bPrinting,
                     bool                           useGpuPmePpCommunication);
 
-/*! \brief Finish the PME load balancing and print the settings when fplog!=NULL */
-void pme_loadbal_done(pme_load_balancing_t* pme_lb, FILE* fplog, const gmx::MDLogger& mdlog, gmx_bool bNonBondedOnGPU);
+/*! \brief Finish the PME load balancing and print the settings when fplog!=NULL
+ *
+ * All tried settings and the outcome are added to \p performanceReport
+ * when it is not nullptr.
+ */
+void pme_loadbal_done(pme_load_balancing_t*   pme_lb,
+                      FILE*                   fplog,
+                      const gmx::MDLogger&    mdlog,
+                      gmx_bool                bNonBondedOnGPU,
+                      gmx::PerformanceReport* performanceReport);
 
 #endif
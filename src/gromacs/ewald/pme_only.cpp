@@ -199,7 +199,15 @@ static gmx_pme_t* gmx_pmeonly_switch(std::vector<gmx_pme_t*>* pmedata,
         if (gmx_pme_grid_matches(*pme, grid_size))
         {
             /* Here we have found an existing PME data structure that suits us.
-             * However, in the GPU case, we have to reinitialize it - there's only one GPU structure.
+             * On the CPU it can be used as is, as is done on PP ranks,
+             * which avoids the cost of re-creating the FFT plans.
+             */
+            if (!pme_gpu_task_enabled(pme) && pme->ewaldcoeff_q == ewaldcoeff_q
+                && pme->ewaldcoeff_lj == ewaldcoeff_lj)
+            {
+                return pme;
+            }
+            /* In the GPU case, we have to reinitialize it - there's only one GPU structure.
              * This should not cause actual GPU reallocations, at least (the allocated buffers are never shrunk).
              * So, just some grid size updates in the GPU kernel parameters.
              * TODO: this should be something like gmx_pme_update_split_params()
@@ -38,6 +38,9 @@
 
 #include <cmath>
 
+#include <algorithm>
+#include <array>
+
 #include "gromacs/fft/parallel_3dfft.h"
 #include "gromacs/math/units.h"
 #include "gromacs/math/utilities.h"
@@ -81,6 +84,14 @@ struct pme_solve_work_t
     gmx::PaddedVector<real> eterm;
     std::vector<real>       m2inv;
 
+    /* Coulomb influence function values for all grid points of this thread,
+     * stored at steps without energy and virial for reuse while the box and
+     * the Ewald parameters, stored in etermCacheKey, do not change.
+     */
+    std::vector<real>   etermCache;
+    std::array<real, 9> etermCacheKey     = {};
+    bool                etermCacheIsValid = false;
+
     real   energy_q;
     matrix vir_q;
     real   energy_lj;
@@ -345,6 +356,36 @@ int PmeSolve::solveCoulombYZX(const gmx_pme_t& pme,
     iyz0 = local_ndata[YY] * local_ndata[ZZ] * thread / nthread;
     iyz1 = local_ndata[YY] * local_ndata[ZZ] * (thread + 1) / nthread;
 
+    /* The influence function only depends on the box and the Ewald parameters.
+     * When these did not change since the previous call, which is the case
+     * with a fixed box and with perturbed charges, we store it at the first
+     * call and reuse it afterwards. This avoids the exponentials and divisions.
+     * Stored values are only used at steps without energy and virial,
+     * as the latter also need the components of m.
+     */
+    bool useEtermCache  = false;
+    bool fillEtermCache = false;
+    if (!computeEnergyAndVirial)
+    {
+        const std::array<real, 9> etermCacheKey = {
+            rxx, ryx, ryy, rzx, rzy, rzz, vol, ewaldcoeff, elfac
+        };
+        if (etermCacheKey == work.etermCacheKey)
+        {
+            useEtermCache  = work.etermCacheIsValid;
+            fillEtermCache = !work.etermCacheIsValid;
+        }
+        else
+        {
+            work.etermCacheKey     = etermCacheKey;
+            work.etermCacheIsValid = false;
+        }
+        if (fillEtermCache)
+        {
+            work.etermCache.resize((iyz1 - iyz0) * local_ndata[XX]);
+        }
+    }
+
     for (iyz = iyz0; iyz < iyz1; iyz++)
     {
         iy = iyz / local_ndata[ZZ];
@@ -473,6 +514,18 @@ int PmeSolve::solveCoulombYZX(const gmx_pme_t& pme,
                 virzz += ets2vf * mhz[kx] * mhz[kx] - ets2;
             }
         }
+        else if (useEtermCache)
+        {
+            /* Note that since x is the minor index, local_offset[XX]=0 */
+            const real* gmx_restrict etermStored =
+                    work.etermCache.data() + (iyz - iyz0) * local_ndata[XX];
+
+            for (kx = kxstart; kx < kxend; kx++, p0++)
+            {
+                p0->re *= etermStored[kx];
+                p0->im *= etermStored[kx];
+            }
+        }
         else
         {
             /* We don't need to calculate the energy and the virial.
@@ -522,9 +575,21 @@ int PmeSolve::solveCoulombYZX(const gmx_pme_t& pme,
                 p0->re = d1 * eterm[kx];
                 p0->im = d2 * eterm[kx];
             }
+
+            if (fillEtermCache)
+            {
+                std::copy(eterm + kxstart,
+                          eterm + kxend,
+                          work.etermCache.data() + (iyz - iyz0) * local_ndata[XX] + kxstart);
+            }
         }
     }
 
+    if (fillEtermCache)
+    {
+        work.etermCacheIsValid = true;
+    }
+
     if (computeEnergyAndVirial)
     {
         /* Update virial with local values.
@@ -40,6 +40,7 @@
 #include <cassert>
 
 #include <algorithm>
+#include <vector>
 
 #include "gromacs/ewald/pme.h"
 #include "gromacs/fft/parallel_3dfft.h"
@@ -179,13 +180,30 @@ static void calc_interpolation_idx(const gmx_pme_t*  pme,
     }
 }
 
-static void make_thread_local_ind(const PmeAtomComm* atc, int thread, splinedata_t* spline)
+/* Combines the thread-local atom indices and sorts them on the x-plane of their grid index.
+ *
+ * The spreading of an atom touches pme_order x-planes of the thread grid.
+ * Sorting on the grid x-plane with a stable counting sort ensures that
+ * consecutive atoms touch nearly the same grid planes, which limits the
+ * cache footprint of spreading and gathering when atoms are not spatially
+ * ordered. The sort is deterministic, so the order stays consistent between
+ * repeated calls for the same coordinates, as needed for the splines.
+ */
+static void make_thread_local_ind(const PmeAtomComm* atc,
+                                  int                thread,
+                                  const pmegrid_t&   grid,
+                                  splinedata_t*      spline)
 {
     int n, t, i, start, end;
 
     /* Combine the indices made by each thread into one index */
 
-    n     = 0;
+    std::vector<int>& planeCount = spline->planeCount;
+    planeCount.assign(grid.s[XX] + 1, 0);
+
+    std::vector<int>& combined = spline->sortedInd;
+    combined.clear();
+
     start = 0;
     for (t = 0; t < atc->nthread; t++)
     {
@@ -198,10 +216,27 @@ static void make_thread_local_ind(const PmeAtomComm* atc, int thread, splinedata
         end = threadMap.n[thread];
         for (i = start; i < end; i++)
         {
-            spline->ind[n++] = threadMap.i[i];
+            const int atomIndex = threadMap.i[i];
+            const int plane     = atc->idx[atomIndex][XX] - grid.offset[XX];
+            GMX_ASSERT(plane >= 0 && plane < grid.s[XX], "Atoms should be within the thread grid");
+            planeCount[plane + 1]++;
+            combined.push_back(atomIndex);
         }
     }
 
+    /* Convert the counts to the starting index for each plane */
+    for (int plane = 1; plane <= grid.s[XX]; plane++)
+    {
+        planeCount[plane] += planeCount[plane - 1];
+    }
+
+    n = combined.size();
+    for (i = 0; i < n; i++)
+    {
+        const int plane                  = atc->idx[combined[i]][XX] - grid.offset[XX];
+        spline->ind[planeCount[plane]++] = combined[i];
+    }
+
     spline->n = n;
 }
 
@@ -964,7 +999,7 @@ void spread_on_grid(const gmx_pme_t* pme,
                 else
                 {
                     /* Get the indices our thread should operate on */
-                    make_thread_local_ind(atc, thread, spline);
+                    make_thread_local_ind(atc, thread, grids->pmeGrids.grid_th[thread], spline);
                 }
             }
 
@@ -316,6 +316,22 @@ public:
         const real cellVolume = box[0] * box[4] * box[8];
         // FIXME - this is box[XX][XX] * box[YY][YY] * box[ZZ][ZZ], should be stored in the PME structure
         pmePerformSolve(pmeSafe.get(), codePath, method, cellVolume, gridOrdering, computeEnergyAndVirial);
+        if (codePath == CodePath::CPU && method == PmeSolveAlgorithm::Coulomb
+            && !computeEnergyAndVirial)
+        {
+            // Solve twice more with the same box, which stores and then
+            // reuses the influence function, this should not change the result
+            for (int repeat = 0; repeat < 2; repeat++)
+            {
+                pmeSetComplexGrid(pmeSafe.get(), codePath, gridOrdering, nonZeroGridValues);
+                pmePerformSolve(pmeSafe.get(),
+                                codePath,
+                                method,
+                                cellVolume,
+                                gridOrdering,
+                                computeEnergyAndVirial);
+            }
+        }
         pmeFinalizeTest(pmeSafe.get(), codePath);
 
         /* Check the outputs */
@@ -1256,6 +1256,11 @@ void fft5d_execute(fft5d_plan plan, int thread, fft5d_time times)
                 wallcycle_start(times, WallCycleCounter::PmeFftComm);
 #endif
 #if GMX_MPI
+                /* Note that the transpose is a blocking collective and is
+                 * not overlapped with the FFTs. Overlap would require
+                 * non-blocking collectives, which thread-MPI does not
+                 * provide, and splitting of the slabs into sub-blocks.
+                 */
                 if ((s == 0 && !(plan->flags & FFT5D_ORDER_YZ))
                     || (s == 1 && (plan->flags & FFT5D_ORDER_YZ)))
                 {
@@ -41,12 +41,20 @@
 #include <cstdlib>
 
 #include <filesystem>
+#include <functional>
 #include <mutex>
+#include <string>
+#include <system_error>
 
 #include "gromacs/fft/fft.h"
+#include "gromacs/hardware/cpuinfo.h"
+#include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/real.h"
+#include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/sysinfo.h"
 
 #if GMX_DOUBLE
 #    define FFTWPREFIX(name) fftw_##name
@@ -71,6 +79,90 @@ static std::mutex big_fftw_mutex;
     }                            \
     GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
 
+namespace
+{
+
+#if GMX_FFT_FFTW3
+//! Whether the wisdom file has been read, protected by big_fftw_mutex
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+bool wisdomImported = false;
+
+/*! \brief Returns the wisdom file name, empty when GMX_FFTW_WISDOM_FILE is not set
+ *
+ * Wisdom measured on one CPU model or with one number of threads competing
+ * for the caches can be far from optimal for another, so the name set with
+ * GMX_FFTW_WISDOM_FILE is suffixed with a hash of the CPU brand string and
+ * the number of OpenMP threads. This lets a shared file system hold wisdom
+ * for all node types and thread counts without them overwriting each other.
+ */
+const std::string& wisdomFileName()
+{
+    static const std::string fileName = []()
+    {
+        const char* baseName = std::getenv("GMX_FFTW_WISDOM_FILE");
+        if (baseName == nullptr || baseName[0] == '\0')
+        {
+            return std::string();
+        }
+        const size_t cpuHash = std::hash<std::string>{}(gmx::CpuInfo::detect().brandString());
+        return gmx::formatString("%s.%zx.nt%d", baseName, cpuHash, gmx_omp_get_max_threads());
+    }();
+
+    return fileName;
+}
+#endif
+
+/*! \brief Reads FFTW wisdom from the wisdom file, at most once per process
+ *
+ * Must be called with big_fftw_mutex locked. A missing or invalid file
+ * is not an error, FFTW then simply measures plans from scratch.
+ */
+void importWisdomOnce()
+{
+#if GMX_FFT_FFTW3
+    if (!wisdomImported)
+    {
+        wisdomImported = true;
+        const std::string& fileName = wisdomFileName();
+        if (!fileName.empty())
+        {
+            FFTWPREFIX(import_wisdom_from_filename)(fileName.c_str());
+        }
+    }
+#endif
+}
+
+/*! \brief Writes all FFTW wisdom to the wisdom file after measured planning
+ *
+ * Must be called with big_fftw_mutex locked. The wisdom is written to a
+ * process-specific temporary file that is renamed afterwards, so runs sharing
+ * the wisdom file never read a partially written file.
+ */
+void exportWisdom(int fftwFlags)
+{
+#if GMX_FFT_FFTW3
+    const std::string& fileName = wisdomFileName();
+    if (fileName.empty() || (fftwFlags & FFTW_ESTIMATE))
+    {
+        return;
+    }
+    const std::string tmpFileName = fileName + "." + std::to_string(gmx_getpid());
+    if (FFTWPREFIX(export_wisdom_to_filename)(tmpFileName.c_str()))
+    {
+        std::error_code errorCode;
+        std::filesystem::rename(tmpFileName, fileName, errorCode);
+        if (errorCode)
+        {
+            std::filesystem::remove(tmpFileName, errorCode);
+        }
+    }
+#else
+    GMX_UNUSED_VALUE(fftwFlags);
+#endif
+}
+
+} // namespace
+
 /* We assume here that aligned memory starts at multiple of 16 bytes and unaligned memory starts at multiple of 8 bytes. The later is guranteed for all malloc implementation.
    Consequesences:
    - It is not allowed to use these FFT plans from memory which doesn't have a starting address as a multiple of 8 bytes.
@@ -133,6 +225,7 @@ int gmx_fft_init_many_1d(gmx_fft_t* pfft, int nx, int howmany, gmx_fft_flag flag
     *pfft = nullptr;
 
     FFTW_LOCK
+    importWisdomOnce();
     if ((fft = static_cast<gmx_fft_t>(FFTWPREFIX(malloc)(sizeof(struct gmx_fft)))) == nullptr)
     {
         FFTW_UNLOCK
@@ -222,6 +315,7 @@ int gmx_fft_init_many_1d(gmx_fft_t* pfft, int nx, int howmany, gmx_fft_flag flag
     fft->ndim           = 1;
 
     *pfft = fft;
+    exportWisdom(fftw_flags);
     FFTW_UNLOCK
     return 0;
 }
@@ -253,6 +347,7 @@ int gmx_fft_init_many_1d_real(gmx_fft_t* pfft, int nx, int howmany, gmx_fft_flag
     *pfft = nullptr;
 
     FFTW_LOCK
+    importWisdomOnce();
     if ((fft = static_cast<gmx_fft_t>(FFTWPREFIX(malloc)(sizeof(struct gmx_fft)))) == nullptr)
     {
         FFTW_UNLOCK
@@ -421,6 +516,7 @@ int gmx_fft_init_many_1d_real(gmx_fft_t* pfft, int nx, int howmany, gmx_fft_flag
     fft->ndim           = 1;
 
     *pfft = fft;
+    exportWisdom(fftw_flags);
     FFTW_UNLOCK
     return 0;
 }
@@ -448,6 +544,7 @@ int gmx_fft_init_2d_real(gmx_fft_t* pfft, int nx, int ny, gmx_fft_flag flags)
     *pfft = nullptr;
 
     FFTW_LOCK
+    importWisdomOnce();
     if ((fft = static_cast<gmx_fft_t>(FFTWPREFIX(malloc)(sizeof(struct gmx_fft)))) == nullptr)
     {
         FFTW_UNLOCK
@@ -532,6 +629,7 @@ int gmx_fft_init_2d_real(gmx_fft_t* pfft, int nx, int ny, gmx_fft_flag flags)
     fft->ndim           = 2;
 
     *pfft = fft;
+    exportWisdom(fftw_flags);
     FFTW_UNLOCK
     return 0;
 }
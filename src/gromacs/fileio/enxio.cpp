@@ -99,6 +99,8 @@ struct ener_file
     t_fileio*  fio;
     int        framenr;
     real       frametime;
+    //! Whether do_enx() skips over the block data when reading
+    bool skipBlockData;
 };
 
 static void enxsubblock_init(t_enxsubblock* sb)
@@ -965,6 +967,47 @@ static void convert_full_sums(ener_old_t* ener_old, t_enxframe* fr)
     ener_old->step_prev = fr->step;
 }
 
+//! Returns the number of bytes that XDR uses to store one item of \p type, which must not be String
+static int xdrEncodedSize(XdrDataType type)
+{
+    switch (type)
+    {
+        case XdrDataType::Int: return 4;
+        case XdrDataType::Float: return 4;
+        case XdrDataType::Double: return 8;
+        case XdrDataType::Int64: return 8;
+        /* XDR pads each char to four bytes */
+        case XdrDataType::Char: return 4;
+        default:
+            gmx_incons(
+                    "Reading unknown block data type: this file is corrupted or from the "
+                    "future");
+    }
+}
+
+/*! \brief Moves the read position of \p fio forward by \p numBytes
+ *
+ * Returns false when the file ends before the new position. Seeking past
+ * the end of a file succeeds, so the file size is checked explicitly to
+ * detect a frame that was truncated, e.g. by a crashed run, as reading
+ * the data would.
+ */
+static bool skipBytes(t_fileio* fio, gmx_off_t numBytes)
+{
+    FILE*           fp          = gmx_fio_getfp(fio);
+    const gmx_off_t newPosition = gmx_fio_ftell(fio) + numBytes;
+    if (gmx_fseek(fp, 0, SEEK_END) != 0 || gmx_ftell(fp) < newPosition)
+    {
+        return false;
+    }
+    return gmx_fio_seek(fio, newPosition) == 0;
+}
+
+void enx_set_skip_block_data(ener_file_t ef, bool skipBlockData)
+{
+    ef->skipBlockData = skipBlockData;
+}
+
 gmx_bool do_enx(ener_file_t ef, t_enxframe* fr)
 {
     int      file_version = -1;
@@ -1080,6 +1123,12 @@ gmx_bool do_enx(ener_file_t ef, t_enxframe* fr)
         /* Convert old full simulation sums to sums between energy frames */
         convert_full_sums(&(ef->eo), fr);
     }
+    /* When skipping the block data, the number of bytes to skip is
+     * accumulated and the file position is moved only before reading
+     * a string, which has no fixed size, and at the end of the frame.
+     */
+    const bool skipBlockData = bRead && ef->skipBlockData;
+    gmx_off_t  bytesToSkip   = 0;
     /* read the blocks */
     for (b = 0; b < fr->nblock; b++)
     {
@@ -1091,6 +1140,17 @@ gmx_bool do_enx(ener_file_t ef, t_enxframe* fr)
         {
             t_enxsubblock* sub = &(fr->block[b].sub[i]); /* shortcut */
 
+            if (skipBlockData && sub->type != XdrDataType::String)
+            {
+                bytesToSkip += static_cast<gmx_off_t>(sub->nr) * xdrEncodedSize(sub->type);
+                continue;
+            }
+            if (bytesToSkip > 0)
+            {
+                bOK = bOK && skipBytes(ef->fio, bytesToSkip);
+                bytesToSkip = 0;
+            }
+
             if (bRead)
             {
                 enxsubblock_alloc(sub);
@@ -1123,6 +1183,15 @@ gmx_bool do_enx(ener_file_t ef, t_enxframe* fr)
             bOK = bOK && bOK1;
         }
     }
+    if (skipBlockData)
+    {
+        if (bytesToSkip > 0)
+        {
+            bOK = bOK && skipBytes(ef->fio, bytesToSkip);
+        }
+        /* The block headers have been read, but not their contents */
+        fr->nblock = 0;
+    }
 
     if (!bRead)
     {
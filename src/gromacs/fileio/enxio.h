@@ -178,6 +178,13 @@ void free_enxnms(int n, gmx_enxnm_t* nms);
 gmx_bool do_enx(ener_file_t ef, t_enxframe* fr);
 /* Reads enx_frames, memory in fr is (re)allocated if necessary */
 
+/* Sets whether do_enx() skips the block data, e.g. the free-energy
+ * histograms, when reading. With skipping, the frames are returned
+ * without blocks. This avoids reading and decoding data that a tool
+ * does not use.
+ */
+void enx_set_skip_block_data(ener_file_t ef, bool skipBlockData);
+
 void get_enx_state(const std::filesystem::path& fn,
                    real                         t,
                    const SimulationGroups&      groups,
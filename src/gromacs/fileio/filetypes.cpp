@@ -50,6 +50,7 @@ enum
     eftASC,
     eftXDR,
     eftTNG,
+    eftH5MD,
     eftGEN,
     eftNR
 };
@@ -69,6 +70,13 @@ static const int tros[] = { efXTC, efTRR, efGRO, efG96, efPDB, efTNG };
 static const int trns[] = { efTRR, efCPT, efTNG };
 #define NTRNS asize(trns)
 
+/* mdrun can also write H5MD, which the other tools can not read or write */
+static const int mdruntrns[] = { efTRR, efCPT, efTNG, efH5MD };
+#define NMDRUNTRNS asize(mdruntrns)
+
+static const int mdruntrcompressed[] = { efXTC, efTNG, efH5MD };
+#define NMDRUNTRCOMPRESSED asize(mdruntrcompressed)
+
 static const int stos[] = { efGRO, efG96, efPDB, efBRK, efENT, efESP };
 #define NSTOS asize(stos)
 
@@ -146,7 +154,17 @@ static const t_deffile deffile[efNR] = {
     { eftASC, ".xpm", "root", nullptr, "X PixMap compatible matrix file" },
     { eftASC, "", "rundir", nullptr, "Run directory" },
     { eftASC, ".csv", "bench", nullptr, "CSV data file" },
-    { eftASC, ".inp", "topol-qmmm", nullptr, "Input file for QM program" }
+    { eftASC, ".inp", "topol-qmmm", nullptr, "Input file for QM program" },
+    { eftH5MD, ".h5md", "traj", nullptr, "Trajectory file (H5MD format)" },
+    { eftASC, ".json", "perf", nullptr, "Data file in JSON format" },
+    { eftGEN, ".???", "traj", nullptr, "Full precision trajectory", NMDRUNTRNS, mdruntrns },
+    { eftGEN,
+      ".???",
+      "traj_comp",
+      nullptr,
+      "Compressed trajectory",
+      NMDRUNTRCOMPRESSED,
+      mdruntrcompressed }
 };
 
 const char* ftp2ext(int ftp)
@@ -168,7 +186,8 @@ const char* ftp2ext_generic(int ftp)
         switch (ftp)
         {
             case efTRX: return "trx";
-            case efTRN: return "trn";
+            case efTRN:
+            case efMDRUNTRN: return "trn";
             case efSTO: return "sto";
             case efSTX: return "stx";
             case efTPS: return "tps";
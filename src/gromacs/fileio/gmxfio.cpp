@@ -762,8 +762,43 @@ int xtc_seek_time(t_fileio* fio, real time, int natoms, gmx_bool bSeekForwardOnl
     int ret;
 
     gmx_fio_lock(fio);
-    ret = xdr_xtc_seek_time(time, fio->fp, fio->xdr, natoms, bSeekForwardOnly);
+    if (fio->xtcFrameIndex)
+    {
+        const gmx_off_t minimumOffset = bSeekForwardOnly ? gmx_ftell(fio->fp) : 0;
+        const auto      frame = fio->xtcFrameIndex->findFrameForTime(time, minimumOffset);
+        if (minimumOffset < 0 || !frame.has_value()
+            || gmx_fseek(fio->fp, fio->xtcFrameIndex->entries()[*frame].offset, SEEK_SET) != 0)
+        {
+            ret = -1;
+        }
+        else
+        {
+            ret = 0;
+        }
+    }
+    else
+    {
+        ret = xdr_xtc_seek_time(time, fio->fp, fio->xdr, natoms, bSeekForwardOnly);
+    }
+    gmx_fio_unlock(fio);
+
+    return ret;
+}
+
+gmx::XtcFrameIndex* gmx_fio_get_xtc_frame_index(t_fileio* fio)
+{
+    gmx::XtcFrameIndex* ret;
+
+    gmx_fio_lock(fio);
+    ret = fio->xtcFrameIndex.get();
     gmx_fio_unlock(fio);
 
     return ret;
 }
+
+void gmx_fio_set_xtc_frame_index(t_fileio* fio, std::unique_ptr<gmx::XtcFrameIndex> index)
+{
+    gmx_fio_lock(fio);
+    fio->xtcFrameIndex = std::move(index);
+    gmx_fio_unlock(fio);
+}
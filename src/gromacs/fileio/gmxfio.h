@@ -39,6 +39,7 @@
 
 #include <array>
 #include <filesystem>
+#include <memory>
 #include <vector>
 
 #include "gromacs/math/vectypes.h"
@@ -49,6 +50,11 @@
 
 typedef struct t_fileio t_fileio;
 
+namespace gmx
+{
+class XtcFrameIndex;
+} // namespace gmx
+
 /* NOTE ABOUT THREAD SAFETY:
 
    The functions are all thread-safe, provided that two threads don't
@@ -170,6 +176,14 @@ int gmx_fio_get_file_md5(t_fileio* fio, gmx_off_t offset, std::array<unsigned ch
 
 
 int xtc_seek_time(t_fileio* fio, real time, int natoms, gmx_bool bSeekForwardOnly);
+/* Seek to time in an xtc file. Uses the frame index attached to fio
+ * when there is one, and bisects the file otherwise. */
+
+gmx::XtcFrameIndex* gmx_fio_get_xtc_frame_index(t_fileio* fio);
+/* Return the xtc frame index attached to fio, or nullptr if there is none */
+
+void gmx_fio_set_xtc_frame_index(t_fileio* fio, std::unique_ptr<gmx::XtcFrameIndex> index);
+/* Attach an xtc frame index to fio, which takes ownership */
 
 
 #endif
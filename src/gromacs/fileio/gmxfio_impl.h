@@ -52,10 +52,12 @@
    WARNING WARNING WARNING WARNING */
 
 #include <filesystem>
+#include <memory>
 
 #include "thread_mpi/lock.h"
 
 #include "gromacs/fileio/xdrf.h"
+#include "gromacs/fileio/xtcframeindex.h"
 
 struct t_fileio
 {
@@ -67,6 +69,7 @@ struct t_fileio
     XDR*                  xdr;     /* the xdr data pointer */
     enum xdr_op           xdrmode; /* the xdr mode */
     int                   iFTP;    /* the file type identifier */
+    std::unique_ptr<gmx::XtcFrameIndex> xtcFrameIndex; /* xtc frame offsets, or nullptr */
 
     t_fileio *next, *prev; /* next and previous file pointers in the
                               linked list */
@@ -31,7 +31,6 @@
  * To help us fund GROMACS development, we humbly ask that you cite
  * the research papers on the package. Check out https://www.gromacs.org.
  */
-
 /*! \brief I/o interface to H5MD HDF5 files.
  *
  * \author Magnus Lundborg <lundborg.magnus@gmail.com>
@@ -53,11 +52,56 @@ CLANG_DIAGNOSTIC_IGNORE("-Wold-style-cast")
 CLANG_DIAGNOSTIC_IGNORE("-Wmissing-noreturn")
 #endif // GMX_USE_HDF5
 
+//! Whether files can be shared by MPI ranks, which needs a parallel HDF5 library.
+#if GMX_USE_HDF5 && GMX_LIB_MPI && defined(H5_HAVE_PARALLEL)
+#    define GMX_H5MD_PARALLEL 1
+#else
+#    define GMX_H5MD_PARALLEL 0
+#endif
+
 namespace gmx
 {
 H5md::H5md(const std::filesystem::path& fileName, const H5mdFileMode mode)
 {
 #if GMX_USE_HDF5
+    openFile(fileName, mode, H5P_DEFAULT);
+    dataTransferProperties_ = H5P_DEFAULT;
+#else
+    GMX_UNUSED_VALUE(fileName);
+    GMX_UNUSED_VALUE(mode);
+    throw FileIOError("GROMACS was compiled without HDF5 support, cannot handle this file type");
+#endif
+}
+
+H5md::H5md(const std::filesystem::path& fileName, const H5mdFileMode mode, MPI_Comm comm)
+{
+#if GMX_H5MD_PARALLEL
+    hid_t fileAccess = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_mpio(fileAccess, comm, MPI_INFO_NULL);
+    /* All ranks create the same groups and datasets, so metadata can be written collectively. */
+    H5Pset_coll_metadata_write(fileAccess, true);
+    openFile(fileName, mode, fileAccess);
+    H5Pclose(fileAccess);
+
+    dataTransferProperties_ = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_dxpl_mpio(dataTransferProperties_, H5FD_MPIO_COLLECTIVE);
+    isParallel_ = true;
+    MPI_Comm_rank(comm, &rank_);
+#else
+    GMX_UNUSED_VALUE(fileName);
+    GMX_UNUSED_VALUE(mode);
+    GMX_UNUSED_VALUE(comm);
+    throw NotImplementedError(
+            "GROMACS was compiled without parallel HDF5 support, cannot share H5MD files between "
+            "MPI ranks");
+#endif
+}
+
+#if GMX_USE_HDF5
+void H5md::openFile(const std::filesystem::path& fileName,
+                    const H5mdFileMode           mode,
+                    const hid_t                  fileAccess)
+{
     /* Disable automatic HDF5 error output, e.g. when items are not found. Explicit H5EPrint2() will
      * still print error messages. */
     H5Eset_auto2(H5E_DEFAULT, nullptr, nullptr);
@@ -65,11 +109,13 @@ H5md::H5md(const std::filesystem::path& fileName, const H5mdFileMode mode)
     switch (mode)
     {
         case H5mdFileMode::Write:
-            file_ = H5Fcreate(
-                    fileName.string().c_str(), H5F_ACC_TRUNC, H5Pcreate(H5P_FILE_CREATE), H5P_DEFAULT);
+            file_ = H5Fcreate(fileName.string().c_str(),
+                              H5F_ACC_TRUNC,
+                              H5Pcreate(H5P_FILE_CREATE),
+                              fileAccess);
             break;
         case H5mdFileMode::Read:
-            file_ = H5Fopen(fileName.string().c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+            file_ = H5Fopen(fileName.string().c_str(), H5F_ACC_RDONLY, fileAccess);
             break;
         default: throw NotImplementedError("Appending to H5MD is not implemented yet.");
     }
@@ -86,13 +132,8 @@ H5md::H5md(const std::filesystem::path& fileName, const H5mdFileMode mode)
         throw FileIOError("Cannot open H5MD file.");
     }
     filemode_ = mode;
-
-#else
-    GMX_UNUSED_VALUE(fileName);
-    GMX_UNUSED_VALUE(mode);
-    throw FileIOError("GROMACS was compiled without HDF5 support, cannot handle this file type");
-#endif
 }
+#endif
 
 H5md::~H5md()
 {
@@ -101,12 +142,31 @@ H5md::~H5md()
     {
         H5Fclose(file_);
     }
+    if (dataTransferProperties_ != H5P_DEFAULT)
+    {
+        H5Pclose(dataTransferProperties_);
+    }
 
     /* Do not throw, if GMX_USE_HDF5 is false, in the destructor. */
 
 #endif
 }
 
+bool H5md::supportsParallelIO()
+{
+    return GMX_H5MD_PARALLEL != 0;
+}
+
+void H5md::flush()
+{
+#if GMX_USE_HDF5
+    if (H5Fflush(file_, H5F_SCOPE_LOCAL) < 0)
+    {
+        throw FileIOError("Cannot flush H5MD file.");
+    }
+#endif
+}
+
 } // namespace gmx
 
 CLANG_DIAGNOSTIC_RESET
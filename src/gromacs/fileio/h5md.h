@@ -44,6 +44,8 @@
 
 #include <filesystem>
 
+#include "gromacs/utility/gmxmpi.h"
+
 enum class PbcType : int;
 
 namespace gmx
@@ -68,7 +70,13 @@ class H5md
 private:
     hid_t file_;            //!< The HDF5 identifier of the file. This is the H5MD root.
     H5mdFileMode filemode_; //!< Whether the file is open for reading ('r'), writing ('w') or appending ('a')
+    hid_t dataTransferProperties_; //!< The HDF5 property list to use when reading or writing datasets.
+
+    //! Open the file with the HDF5 file access property list \p fileAccess.
+    void openFile(const std::filesystem::path& fileName, H5mdFileMode mode, hid_t fileAccess);
 #endif
+    bool isParallel_ = false; //!< Whether the file is shared by the ranks of a communicator.
+    int  rank_       = 0;     //!< The rank of this process in that communicator.
 
 public:
     /*! \brief Open an H5MD file and manage its filehandle.
@@ -79,8 +87,45 @@ public:
      */
     H5md(const std::filesystem::path& fileName, const H5mdFileMode mode);
 
+    /*! \brief Open an H5MD file shared by all ranks of \p comm.
+     *
+     * This is a collective call. All data is then written collectively, so that each
+     * rank can write its own part of the datasets. Requires HDF5 with parallel I/O support,
+     * see supportsParallelIO().
+     *
+     * \param[in] fileName    Name of the file to open. The same as the file path.
+     * \param[in] mode        The mode to open the file.
+     * \param[in] comm        The communicator of the ranks sharing the file.
+     * \throws FileIOError if the file cannot be opened.
+     * \throws NotImplementedError if HDF5 has no parallel I/O support.
+     */
+    H5md(const std::filesystem::path& fileName, const H5mdFileMode mode, MPI_Comm comm);
+
     ~H5md();
 
+    //! Whether the HDF5 library GROMACS was built with supports parallel I/O with MPI.
+    static bool supportsParallelIO();
+
+    //! Whether the file is shared by the ranks of a communicator.
+    bool isParallel() const { return isParallel_; }
+
+    //! Rank of this process among the ranks sharing the file, 0 for serial files.
+    int rank() const { return rank_; }
+
+#if GMX_USE_HDF5
+    //! The HDF5 identifier of the file, for use by the H5MD writing routines.
+    hid_t fileId() const { return file_; }
+
+    //! The HDF5 property list to pass to H5Dwrite and H5Dread, collective for parallel files.
+    hid_t dataTransferProperties() const { return dataTransferProperties_; }
+#endif
+
+    /*! \brief Write all buffered data to disk.
+     *
+     * \throws FileIOError if flushing fails.
+     */
+    void flush();
+
     H5md(const H5md&) = delete;
     H5md& operator=(const H5md&) = delete;
     H5md(H5md&&)                 = delete;
@@ -0,0 +1,737 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the H5MD trajectory writer.
+ *
+ * \ingroup module_fileio
+ */
+#include "gmxpre.h"
+
+#include "h5mdtrajectorywriter.h"
+
+#include "config.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "gromacs/fileio/h5md.h"
+#include "gromacs/pbcutil/pbc.h"
+#include "gromacs/utility/baseversion.h"
+#include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/stringutil.h"
+
+#if GMX_USE_HDF5
+#    include <hdf5.h>
+CLANG_DIAGNOSTIC_IGNORE("-Wold-style-cast")
+#else
+CLANG_DIAGNOSTIC_IGNORE("-Wmissing-noreturn")
+#endif // GMX_USE_HDF5
+
+namespace gmx
+{
+
+#if GMX_USE_HDF5
+
+namespace
+{
+
+/*! \brief Maximum number of atoms in a chunk of a per-atom dataset
+ *
+ * This gives chunks of less than 1 MB, which fit in the default HDF5 chunk
+ * cache and still compress well.
+ */
+constexpr hsize_t c_maxAtomsPerChunk = 65536;
+//! Number of frames in a chunk of the step and time datasets.
+constexpr hsize_t c_framesPerScalarChunk = 256;
+//! Deflate compression level, higher levels give little gain for coordinates.
+constexpr unsigned int c_deflateLevel = 1;
+
+//! Throw when \p result of an HDF5 call, described by \p what, signals an error.
+template<typename T>
+T checked(T result, const char* what)
+{
+    if (result < 0)
+    {
+        GMX_THROW(FileIOError(formatString("Cannot %s in H5MD file.", what)));
+    }
+    return result;
+}
+
+//! The HDF5 type of real in memory.
+hid_t realMemoryType()
+{
+    return GMX_DOUBLE ? H5T_NATIVE_DOUBLE : H5T_NATIVE_FLOAT;
+}
+
+//! The HDF5 type used to store real values in the file.
+hid_t realFileType()
+{
+    return GMX_DOUBLE ? H5T_IEEE_F64LE : H5T_IEEE_F32LE;
+}
+
+//! How the values of a dataset are compressed.
+struct Compression
+{
+    //! Whether to compress without loss with the shuffle and deflate filters.
+    bool deflate = false;
+    //! Number of decimal digits kept by the scale-offset filter, -1 to store values without loss.
+    int decimalDigits = -1;
+};
+
+//! Whether datasets written to \p file can use HDF5 filter \p filter.
+bool canUseFilter(const H5md& file, H5Z_filter_t filter)
+{
+    if (H5Zfilter_avail(filter) <= 0)
+    {
+        return false;
+    }
+    /* Parallel writes to filtered datasets are only supported from HDF5 1.10.2 */
+    return !file.isParallel() || H5_VERSION_GE(1, 10, 2);
+}
+
+//! Create group \p name in \p parent.
+hid_t createGroup(hid_t parent, const char* name)
+{
+    return checked(H5Gcreate2(parent, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), "create group");
+}
+
+//! Write attribute \p name with integer \p values to \p object, scalar when there is one value.
+void writeIntAttribute(hid_t object, const char* name, ArrayRef<const int> values)
+{
+    const hsize_t size  = values.size();
+    hid_t         space = (size == 1) ? H5Screate(H5S_SCALAR) : H5Screate_simple(1, &size, nullptr);
+    hid_t attribute =
+            checked(H5Acreate2(object, name, H5T_STD_I32LE, space, H5P_DEFAULT, H5P_DEFAULT),
+                    "create attribute");
+    checked(H5Awrite(attribute, H5T_NATIVE_INT, values.data()), "write attribute");
+    H5Aclose(attribute);
+    H5Sclose(space);
+}
+
+/*! \brief Write attribute \p name with string \p values to \p object
+ *
+ * A single value is written as a scalar, several values as an array of
+ * fixed-length strings.
+ */
+void writeStringAttribute(hid_t object, const char* name, ArrayRef<const std::string> values)
+{
+    size_t maxLength = 0;
+    for (const auto& value : values)
+    {
+        maxLength = std::max(maxLength, value.size());
+    }
+    const size_t      stringSize = maxLength + 1;
+    std::vector<char> buffer(values.size() * stringSize, '\0');
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        values[i].copy(buffer.data() + i * stringSize, values[i].size());
+    }
+
+    hid_t type = H5Tcopy(H5T_C_S1);
+    H5Tset_size(type, stringSize);
+    H5Tset_strpad(type, H5T_STR_NULLTERM);
+    const hsize_t size  = values.size();
+    hid_t         space = (size == 1) ? H5Screate(H5S_SCALAR) : H5Screate_simple(1, &size, nullptr);
+    hid_t attribute     = checked(H5Acreate2(object, name, type, space, H5P_DEFAULT, H5P_DEFAULT),
+                              "create attribute");
+    checked(H5Awrite(attribute, type, buffer.data()), "write attribute");
+    H5Aclose(attribute);
+    H5Sclose(space);
+    H5Tclose(type);
+}
+
+/*! \brief Create a dataset in \p parent that can be extended along its first dimension.
+ *
+ * \param[in] parent          Group to create the dataset in.
+ * \param[in] name            Name of the dataset.
+ * \param[in] fileType        HDF5 type of the stored values.
+ * \param[in] frameDims       Dimensions of a single frame.
+ * \param[in] framesPerChunk  Number of frames in a chunk.
+ * \param[in] frameChunkDims  Dimensions of the part of a frame in a chunk.
+ * \param[in] compression     How to compress the data.
+ */
+hid_t createExtendibleDataset(hid_t                   parent,
+                              const char*             name,
+                              hid_t                   fileType,
+                              ArrayRef<const hsize_t> frameDims,
+                              hsize_t                 framesPerChunk,
+                              ArrayRef<const hsize_t> frameChunkDims,
+                              const Compression&      compression)
+{
+    std::vector<hsize_t> dims    = { 0 };
+    std::vector<hsize_t> maxDims = { H5S_UNLIMITED };
+    std::vector<hsize_t> chunk   = { framesPerChunk };
+    dims.insert(dims.end(), frameDims.begin(), frameDims.end());
+    maxDims.insert(maxDims.end(), frameDims.begin(), frameDims.end());
+    chunk.insert(chunk.end(), frameChunkDims.begin(), frameChunkDims.end());
+
+    hid_t space      = H5Screate_simple(dims.size(), dims.data(), maxDims.data());
+    hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+    checked(H5Pset_chunk(properties, chunk.size(), chunk.data()), "set chunk size");
+    if (compression.decimalDigits >= 0)
+    {
+        H5Pset_scaleoffset(properties, H5Z_SO_FLOAT_DSCALE, compression.decimalDigits);
+    }
+    else if (compression.deflate)
+    {
+        /* Shuffling bytes does not help after the bits have been packed by scale-offset */
+        H5Pset_shuffle(properties);
+    }
+    if (compression.deflate)
+    {
+        H5Pset_deflate(properties, c_deflateLevel);
+    }
+    hid_t dataset = checked(
+            H5Dcreate2(parent, name, fileType, space, H5P_DEFAULT, properties, H5P_DEFAULT),
+            "create dataset");
+    H5Pclose(properties);
+    H5Sclose(space);
+    return dataset;
+}
+
+/*! \internal \brief
+ * A time-dependent H5MD element with step, time and value datasets.
+ */
+class TimeSeries
+{
+public:
+    /*! \brief Create the element \p name in \p parent.
+     *
+     * \param[in] parent          Group to create the element in.
+     * \param[in] name            Name of the element.
+     * \param[in] frameDims       Dimensions of a single frame of the values.
+     * \param[in] frameChunkDims  Dimensions of the part of a frame in a chunk.
+     * \param[in] unit            Unit of the values.
+     * \param[in] compression     How to compress the values.
+     */
+    TimeSeries(hid_t                   parent,
+               const char*             name,
+               ArrayRef<const hsize_t> frameDims,
+               ArrayRef<const hsize_t> frameChunkDims,
+               const char*             unit,
+               const Compression&      compression) :
+        frameDims_(frameDims.begin(), frameDims.end())
+    {
+        group_ = createGroup(parent, name);
+        step_ = createExtendibleDataset(
+                group_, "step", H5T_STD_I64LE, {}, c_framesPerScalarChunk, {}, Compression());
+        time_ = createExtendibleDataset(
+                group_, "time", H5T_IEEE_F64LE, {}, c_framesPerScalarChunk, {}, Compression());
+        value_ = createExtendibleDataset(
+                group_, "value", realFileType(), frameDims, 1, frameChunkDims, compression);
+        const std::array<std::string, 1> timeUnit  = { "ps" };
+        const std::array<std::string, 1> valueUnit = { unit };
+        writeStringAttribute(time_, "unit", timeUnit);
+        writeStringAttribute(value_, "unit", valueUnit);
+    }
+    ~TimeSeries()
+    {
+        H5Dclose(value_);
+        H5Dclose(time_);
+        H5Dclose(step_);
+        H5Gclose(group_);
+    }
+    GMX_DISALLOW_COPY_MOVE_AND_ASSIGN(TimeSeries);
+
+    /*! \brief Extend the datasets by a frame and write its step and time.
+     *
+     * Collective for shared files, only ranks with \p writeStepAndTime write.
+     */
+    void appendFrame(int64_t step, double time, bool writeStepAndTime, hid_t transferProperties)
+    {
+        numFrames_++;
+        checked(H5Dset_extent(step_, &numFrames_), "extend dataset");
+        checked(H5Dset_extent(time_, &numFrames_), "extend dataset");
+        std::vector<hsize_t> valueDims = { numFrames_ };
+        valueDims.insert(valueDims.end(), frameDims_.begin(), frameDims_.end());
+        checked(H5Dset_extent(value_, valueDims.data()), "extend dataset");
+
+        writeScalar(step_, H5T_NATIVE_INT64, &step, writeStepAndTime, transferProperties);
+        writeScalar(time_, H5T_NATIVE_DOUBLE, &time, writeStepAndTime, transferProperties);
+    }
+
+    //! The value dataset.
+    hid_t value() const { return value_; }
+    //! Index of the last frame appended.
+    hsize_t lastFrame() const { return numFrames_ - 1; }
+
+private:
+    //! Write \p value to the last frame of \p dataset when \p doWrite, otherwise write no data.
+    void writeScalar(hid_t       dataset,
+                     hid_t       memoryType,
+                     const void* value,
+                     bool        doWrite,
+                     hid_t       transferProperties) const
+    {
+        const hsize_t one         = 1;
+        const hsize_t frame       = lastFrame();
+        hid_t         fileSpace   = H5Dget_space(dataset);
+        hid_t         memorySpace = H5Screate_simple(1, &one, nullptr);
+        if (doWrite)
+        {
+            H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, &frame, nullptr, &one, nullptr);
+        }
+        else
+        {
+            H5Sselect_none(fileSpace);
+            H5Sselect_none(memorySpace);
+        }
+        checked(H5Dwrite(dataset, memoryType, memorySpace, fileSpace, transferProperties, value),
+                "write dataset");
+        H5Sclose(memorySpace);
+        H5Sclose(fileSpace);
+    }
+
+    //! Dimensions of a single frame of the values.
+    std::vector<hsize_t> frameDims_;
+    //! Number of frames in the datasets.
+    hsize_t numFrames_ = 0;
+    //! The group of the element.
+    hid_t group_;
+    //! The step dataset.
+    hid_t step_;
+    //! The time dataset.
+    hid_t time_;
+    //! The value dataset.
+    hid_t value_;
+};
+
+} // namespace
+
+/*! \internal \brief
+ * Private implementation class for H5mdTrajectoryWriter.
+ */
+class H5mdTrajectoryWriter::Impl
+{
+public:
+    Impl(H5md*                    file,
+         int                      numAtoms,
+         PbcType                  pbcType,
+         const std::string&       author,
+         const H5mdWriterOptions& options);
+    ~Impl();
+
+    /*! \brief Write a frame, see H5mdTrajectoryWriter::writeLocalFrame()
+     *
+     * With \p allAtoms, the vectors hold all atoms in global order and
+     * \p globalAtomIndices is not used.
+     */
+    void write(int64_t             step,
+               double              time,
+               const matrix        box,
+               bool                allAtoms,
+               ArrayRef<const int> globalAtomIndices,
+               const rvec*         x,
+               const rvec*         v,
+               const rvec*         f);
+
+private:
+    //! Create a per-atom element \p name, with unit \p unit.
+    std::unique_ptr<TimeSeries> createParticleElement(const char*        name,
+                                                      const char*        unit,
+                                                      const Compression& compression) const;
+    //! Set up the file indices and sources of the atoms written in the next frame.
+    void selectAtoms(bool allAtoms, ArrayRef<const int> globalAtomIndices);
+    //! Write the selected atoms from \p values to the last frame of \p element.
+    void writeParticleValues(const TimeSeries& element, const rvec* values);
+
+    //! The H5MD file.
+    H5md* file_;
+    //! The number of atoms in the files.
+    int numWrittenAtoms_;
+    //! Index in the file of each global atom, -1 when not written, empty when all are written.
+    std::vector<int> fileIndex_;
+    //! Compression of the positions.
+    Compression positionCompression_;
+    //! Compression of the other per-atom data.
+    Compression compression_;
+    //! The particles/system group.
+    hid_t system_;
+    //! The particles/system/box group.
+    hid_t boxGroup_;
+    //! Box edges, created on the first frame.
+    std::unique_ptr<TimeSeries> edges_;
+    //! Positions, created when first written.
+    std::unique_ptr<TimeSeries> position_;
+    //! Velocities, created when first written.
+    std::unique_ptr<TimeSeries> velocity_;
+    //! Forces, created when first written.
+    std::unique_ptr<TimeSeries> force_;
+
+    //! Whether the atoms of the current frame are all atoms in file order.
+    bool writeAllInOrder_ = false;
+    //! File indices of the atoms of the current frame, when not all in order.
+    std::vector<int> selectedFileIndices_;
+    //! Whether the values of the selected atoms need to be gathered from the input.
+    bool gatherValues_ = false;
+    //! Index in the input vectors of each selected atom, when gathering.
+    std::vector<int> selectedSources_;
+    //! Buffer for gathered values.
+    std::vector<RVec> gatheredValues_;
+    //! Buffer for the file coordinates of the selected atoms.
+    std::vector<hsize_t> elementCoordinates_;
+};
+
+H5mdTrajectoryWriter::Impl::Impl(H5md*                    file,
+                                 int                      numAtoms,
+                                 PbcType                  pbcType,
+                                 const std::string&       author,
+                                 const H5mdWriterOptions& options) :
+    file_(file),
+    numWrittenAtoms_(options.selection.empty() ? numAtoms : gmx::ssize(options.selection))
+{
+    if (!options.selection.empty())
+    {
+        fileIndex_.assign(numAtoms, -1);
+        for (size_t i = 0; i < options.selection.size(); i++)
+        {
+            fileIndex_[options.selection[i]] = i;
+        }
+    }
+    compression_.deflate = canUseFilter(*file_, H5Z_FILTER_DEFLATE)
+                           && canUseFilter(*file_, H5Z_FILTER_SHUFFLE);
+    positionCompression_ = compression_;
+    if (options.positionPrecision > 0 && canUseFilter(*file_, H5Z_FILTER_SCALEOFFSET))
+    {
+        /* Keep at least the requested precision, as the filter works with decimal digits */
+        const double digits = std::ceil(std::log10(options.positionPrecision) - 1e-6);
+        positionCompression_.decimalDigits = std::max(0, static_cast<int>(digits));
+    }
+
+    const hid_t fileId = file_->fileId();
+
+    const std::array<int, 2>         version        = { 1, 1 };
+    const std::array<std::string, 1> authorName     = { author };
+    const std::array<std::string, 1> creatorName    = { "GROMACS" };
+    const std::array<std::string, 1> creatorVersion = { gmx_version() };
+    hid_t                            h5md           = createGroup(fileId, "h5md");
+    writeIntAttribute(h5md, "version", version);
+    hid_t authorGroup = createGroup(h5md, "author");
+    writeStringAttribute(authorGroup, "name", authorName);
+    H5Gclose(authorGroup);
+    hid_t creatorGroup = createGroup(h5md, "creator");
+    writeStringAttribute(creatorGroup, "name", creatorName);
+    writeStringAttribute(creatorGroup, "version", creatorVersion);
+    H5Gclose(creatorGroup);
+    H5Gclose(h5md);
+
+    hid_t particles = createGroup(fileId, "particles");
+    system_         = createGroup(particles, "system");
+    H5Gclose(particles);
+
+    const int                    numPeriodicDimensions = numPbcDimensions(pbcType);
+    const std::array<int, 1>     dimension             = { DIM };
+    std::array<std::string, DIM> boundary;
+    for (int d = 0; d < DIM; d++)
+    {
+        boundary[d] = (d < numPeriodicDimensions) ? "periodic" : "none";
+    }
+    boxGroup_ = createGroup(system_, "box");
+    writeIntAttribute(boxGroup_, "dimension", dimension);
+    writeStringAttribute(boxGroup_, "boundary", boundary);
+}
+
+H5mdTrajectoryWriter::Impl::~Impl()
+{
+    // The elements need to be closed before the groups they are in
+    edges_.reset();
+    position_.reset();
+    velocity_.reset();
+    force_.reset();
+    H5Gclose(boxGroup_);
+    H5Gclose(system_);
+}
+
+std::unique_ptr<TimeSeries>
+H5mdTrajectoryWriter::Impl::createParticleElement(const char*        name,
+                                                  const char*        unit,
+                                                  const Compression& compression) const
+{
+    const hsize_t numAtoms      = numWrittenAtoms_;
+    const hsize_t atomsPerChunk = std::clamp(numAtoms, hsize_t(1), c_maxAtomsPerChunk);
+    const std::array<hsize_t, 2> frameDims      = { numAtoms, DIM };
+    const std::array<hsize_t, 2> frameChunkDims = { atomsPerChunk, DIM };
+    return std::make_unique<TimeSeries>(
+            system_, name, frameDims, frameChunkDims, unit, compression);
+}
+
+void H5mdTrajectoryWriter::Impl::selectAtoms(bool allAtoms, ArrayRef<const int> globalAtomIndices)
+{
+    const bool writeAll = fileIndex_.empty();
+
+    writeAllInOrder_ = allAtoms;
+    gatherValues_    = !writeAll;
+    selectedSources_.clear();
+    selectedFileIndices_.clear();
+    if (allAtoms && !writeAll)
+    {
+        /* The selected atoms are gathered in file order from the global vectors */
+        for (size_t globalIndex = 0; globalIndex < fileIndex_.size(); globalIndex++)
+        {
+            if (fileIndex_[globalIndex] >= 0)
+            {
+                selectedSources_.push_back(globalIndex);
+            }
+        }
+    }
+    else if (!allAtoms)
+    {
+        for (size_t i = 0; i < globalAtomIndices.size(); i++)
+        {
+            const int globalIndex = globalAtomIndices[i];
+            GMX_ASSERT(globalIndex >= 0
+                               && (writeAll ? globalIndex < numWrittenAtoms_
+                                            : globalIndex < gmx::ssize(fileIndex_)),
+                       "Global atom indices should be valid");
+            const int fileIndex = writeAll ? globalIndex : fileIndex_[globalIndex];
+            if (fileIndex >= 0)
+            {
+                selectedFileIndices_.push_back(fileIndex);
+                if (!writeAll)
+                {
+                    selectedSources_.push_back(i);
+                }
+            }
+        }
+    }
+}
+
+void H5mdTrajectoryWriter::Impl::writeParticleValues(const TimeSeries& element, const rvec* values)
+{
+    if (gatherValues_)
+    {
+        gatheredValues_.resize(selectedSources_.size());
+        for (size_t i = 0; i < selectedSources_.size(); i++)
+        {
+            gatheredValues_[i] = values[selectedSources_[i]];
+        }
+        values = as_rvec_array(gatheredValues_.data());
+    }
+
+    const hsize_t frame       = element.lastFrame();
+    const hsize_t numSelected = writeAllInOrder_ ? numWrittenAtoms_ : selectedFileIndices_.size();
+    const hsize_t numElements = std::max(numSelected * DIM, hsize_t(1));
+    hid_t         fileSpace   = H5Dget_space(element.value());
+    hid_t         memorySpace = H5Screate_simple(1, &numElements, nullptr);
+    if (numSelected == 0)
+    {
+        H5Sselect_none(fileSpace);
+        H5Sselect_none(memorySpace);
+    }
+    else if (writeAllInOrder_)
+    {
+        const std::array<hsize_t, 3> start = { frame, 0, 0 };
+        const std::array<hsize_t, 3> count = { 1, numSelected, DIM };
+        H5Sselect_hyperslab(
+                fileSpace, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr);
+    }
+    else
+    {
+        /* The atoms of a rank are scattered over the file, so we select
+         * the elements of each atom in the order they are stored in memory. */
+        elementCoordinates_.resize(numSelected * DIM * 3);
+        hsize_t* coordinates = elementCoordinates_.data();
+        for (const int fileIndex : selectedFileIndices_)
+        {
+            for (int d = 0; d < DIM; d++)
+            {
+                *coordinates++ = frame;
+                *coordinates++ = fileIndex;
+                *coordinates++ = d;
+            }
+        }
+        checked(H5Sselect_elements(
+                        fileSpace, H5S_SELECT_SET, numSelected * DIM, elementCoordinates_.data()),
+                "select atoms");
+    }
+    checked(H5Dwrite(element.value(),
+                     realMemoryType(),
+                     memorySpace,
+                     fileSpace,
+                     file_->dataTransferProperties(),
+                     values),
+            "write dataset");
+    H5Sclose(memorySpace);
+    H5Sclose(fileSpace);
+}
+
+void H5mdTrajectoryWriter::Impl::write(int64_t             step,
+                                       double              time,
+                                       const matrix        box,
+                                       bool                allAtoms,
+                                       ArrayRef<const int> globalAtomIndices,
+                                       const rvec*         x,
+                                       const rvec*         v,
+                                       const rvec*         f)
+{
+    GMX_RELEASE_ASSERT(!allAtoms || !file_->isParallel(),
+                       "Frames with all atoms can only be written to files that are not shared");
+
+    const hid_t transferProperties = file_->dataTransferProperties();
+    const bool  writesSharedData   = (file_->rank() == 0);
+
+    if (!edges_)
+    {
+        const std::array<hsize_t, 2> boxDims = { DIM, DIM };
+        edges_ = std::make_unique<TimeSeries>(
+                boxGroup_, "edges", boxDims, boxDims, "nm", Compression());
+    }
+    edges_->appendFrame(step, time, writesSharedData, transferProperties);
+    {
+        const std::array<hsize_t, 3> start       = { edges_->lastFrame(), 0, 0 };
+        const std::array<hsize_t, 3> count       = { 1, DIM, DIM };
+        const hsize_t                numElements = DIM * DIM;
+        hid_t                        fileSpace   = H5Dget_space(edges_->value());
+        hid_t                        memorySpace = H5Screate_simple(1, &numElements, nullptr);
+        if (writesSharedData)
+        {
+            H5Sselect_hyperslab(
+                    fileSpace, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr);
+        }
+        else
+        {
+            H5Sselect_none(fileSpace);
+            H5Sselect_none(memorySpace);
+        }
+        checked(H5Dwrite(edges_->value(),
+                         realMemoryType(),
+                         memorySpace,
+                         fileSpace,
+                         transferProperties,
+                         box),
+                "write dataset");
+        H5Sclose(memorySpace);
+        H5Sclose(fileSpace);
+    }
+
+    selectAtoms(allAtoms, globalAtomIndices);
+    const auto writeQuantity = [&](std::unique_ptr<TimeSeries>* element,
+                                   const char*                  name,
+                                   const char*                  unit,
+                                   const Compression&           compression,
+                                   const rvec*                  values)
+    {
+        if (values == nullptr)
+        {
+            return;
+        }
+        if (!*element)
+        {
+            *element = createParticleElement(name, unit, compression);
+        }
+        (*element)->appendFrame(step, time, writesSharedData, transferProperties);
+        writeParticleValues(**element, values);
+    };
+    writeQuantity(&position_, "position", "nm", positionCompression_, x);
+    writeQuantity(&velocity_, "velocity", "nm ps-1", compression_, v);
+    writeQuantity(&force_, "force", "kJ mol-1 nm-1", compression_, f);
+}
+
+#else
+
+//! Empty implementation, as writers cannot be created without HDF5.
+class H5mdTrajectoryWriter::Impl
+{
+};
+
+#endif // GMX_USE_HDF5
+
+H5mdTrajectoryWriter::H5mdTrajectoryWriter(H5md*                    file,
+                                           int                      numAtoms,
+                                           PbcType                  pbcType,
+                                           const std::string&       author,
+                                           const H5mdWriterOptions& options)
+{
+#if GMX_USE_HDF5
+    impl_ = std::make_unique<Impl>(file, numAtoms, pbcType, author, options);
+#else
+    GMX_UNUSED_VALUE(file);
+    GMX_UNUSED_VALUE(numAtoms);
+    GMX_UNUSED_VALUE(pbcType);
+    GMX_UNUSED_VALUE(author);
+    GMX_UNUSED_VALUE(options);
+    GMX_THROW(FileIOError("GROMACS was compiled without HDF5 support, cannot write H5MD files"));
+#endif
+}
+
+H5mdTrajectoryWriter::~H5mdTrajectoryWriter() = default;
+
+void H5mdTrajectoryWriter::writeFrame(int64_t      step,
+                                      double       time,
+                                      const matrix box,
+                                      const rvec*  x,
+                                      const rvec*  v,
+                                      const rvec*  f)
+{
+#if GMX_USE_HDF5
+    impl_->write(step, time, box, true, {}, x, v, f);
+#else
+    GMX_UNUSED_VALUE(step);
+    GMX_UNUSED_VALUE(time);
+    GMX_UNUSED_VALUE(box);
+    GMX_UNUSED_VALUE(x);
+    GMX_UNUSED_VALUE(v);
+    GMX_UNUSED_VALUE(f);
+#endif
+}
+
+void H5mdTrajectoryWriter::writeLocalFrame(int64_t             step,
+                                           double              time,
+                                           const matrix        box,
+                                           ArrayRef<const int> globalAtomIndices,
+                                           const rvec*         x,
+                                           const rvec*         v,
+                                           const rvec*         f)
+{
+#if GMX_USE_HDF5
+    impl_->write(step, time, box, false, globalAtomIndices, x, v, f);
+#else
+    GMX_UNUSED_VALUE(step);
+    GMX_UNUSED_VALUE(time);
+    GMX_UNUSED_VALUE(box);
+    GMX_UNUSED_VALUE(globalAtomIndices);
+    GMX_UNUSED_VALUE(x);
+    GMX_UNUSED_VALUE(v);
+    GMX_UNUSED_VALUE(f);
+#endif
+}
+
+} // namespace gmx
+
+CLANG_DIAGNOSTIC_RESET
@@ -0,0 +1,164 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \libinternal \file
+ * \brief
+ * Declares a writer of simulation trajectories to H5MD files.
+ *
+ * \inlibraryapi
+ * \ingroup module_fileio
+ */
+#ifndef GMX_FILEIO_H5MDTRAJECTORYWRITER_H
+#define GMX_FILEIO_H5MDTRAJECTORYWRITER_H
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/classhelpers.h"
+#include "gromacs/utility/real.h"
+
+enum class PbcType : int;
+
+namespace gmx
+{
+
+class H5md;
+
+/*! \libinternal \brief
+ * Settings for the data written by H5mdTrajectoryWriter.
+ */
+struct H5mdWriterOptions
+{
+    /*! \brief Global indices of the atoms to write, in increasing order
+     *
+     * When empty, all atoms are written.
+     */
+    std::vector<int> selection;
+    /*! \brief Precision to store positions with, as for XTC
+     *
+     * Positions are then rounded to multiples of 1/positionPrecision
+     * with the HDF5 scale-offset filter. With 0 they are stored without loss.
+     */
+    real positionPrecision = 0;
+};
+
+/*! \libinternal \brief
+ * Writes positions, velocities, forces and the box of a system to an H5MD file.
+ *
+ * The data is stored in the particles/system group of the file, following
+ * the H5MD specification, with time-dependent elements for each quantity
+ * that hold step, time and value datasets. The value datasets are chunked
+ * so they can be extended by one frame at a time, and compressed with the
+ * HDF5 deflate filter when it is available.
+ *
+ * When the file is shared by several ranks, all ranks call the write
+ * functions collectively. Each rank passes the data of its own atoms with
+ * their global indices, so the frame does not need to be gathered on a
+ * single rank first.
+ */
+class H5mdTrajectoryWriter
+{
+public:
+    /*! \brief Set up the H5MD structure for a system in \p file.
+     *
+     * Collective when \p file is shared by several ranks.
+     *
+     * \param[in] file      The open H5MD file, should outlive the writer.
+     * \param[in] numAtoms  The total number of atoms in the system.
+     * \param[in] pbcType   The periodic boundary conditions of the system.
+     * \param[in] author    Name to store as the author of the file.
+     * \param[in] options   Which atoms to write and how.
+     * \throws FileIOError when the H5MD structure cannot be created.
+     */
+    H5mdTrajectoryWriter(H5md*                    file,
+                         int                      numAtoms,
+                         PbcType                  pbcType,
+                         const std::string&       author,
+                         const H5mdWriterOptions& options = {});
+    ~H5mdTrajectoryWriter();
+    GMX_DISALLOW_COPY_MOVE_AND_ASSIGN(H5mdTrajectoryWriter);
+
+    /*! \brief Write a frame with the data of all atoms, in global order.
+     *
+     * Each of \p x, \p v and \p f can be nullptr when that quantity is
+     * not written for this frame. Can only be used with files that are not
+     * shared by several ranks.
+     *
+     * \throws FileIOError when writing fails.
+     */
+    void writeFrame(int64_t      step,
+                    double       time,
+                    const matrix box,
+                    const rvec*  x,
+                    const rvec*  v,
+                    const rvec*  f);
+
+    /*! \brief Write the part of a frame held by this rank.
+     *
+     * Collective: all ranks sharing the file must call this with the same
+     * \p step, \p time and box and the same choice of present quantities.
+     * The box, step and time are written by rank 0. Atoms that are not
+     * in the selection of the writer are skipped, so the cost only
+     * depends on the number of local atoms.
+     *
+     * \param[in] step               The MD step.
+     * \param[in] time               The simulation time.
+     * \param[in] box                The simulation box.
+     * \param[in] globalAtomIndices  The global indices of the local atoms.
+     * \param[in] x                  Positions of the local atoms, or nullptr.
+     * \param[in] v                  Velocities of the local atoms, or nullptr.
+     * \param[in] f                  Forces on the local atoms, or nullptr.
+     * \throws FileIOError when writing fails.
+     */
+    void writeLocalFrame(int64_t             step,
+                         double              time,
+                         const matrix        box,
+                         ArrayRef<const int> globalAtomIndices,
+                         const rvec*         x,
+                         const rvec*         v,
+                         const rvec*         f);
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace gmx
+
+#endif
@@ -44,6 +44,7 @@
 
 #include "gromacs/fileio/xdr_datatype.h"
 #include "gromacs/fileio/xdrf.h"
+#include "gromacs/simd/simd.h"
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/enumerationhelpers.h"
 #include "gromacs/utility/futil.h"
@@ -80,6 +81,62 @@ const float maxAbsoluteInt = std::nextafterf(float(INT_MAX), 0.F); // NOLINT(cer
 #ifndef SQR
 #    define SQR(x) ((x) * (x))
 #endif
+
+bool xtc_quantize_coordinates(const float* fp, std::size_t n, float precision, int* ip)
+{
+    std::size_t i      = 0;
+    bool        bRange = true;
+
+#if GMX_SIMD_HAVE_FLOAT && GMX_SIMD_HAVE_LOADU && GMX_SIMD_HAVE_STOREU
+    /* Note that we add 0.5 after rounding the product to float, exactly
+     * as the scalar code below does, so the output is bit-identical.
+     */
+    const gmx::SimdFloat simdPrecision(precision);
+    const gmx::SimdFloat half(0.5F);
+    const gmx::SimdFloat minusHalf(-0.5F);
+    const gmx::SimdFloat zero(0.0F);
+    const gmx::SimdFloat maxInt(maxAbsoluteInt);
+    gmx::SimdFBool       outOfRange = (maxInt < zero);
+    for (; i + GMX_SIMD_FLOAT_WIDTH <= n; i += GMX_SIMD_FLOAT_WIDTH)
+    {
+        const gmx::SimdFloat x       = gmx::loadU<gmx::SimdFloat>(fp + i);
+        const gmx::SimdFloat product = x * simdPrecision;
+        const gmx::SimdFloat lf      = product + gmx::blend(minusHalf, half, zero <= x);
+        outOfRange                   = outOfRange || (maxInt < gmx::abs(lf));
+        gmx::storeU(ip + i, gmx::cvttR2I(lf));
+    }
+    bRange = !gmx::anyTrue(outOfRange);
+#endif
+    for (; i < n; i++)
+    {
+        /* find nearest integer */
+        const float lf = (fp[i] >= 0.0) ? fp[i] * precision + 0.5 : fp[i] * precision - 0.5;
+        if (std::fabs(lf) > maxAbsoluteInt)
+        {
+            /* scaling would cause overflow */
+            bRange = false;
+        }
+        ip[i] = static_cast<int>(lf);
+    }
+    return bRange;
+}
+
+void xtc_dequantize_coordinates(const int* ip, std::size_t n, float inv_precision, float* fp)
+{
+    std::size_t i = 0;
+#if GMX_SIMD_HAVE_FLOAT && GMX_SIMD_HAVE_LOADU && GMX_SIMD_HAVE_STOREU
+    const gmx::SimdFloat simdInvPrecision(inv_precision);
+    for (; i + GMX_SIMD_FLOAT_WIDTH <= n; i += GMX_SIMD_FLOAT_WIDTH)
+    {
+        gmx::storeU(fp + i, gmx::cvtI2R(gmx::loadU<gmx::SimdFInt32>(ip + i)) * simdInvPrecision);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        fp[i] = ip[i] * inv_precision;
+    }
+}
+
 static const int magicints[] = {
     0,        0,        0,       0,       0,       0,       0,       0,       0,       8,
     10,       12,       16,      20,      25,      32,      40,      50,      64,      80,
@@ -430,7 +487,6 @@ int xdr3dfcoord(XDR* xdrs, float* fp, int* size, float* precision, int magic_num
     unsigned     sizeint[3], sizesmall[3], bitsizeint[3], *luip;
     int          flag, k;
     int          smallnum, smaller, larger, i, is_small, is_smaller, run, prevrun;
-    float *      lfp, lf;
     int          tmp, *thiscoord, prevcoord[3];
     unsigned int tmpcoord[30];
 
@@ -527,87 +583,25 @@ int xdr3dfcoord(XDR* xdrs, float* fp, int* size, float* precision, int magic_num
         minint[0] = minint[1] = minint[2] = INT_MAX;
         maxint[0] = maxint[1] = maxint[2] = INT_MIN;
         prevrun                           = -1;
-        lfp                               = fp;
-        lip                               = ip;
         mindiff                           = INT_MAX;
         oldlint1 = oldlint2 = oldlint3 = 0;
-        while (lfp < fp + size3)
+        if (!xtc_quantize_coordinates(fp, size3, *precision, ip))
         {
-            /* find nearest integer */
-            if (*lfp >= 0.0)
-            {
-                lf = *lfp * *precision + 0.5;
-            }
-            else
-            {
-                lf = *lfp * *precision - 0.5;
-            }
-            if (std::fabs(lf) > maxAbsoluteInt)
-            {
-                /* scaling would cause overflow */
-                errval = 0;
-            }
-            lint1 = static_cast<int>(lf);
-            if (lint1 < minint[0])
-            {
-                minint[0] = lint1;
-            }
-            if (lint1 > maxint[0])
-            {
-                maxint[0] = lint1;
-            }
-            *lip++ = lint1;
-            lfp++;
-            if (*lfp >= 0.0)
-            {
-                lf = *lfp * *precision + 0.5;
-            }
-            else
-            {
-                lf = *lfp * *precision - 0.5;
-            }
-            if (std::fabs(lf) > maxAbsoluteInt)
-            {
-                /* scaling would cause overflow */
-                errval = 0;
-            }
-            lint2 = static_cast<int>(lf);
-            if (lint2 < minint[1])
-            {
-                minint[1] = lint2;
-            }
-            if (lint2 > maxint[1])
-            {
-                maxint[1] = lint2;
-            }
-            *lip++ = lint2;
-            lfp++;
-            if (*lfp >= 0.0)
-            {
-                lf = *lfp * *precision + 0.5;
-            }
-            else
-            {
-                lf = *lfp * *precision - 0.5;
-            }
-            if (std::abs(lf) > maxAbsoluteInt)
-            {
-                /* scaling would cause overflow */
-                errval = 0;
-            }
-            lint3 = static_cast<int>(lf);
-            if (lint3 < minint[2])
-            {
-                minint[2] = lint3;
-            }
-            if (lint3 > maxint[2])
-            {
-                maxint[2] = lint3;
-            }
-            *lip++ = lint3;
-            lfp++;
+            errval = 0;
+        }
+        for (lip = ip; lip < ip + size3; lip += 3)
+        {
+            lint1     = lip[0];
+            lint2     = lip[1];
+            lint3     = lip[2];
+            minint[0] = std::min(minint[0], lint1);
+            minint[1] = std::min(minint[1], lint2);
+            minint[2] = std::min(minint[2], lint3);
+            maxint[0] = std::max(maxint[0], lint1);
+            maxint[1] = std::max(maxint[1], lint2);
+            maxint[2] = std::max(maxint[2], lint3);
             diff = std::abs(oldlint1 - lint1) + std::abs(oldlint2 - lint2) + std::abs(oldlint3 - lint3);
-            if (diff < mindiff && lfp > fp + 3)
+            if (diff < mindiff && lip > ip)
             {
                 mindiff = diff;
             }
@@ -1001,7 +995,6 @@ int xdr3dfcoord(XDR* xdrs, float* fp, int* size, float* precision, int magic_num
         buffer.lastbits = 0;
         buffer.lastbyte = 0;
 
-        lfp           = fp;
         inv_precision = 1.0 / *precision;
         run           = 0;
         i             = 0;
@@ -1043,7 +1036,7 @@ int xdr3dfcoord(XDR* xdrs, float* fp, int* size, float* precision, int magic_num
             if (run > 0)
             {
                 thiscoord += 3;
-                for (k = 0; k < run; k += 3)
+                for (k = 0; k < run && i < lsize; k += 3)
                 {
                     receiveints(&buffer, 3, smallidx, sizesmall, thiscoord);
                     i++;
@@ -1064,9 +1057,11 @@ int xdr3dfcoord(XDR* xdrs, float* fp, int* size, float* precision, int magic_num
                         tmp          = thiscoord[2];
                         thiscoord[2] = prevcoord[2];
                         prevcoord[2] = tmp;
-                        *lfp++       = prevcoord[0] * inv_precision;
-                        *lfp++       = prevcoord[1] * inv_precision;
-                        *lfp++       = prevcoord[2] * inv_precision;
+
+                        /* the first atom is output before the second */
+                        thiscoord[-3] = prevcoord[0];
+                        thiscoord[-2] = prevcoord[1];
+                        thiscoord[-1] = prevcoord[2];
                     }
                     else
                     {
@@ -1074,17 +1069,9 @@ int xdr3dfcoord(XDR* xdrs, float* fp, int* size, float* precision, int magic_num
                         prevcoord[1] = thiscoord[1];
                         prevcoord[2] = thiscoord[2];
                     }
-                    *lfp++ = thiscoord[0] * inv_precision;
-                    *lfp++ = thiscoord[1] * inv_precision;
-                    *lfp++ = thiscoord[2] * inv_precision;
+                    thiscoord += 3;
                 }
             }
-            else
-            {
-                *lfp++ = thiscoord[0] * inv_precision;
-                *lfp++ = thiscoord[1] * inv_precision;
-                *lfp++ = thiscoord[2] * inv_precision;
-            }
             smallidx += is_smaller;
             if (is_smaller < 0)
             {
@@ -1105,6 +1092,8 @@ int xdr3dfcoord(XDR* xdrs, float* fp, int* size, float* precision, int magic_num
             }
             sizesmall[0] = sizesmall[1] = sizesmall[2] = magicints[smallidx];
         }
+        /* All integer coordinates are in ip in output order now */
+        xtc_dequantize_coordinates(ip, size3, inv_precision, fp);
     }
     if (we_should_free)
     {
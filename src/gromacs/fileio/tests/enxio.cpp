@@ -0,0 +1,182 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for reading energy files, with and without skipping block data.
+ *
+ * \ingroup module_fileio
+ */
+#include "gmxpre.h"
+
+#include "gromacs/fileio/enxio.h"
+
+#include <filesystem>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/trajectory/energyframe.h"
+
+#include "testutils/testfilemanager.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! Number of frames in the test energy file.
+constexpr int c_numFrames = 3;
+//! Number of values in the block of each frame.
+constexpr int c_numBlockValues = 20;
+
+//! Tests energy file reading, the parameter tells whether block data is skipped.
+class EnergyFileTest : public ::testing::TestWithParam<bool>
+{
+public:
+    EnergyFileTest()
+    {
+        edrFileName_ = fileManager_.getTemporaryFilePath("ener.edr");
+
+        ener_file_t  energyFile  = open_enx(edrFileName_, "w");
+        char         name[]      = "Potential";
+        char         unit[]      = "kJ/mol";
+        gmx_enxnm_t  energyName  = { name, unit };
+        gmx_enxnm_t* energyNames = &energyName;
+        int          numEnergies = 1;
+        do_enxnms(energyFile, &numEnergies, &energyNames);
+
+        t_energy           energy = { 0, 0, 0 };
+        std::vector<float> blockValues(c_numBlockValues);
+        t_enxframe         frame;
+        init_enxframe(&frame);
+        frame.nsteps = 0;
+        frame.dt     = 0.002;
+        frame.nsum   = 0;
+        frame.nre    = 1;
+        frame.ener   = &energy;
+        add_blocks_enxframe(&frame, 1);
+        add_subblocks_enxblock(&frame.block[0], 1);
+        frame.block[0].id          = enxDISRE;
+        frame.block[0].sub[0].nr   = c_numBlockValues;
+        frame.block[0].sub[0].type = XdrDataType::Float;
+        frame.block[0].sub[0].fval = blockValues.data();
+        for (int f = 0; f < c_numFrames; f++)
+        {
+            frame.t    = f;
+            frame.step = 10 * f;
+            energy.e   = -100 - f;
+            for (int i = 0; i < c_numBlockValues; i++)
+            {
+                blockValues[i] = f + 0.01F * i;
+            }
+            EXPECT_TRUE(do_enx(energyFile, &frame));
+        }
+        // The block data is owned by blockValues
+        frame.block[0].sub[0].fval = nullptr;
+        free_enxframe(&frame);
+        close_enx(energyFile);
+    }
+
+    //! Reads all frames and returns their energies, sets whether the last read succeeded
+    std::vector<real> readEnergies(bool* lastReadOK)
+    {
+        std::vector<real> energies;
+        ener_file_t       energyFile  = open_enx(edrFileName_, "r");
+        gmx_enxnm_t*      energyNames = nullptr;
+        int               numEnergies = 0;
+        do_enxnms(energyFile, &numEnergies, &energyNames);
+        EXPECT_EQ(1, numEnergies);
+        enx_set_skip_block_data(energyFile, GetParam());
+
+        t_enxframe frame;
+        init_enxframe(&frame);
+        bool readOK;
+        while ((readOK = do_enx(energyFile, &frame)))
+        {
+            energies.push_back(frame.ener[0].e);
+            if (GetParam())
+            {
+                EXPECT_EQ(0, frame.nblock);
+            }
+            else if (frame.nblock == 1 && frame.block[0].sub[0].nr == c_numBlockValues)
+            {
+                EXPECT_FLOAT_EQ(frame.t + 0.01F, frame.block[0].sub[0].fval[1]);
+            }
+            else
+            {
+                ADD_FAILURE() << "Frame at time " << frame.t << " has the wrong block data";
+            }
+        }
+        *lastReadOK = readOK;
+        free_enxframe(&frame);
+        free_enxnms(numEnergies, energyNames);
+        close_enx(energyFile);
+        return energies;
+    }
+
+    TestFileManager       fileManager_;
+    std::filesystem::path edrFileName_;
+};
+
+TEST_P(EnergyFileTest, ReadsAllFrames)
+{
+    bool                    lastReadOK = false;
+    const std::vector<real> energies   = readEnergies(&lastReadOK);
+    ASSERT_EQ(c_numFrames, energies.size());
+    for (int f = 0; f < c_numFrames; f++)
+    {
+        EXPECT_EQ(-100 - f, energies[f]);
+    }
+}
+
+TEST_P(EnergyFileTest, DropsFrameWithTruncatedBlockData)
+{
+    // Cut off the end of the block data of the last frame, as a crashed run can leave it
+    std::filesystem::resize_file(edrFileName_, std::filesystem::file_size(edrFileName_) - 8);
+
+    bool                    lastReadOK = true;
+    const std::vector<real> energies   = readEnergies(&lastReadOK);
+    EXPECT_FALSE(lastReadOK);
+    EXPECT_EQ(c_numFrames - 1, energies.size());
+}
+
+INSTANTIATE_TEST_SUITE_P(WithAndWithoutBlockSkipping,
+                         EnergyFileTest,
+                         ::testing::Values(false, true));
+
+} // namespace
+} // namespace test
+} // namespace gmx
@@ -0,0 +1,286 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for writing trajectories to H5MD files
+ *
+ * \ingroup module_fileio
+ */
+#include "gmxpre.h"
+
+#include "gromacs/fileio/h5mdtrajectorywriter.h"
+
+#include "config.h"
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/fileio/h5md.h"
+#include "gromacs/math/vec.h"
+#include "gromacs/mdtypes/md_enums.h"
+
+#include "testutils/testasserts.h"
+#include "testutils/testfilemanager.h"
+
+#if GMX_USE_HDF5
+#    include <hdf5.h>
+CLANG_DIAGNOSTIC_IGNORE("-Wold-style-cast")
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! Number of atoms in the test system.
+constexpr int c_numAtoms = 7;
+
+//! Returns the dimensions of dataset \p name in \p file.
+std::vector<hsize_t> datasetDims(hid_t file, const char* name)
+{
+    hid_t dataset = H5Dopen2(file, name, H5P_DEFAULT);
+    EXPECT_GE(dataset, 0) << "Dataset " << name << " is missing";
+    hid_t                space = H5Dget_space(dataset);
+    std::vector<hsize_t> dims(H5Sget_simple_extent_ndims(space));
+    H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+    H5Sclose(space);
+    H5Dclose(dataset);
+    return dims;
+}
+
+//! Returns the contents of real dataset \p name in \p file.
+std::vector<real> readRealDataset(hid_t file, const char* name)
+{
+    std::vector<hsize_t> dims = datasetDims(file, name);
+    std::vector<real>    values(
+            std::accumulate(dims.begin(), dims.end(), hsize_t(1), std::multiplies<>()));
+    hid_t       dataset    = H5Dopen2(file, name, H5P_DEFAULT);
+    const hid_t memoryType = GMX_DOUBLE ? H5T_NATIVE_DOUBLE : H5T_NATIVE_FLOAT;
+    H5Dread(dataset, memoryType, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data());
+    H5Dclose(dataset);
+    return values;
+}
+
+//! Returns the contents of 64-bit integer dataset \p name in \p file.
+std::vector<int64_t> readStepDataset(hid_t file, const char* name)
+{
+    std::vector<int64_t> values(datasetDims(file, name)[0]);
+    hid_t                dataset = H5Dopen2(file, name, H5P_DEFAULT);
+    H5Dread(dataset, H5T_NATIVE_INT64, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data());
+    H5Dclose(dataset);
+    return values;
+}
+
+//! Returns test coordinates for \p frame.
+std::vector<RVec> makeVectors(int frame, real scale)
+{
+    std::vector<RVec> v(c_numAtoms);
+    for (int i = 0; i < c_numAtoms; i++)
+    {
+        v[i] = { scale * i, scale * (frame + 0.5F), -scale * i * frame };
+    }
+    return v;
+}
+
+class H5mdTrajectoryWriterTest : public ::testing::Test
+{
+public:
+    //! Check the contents written by writeTestFrames() to fileName_.
+    void checkFile()
+    {
+        hid_t file = H5Fopen(fileName_.string().c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        ASSERT_GE(file, 0);
+
+        EXPECT_GT(H5Aexists_by_name(file, "h5md", "version", H5P_DEFAULT), 0);
+        EXPECT_GT(H5Aexists_by_name(file, "particles/system/box", "boundary", H5P_DEFAULT), 0);
+
+        const std::vector<hsize_t> positionDims = { 3, c_numAtoms, DIM };
+        EXPECT_EQ(positionDims, datasetDims(file, "particles/system/position/value"));
+        const std::vector<hsize_t> velocityDims = { 2, c_numAtoms, DIM };
+        EXPECT_EQ(velocityDims, datasetDims(file, "particles/system/velocity/value"));
+        const std::vector<hsize_t> boxDims = { 3, DIM, DIM };
+        EXPECT_EQ(boxDims, datasetDims(file, "particles/system/box/edges/value"));
+
+        const std::vector<int64_t> positionSteps = { 0, 10, 20 };
+        EXPECT_EQ(positionSteps, readStepDataset(file, "particles/system/position/step"));
+        const std::vector<int64_t> velocitySteps = { 0, 20 };
+        EXPECT_EQ(velocitySteps, readStepDataset(file, "particles/system/velocity/step"));
+
+        const std::vector<real> positions =
+                readRealDataset(file, "particles/system/position/value");
+        const std::vector<real> velocities =
+                readRealDataset(file, "particles/system/velocity/value");
+        const std::vector<real> boxes = readRealDataset(file, "particles/system/box/edges/value");
+        for (int frame = 0; frame < 3; frame++)
+        {
+            const std::vector<RVec> x = makeVectors(frame, 1);
+            for (int i = 0; i < c_numAtoms; i++)
+            {
+                for (int d = 0; d < DIM; d++)
+                {
+                    EXPECT_REAL_EQ(x[i][d], positions[(frame * c_numAtoms + i) * DIM + d]);
+                }
+            }
+            EXPECT_REAL_EQ(3 + frame, boxes[frame * DIM * DIM]);
+        }
+        const std::vector<RVec> v = makeVectors(2, -2);
+        EXPECT_REAL_EQ(v[c_numAtoms - 1][ZZ], velocities.back());
+
+        H5Fclose(file);
+    }
+
+    TestFileManager       fileManager_;
+    std::filesystem::path fileName_ = fileManager_.getTemporaryFilePath("traj.h5md");
+};
+
+TEST_F(H5mdTrajectoryWriterTest, WritesFramesWithAllAtoms)
+{
+    {
+        H5md                 file(fileName_, H5mdFileMode::Write);
+        H5mdTrajectoryWriter writer(&file, c_numAtoms, PbcType::Xyz, "test");
+        for (int frame = 0; frame < 3; frame++)
+        {
+            const std::vector<RVec> x = makeVectors(frame, 1);
+            const std::vector<RVec> v = makeVectors(frame, -2);
+            matrix                  box;
+            clear_mat(box);
+            box[XX][XX] = 3 + frame;
+            writer.writeFrame(10 * frame,
+                              0.1 * frame,
+                              box,
+                              as_rvec_array(x.data()),
+                              frame % 2 == 0 ? as_rvec_array(v.data()) : nullptr,
+                              nullptr);
+        }
+    }
+    checkFile();
+}
+
+TEST_F(H5mdTrajectoryWriterTest, WritesFramesWithScatteredAtoms)
+{
+    // Store the atoms in a different order, as a domain decomposition rank would
+    const std::vector<int> globalAtomIndices = { 4, 0, 6, 2, 1, 5, 3 };
+    {
+        H5md                 file(fileName_, H5mdFileMode::Write);
+        H5mdTrajectoryWriter writer(&file, c_numAtoms, PbcType::Xyz, "test");
+        for (int frame = 0; frame < 3; frame++)
+        {
+            const std::vector<RVec> xGlobal = makeVectors(frame, 1);
+            const std::vector<RVec> vGlobal = makeVectors(frame, -2);
+            std::vector<RVec>       x, v;
+            for (int globalIndex : globalAtomIndices)
+            {
+                x.push_back(xGlobal[globalIndex]);
+                v.push_back(vGlobal[globalIndex]);
+            }
+            matrix box;
+            clear_mat(box);
+            box[XX][XX] = 3 + frame;
+            writer.writeLocalFrame(10 * frame,
+                                   0.1 * frame,
+                                   box,
+                                   globalAtomIndices,
+                                   as_rvec_array(x.data()),
+                                   frame % 2 == 0 ? as_rvec_array(v.data()) : nullptr,
+                                   nullptr);
+        }
+    }
+    checkFile();
+}
+
+TEST_F(H5mdTrajectoryWriterTest, WritesSelectedAtomsWithReducedPrecision)
+{
+    const std::vector<int> globalAtomIndices = { 4, 0, 6, 2, 1, 5, 3 };
+    H5mdWriterOptions      options;
+    options.selection         = { 1, 2, 5 };
+    options.positionPrecision = 100;
+    const std::vector<RVec> xGlobal = { { 0.123456, 1, 2 }, { 1.234567, -2.46813, 3 },
+                                        { 2.5, 4.98765, 0 }, { 3, 3, 3 },
+                                        { 4, 4, 4 },         { -5.55555, 0.01, 12.3456 },
+                                        { 6, 6, 6 } };
+    {
+        H5md                 file(fileName_, H5mdFileMode::Write);
+        H5mdTrajectoryWriter writer(&file, c_numAtoms, PbcType::XY, "test", options);
+        matrix               box = { { 1, 0, 0 }, { 0, 2, 0 }, { 0, 0, 3 } };
+        // One frame with all atoms in global order, one with atoms in rank order
+        writer.writeFrame(0, 0, box, as_rvec_array(xGlobal.data()), nullptr, nullptr);
+        std::vector<RVec> x;
+        for (int globalIndex : globalAtomIndices)
+        {
+            x.push_back(xGlobal[globalIndex]);
+        }
+        writer.writeLocalFrame(
+                1, 0.1, box, globalAtomIndices, as_rvec_array(x.data()), nullptr, nullptr);
+    }
+
+    hid_t file = H5Fopen(fileName_.string().c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    ASSERT_GE(file, 0);
+    const std::vector<hsize_t> positionDims = { 2, 3, DIM };
+    EXPECT_EQ(positionDims, datasetDims(file, "particles/system/position/value"));
+    const std::vector<real> positions = readRealDataset(file, "particles/system/position/value");
+    const real              tolerance = 0.5 / options.positionPrecision + GMX_REAL_EPS * 100;
+    for (int frame = 0; frame < 2; frame++)
+    {
+        for (size_t i = 0; i < options.selection.size(); i++)
+        {
+            for (int d = 0; d < DIM; d++)
+            {
+                EXPECT_NEAR(xGlobal[options.selection[i]][d],
+                            positions[(frame * options.selection.size() + i) * DIM + d],
+                            tolerance);
+            }
+        }
+    }
+    H5Fclose(file);
+}
+
+TEST(H5mdTest, SerialFilesAreNotParallel)
+{
+    TestFileManager fileManager;
+    H5md            file(fileManager.getTemporaryFilePath("serial.h5md"), H5mdFileMode::Write);
+    EXPECT_FALSE(file.isParallel());
+    EXPECT_EQ(0, file.rank());
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
+
+CLANG_DIAGNOSTIC_RESET
+
+#endif // GMX_USE_HDF5
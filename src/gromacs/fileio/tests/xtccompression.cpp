@@ -0,0 +1,189 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the coordinate quantization used in XTC compression.
+ *
+ * \ingroup module_fileio
+ */
+#include "gmxpre.h"
+
+#include <cmath>
+
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/fileio/xdrf.h"
+#include "gromacs/fileio/xtcio.h"
+#include "gromacs/math/vec.h"
+#include "gromacs/random/tabulatednormaldistribution.h"
+#include "gromacs/random/threefry.h"
+#include "gromacs/utility/smalloc.h"
+
+#include "testutils/testfilemanager.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! The scalar quantization as originally written in xdr3dfcoord.
+std::vector<int> referenceQuantization(const std::vector<float>& x, float precision, bool* bRange)
+{
+    const float      maxAbsoluteInt = std::nextafterf(float(std::numeric_limits<int>::max()), 0.F);
+    std::vector<int> ix(x.size());
+    *bRange = true;
+    for (size_t i = 0; i < x.size(); i++)
+    {
+        float lf;
+        if (x[i] >= 0.0)
+        {
+            lf = x[i] * precision + 0.5;
+        }
+        else
+        {
+            lf = x[i] * precision - 0.5;
+        }
+        if (std::fabs(lf) > maxAbsoluteInt)
+        {
+            *bRange = false;
+        }
+        ix[i] = static_cast<int>(lf);
+    }
+    return ix;
+}
+
+//! Return coordinates including values that round to halfway cases.
+std::vector<float> testCoordinates(int n)
+{
+    gmx::ThreeFry2x64<64>                   rng(1234, gmx::RandomDomain::Other);
+    gmx::TabulatedNormalDistribution<float> dist(0, 5);
+    std::vector<float>                      x(n);
+    for (int i = 0; i < n; i++)
+    {
+        x[i] = dist(rng);
+    }
+    // Values at and near rounding boundaries with precision 1000
+    const float special[] = { 0.0F, -0.0F, 0.0005F, -0.0005F, 0.0015F, -0.0025F, 1.2345F, -1.2345F };
+    for (size_t i = 0; i < sizeof(special) / sizeof(special[0]) && i < x.size(); i++)
+    {
+        x[3 * i % n] = special[i];
+    }
+    return x;
+}
+
+TEST(XtcCompressionTest, QuantizationMatchesScalarReference)
+{
+    // Use a size that is not a multiple of any SIMD width
+    const std::vector<float> x = testCoordinates(3 * 333);
+    for (float precision : { 1000.0F, 100.0F, 12345.6F })
+    {
+        bool             bRangeReference;
+        std::vector<int> expected = referenceQuantization(x, precision, &bRangeReference);
+        std::vector<int> ix(x.size());
+        EXPECT_EQ(bRangeReference, xtc_quantize_coordinates(x.data(), x.size(), precision, ix.data()));
+        EXPECT_EQ(expected, ix);
+    }
+}
+
+TEST(XtcCompressionTest, QuantizationDetectsOverflow)
+{
+    std::vector<float> x = testCoordinates(99);
+    x[70]                = 3e6;
+    std::vector<int> ix(x.size());
+    EXPECT_FALSE(xtc_quantize_coordinates(x.data(), x.size(), 1000.0F, ix.data()));
+    x[70] = 3;
+    EXPECT_TRUE(xtc_quantize_coordinates(x.data(), x.size(), 1000.0F, ix.data()));
+}
+
+TEST(XtcCompressionTest, DequantizationMatchesScalarReference)
+{
+    const std::vector<float> x = testCoordinates(3 * 111);
+    std::vector<int>         ix(x.size());
+    xtc_quantize_coordinates(x.data(), x.size(), 1000.0F, ix.data());
+    std::vector<float> result(x.size());
+    xtc_dequantize_coordinates(ix.data(), ix.size(), 1.0F / 1000.0F, result.data());
+    for (size_t i = 0; i < x.size(); i++)
+    {
+        EXPECT_EQ(ix[i] * (1.0F / 1000.0F), result[i]);
+    }
+}
+
+TEST(XtcCompressionTest, FrameRoundTripIsWithinPrecision)
+{
+    TestFileManager          fileManager;
+    const auto               fileName = fileManager.getTemporaryFilePath("roundtrip.xtc");
+    const int                natoms   = 1000;
+    const real               prec     = 1000;
+    const std::vector<float> values   = testCoordinates(3 * natoms);
+    std::vector<RVec>        x(natoms);
+    for (int i = 0; i < natoms; i++)
+    {
+        // Water-like clusters of nearby atoms exercise the run-length encoding
+        x[i] = { 2 + values[3 * (i / 3)] + 0.01F * (i % 3), 2 + values[3 * i + 1], 2 + values[3 * i + 2] };
+    }
+    matrix box = { { 5, 0, 0 }, { 0, 5, 0 }, { 0, 0, 5 } };
+
+    t_fileio* fio = open_xtc(fileName, "w");
+    ASSERT_EQ(1, write_xtc(fio, natoms, 0, 0, box, as_rvec_array(x.data()), prec));
+    close_xtc(fio);
+
+    fio = open_xtc(fileName, "r");
+    int      readNatoms;
+    int64_t  step;
+    real     time, readPrec;
+    matrix   readBox;
+    rvec*    readX = nullptr;
+    gmx_bool bOK;
+    ASSERT_EQ(1, read_first_xtc(fio, &readNatoms, &step, &time, readBox, &readX, &readPrec, &bOK));
+    close_xtc(fio);
+    ASSERT_EQ(natoms, readNatoms);
+    for (int i = 0; i < natoms; i++)
+    {
+        for (int d = 0; d < DIM; d++)
+        {
+            EXPECT_NEAR(x[i][d], readX[i][d], 0.5 / prec + 1e-6);
+        }
+    }
+    sfree(readX);
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
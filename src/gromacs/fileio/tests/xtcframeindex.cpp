@@ -0,0 +1,246 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the XTC frame index.
+ *
+ * \ingroup module_fileio
+ */
+#include "gmxpre.h"
+
+#include "gromacs/fileio/xtcframeindex.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/fileio/gmxfio.h"
+#include "gromacs/fileio/gmxfio_xdr.h"
+#include "gromacs/fileio/xtcio.h"
+#include "gromacs/math/vec.h"
+#include "gromacs/utility/smalloc.h"
+
+#include "testutils/testfilemanager.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! Number of frames written to the test trajectories.
+constexpr int c_numFrames = 10;
+
+class XtcFrameIndexTest : public ::testing::TestWithParam<int>
+{
+public:
+    XtcFrameIndexTest() : natoms_(GetParam())
+    {
+        xtcFileName_ = fileManager_.getTemporaryFilePath("traj.xtc");
+        writeTrajectory();
+    }
+
+    //! Write a trajectory with frames at times \p startTime, \p startTime + 2, ...
+    void writeTrajectory(real startTime = 0)
+    {
+        t_fileio*         fio = open_xtc(xtcFileName_, "w");
+        std::vector<RVec> x(natoms_);
+        matrix            box = { { 3, 0, 0 }, { 0, 3, 0 }, { 0, 0, 3 } };
+        for (int frame = 0; frame < c_numFrames; frame++)
+        {
+            for (int i = 0; i < natoms_; i++)
+            {
+                // Vary the coordinates so the compressed frames differ in size
+                x[i] = { 0.01F * i * (frame + 1), 0.1F * frame, 0.002F * i * i };
+            }
+            ASSERT_EQ(1,
+                      write_xtc(fio,
+                                natoms_,
+                                frame * 100,
+                                startTime + 2.0 * frame,
+                                box,
+                                as_rvec_array(x.data()),
+                                1000));
+        }
+        close_xtc(fio);
+    }
+
+    //! Build an index by scanning the whole test trajectory.
+    XtcFrameIndex scanTrajectory()
+    {
+        XtcFrameIndex index(natoms_);
+        t_fileio*     fio = open_xtc(xtcFileName_, "r");
+        EXPECT_EQ(std::filesystem::file_size(xtcFileName_),
+                  scanXtcFrames(gmx_fio_getfp(fio), gmx_fio_getxdr(fio), 0, &index));
+        close_xtc(fio);
+        return index;
+    }
+
+    TestFileManager       fileManager_;
+    std::filesystem::path xtcFileName_;
+    int                   natoms_;
+};
+
+TEST_P(XtcFrameIndexTest, ScanFindsAllFrames)
+{
+    XtcFrameIndex index = scanTrajectory();
+    ASSERT_EQ(c_numFrames, index.numFrames());
+    gmx_off_t offset = 0;
+    for (int frame = 0; frame < c_numFrames; frame++)
+    {
+        const XtcFrameIndexEntry& entry = index.entries()[frame];
+        EXPECT_EQ(offset, entry.offset);
+        EXPECT_EQ(frame * 100, entry.step);
+        EXPECT_FLOAT_EQ(2.0 * frame, entry.time);
+        offset += entry.size;
+    }
+    EXPECT_EQ(std::filesystem::file_size(xtcFileName_), index.endOffset());
+}
+
+TEST_P(XtcFrameIndexTest, RoundTripsThroughFile)
+{
+    XtcFrameIndex index         = scanTrajectory();
+    const auto    indexFileName = XtcFrameIndex::indexFileName(xtcFileName_);
+    fileManager_.manageGeneratedOutputFile(indexFileName);
+    ASSERT_TRUE(index.persistTo(indexFileName));
+
+    auto readIndex = readXtcFrameIndex(indexFileName, natoms_);
+    ASSERT_TRUE(readIndex.has_value());
+    ASSERT_EQ(index.numFrames(), readIndex->numFrames());
+    for (int frame = 0; frame < c_numFrames; frame++)
+    {
+        EXPECT_EQ(index.entries()[frame].offset, readIndex->entries()[frame].offset);
+        EXPECT_EQ(index.entries()[frame].size, readIndex->entries()[frame].size);
+        EXPECT_EQ(index.entries()[frame].step, readIndex->entries()[frame].step);
+        EXPECT_EQ(index.entries()[frame].time, readIndex->entries()[frame].time);
+    }
+    EXPECT_FALSE(readXtcFrameIndex(indexFileName, natoms_ + 1).has_value());
+}
+
+TEST_P(XtcFrameIndexTest, FindsFrameForTime)
+{
+    XtcFrameIndex index = scanTrajectory();
+    EXPECT_EQ(0, index.findFrameForTime(0, 0));
+    EXPECT_EQ(2, index.findFrameForTime(5, 0));
+    EXPECT_EQ(2, index.findFrameForTime(6, 0));
+    EXPECT_EQ(8, index.findFrameForTime(18, 0));
+    EXPECT_FALSE(index.findFrameForTime(19, 0).has_value());
+    // Seeking forward never returns earlier frames
+    EXPECT_EQ(4, index.findFrameForTime(1, index.entries()[4].offset));
+}
+
+TEST_P(XtcFrameIndexTest, SeekUsesIndexFile)
+{
+    XtcFrameIndex index         = scanTrajectory();
+    const auto    indexFileName = XtcFrameIndex::indexFileName(xtcFileName_);
+    fileManager_.manageGeneratedOutputFile(indexFileName);
+    ASSERT_TRUE(index.persistTo(indexFileName));
+
+    t_fileio* fio    = open_xtc(xtcFileName_, "r");
+    int       natoms = 0;
+    int64_t   step   = 0;
+    real      time   = 0;
+    real      prec   = 0;
+    matrix    box;
+    rvec*     x   = nullptr;
+    gmx_bool  bOK = FALSE;
+    ASSERT_EQ(1, read_first_xtc(fio, &natoms, &step, &time, box, &x, &prec, &bOK));
+    ASSERT_NE(nullptr, gmx_fio_get_xtc_frame_index(fio));
+    EXPECT_EQ(c_numFrames, gmx_fio_get_xtc_frame_index(fio)->numFrames());
+
+    ASSERT_EQ(0, xtc_seek_time(fio, 11, natoms, TRUE));
+    ASSERT_EQ(1, read_next_xtc(fio, natoms, &step, &time, box, x, &prec, &bOK));
+    EXPECT_EQ(500, step);
+    ASSERT_EQ(1, read_next_xtc(fio, natoms, &step, &time, box, x, &prec, &bOK));
+    EXPECT_EQ(600, step);
+    EXPECT_FLOAT_EQ(12, time);
+    sfree(x);
+    close_xtc(fio);
+}
+
+TEST_P(XtcFrameIndexTest, StaleIndexFileIsIgnored)
+{
+    XtcFrameIndex index         = scanTrajectory();
+    const auto    indexFileName = XtcFrameIndex::indexFileName(xtcFileName_);
+    fileManager_.manageGeneratedOutputFile(indexFileName);
+    ASSERT_TRUE(index.persistTo(indexFileName));
+    // Truncate the trajectory in the middle of the last frame
+    std::filesystem::resize_file(xtcFileName_, index.entries().back().offset + 8);
+
+    t_fileio* fio    = open_xtc(xtcFileName_, "r");
+    int       natoms = 0;
+    int64_t   step   = 0;
+    real      time   = 0;
+    real      prec   = 0;
+    matrix    box;
+    rvec*     x   = nullptr;
+    gmx_bool  bOK = FALSE;
+    ASSERT_EQ(1, read_first_xtc(fio, &natoms, &step, &time, box, &x, &prec, &bOK));
+    EXPECT_EQ(nullptr, gmx_fio_get_xtc_frame_index(fio));
+    sfree(x);
+    close_xtc(fio);
+}
+
+TEST_P(XtcFrameIndexTest, IndexFileWithOtherTimesIsIgnored)
+{
+    XtcFrameIndex index         = scanTrajectory();
+    const auto    indexFileName = XtcFrameIndex::indexFileName(xtcFileName_);
+    fileManager_.manageGeneratedOutputFile(indexFileName);
+    ASSERT_TRUE(index.persistTo(indexFileName));
+    // Rewrite the trajectory with the same steps and frame sizes, but other times
+    writeTrajectory(1);
+
+    t_fileio* fio    = open_xtc(xtcFileName_, "r");
+    int       natoms = 0;
+    int64_t   step   = 0;
+    real      time   = 0;
+    real      prec   = 0;
+    matrix    box;
+    rvec*     x   = nullptr;
+    gmx_bool  bOK = FALSE;
+    ASSERT_EQ(1, read_first_xtc(fio, &natoms, &step, &time, box, &x, &prec, &bOK));
+    EXPECT_EQ(nullptr, gmx_fio_get_xtc_frame_index(fio));
+    sfree(x);
+    close_xtc(fio);
+}
+
+// Systems with up to 9 atoms are stored uncompressed
+INSTANTIATE_TEST_SUITE_P(WithAndWithoutCompression, XtcFrameIndexTest, ::testing::Values(5, 40));
+
+} // namespace
+} // namespace test
+} // namespace gmx
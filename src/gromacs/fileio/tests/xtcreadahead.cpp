@@ -0,0 +1,234 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for reading XTC frames ahead on worker threads.
+ *
+ * \ingroup module_fileio
+ */
+#include "gmxpre.h"
+
+#include "gromacs/fileio/xtcreadahead.h"
+
+#include <filesystem>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/fileio/gmxfio.h"
+#include "gromacs/fileio/gmxfio_xdr.h"
+#include "gromacs/fileio/xtcframeindex.h"
+#include "gromacs/fileio/xtcio.h"
+#include "gromacs/math/vec.h"
+
+#include "testutils/testasserts.h"
+#include "testutils/testfilemanager.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! Number of atoms in the test trajectory.
+constexpr int c_natoms = 50;
+//! Number of frames in the test trajectory.
+constexpr int c_numFrames = 17;
+
+//! A frame read from the test trajectory.
+struct Frame
+{
+    int64_t           step = 0;
+    real              time = 0;
+    matrix            box  = { { 0 } };
+    std::vector<RVec> x    = std::vector<RVec>(c_natoms);
+};
+
+class XtcReadAheadTest : public ::testing::TestWithParam<int>
+{
+public:
+    XtcReadAheadTest()
+    {
+        xtcFileName_  = fileManager_.getTemporaryFilePath("traj.xtc");
+        t_fileio* fio = open_xtc(xtcFileName_, "w");
+        Frame     frame;
+        for (int f = 0; f < c_numFrames; f++)
+        {
+            for (int i = 0; i < c_natoms; i++)
+            {
+                frame.x[i] = { 0.013F * i * (f + 1), 0.1F * f, 0.002F * i * i };
+            }
+            frame.box[XX][XX] = frame.box[YY][YY] = frame.box[ZZ][ZZ] = 3 + 0.1 * f;
+            write_xtc(fio, c_natoms, 10 * f, 0.5 * f, frame.box, as_rvec_array(frame.x.data()), 1000);
+        }
+        close_xtc(fio);
+    }
+
+    /*! \brief Read all frames from \p startFrame on without reading ahead.
+     *
+     * Returns in \p bOKAtEnd whether the last read call reported success.
+     */
+    std::vector<Frame> readSequentially(int startFrame, gmx_bool* bOKAtEnd = nullptr)
+    {
+        std::vector<Frame> frames;
+        t_fileio*          fio = open_xtc(xtcFileName_, "r");
+        Frame              frame;
+        real               prec;
+        gmx_bool           bOK;
+        while (read_next_xtc(
+                fio, c_natoms, &frame.step, &frame.time, frame.box, as_rvec_array(frame.x.data()), &prec, &bOK))
+        {
+            frames.push_back(frame);
+        }
+        close_xtc(fio);
+        if (bOKAtEnd != nullptr)
+        {
+            *bOKAtEnd = bOK;
+        }
+        frames.erase(frames.begin(), frames.begin() + startFrame);
+        return frames;
+    }
+
+    /*! \brief Read all frames from \p startOffset on, reading ahead.
+     *
+     * The number of reading threads is the test parameter.
+     * Returns in \p bOKAtEnd whether the last read call reported success.
+     * Without \p bOKAtEnd, the whole file is expected to be read successfully.
+     */
+    std::vector<Frame> readAhead(gmx_off_t            startOffset,
+                                 const XtcFrameIndex* index,
+                                 gmx_bool*            bOKAtEnd = nullptr)
+    {
+        std::vector<Frame> frames;
+        XtcReadAhead       readAhead(xtcFileName_, c_natoms, startOffset, index, GetParam());
+        Frame              frame;
+        real               prec;
+        gmx_bool           bOK;
+        while (readAhead.readNextFrame(
+                &frame.step, &frame.time, frame.box, as_rvec_array(frame.x.data()), &prec, &bOK))
+        {
+            frames.push_back(frame);
+        }
+        if (bOKAtEnd != nullptr)
+        {
+            *bOKAtEnd = bOK;
+        }
+        else
+        {
+            EXPECT_TRUE(bOK);
+            EXPECT_EQ(std::filesystem::file_size(xtcFileName_), readAhead.nextOffset());
+        }
+        return frames;
+    }
+
+    //! Build a frame index of the test trajectory.
+    XtcFrameIndex buildIndex()
+    {
+        XtcFrameIndex index(c_natoms);
+        t_fileio*     fio = open_xtc(xtcFileName_, "r");
+        scanXtcFrames(gmx_fio_getfp(fio), gmx_fio_getxdr(fio), 0, &index);
+        close_xtc(fio);
+        return index;
+    }
+
+    TestFileManager       fileManager_;
+    std::filesystem::path xtcFileName_;
+};
+
+//! Check that \p actual contains the same frames as \p expected.
+void compareFrames(const std::vector<Frame>& expected, const std::vector<Frame>& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t f = 0; f < expected.size(); f++)
+    {
+        EXPECT_EQ(expected[f].step, actual[f].step);
+        EXPECT_EQ(expected[f].time, actual[f].time);
+        for (int d = 0; d < DIM; d++)
+        {
+            EXPECT_EQ(expected[f].box[d][d], actual[f].box[d][d]);
+        }
+        for (int i = 0; i < c_natoms; i++)
+        {
+            EXPECT_EQ(expected[f].x[i], actual[f].x[i]);
+        }
+    }
+}
+
+TEST_P(XtcReadAheadTest, ReturnsSameFramesAsSequentialReading)
+{
+    compareFrames(readSequentially(0), readAhead(0, nullptr));
+}
+
+TEST_P(XtcReadAheadTest, StartsAtGivenOffset)
+{
+    XtcFrameIndex index = buildIndex();
+    compareFrames(readSequentially(5), readAhead(index.entries()[5].offset, nullptr));
+}
+
+TEST_P(XtcReadAheadTest, UsesFrameIndex)
+{
+    XtcFrameIndex index = buildIndex();
+    compareFrames(readSequentially(3), readAhead(index.entries()[3].offset, &index));
+}
+
+TEST_P(XtcReadAheadTest, HandlesPartialFrameIndex)
+{
+    XtcFrameIndex index = buildIndex();
+    index.truncate(index.entries()[8].offset);
+    compareFrames(readSequentially(0), readAhead(0, &index));
+}
+
+TEST_P(XtcReadAheadTest, ReportsTruncatedFrame)
+{
+    XtcFrameIndex index = buildIndex();
+    // Cut the trajectory in the middle of the coordinates of frame 10
+    const XtcFrameIndexEntry& truncatedFrame = index.entries()[10];
+    std::filesystem::resize_file(xtcFileName_, truncatedFrame.offset + truncatedFrame.size / 2);
+
+    gmx_bool                 bOKSequential = TRUE;
+    const std::vector<Frame> expected      = readSequentially(0, &bOKSequential);
+    ASSERT_FALSE(bOKSequential);
+    ASSERT_EQ(10, expected.size());
+
+    gmx_bool bOKReadAhead = TRUE;
+    compareFrames(expected, readAhead(0, nullptr, &bOKReadAhead));
+    EXPECT_FALSE(bOKReadAhead);
+}
+
+INSTANTIATE_TEST_SUITE_P(WithThreads, XtcReadAheadTest, ::testing::Values(1, 3));
+
+} // namespace
+} // namespace test
+} // namespace gmx
@@ -47,6 +47,8 @@
 
 /* This file is completely threadsafe - keep it that way! */
 
+#include "config.h"
+
 #include <cinttypes>
 #include <cstdint>
 #include <cstdio>
@@ -62,6 +64,13 @@
 #include <utility>
 #include <vector>
 
+#if HAVE_MMAP
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
 #include "gromacs/applied_forces/awh/read_params.h"
 #include "gromacs/fileio/filetypes.h"
 #include "gromacs/fileio/gmxfio.h"
@@ -86,6 +95,7 @@
 #include "gromacs/topology/topology.h"
 #include "gromacs/utility/arraysize.h"
 #include "gromacs/utility/baseversion.h"
+#include "gromacs/utility/classhelpers.h"
 #include "gromacs/utility/cstringutil.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
@@ -3303,6 +3313,75 @@ static void close_tpx(t_fileio* fio)
     gmx_fio_close(fio);
 }
 
+namespace
+{
+
+/*! \brief
+ * Read-only memory mapping of a TPR file.
+ *
+ * Deserializing the TPR body straight from the mapping avoids reading
+ * the whole body into a heap buffer first. The pages are only read
+ * from disk when they are deserialized.
+ */
+class MappedTprFile
+{
+public:
+    //! Maps \p fileName, the mapping is empty when that is not possible.
+    explicit MappedTprFile(const std::filesystem::path& fileName)
+    {
+#if HAVE_MMAP
+        const int fd = open(fileName.string().c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat fileStatus;
+        if (fstat(fd, &fileStatus) == 0 && fileStatus.st_size > 0)
+        {
+            void* data = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                data_ = static_cast<const char*>(data);
+                size_ = fileStatus.st_size;
+            }
+        }
+        // The mapping stays valid after closing the file
+        close(fd);
+#else
+        GMX_UNUSED_VALUE(fileName);
+#endif
+    }
+    ~MappedTprFile()
+    {
+#if HAVE_MMAP
+        if (data_ != nullptr)
+        {
+            munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+    }
+    //! Returns the \p size bytes starting at \p offset, empty when they are not mapped.
+    gmx::ArrayRef<const char> bytes(gmx_off_t offset, int64_t size) const
+    {
+        if (data_ == nullptr || offset < 0 || size < 0
+            || static_cast<uint64_t>(offset) + static_cast<uint64_t>(size) > size_)
+        {
+            return {};
+        }
+        return { data_ + offset, data_ + offset + size };
+    }
+
+    GMX_DISALLOW_COPY_AND_ASSIGN(MappedTprFile);
+
+private:
+    //! Start of the mapping, or nullptr.
+    const char* data_ = nullptr;
+    //! Size of the mapping in bytes.
+    std::size_t size_ = 0;
+};
+
+} // namespace
+
 /*! \brief
  * Fill information into the header only from state before writing.
  *
@@ -3358,18 +3437,22 @@ static void doTpxBodyBuffer(gmx::ISerializer* serializer, gmx::ArrayRef<char> bu
  * Here the information from the serialization interface \p serializer
  * is used to first populate the datastructures containing the simulation
  * information. Depending on the version found in the header \p tpx,
- * this is done using the new reading of the data as one block from disk,
+ * this is done using the new reading of the data as one block,
  * followed by complete deserialization of the information read from there.
+ * That block is deserialized directly from a memory mapping of \p fileName
+ * when possible, otherwise it is first read from disk into a buffer.
  * Otherwise, the datastructures are populated as before one by one from disk.
  * The second version is the default for the legacy tools that read the
  * coordinates and velocities separate from the state.
  *
- * After reading in the data, a separate buffer is populated from them
- * containing only \p ir and \p mtop that can be communicated directly
- * to nodes needing the information to set up a simulation.
+ * The header of the returned struct describes \p ir and \p mtop for
+ * communication to other nodes, but its body is left empty, see
+ * serializeTprBodyForCommunication().
  *
  * \param[in] tpx The file header.
  * \param[in] serializer The Serialization interface used to read the TPR.
+ * \param[in] fio The file \p serializer reads from.
+ * \param[in] fileName The name of the file.
  * \param[out] ir Input rec to populate.
  * \param[out] state State vectors to populate.
  * \param[out] x Coordinates to populate if needed.
@@ -3378,24 +3461,43 @@ static void doTpxBodyBuffer(gmx::ISerializer* serializer, gmx::ArrayRef<char> bu
  *
  * \returns Partial de-serialized TPR used for communication to nodes.
  */
-static PartialDeserializedTprFile readTpxBody(TpxFileHeader*    tpx,
-                                              gmx::ISerializer* serializer,
-                                              t_inputrec*       ir,
-                                              t_state*          state,
-                                              rvec*             x,
-                                              rvec*             v,
-                                              gmx_mtop_t*       mtop)
+static PartialDeserializedTprFile readTpxBody(TpxFileHeader*               tpx,
+                                              gmx::ISerializer*            serializer,
+                                              t_fileio*                    fio,
+                                              const std::filesystem::path& fileName,
+                                              t_inputrec*                  ir,
+                                              t_state*                     state,
+                                              rvec*                        x,
+                                              rvec*                        v,
+                                              gmx_mtop_t*                  mtop)
 {
     PartialDeserializedTprFile partialDeserializedTpr;
     if (tpx->fileVersion >= tpxv_AddSizeField
         && tpx->fileGeneration >= static_cast<int>(TpxGeneration::AddSizeField))
     {
-        partialDeserializedTpr.body.resize(tpx->sizeOfTprBody);
-        partialDeserializedTpr.header = *tpx;
-        doTpxBodyBuffer(serializer, partialDeserializedTpr.body);
+        const MappedTprFile             mappedFile(fileName);
+        const gmx::ArrayRef<const char> mappedBody =
+                mappedFile.bytes(gmx_fio_ftell(fio), tpx->sizeOfTprBody);
+        if (!mappedBody.empty())
+        {
+            // See completeTprDeserialization() for the endianness
+            gmx::InMemoryDeserializer tprBodyDeserializer(
+                    mappedBody, tpx->isDouble, gmx::EndianSwapBehavior::SwapIfHostIsLittleEndian);
+            partialDeserializedTpr.pbcType =
+                    do_tpx_body(&tprBodyDeserializer, tpx, ir, state, x, v, mtop);
+        }
+        else
+        {
+            partialDeserializedTpr.body.resize(tpx->sizeOfTprBody);
+            partialDeserializedTpr.header = *tpx;
+            doTpxBodyBuffer(serializer, partialDeserializedTpr.body);
 
-        partialDeserializedTpr.pbcType =
-                completeTprDeserialization(&partialDeserializedTpr, ir, state, x, v, mtop);
+            partialDeserializedTpr.pbcType =
+                    completeTprDeserialization(&partialDeserializedTpr, ir, state, x, v, mtop);
+            // Release the file contents, they are no longer needed
+            partialDeserializedTpr.body.clear();
+            partialDeserializedTpr.body.shrink_to_fit();
+        }
     }
     else
     {
@@ -3403,17 +3505,8 @@ static PartialDeserializedTprFile readTpxBody(TpxFileHeader*    tpx,
     }
     // Update header to system info for communication to nodes.
     // As we only need to communicate the inputrec and mtop to other nodes,
-    // we prepare a new char buffer with the information we have already read
-    // in on main.
+    // the body for that is only serialized when it is actually communicated.
     partialDeserializedTpr.header = populateTpxHeader(*state, ir, mtop);
-    // Long-term we should move to use little endian in files to avoid extra byte swapping,
-    // but since we just used the default XDR format (which is big endian) for the TPR
-    // header it would cause third-party libraries reading our raw data to tear their hair
-    // if we swap the endian in the middle of the file, so we stick to big endian in the
-    // TPR file for now - and thus we ask the serializer to swap if this host is little endian.
-    gmx::InMemorySerializer tprBodySerializer(gmx::EndianSwapBehavior::SwapIfHostIsLittleEndian);
-    do_tpx_body(&tprBodySerializer, &partialDeserializedTpr.header, ir, mtop);
-    partialDeserializedTpr.body = tprBodySerializer.finishAndGetBuffer();
 
     return partialDeserializedTpr;
 }
@@ -3477,6 +3570,19 @@ void write_tpx_state(const std::filesystem::path& fn,
     close_tpx(fio);
 }
 
+void serializeTprBodyForCommunication(PartialDeserializedTprFile* partialDeserializedTpr,
+                                      const t_inputrec*           ir,
+                                      const gmx_mtop_t*           mtop)
+{
+    // See completeTprDeserialization() for the endianness
+    gmx::InMemorySerializer tprBodySerializer(gmx::EndianSwapBehavior::SwapIfHostIsLittleEndian);
+    do_tpx_body(&tprBodySerializer,
+                &partialDeserializedTpr->header,
+                const_cast<t_inputrec*>(ir),
+                const_cast<gmx_mtop_t*>(mtop));
+    partialDeserializedTpr->body = tprBodySerializer.finishAndGetBuffer();
+}
+
 PbcType completeTprDeserialization(PartialDeserializedTprFile* partialDeserializedTpr,
                                    t_inputrec*                 ir,
                                    t_state*                    state,
@@ -3510,8 +3616,8 @@ read_tpx_state(const std::filesystem::path& fn, t_inputrec* ir, t_state* state,
     gmx::FileIOXdrSerializer   serializer(fio);
     PartialDeserializedTprFile partialDeserializedTpr;
     do_tpxheader(&serializer, &partialDeserializedTpr.header, fn, fio, ir == nullptr);
-    partialDeserializedTpr =
-            readTpxBody(&partialDeserializedTpr.header, &serializer, ir, state, nullptr, nullptr, mtop);
+    partialDeserializedTpr = readTpxBody(
+            &partialDeserializedTpr.header, &serializer, fio, fn, ir, state, nullptr, nullptr, mtop);
     close_tpx(fio);
     return partialDeserializedTpr;
 }
@@ -3526,7 +3632,7 @@ PbcType read_tpx(const std::filesystem::path& fn, t_inputrec* ir, matrix box, in
     gmx::FileIOXdrSerializer serializer(fio);
     do_tpxheader(&serializer, &tpx, fn, fio, ir == nullptr);
     PartialDeserializedTprFile partialDeserializedTpr =
-            readTpxBody(&tpx, &serializer, ir, &state, x, v, mtop);
+            readTpxBody(&tpx, &serializer, fio, fn, ir, &state, x, v, mtop);
     close_tpx(fio);
     if (mtop != nullptr && natoms != nullptr)
     {
@@ -61,7 +61,9 @@
 #include "gromacs/fileio/tpxio.h"
 #include "gromacs/fileio/trrio.h"
 #include "gromacs/fileio/xdrf.h"
+#include "gromacs/fileio/xtcframeindex.h"
 #include "gromacs/fileio/xtcio.h"
+#include "gromacs/fileio/xtcreadahead.h"
 #include "gromacs/math/functions.h"
 #include "gromacs/math/vec.h"
 #include "gromacs/math/vectypes.h"
@@ -103,6 +105,7 @@ struct t_trxstatus
     gmx_tng_trajectory_t tng;
     int                  natoms;
     char*                persistent_line; /* Persistent line for reading g96 trajectories */
+    gmx::XtcReadAhead*   xtcReadAhead;    /* Decodes xtc frames ahead on other threads */
 #if GMX_USE_PLUGINS
     gmx_vmdplugin_t* vmdplugin;
 #endif
@@ -186,6 +189,33 @@ static void status_init(t_trxstatus* status)
     status->tf              = 0;
     status->persistent_line = nullptr;
     status->tng             = nullptr;
+    status->xtcReadAhead    = nullptr;
+}
+
+/* Stop reading ahead and leave the file positioned just after the last
+ * frame that was returned, so the file can be used directly again. */
+static void stopXtcReadAhead(t_trxstatus* status)
+{
+    if (status->xtcReadAhead != nullptr)
+    {
+        gmx_fio_seek(status->fio, status->xtcReadAhead->nextOffset());
+        delete status->xtcReadAhead;
+        status->xtcReadAhead = nullptr;
+    }
+}
+
+/* Start decoding frames on other threads when requested by the user */
+static void startXtcReadAhead(t_trxstatus* status, int natoms)
+{
+    const int numThreads = gmx::XtcReadAhead::numThreadsRequested();
+    if (status->xtcReadAhead == nullptr && numThreads > 0)
+    {
+        status->xtcReadAhead = new gmx::XtcReadAhead(gmx_fio_getname(status->fio),
+                                                     natoms,
+                                                     gmx_fio_ftell(status->fio),
+                                                     gmx_fio_get_xtc_frame_index(status->fio),
+                                                     numThreads);
+    }
 }
 
 
@@ -254,6 +284,8 @@ real ndec2prec(int ndec)
 
 t_fileio* trx_get_fileio(t_trxstatus* status)
 {
+    /* The caller might access the file directly */
+    stopXtcReadAhead(status);
     return status->fio;
 }
 
@@ -264,7 +296,13 @@ float trx_get_time_of_final_frame(t_trxstatus* status)
     gmx_bool  bOK;
     float     lasttime = -1;
 
-    if (filetype == efXTC)
+    const gmx::XtcFrameIndex* xtcFrameIndex = gmx_fio_get_xtc_frame_index(stfio);
+
+    if (filetype == efXTC && xtcFrameIndex != nullptr && xtcFrameIndex->numFrames() > 0)
+    {
+        lasttime = xtcFrameIndex->entries().back().time;
+    }
+    else if (filetype == efXTC)
     {
         lasttime = xdr_xtc_get_last_frame_time(
                 gmx_fio_getfp(stfio), gmx_fio_getxdr(stfio), status->natoms, &bOK);
@@ -655,6 +693,7 @@ void close_trx(t_trxstatus* status)
         return;
     }
     gmx_tng_close(&status->tng);
+    delete status->xtcReadAhead;
     if (status->fio)
     {
         gmx_fio_close(status->fio);
@@ -872,6 +911,7 @@ bool read_next_frame(const gmx_output_env_t* oenv, t_trxstatus* status, t_trxfra
             case efXTC:
                 if (startTime.has_value() && (status->tf < startTime.value()))
                 {
+                    stopXtcReadAhead(status);
                     if (xtc_seek_time(status->fio, startTime.value(), fr->natoms, TRUE))
                     {
                         gmx_fatal(FARGS,
@@ -881,9 +921,18 @@ bool read_next_frame(const gmx_output_env_t* oenv, t_trxstatus* status, t_trxfra
                     }
                     initcount(status);
                 }
-                bRet      = (read_next_xtc(
-                                status->fio, fr->natoms, &fr->step, &fr->time, fr->box, fr->x, &fr->prec, &bOK)
-                        != 0);
+                startXtcReadAhead(status, fr->natoms);
+                if (status->xtcReadAhead != nullptr)
+                {
+                    bRet = (status->xtcReadAhead->readNextFrame(&fr->step, &fr->time, fr->box, fr->x, &fr->prec, &bOK)
+                            != 0);
+                }
+                else
+                {
+                    bRet = (read_next_xtc(
+                                    status->fio, fr->natoms, &fr->step, &fr->time, fr->box, fr->x, &fr->prec, &bOK)
+                            != 0);
+                }
                 fr->bPrec = (bRet && fr->prec > 0);
                 fr->bStep = bRet;
                 fr->bTime = bRet;
@@ -1153,6 +1202,7 @@ gmx_bool read_next_x(const gmx_output_env_t* oenv, t_trxstatus* status, real* t,
 void rewind_trj(t_trxstatus* status)
 {
     initcount(status);
+    stopXtcReadAhead(status);
 
     gmx_fio_rewind(status->fio);
 }
@@ -36,6 +36,7 @@
 
 #include "config.h"
 
+#include <cstddef>
 #include <cstdio>
 
 #include "gromacs/utility/basedefinitions.h"
@@ -76,6 +77,16 @@
 /* Read or write reduced precision *float* coordinates */
 int xdr3dfcoord(XDR* xdrs, float* fp, int* size, float* precision, int magic_number);
 
+/* Convert n float coordinates to the nearest integer multiples of 1/precision,
+ * rounding halfway cases away from zero, as done for xtc compression.
+ * Uses SIMD when available, with bit-identical results to the scalar code.
+ * Returns FALSE if any scaled value does not fit in an int.
+ */
+bool xtc_quantize_coordinates(const float* fp, std::size_t n, float precision, int* ip);
+
+/* Convert n integer coordinates back to float by multiplying with inv_precision */
+void xtc_dequantize_coordinates(const int* ip, std::size_t n, float inv_precision, float* fp);
+
 
 /* Read or write a *real* value (stored as float) */
 int xdr_real(XDR* xdrs, real* r);
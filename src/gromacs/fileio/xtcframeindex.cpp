@@ -0,0 +1,358 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the persistent frame-offset index for XTC trajectory files.
+ *
+ * \ingroup module_fileio
+ */
+#include "gmxpre.h"
+
+#include "xtcframeindex.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+#include "gromacs/fileio/xdrf.h"
+#include "gromacs/utility/classhelpers.h"
+#include "gromacs/utility/gmxassert.h"
+
+namespace gmx
+{
+
+namespace
+{
+
+//! Magic number identifying XTC frame index files ("XTCI").
+constexpr int c_xtcFrameIndexMagic = 0x58544349;
+//! Version of the XTC frame index file format.
+constexpr int c_xtcFrameIndexVersion = 1;
+//! Size in bytes of an XDR int.
+constexpr gmx_off_t c_xdrIntSize = 4;
+//! Size of the frame header holding magic number, atom count, step and time.
+constexpr gmx_off_t c_frameHeaderSize = 4 * c_xdrIntSize;
+//! Offset of the repeated atom count, after the header and the box.
+constexpr gmx_off_t c_frameAtomCountOffset = c_frameHeaderSize + 9 * c_xdrIntSize;
+/*! \brief Offset of the compressed data size of frames with more than 9 atoms.
+ *
+ * Follows the atom count, the precision, the minimum and maximum
+ * integer coordinates and the smallidx value.
+ */
+constexpr gmx_off_t c_frameDataSizeOffset = c_frameAtomCountOffset + 9 * c_xdrIntSize;
+
+//! Read or write the header of an index file.
+bool serializeIndexHeader(XDR* xdrs, int* magic, int* version, int* natoms)
+{
+    return xdr_int(xdrs, magic) != 0 && xdr_int(xdrs, version) != 0 && xdr_int(xdrs, natoms) != 0;
+}
+
+//! Read or write a single index entry.
+bool serializeIndexEntry(XDR* xdrs, XtcFrameIndexEntry* entry)
+{
+    int64_t offset = entry->offset;
+    int64_t size   = entry->size;
+    bool    ok     = xdr_int64(xdrs, &offset) != 0 && xdr_int64(xdrs, &size) != 0
+              && xdr_int64(xdrs, &entry->step) != 0 && xdr_float(xdrs, &entry->time) != 0;
+    entry->offset = offset;
+    entry->size   = size;
+    return ok;
+}
+
+/*! \brief Determine the size of the XTC frame starting at \p offset.
+ *
+ * Returns 0 when there is no complete, valid frame with \p natoms
+ * atoms at \p offset.
+ */
+gmx_off_t xtcFrameSize(FILE*               fp,
+                       XDR*                xdrs,
+                       gmx_off_t           offset,
+                       gmx_off_t           fileSize,
+                       int                 natoms,
+                       XtcFrameIndexEntry* entry)
+{
+    if (offset + c_frameAtomCountOffset + c_xdrIntSize > fileSize
+        || gmx_fseek(fp, offset, SEEK_SET) != 0)
+    {
+        return 0;
+    }
+    int   magic       = 0;
+    int   frameNatoms = 0;
+    int   step        = 0;
+    float time        = 0;
+    if (xdr_int(xdrs, &magic) == 0 || (magic != XTC_MAGIC && magic != XTC_NEW_MAGIC)
+        || xdr_int(xdrs, &frameNatoms) == 0 || frameNatoms != natoms || xdr_int(xdrs, &step) == 0
+        || xdr_float(xdrs, &time) == 0)
+    {
+        return 0;
+    }
+    int coordinateCount = 0;
+    if (gmx_fseek(fp, offset + c_frameAtomCountOffset, SEEK_SET) != 0
+        || xdr_int(xdrs, &coordinateCount) == 0 || coordinateCount != natoms)
+    {
+        return 0;
+    }
+
+    gmx_off_t size = 0;
+    if (natoms <= 9)
+    {
+        // Tiny systems store their coordinates uncompressed
+        size = c_frameAtomCountOffset + c_xdrIntSize + 3 * natoms * c_xdrIntSize;
+    }
+    else
+    {
+        if (gmx_fseek(fp, offset + c_frameDataSizeOffset, SEEK_SET) != 0)
+        {
+            return 0;
+        }
+        int64_t dataSize = 0;
+        if (magic == XTC_NEW_MAGIC)
+        {
+            if (xdr_int64(xdrs, &dataSize) == 0)
+            {
+                return 0;
+            }
+            size = c_frameDataSizeOffset + 2 * c_xdrIntSize;
+        }
+        else
+        {
+            int intDataSize = 0;
+            if (xdr_int(xdrs, &intDataSize) == 0)
+            {
+                return 0;
+            }
+            dataSize = intDataSize;
+            size     = c_frameDataSizeOffset + c_xdrIntSize;
+        }
+        if (dataSize < 0)
+        {
+            return 0;
+        }
+        // XDR opaque data is padded to a multiple of four bytes
+        size += ((dataSize + c_xdrIntSize - 1) / c_xdrIntSize) * c_xdrIntSize;
+    }
+    if (offset + size > fileSize)
+    {
+        return 0;
+    }
+    entry->offset = offset;
+    entry->size   = size;
+    entry->step   = step;
+    entry->time   = time;
+    return size;
+}
+
+} // namespace
+
+/*! \internal \brief
+ * Sidecar file a persistent index appends its entries to.
+ */
+class XtcFrameIndex::Impl
+{
+public:
+    //! Take ownership of open file \p fp.
+    explicit Impl(FILE* fp) : fp_(fp) { xdrstdio_create(&xdr_, fp_, XDR_ENCODE); }
+    ~Impl()
+    {
+        xdr_destroy(&xdr_);
+        std::fclose(fp_);
+    }
+    GMX_DISALLOW_COPY_AND_ASSIGN(Impl);
+
+    //! Write a single entry and flush it to the file.
+    bool write(XtcFrameIndexEntry entry)
+    {
+        return serializeIndexEntry(&xdr_, &entry) && std::fflush(fp_) == 0;
+    }
+
+    //! The sidecar file.
+    FILE* fp_;
+    //! XDR stream writing to the sidecar file.
+    XDR xdr_;
+};
+
+XtcFrameIndex::XtcFrameIndex(int natoms) : natoms_(natoms) {}
+
+XtcFrameIndex::~XtcFrameIndex() = default;
+
+XtcFrameIndex::XtcFrameIndex(XtcFrameIndex&& other) noexcept = default;
+
+XtcFrameIndex& XtcFrameIndex::operator=(XtcFrameIndex&& other) noexcept = default;
+
+std::filesystem::path XtcFrameIndex::indexFileName(const std::filesystem::path& xtcFileName)
+{
+    auto fileName = xtcFileName;
+    fileName.concat(".idx");
+    return fileName;
+}
+
+gmx_off_t XtcFrameIndex::endOffset(gmx_off_t startOffset) const
+{
+    return entries_.empty() ? startOffset : entries_.back().offset + entries_.back().size;
+}
+
+void XtcFrameIndex::addFrame(const XtcFrameIndexEntry& entry)
+{
+    GMX_ASSERT(entries_.empty() || entry.offset == endOffset(),
+               "XTC frames should be added to the index in file order");
+    if (!entries_.empty() && entry.time < entries_.back().time)
+    {
+        timesAreMonotonic_ = false;
+    }
+    entries_.push_back(entry);
+    if (impl_ && !impl_->write(entry))
+    {
+        // Stop maintaining a sidecar file that can no longer be written
+        impl_.reset();
+    }
+}
+
+void XtcFrameIndex::truncate(gmx_off_t fileSize)
+{
+    while (!entries_.empty() && entries_.back().offset + entries_.back().size > fileSize)
+    {
+        entries_.pop_back();
+    }
+}
+
+std::optional<int64_t> XtcFrameIndex::findFrameForTime(real time, gmx_off_t minimumOffset) const
+{
+    const auto startsBefore = [](const XtcFrameIndexEntry& entry, gmx_off_t offset) {
+        return entry.offset < offset;
+    };
+    const auto first = std::lower_bound(entries_.begin(), entries_.end(), minimumOffset, startsBefore);
+    const auto isEarlier = [time](const XtcFrameIndexEntry& entry) { return entry.time < time; };
+    const auto found = timesAreMonotonic_ ? std::partition_point(first, entries_.end(), isEarlier)
+                                          : std::find_if_not(first, entries_.end(), isEarlier);
+    if (found == entries_.end())
+    {
+        return std::nullopt;
+    }
+    return (found == first ? found : found - 1) - entries_.begin();
+}
+
+bool XtcFrameIndex::persistTo(const std::filesystem::path& fileName)
+{
+    impl_.reset();
+    FILE* fp = std::fopen(fileName.string().c_str(), "wb");
+    if (fp == nullptr)
+    {
+        return false;
+    }
+    auto impl    = std::make_unique<Impl>(fp);
+    int  magic   = c_xtcFrameIndexMagic;
+    int  version = c_xtcFrameIndexVersion;
+    int  natoms  = natoms_;
+    bool ok      = serializeIndexHeader(&impl->xdr_, &magic, &version, &natoms);
+    for (auto entry : entries_)
+    {
+        ok = ok && serializeIndexEntry(&impl->xdr_, &entry);
+    }
+    if (!ok || std::fflush(fp) != 0)
+    {
+        return false;
+    }
+    impl_ = std::move(impl);
+    return true;
+}
+
+std::optional<XtcFrameIndex> readXtcFrameIndex(const std::filesystem::path& fileName, int natoms)
+{
+    FILE* fp = std::fopen(fileName.string().c_str(), "rb");
+    if (fp == nullptr)
+    {
+        return std::nullopt;
+    }
+    XDR xdrs;
+    xdrstdio_create(&xdrs, fp, XDR_DECODE);
+
+    std::optional<XtcFrameIndex> index;
+    int                          magic       = 0;
+    int                          version     = 0;
+    int                          indexNatoms = 0;
+    if (serializeIndexHeader(&xdrs, &magic, &version, &indexNatoms) && magic == c_xtcFrameIndexMagic
+        && version == c_xtcFrameIndexVersion && indexNatoms == natoms)
+    {
+        index.emplace(natoms);
+        XtcFrameIndexEntry entry;
+        while (serializeIndexEntry(&xdrs, &entry))
+        {
+            if (entry.size <= 0 || (index->numFrames() > 0 && entry.offset != index->endOffset()))
+            {
+                index.reset();
+                break;
+            }
+            index->addFrame(entry);
+        }
+    }
+    xdr_destroy(&xdrs);
+    std::fclose(fp);
+    return index;
+}
+
+gmx_off_t scanXtcFrames(FILE*          fp,
+                        XDR*           xdrs,
+                        gmx_off_t      startOffset,
+                        XtcFrameIndex* index,
+                        int64_t        maxFrames)
+{
+    const gmx_off_t savedPosition = gmx_ftell(fp);
+    if (savedPosition < 0 || gmx_fseek(fp, 0, SEEK_END) != 0)
+    {
+        return -1;
+    }
+    const gmx_off_t fileSize = gmx_ftell(fp);
+    if (fileSize < 0)
+    {
+        return -1;
+    }
+
+    gmx_off_t          offset = index->endOffset(startOffset);
+    XtcFrameIndexEntry entry;
+    for (int64_t frame = 0; (maxFrames < 0 || frame < maxFrames)
+                            && xtcFrameSize(fp, xdrs, offset, fileSize, index->natoms(), &entry) > 0;
+         frame++)
+    {
+        index->addFrame(entry);
+        offset += entry.size;
+    }
+
+    if (gmx_fseek(fp, savedPosition, SEEK_SET) != 0)
+    {
+        return -1;
+    }
+    return offset;
+}
+
+} // namespace gmx
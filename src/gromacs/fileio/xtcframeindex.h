@@ -0,0 +1,182 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \libinternal \file
+ * \brief
+ * Declares a persistent frame-offset index for XTC trajectory files.
+ *
+ * The XTC format has no frame table, so seeking to a given time normally
+ * requires bisecting the file and re-parsing frame headers. The index
+ * stores the byte offset, size, step and time of every frame in a small
+ * sidecar file next to the trajectory, which turns seeks and frame counts
+ * into a lookup.
+ *
+ * \inlibraryapi
+ * \ingroup module_fileio
+ */
+#ifndef GMX_FILEIO_XTCFRAMEINDEX_H
+#define GMX_FILEIO_XTCFRAMEINDEX_H
+
+#include <cstdint>
+#include <cstdio>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "gromacs/fileio/xdrf.h"
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/futil.h"
+#include "gromacs/utility/real.h"
+
+namespace gmx
+{
+
+//! Location and identification of a single frame in an XTC file.
+struct XtcFrameIndexEntry
+{
+    //! Byte offset of the start of the frame header.
+    gmx_off_t offset;
+    //! Size of the frame in bytes, including the header.
+    gmx_off_t size;
+    //! MD step stored in the frame header.
+    int64_t step;
+    //! Time stored in the frame header.
+    float time;
+};
+
+/*! \libinternal \brief
+ * Frame-offset table for an XTC file, optionally backed by a sidecar file.
+ *
+ * Entries are always contiguous, i.e. each frame starts where the
+ * previous one ended. This makes it possible to detect both stale
+ * indices and trajectories that were extended without updating the
+ * index.
+ */
+class XtcFrameIndex
+{
+public:
+    //! Construct an empty index for a trajectory with \p natoms atoms.
+    explicit XtcFrameIndex(int natoms);
+    ~XtcFrameIndex();
+    //! Move constructor.
+    XtcFrameIndex(XtcFrameIndex&& other) noexcept;
+    //! Move assignment.
+    XtcFrameIndex& operator=(XtcFrameIndex&& other) noexcept;
+
+    //! Return the name of the index sidecar file for \p xtcFileName.
+    static std::filesystem::path indexFileName(const std::filesystem::path& xtcFileName);
+
+    //! Number of atoms in the frames of the indexed trajectory.
+    int natoms() const { return natoms_; }
+    //! Number of indexed frames.
+    int64_t numFrames() const { return static_cast<int64_t>(entries_.size()); }
+    //! Return the indexed frames.
+    ArrayRef<const XtcFrameIndexEntry> entries() const { return entries_; }
+    //! Byte offset just past the last indexed frame, or \p startOffset when empty.
+    gmx_off_t endOffset(gmx_off_t startOffset = 0) const;
+
+    /*! \brief Add a frame directly following the last indexed one.
+     *
+     * When the index is persistent, the entry is also appended to the
+     * sidecar file.
+     */
+    void addFrame(const XtcFrameIndexEntry& entry);
+
+    //! Remove all frames that do not end at or before \p fileSize.
+    void truncate(gmx_off_t fileSize);
+
+    /*! \brief Return the index of the frame from which reading should
+     * start to find the first frame with time at or after \p time.
+     *
+     * Only frames starting at or after \p minimumOffset are considered.
+     * The returned frame is the one preceding the first frame not
+     * earlier than \p time, so that callers applying their own time
+     * comparison never miss a frame because of rounding. Returns an
+     * empty optional if no such frame exists.
+     */
+    std::optional<int64_t> findFrameForTime(real time, gmx_off_t minimumOffset) const;
+
+    /*! \brief Store the index in \p fileName and keep it updated.
+     *
+     * Writes the header and all current entries, and appends every
+     * frame added later. Any previous content of the file is replaced.
+     *
+     * \returns Whether the file could be written. On failure the index
+     *          stays usable in memory, but is not persisted.
+     */
+    bool persistTo(const std::filesystem::path& fileName);
+
+private:
+    //! Implementation type for the persistent sidecar file.
+    class Impl;
+
+    //! Number of atoms per frame.
+    int natoms_;
+    //! Indexed frames, in file order.
+    std::vector<XtcFrameIndexEntry> entries_;
+    //! Whether the frame times never decrease, which allows bisection.
+    bool timesAreMonotonic_ = true;
+    //! Sidecar file the index is appended to, when persistent.
+    std::unique_ptr<Impl> impl_;
+};
+
+/*! \brief Read an index sidecar file.
+ *
+ * Returns an empty optional when the file does not exist, when it
+ * was not written for \p natoms atoms, or when it is malformed.
+ * A trailing partially written entry is ignored.
+ */
+std::optional<XtcFrameIndex> readXtcFrameIndex(const std::filesystem::path& fileName, int natoms);
+
+/*! \brief Extend \p index by scanning the frames of an XTC file.
+ *
+ * Starts at the end of the last indexed frame, or at \p startOffset
+ * when the index is empty, and stops at the end of the file or at the
+ * first incomplete or malformed frame, or after \p maxFrames frames
+ * when that is not negative. Only the frame headers and the sizes of
+ * the compressed coordinate blocks are read, the coordinates themselves
+ * are skipped. The position of \p fp is restored.
+ *
+ * \returns The byte offset where scanning stopped, or -1 on I/O errors.
+ */
+gmx_off_t scanXtcFrames(FILE*          fp,
+                        XDR*           xdrs,
+                        gmx_off_t      startOffset,
+                        XtcFrameIndex* index,
+                        int64_t        maxFrames = -1);
+
+} // namespace gmx
+
+#endif
@@ -36,11 +36,17 @@
 #include "xtcio.h"
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
+#include <filesystem>
+#include <memory>
+#include <system_error>
+
 #include "gromacs/fileio/gmxfio.h"
 #include "gromacs/fileio/gmxfio_xdr.h"
 #include "gromacs/fileio/xdrf.h"
+#include "gromacs/fileio/xtcframeindex.h"
 #include "gromacs/math/vec.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
@@ -69,6 +75,135 @@ static int xdr_r2f(XDR* xdrs, real* r, gmx_bool gmx_unused bRead)
 #endif
 }
 
+/*! \brief Whether xtc frame index sidecar files should be maintained
+ *
+ * When set, write_xtc keeps an index file next to the trajectory up to
+ * date and read_first_xtc builds one when it is missing or stale.
+ * Existing valid index files are always used for seeking.
+ */
+static bool xtcFrameIndexRequested()
+{
+    /* Called for every written frame, so only query the environment once */
+    static const bool requested = (std::getenv("GMX_XTC_FRAME_INDEX") != nullptr);
+
+    return requested;
+}
+
+/* Add the frame that was just written at frameStart to the frame index
+ * of fio, creating or continuing the index file on the first frame.
+ */
+static void updateWriterFrameIndex(t_fileio* fio, int natoms, int64_t step, real time, gmx_off_t frameStart)
+{
+    gmx::XtcFrameIndex* index = gmx_fio_get_xtc_frame_index(fio);
+    if (index == nullptr)
+    {
+        const auto indexFileName = gmx::XtcFrameIndex::indexFileName(gmx_fio_getname(fio));
+        auto       newIndex      = std::make_unique<gmx::XtcFrameIndex>(natoms);
+        if (frameStart > 0)
+        {
+            /* We are appending, continue the existing index if it
+             * covers exactly the frames that are already present */
+            auto oldIndex = gmx::readXtcFrameIndex(indexFileName, natoms);
+            if (oldIndex.has_value())
+            {
+                oldIndex->truncate(frameStart);
+                if (oldIndex->numFrames() > 0 && oldIndex->endOffset() == frameStart)
+                {
+                    *newIndex = std::move(oldIndex.value());
+                }
+            }
+        }
+        if ((frameStart == 0 || newIndex->numFrames() > 0) && newIndex->persistTo(indexFileName))
+        {
+            index = newIndex.get();
+        }
+        else
+        {
+            /* Make sure readers do not pick up a stale index */
+            std::error_code errorCode;
+            std::filesystem::remove(indexFileName, errorCode);
+            newIndex = std::make_unique<gmx::XtcFrameIndex>(natoms);
+        }
+        gmx_fio_set_xtc_frame_index(fio, std::move(newIndex));
+        if (index == nullptr)
+        {
+            return;
+        }
+    }
+    const gmx_off_t frameEnd = gmx_fio_ftell(fio);
+    if (index->natoms() == natoms && index->endOffset(frameStart) == frameStart
+        && frameEnd > frameStart)
+    {
+        index->addFrame({ frameStart, frameEnd - frameStart, step, static_cast<float>(time) });
+    }
+}
+
+/* Attach a frame index to fio, which is open for reading and has its
+ * first frame starting at frameStart. An existing index file is
+ * validated against the trajectory and extended when the trajectory
+ * has grown. When requested, a missing or stale index is rebuilt.
+ */
+static void attachReaderFrameIndex(t_fileio* fio, int natoms, gmx_off_t frameStart)
+{
+    if (gmx_fio_get_xtc_frame_index(fio) != nullptr || frameStart < 0)
+    {
+        return;
+    }
+    FILE*      fp            = gmx_fio_getfp(fio);
+    XDR*       xd            = gmx_fio_getxdr(fio);
+    const auto indexFileName = gmx::XtcFrameIndex::indexFileName(gmx_fio_getname(fio));
+    auto       index         = gmx::readXtcFrameIndex(indexFileName, natoms);
+    bool       bUpdateFile   = false;
+    if (index.has_value() && index->numFrames() > 0 && index->entries()[0].offset == frameStart)
+    {
+        /* Re-scan the last indexed frame, which verifies that it matches
+         * the trajectory, and pick up any frames written after it. */
+        const int64_t                  numIndexedFrames = index->numFrames();
+        const gmx::XtcFrameIndexEntry lastFrame        = index->entries().back();
+        index->truncate(lastFrame.offset);
+        gmx::scanXtcFrames(fp, xd, frameStart, &index.value());
+        if (index->numFrames() < numIndexedFrames)
+        {
+            index.reset();
+        }
+        else
+        {
+            const gmx::XtcFrameIndexEntry& rescannedFrame = index->entries()[numIndexedFrames - 1];
+            if (rescannedFrame.size != lastFrame.size || rescannedFrame.step != lastFrame.step
+                || rescannedFrame.time != lastFrame.time)
+            {
+                index.reset();
+            }
+            else
+            {
+                bUpdateFile = (index->numFrames() > numIndexedFrames);
+            }
+        }
+    }
+    else
+    {
+        index.reset();
+    }
+
+    if (!index.has_value() && xtcFrameIndexRequested())
+    {
+        index.emplace(natoms);
+        if (gmx::scanXtcFrames(fp, xd, frameStart, &index.value()) < 0 || index->numFrames() == 0)
+        {
+            index.reset();
+        }
+        bUpdateFile = true;
+    }
+    if (!index.has_value())
+    {
+        return;
+    }
+    if (bUpdateFile && xtcFrameIndexRequested() && !index->persistTo(indexFileName) && debug)
+    {
+        fprintf(debug, "Could not write xtc frame index file '%s'\n", indexFileName.string().c_str());
+    }
+    gmx_fio_set_xtc_frame_index(fio, std::make_unique<gmx::XtcFrameIndex>(std::move(index.value())));
+}
 
 t_fileio* open_xtc(const std::filesystem::path& fn, const char* mode)
 {
@@ -214,7 +349,8 @@ int write_xtc(t_fileio* fio, int natoms, int64_t step, real time, const rvec* bo
         return 1;
     }
 
-    xd = gmx_fio_getxdr(fio);
+    const gmx_off_t frameStart = gmx_fio_ftell(fio);
+    xd                         = gmx_fio_getxdr(fio);
     /* write magic number and xtc identidier */
     if (xtc_header(xd, &magic_number, &natoms, &step, &time, FALSE, &bDum) == 0)
     {
@@ -231,6 +367,10 @@ int write_xtc(t_fileio* fio, int natoms, int64_t step, real time, const rvec* bo
             bOK = 0;
         }
     }
+    if (bOK && xtcFrameIndexRequested())
+    {
+        updateWriterFrameIndex(fio, natoms, step, time, frameStart);
+    }
     return bOK; /* 0 if bad, 1 if writing went well */
 }
 
@@ -239,8 +379,9 @@ int read_first_xtc(t_fileio* fio, int* natoms, int64_t* step, real* time, matrix
     int  magic;
     XDR* xd;
 
-    *bOK = TRUE;
-    xd   = gmx_fio_getxdr(fio);
+    *bOK                       = TRUE;
+    xd                         = gmx_fio_getxdr(fio);
+    const gmx_off_t frameStart = gmx_fio_ftell(fio);
 
     /* read header and malloc x */
     if (!xtc_header(xd, &magic, natoms, step, time, TRUE, bOK))
@@ -255,6 +396,11 @@ int read_first_xtc(t_fileio* fio, int* natoms, int64_t* step, real* time, matrix
 
     *bOK = (xtc_coord(xd, natoms, box, *x, prec, magic, TRUE) != 0);
 
+    if (*bOK)
+    {
+        attachReaderFrameIndex(fio, *natoms, frameStart);
+    }
+
     return static_cast<int>(*bOK);
 }
 
@@ -0,0 +1,259 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the multi-threaded read-ahead pipeline for XTC trajectories.
+ *
+ * \ingroup module_fileio
+ */
+#include "gmxpre.h"
+
+#include "xtcreadahead.h"
+
+#include <cstdlib>
+
+#include <algorithm>
+
+#include "gromacs/fileio/gmxfio.h"
+#include "gromacs/fileio/gmxfio_xdr.h"
+#include "gromacs/fileio/xtcio.h"
+#include "gromacs/math/vec.h"
+#include "gromacs/utility/gmxassert.h"
+
+namespace gmx
+{
+
+namespace
+{
+
+//! Number of frames that are buffered per decoding thread.
+constexpr int c_framesPerThread = 2;
+
+} // namespace
+
+XtcReadAhead::XtcReadAhead(const std::filesystem::path& fileName,
+                           int                          natoms,
+                           gmx_off_t                    startOffset,
+                           const XtcFrameIndex*         knownFrames,
+                           int                          numThreads) :
+    natoms_(natoms), startOffset_(startOffset), frames_(natoms)
+{
+    GMX_RELEASE_ASSERT(numThreads > 0, "Need at least one thread for reading ahead");
+
+    if (knownFrames != nullptr && knownFrames->natoms() == natoms)
+    {
+        for (const auto& entry : knownFrames->entries())
+        {
+            if (entry.offset >= startOffset && entry.offset == frames_.endOffset(startOffset))
+            {
+                frames_.addFrame(entry);
+            }
+        }
+    }
+    // Frames beyond the end of the index, if any, are located by scanning
+    scanFile_ = open_xtc(fileName, "r");
+
+    slots_.resize(c_framesPerThread * numThreads);
+    for (auto& slot : slots_)
+    {
+        slot.x.resize(natoms_);
+    }
+    for (int thread = 0; thread < numThreads; thread++)
+    {
+        workerFiles_.push_back(open_xtc(fileName, "r"));
+    }
+    for (t_fileio* fio : workerFiles_)
+    {
+        workers_.emplace_back([this, fio]() { decodeFrames(fio); });
+    }
+}
+
+XtcReadAhead::~XtcReadAhead()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+    for (t_fileio* fio : workerFiles_)
+    {
+        close_xtc(fio);
+    }
+    if (scanFile_ != nullptr)
+    {
+        close_xtc(scanFile_);
+    }
+}
+
+int XtcReadAhead::numThreadsRequested()
+{
+    const char* env = std::getenv("GMX_XTC_READ_THREADS");
+    return (env != nullptr) ? std::max(0, std::atoi(env)) : 0;
+}
+
+bool XtcReadAhead::locateFrame(int64_t frame)
+{
+    if (frame < frames_.numFrames())
+    {
+        return true;
+    }
+    if (!allFramesLocated_)
+    {
+        // Locate a batch of frames at once to limit the time the lock is held per frame
+        const int64_t numFramesToLocate = frame - frames_.numFrames() + gmx::ssize(slots_);
+        const int64_t numFramesBefore   = frames_.numFrames();
+        scanXtcFrames(gmx_fio_getfp(scanFile_),
+                      gmx_fio_getxdr(scanFile_),
+                      startOffset_,
+                      &frames_,
+                      numFramesToLocate);
+        // A scan that stops early has reached the end of the file, or a truncated
+        // or corrupt frame that readNextFrame() leaves to read_next_xtc()
+        allFramesLocated_ = (frames_.numFrames() - numFramesBefore < numFramesToLocate);
+    }
+    return frame < frames_.numFrames();
+}
+
+void XtcReadAhead::decodeFrames(t_fileio* fio)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        const int64_t numSlots = gmx::ssize(slots_);
+        condition_.wait(lock, [this, numSlots]() {
+            return stop_ || nextFrameToDecode_ < numFramesReturned_ + numSlots;
+        });
+        if (stop_)
+        {
+            return;
+        }
+        const int64_t frame = nextFrameToDecode_;
+        if (!locateFrame(frame))
+        {
+            // Wake up the caller waiting for a frame that does not exist
+            condition_.notify_all();
+            return;
+        }
+        nextFrameToDecode_++;
+        const gmx_off_t offset = frames_.entries()[frame].offset;
+        Slot&           slot   = slots_[frame % numSlots];
+        lock.unlock();
+
+        // The slot is not accessed by anyone else until it is marked as filled
+        int result;
+        if (gmx_fio_seek(fio, offset) == 0)
+        {
+            result = read_next_xtc(fio,
+                                   natoms_,
+                                   &slot.step,
+                                   &slot.time,
+                                   slot.box,
+                                   as_rvec_array(slot.x.data()),
+                                   &slot.prec,
+                                   &slot.bOK);
+        }
+        else
+        {
+            result   = 0;
+            slot.bOK = FALSE;
+        }
+
+        lock.lock();
+        slot.result = result;
+        slot.frame  = frame;
+        condition_.notify_all();
+    }
+}
+
+int XtcReadAhead::readNextFrame(int64_t* step, real* time, matrix box, rvec* x, real* prec, gmx_bool* bOK)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    const int64_t                frame = numFramesReturned_;
+    Slot&                        slot  = slots_[frame % gmx::ssize(slots_)];
+    condition_.wait(lock, [this, &slot, frame]() {
+        return slot.frame == frame || (allFramesLocated_ && frame >= frames_.numFrames());
+    });
+    if (slot.frame != frame)
+    {
+        /* No more frames could be located. Read the rest of the file as
+         * read_next_xtc() does without reading ahead, so a truncated or
+         * corrupt frame is reported instead of silently ending the trajectory. */
+        const gmx_off_t offset = frames_.endOffset(startOffset_);
+        if (gmx_fio_seek(scanFile_, offset) != 0)
+        {
+            *bOK = FALSE;
+            return 0;
+        }
+        const int result = read_next_xtc(scanFile_, natoms_, step, time, box, x, prec, bOK);
+        if (result != 0)
+        {
+            const gmx_off_t size = gmx_fio_ftell(scanFile_) - offset;
+            frames_.addFrame({ offset, size, *step, static_cast<float>(*time) });
+            // Keep the workers, if any are still running, away from this frame
+            nextFrameToDecode_ = frames_.numFrames();
+            numFramesReturned_++;
+        }
+        return result;
+    }
+
+    *step = slot.step;
+    *time = slot.time;
+    copy_mat(slot.box, box);
+    std::copy(slot.x.begin(), slot.x.end(), reinterpret_cast<RVec*>(x));
+    *prec = slot.prec;
+    *bOK  = slot.bOK;
+
+    const int result = slot.result;
+    slot.frame       = -1;
+    numFramesReturned_++;
+    condition_.notify_all();
+    return result;
+}
+
+gmx_off_t XtcReadAhead::nextOffset() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (numFramesReturned_ == 0)
+    {
+        return startOffset_;
+    }
+    const XtcFrameIndexEntry& lastFrame = frames_.entries()[numFramesReturned_ - 1];
+    return lastFrame.offset + lastFrame.size;
+}
+
+} // namespace gmx
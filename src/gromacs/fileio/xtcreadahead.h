@@ -0,0 +1,177 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \libinternal \file
+ * \brief
+ * Declares a multi-threaded read-ahead pipeline for XTC trajectories.
+ *
+ * \inlibraryapi
+ * \ingroup module_fileio
+ */
+#ifndef GMX_FILEIO_XTCREADAHEAD_H
+#define GMX_FILEIO_XTCREADAHEAD_H
+
+#include <cstdint>
+
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gromacs/fileio/xtcframeindex.h"
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/basedefinitions.h"
+#include "gromacs/utility/classhelpers.h"
+#include "gromacs/utility/futil.h"
+#include "gromacs/utility/real.h"
+
+struct t_fileio;
+
+namespace gmx
+{
+
+/*! \libinternal \brief
+ * Decodes the frames of an XTC file ahead of the caller on worker threads.
+ *
+ * Each worker thread opens the trajectory separately, so frames are
+ * read and decompressed concurrently while the caller processes the
+ * previously returned frames. Frame offsets are taken from an existing
+ * frame index when available, and are otherwise discovered by scanning
+ * frame headers a few frames ahead of the workers. At most \c depth
+ * decoded frames are buffered.
+ *
+ * Frames are returned strictly in file order, so the caller sees the
+ * same sequence as with read_next_xtc().
+ */
+class XtcReadAhead
+{
+public:
+    /*! \brief Start decoding frames of \p fileName from \p startOffset.
+     *
+     * \param[in] fileName    Name of the XTC file.
+     * \param[in] natoms      Number of atoms per frame.
+     * \param[in] startOffset Offset of the first frame to return.
+     * \param[in] knownFrames Frame index of the file to take offsets
+     *                        from, or nullptr.
+     * \param[in] numThreads  Number of decoding threads.
+     */
+    XtcReadAhead(const std::filesystem::path& fileName,
+                 int                          natoms,
+                 gmx_off_t                    startOffset,
+                 const XtcFrameIndex*         knownFrames,
+                 int                          numThreads);
+    //! Stops and joins the worker threads.
+    ~XtcReadAhead();
+    GMX_DISALLOW_COPY_MOVE_AND_ASSIGN(XtcReadAhead);
+
+    /*! \brief Number of decoding threads requested by the user.
+     *
+     * Set through the GMX_XTC_READ_THREADS environment variable,
+     * 0 means that read-ahead is disabled.
+     */
+    static int numThreadsRequested();
+
+    /*! \brief Return the next frame, with the semantics of read_next_xtc().
+     *
+     * Frames after the last frame that could be located, i.e. from a
+     * truncated or corrupt frame on, are read with read_next_xtc() on
+     * the calling thread.
+     *
+     * \returns 1 when a frame was read, 0 at the end of the trajectory
+     *          or when the frame could not be decoded, in which case
+     *          \p bOK is false.
+     */
+    int readNextFrame(int64_t* step, real* time, matrix box, rvec* x, real* prec, gmx_bool* bOK);
+
+    //! Offset just past the last frame returned by readNextFrame().
+    gmx_off_t nextOffset() const;
+
+private:
+    //! Buffer holding a single decoded frame.
+    struct Slot
+    {
+        //! Frame number held by the slot, -1 when empty.
+        int64_t frame = -1;
+        //! Return value of read_next_xtc().
+        int result = 0;
+        //! Step of the frame.
+        int64_t step = 0;
+        //! Time of the frame.
+        real time = 0;
+        //! Box of the frame.
+        matrix box = { { 0 } };
+        //! Coordinates of the frame.
+        std::vector<RVec> x;
+        //! Precision of the frame.
+        real prec = 0;
+        //! Whether the frame was read correctly.
+        gmx_bool bOK = TRUE;
+    };
+
+    //! Main loop of a worker decoding frames with \p fio.
+    void decodeFrames(t_fileio* fio);
+    //! Make sure the offset of \p frame is known, returns false after the last frame.
+    bool locateFrame(int64_t frame);
+
+    //! Number of atoms per frame.
+    int natoms_;
+    //! Offset of the first frame returned.
+    gmx_off_t startOffset_;
+    //! Offsets of the frames from the start offset on, grown on demand.
+    XtcFrameIndex frames_;
+    //! File used to discover frame offsets and to read frames that could not be located.
+    t_fileio* scanFile_ = nullptr;
+    //! Files used by the workers.
+    std::vector<t_fileio*> workerFiles_;
+    //! Decoded frames, frame i is stored in slot i modulo the number of slots.
+    std::vector<Slot> slots_;
+    //! Next frame to be claimed by a worker.
+    int64_t nextFrameToDecode_ = 0;
+    //! Number of frames returned to the caller.
+    int64_t numFramesReturned_ = 0;
+    //! Whether scanning for frames has stopped, at the end of the file or at a bad frame.
+    bool allFramesLocated_ = false;
+    //! Whether the workers should stop.
+    bool stop_ = false;
+    //! Protects all members above that are modified after construction.
+    mutable std::mutex mutex_;
+    //! Signals changes to the state of slots and frames.
+    std::condition_variable condition_;
+    //! The decoding threads.
+    std::vector<std::thread> workers_;
+};
+
+} // namespace gmx
+
+#endif
@@ -63,6 +63,7 @@
 #include "gromacs/utility/arraysize.h"
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/cstringutil.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
 #include "gromacs/utility/real.h"
@@ -3600,15 +3601,42 @@ int gmx_bar(int argc, char* argv[])
         nbmin = nbmax;
     }
 
-    /* first calculate results */
+    /* first calculate results, the pairs of neighboring lambda values are
+     * independent, so distribute them over threads. The block averages of
+     * each result are stored separately and added afterwards in the order
+     * of the results, so the sums do not depend on the threading.
+     */
     bEE      = TRUE;
     disc_err = FALSE;
+    const int           partsumSize = (nbmax + 1) * (nbmax + 1);
+    std::vector<double> resultPartsums(static_cast<size_t>(nresults) * partsumSize, 0.0);
+    std::vector<int>    resultHasErrorEstimate(nresults, TRUE);
+#pragma omp parallel for schedule(dynamic)
+    for (int r = 0; r < nresults; r++)
+    {
+        try
+        {
+            /* Determine the free energy difference with a factor of 10
+             * more accuracy than requested for printing.
+             */
+            gmx_bool bEEResult = TRUE;
+            calc_bar(&(results[r]),
+                     0.1 * prec,
+                     nbmin,
+                     nbmax,
+                     &bEEResult,
+                     resultPartsums.data() + static_cast<size_t>(r) * partsumSize);
+            resultHasErrorEstimate[r] = bEEResult;
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
     for (f = 0; f < nresults; f++)
     {
-        /* Determine the free energy difference with a factor of 10
-         * more accuracy than requested for printing.
-         */
-        calc_bar(&(results[f]), 0.1 * prec, nbmin, nbmax, &bEE, partsum);
+        for (int i = 0; i < partsumSize; i++)
+        {
+            partsum[i] += resultPartsums[static_cast<size_t>(f) * partsumSize + i];
+        }
+        bEE = bEE && resultHasErrorEstimate[f];
 
         if (results[f].dg_disc_err > prec / 10.)
         {
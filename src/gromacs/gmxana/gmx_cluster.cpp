@@ -74,6 +74,7 @@
 #include "gromacs/utility/arraysize.h"
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/cstringutil.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
 #include "gromacs/utility/gmxassert.h"
@@ -883,7 +884,7 @@ int gmx_cluster(int argc, char* argv[])
 
     matrix      box;
     matrix*     boxes = nullptr;
-    rvec *      xtps, *usextps, *x1, **xx = nullptr;
+    rvec *      xtps, *usextps, **xx = nullptr;
     const char *fn, *trx_out_fn;
     t_clusters  clust;
     t_mat *     rms, *orig = nullptr;
@@ -896,7 +897,7 @@ int gmx_cluster(int argc, char* argv[])
     int      isize = 0, ifsize = 0, iosize = 0;
     int *    index = nullptr, *fitidx = nullptr, *outidx = nullptr, *frameindices = nullptr;
     char*    grpname;
-    real     rmsd, **d1, **d2, *time = nullptr, time_invfac, *mass = nullptr;
+    real **  d1, **d2, *time = nullptr, time_invfac, *mass = nullptr;
     char     buf[STRLEN], buf1[80];
     gmx_bool bAnalyze, bUseRmsdCut, bJP_RMSD = FALSE, bReadMat, bReadTraj, bPBC = TRUE;
 
@@ -1256,22 +1257,34 @@ int gmx_cluster(int argc, char* argv[])
         if (!bRMSdist)
         {
             fprintf(stderr, "Computing %dx%d RMS deviation matrix\n", nf, nf);
-            /* Initialize work array */
-            snew(x1, isize);
+            /* The RMSDs of a row are computed in parallel and then stored
+             * in order, so the matrix sums do not depend on the threading.
+             */
+            std::vector<real> rmsdRow(nf);
             for (i1 = 0; i1 < nf; i1++)
             {
-                for (i2 = i1 + 1; i2 < nf; i2++)
+#pragma omp parallel
                 {
-                    for (i = 0; i < isize; i++)
-                    {
-                        copy_rvec(xx[i1][i], x1[i]);
-                    }
-                    if (bFit)
+                    try
                     {
-                        do_fit(isize, mass, xx[i2], x1);
+                        /* Initialize work array */
+                        std::vector<gmx::RVec> x1(isize);
+#pragma omp for schedule(dynamic)
+                        for (int j2 = i1 + 1; j2 < nf; j2++)
+                        {
+                            std::copy(xx[i1], xx[i1] + isize, x1.begin());
+                            if (bFit)
+                            {
+                                do_fit(isize, mass, xx[j2], as_rvec_array(x1.data()));
+                            }
+                            rmsdRow[j2] = rmsdev(isize, mass, xx[j2], as_rvec_array(x1.data()));
+                        }
                     }
-                    rmsd = rmsdev(isize, mass, xx[i2], x1);
-                    set_mat_entry(rms, i1, i2, rmsd);
+                    GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+                }
+                for (i2 = i1 + 1; i2 < nf; i2++)
+                {
+                    set_mat_entry(rms, i1, i2, rmsdRow[i2]);
                 }
                 nrms -= nf - i1 - 1;
                 fprintf(stderr,
@@ -1280,7 +1293,6 @@ int gmx_cluster(int argc, char* argv[])
                         nrms);
                 fflush(stderr);
             }
-            sfree(x1);
         }
         else /* bRMSdist */
         {
@@ -40,8 +40,10 @@
 #include <cstring>
 
 #include <algorithm>
+#include <array>
 #include <filesystem>
 #include <string>
+#include <vector>
 
 #include "gromacs/commandline/filenm.h"
 #include "gromacs/commandline/pargs.h"
@@ -112,6 +114,55 @@ void throwErrorIfIndexOutOfBounds(ArrayRef<const int> indices, const int numAtom
     }
 };
 
+//! The number of frames that are added to the covariance matrix together
+constexpr int c_covarFrameBlockSize = 16;
+
+/*! \brief Add the outer products of a block of frames to the covariance matrix
+ *
+ * Only the upper triangle of the matrix is updated. Summing over a block
+ * of frames before updating the matrix elements reduces the memory traffic
+ * on the matrix, which is much larger than the cache for large selections,
+ * by a factor of the block size.
+ *
+ * \param[in,out] mat       The ndim x ndim covariance matrix
+ * \param[in]     ndim      The dimension of the matrix, DIM times \p natoms
+ * \param[in]     natoms    The number of atoms per frame
+ * \param[in]     xBlock    Displacements of \p numFrames frames, stored frame after frame
+ * \param[in]     numFrames The number of frames in \p xBlock
+ */
+void addFrameBlockToCovariance(real*                mat,
+                               int64_t              ndim,
+                               int                  natoms,
+                               ArrayRef<const RVec> xBlock,
+                               int                  numFrames)
+{
+    std::array<real, c_covarFrameBlockSize> xj;
+    for (int j = 0; j < natoms; j++)
+    {
+        for (int dj = 0; dj < DIM; dj++)
+        {
+            for (int f = 0; f < numFrames; f++)
+            {
+                xj[f] = xBlock[f * natoms + j][dj];
+            }
+            const int64_t k = ndim * (DIM * j + dj);
+            for (int i = j; i < natoms; i++)
+            {
+                const int64_t l = k + DIM * i;
+                for (int d = 0; d < DIM; d++)
+                {
+                    real sum = 0;
+                    for (int f = 0; f < numFrames; f++)
+                    {
+                        sum += xBlock[f * natoms + i][d] * xj[f];
+                    }
+                    mat[l + d] += sum;
+                }
+            }
+        }
+    }
+}
+
 } // namespace
 
 } // namespace gmx
@@ -175,10 +226,10 @@ int gmx_covar(int argc, char* argv[])
     matrix            box, zerobox;
     real *            sqrtm, *mat, *eigenvalues, sum, trace, inv_nframes;
     real              t, tstart, tend, **mat2;
-    real              xj, *w_rls = nullptr;
+    real*             w_rls = nullptr;
     real              min, max, *axis;
     int               natoms, nat, nframes0, nframes, nlevels;
-    int64_t           ndim, i, j, k, l;
+    int64_t           ndim, i, j, k;
     int               WriteXref;
     const char *      fitfile, *trxfile, *ndxfile;
     const char *      eigvalfile, *eigvecfile, *averfile, *logfile;
@@ -376,6 +427,8 @@ int gmx_covar(int argc, char* argv[])
     nframes = 0;
     nat     = read_first_x(oenv, &status, trxfile, &t, &xread, box);
     tstart  = t;
+    std::vector<gmx::RVec> xBlock(gmx::c_covarFrameBlockSize * natoms);
+    int                    numFramesInBlock = 0;
     do
     {
         nframes++;
@@ -405,23 +458,15 @@ int gmx_covar(int argc, char* argv[])
             }
         }
 
-        for (j = 0; j < natoms; j++)
+        std::copy(x, x + natoms, xBlock.begin() + numFramesInBlock * natoms);
+        numFramesInBlock++;
+        if (numFramesInBlock == gmx::c_covarFrameBlockSize)
         {
-            for (dj = 0; dj < DIM; dj++)
-            {
-                k  = ndim * (DIM * j + dj);
-                xj = x[j][dj];
-                for (i = j; i < natoms; i++)
-                {
-                    l = k + DIM * i;
-                    for (d = 0; d < DIM; d++)
-                    {
-                        mat[l + d] += x[i][d] * xj;
-                    }
-                }
-            }
+            gmx::addFrameBlockToCovariance(mat, ndim, natoms, xBlock, numFramesInBlock);
+            numFramesInBlock = 0;
         }
     } while (read_next_x(oenv, status, &t, xread, box) && (bRef || nframes < nframes0));
+    gmx::addFrameBlockToCovariance(mat, ndim, natoms, xBlock, numFramesInBlock);
     close_trx(status);
     gmx_rmpbc_done(gpbc);
 
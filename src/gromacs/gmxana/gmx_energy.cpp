@@ -1898,6 +1898,8 @@ int gmx_energy(int argc, char* argv[])
     snew(frame, 2);
     fp = open_enx(ftp2fn(efEDR, NFILE, fnm), "r");
     do_enxnms(fp, &nre, &enm);
+    /* Only the free-energy output uses the block data */
+    enx_set_skip_block_data(fp, !bDHDL);
 
     Vaver = -1;
 
@@ -241,6 +241,22 @@ static void periodic_mindist_plot(const char*             trxfn,
             index[ind_minj] + 1);
 }
 
+namespace
+{
+
+//! Minimum and maximum distance and contact counts of one atom in calc_dist
+struct AtomDistanceStats
+{
+    real rmin2  = 1e12;
+    real rmax2  = -1e12;
+    int  ixmin  = -1;
+    int  ixmax  = -1;
+    int  nmin_j = 0;
+    int  nmax_j = 0;
+};
+
+} // namespace
+
 static void calc_dist(real     rcut,
                       gmx_bool bPBC,
                       PbcType  pbcType,
@@ -260,13 +276,10 @@ static void calc_dist(real     rcut,
                       int*     ixmax,
                       int*     jxmax)
 {
-    int   i, j, i0 = 0, j1;
-    int   ix, jx;
+    int   j1;
     int*  index3;
-    rvec  dx;
-    real  r2, rmin2, rmax2, rcut2;
+    real  rmin2, rmax2, rcut2;
     t_pbc pbc;
-    int   nmin_j, nmax_j;
 
     *ixmin = -1;
     *jxmin = -1;
@@ -284,7 +297,6 @@ static void calc_dist(real     rcut,
     }
     if (index2)
     {
-        i0     = 0;
         j1     = nx2;
         index3 = index2;
     }
@@ -295,23 +307,22 @@ static void calc_dist(real     rcut,
     }
     GMX_RELEASE_ASSERT(index1 != nullptr, "Need a valid index for plotting distances");
 
-    rmin2 = 1e12;
-    rmax2 = -1e12;
-
-    for (j = 0; (j < j1); j++)
-    {
-        jx = index3[j];
-        if (index2 == nullptr)
-        {
-            i0 = j + 1;
-        }
-        nmin_j = 0;
-        nmax_j = 0;
-        for (i = i0; (i < nx1); i++)
+    /* The atoms j are processed in parallel and their results are then
+     * combined in order, so the output does not depend on the threading.
+     */
+    std::vector<AtomDistanceStats> stats(j1);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int j = 0; j < j1; j++)
+    {
+        AtomDistanceStats& stat = stats[j];
+        const int          jx   = index3[j];
+        const int          i0   = (index2 == nullptr) ? j + 1 : 0;
+        for (int i = i0; i < nx1; i++)
         {
-            ix = index1[i];
+            const int ix = index1[i];
             if (ix != jx)
             {
+                rvec dx;
                 if (bPBC)
                 {
                     pbc_dx(&pbc, x[ix], x[jx], dx);
@@ -320,44 +331,61 @@ static void calc_dist(real     rcut,
                 {
                     rvec_sub(x[ix], x[jx], dx);
                 }
-                r2 = iprod(dx, dx);
-                if (r2 < rmin2)
+                const real r2 = iprod(dx, dx);
+                if (r2 < stat.rmin2)
                 {
-                    rmin2  = r2;
-                    *ixmin = ix;
-                    *jxmin = jx;
+                    stat.rmin2 = r2;
+                    stat.ixmin = ix;
                 }
-                if (r2 > rmax2)
+                if (r2 > stat.rmax2)
                 {
-                    rmax2  = r2;
-                    *ixmax = ix;
-                    *jxmax = jx;
+                    stat.rmax2 = r2;
+                    stat.ixmax = ix;
                 }
                 if (r2 <= rcut2)
                 {
-                    nmin_j++;
+                    stat.nmin_j++;
                 }
                 else
                 {
-                    nmax_j++;
+                    stat.nmax_j++;
                 }
             }
         }
+    }
+
+    rmin2 = 1e12;
+    rmax2 = -1e12;
+    for (int j = 0; j < j1; j++)
+    {
+        const AtomDistanceStats& stat = stats[j];
+        if (stat.rmin2 < rmin2)
+        {
+            rmin2  = stat.rmin2;
+            *ixmin = stat.ixmin;
+            *jxmin = index3[j];
+        }
+        if (stat.rmax2 > rmax2)
+        {
+            rmax2  = stat.rmax2;
+            *ixmax = stat.ixmax;
+            *jxmax = index3[j];
+        }
         if (bGroup)
         {
-            if (nmin_j > 0)
+            if (stat.nmin_j > 0)
             {
                 (*nmin)++;
             }
-            if (nmax_j > 0)
+            if (stat.nmax_j > 0)
             {
                 (*nmax)++;
             }
         }
         else
         {
-            *nmin += nmin_j;
-            *nmax += nmax_j;
+            *nmin += stat.nmin_j;
+            *nmax += stat.nmax_j;
         }
     }
     *rmin = std::sqrt(rmin2);
@@ -207,6 +207,12 @@ typedef struct
     real*   aver;     //!< average of histograms
     real*   sigma;    //!< stddev of histograms
     double* bsWeight; //!< for bootstrapping complete histograms with continuous weights
+
+    /*! \brief -U/kT of the umbrella potential U for the nPull coords at each bin
+     *
+     * Does not change during the WHAM iterations, so it is computed only once per WHAM run.
+     */
+    double** biasExponent;
 } t_UmbrellaWindow;
 
 //! Selection of pull coordinates to be used in WHAM (one structure for each tpr file)
@@ -348,6 +354,7 @@ static t_UmbrellaWindow* initUmbrellaWindows(int nwin)
         win[i].forceAv                           = nullptr;
         win[i].aver = win[i].sigma = nullptr;
         win[i].bsWeight            = nullptr;
+        win[i].biasExponent        = nullptr;
     }
     return win;
 }
@@ -379,6 +386,13 @@ static void freeUmbrellaWindows(t_UmbrellaWindow* win, int nwin)
                 sfree(win[i].bContrib[j]);
             }
         }
+        if (win[i].biasExponent)
+        {
+            for (j = 0; j < win[i].nPull; j++)
+            {
+                sfree(win[i].biasExponent[j]);
+            }
+        }
         sfree(win[i].Histo);
         sfree(win[i].cum);
         sfree(win[i].k);
@@ -395,6 +409,7 @@ static void freeUmbrellaWindows(t_UmbrellaWindow* win, int nwin)
         sfree(win[i].aver);
         sfree(win[i].sigma);
         sfree(win[i].bsWeight);
+        sfree(win[i].biasExponent);
     }
     sfree(win);
 }
@@ -642,14 +657,65 @@ static void setup_acc_wham(const double* profile, t_UmbrellaWindow* window, int
     bFirst = 0;
 }
 
-//! Compute the PMF (one of the two main WHAM routines)
-static void calc_profile(double* profile, t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt, gmx_bool bExact)
+/*! \brief Compute -U/kT of the umbrella potentials at all bins
+ *
+ * Must be called before the WHAM iterations, and again whenever the umbrella positions
+ * or force constants of the windows change.
+ */
+static void setupBiasExponents(t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt)
 {
-    double ztot_half, ztot, min = opt->min, dz = opt->dz;
+    double min = opt->min, dz = opt->dz, ztot_half, ztot;
 
     ztot      = opt->max - opt->min;
     ztot_half = ztot / 2;
 
+    for (int i = 0; i < nWindows; ++i)
+    {
+        if (!window[i].biasExponent)
+        {
+            snew(window[i].biasExponent, window[i].nPull);
+        }
+        for (int j = 0; j < window[i].nPull; ++j)
+        {
+            if (!window[i].biasExponent[j])
+            {
+                snew(window[i].biasExponent[j], opt->bins);
+            }
+            for (int k = 0; k < opt->bins; ++k)
+            {
+                double temp     = (1.0 * k + 0.5) * dz + min;
+                double distance = temp - window[i].pos[j]; /* distance to umbrella center */
+                double U;
+                if (opt->bCycl)
+                {                             /* in cyclic wham:             */
+                    if (distance > ztot_half) /*    |distance| < ztot_half   */
+                    {
+                        distance -= ztot;
+                    }
+                    else if (distance < -ztot_half)
+                    {
+                        distance += ztot;
+                    }
+                }
+
+                if (!opt->bTab)
+                {
+                    /* harmonic potential assumed. */
+                    U = 0.5 * window[i].k[j] * gmx::square(distance);
+                }
+                else
+                {
+                    U = tabulated_pot(distance, opt); /* Use tabulated potential     */
+                }
+                window[i].biasExponent[j][k] = -U / (gmx::c_boltz * opt->Temperature);
+            }
+        }
+    }
+}
+
+//! Compute the PMF (one of the two main WHAM routines)
+static void calc_profile(double* profile, t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt, gmx_bool bExact)
+{
 #pragma omp parallel
     {
         try
@@ -663,43 +729,21 @@ static void calc_profile(double* profile, t_UmbrellaWindow* window, int nWindows
             for (i = i0; i < i1; ++i)
             {
                 int    j, k;
-                double num, denom, invg, temp = 0, distance, U = 0;
+                double num, denom, invg;
                 num = denom = 0.;
                 for (j = 0; j < nWindows; ++j)
                 {
                     for (k = 0; k < window[j].nPull; ++k)
                     {
                         invg = 1.0 / window[j].g[k] * window[j].bsWeight[k];
-                        temp = (1.0 * i + 0.5) * dz + min;
                         num += invg * window[j].Histo[k][i];
 
                         if (!(bExact || window[j].bContrib[k][i]))
                         {
                             continue;
                         }
-                        distance = temp - window[j].pos[k]; /* distance to umbrella center */
-                        if (opt->bCycl)
-                        {                             /* in cyclic wham:             */
-                            if (distance > ztot_half) /*    |distance| < ztot_half   */
-                            {
-                                distance -= ztot;
-                            }
-                            else if (distance < -ztot_half)
-                            {
-                                distance += ztot;
-                            }
-                        }
-
-                        if (!opt->bTab)
-                        {
-                            U = 0.5 * window[j].k[k] * gmx::square(distance); /* harmonic potential assumed. */
-                        }
-                        else
-                        {
-                            U = tabulated_pot(distance, opt); /* Use tabulated potential     */
-                        }
                         denom += invg * window[j].N[k]
-                                 * std::exp(-U / (gmx::c_boltz * opt->Temperature) + window[j].z[k]);
+                                 * std::exp(window[j].biasExponent[k][i] + window[j].z[k]);
                     }
                 }
                 profile[i] = num / denom;
@@ -710,14 +754,10 @@ static void calc_profile(double* profile, t_UmbrellaWindow* window, int nWindows
 }
 
 //! Compute the free energy offsets z (one of the two main WHAM routines)
-static double calc_z(const double* profile, t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt, gmx_bool bExact)
+static double calc_z(const double* profile, t_UmbrellaWindow* window, int nWindows, gmx_bool bExact)
 {
-    double min = opt->min, dz = opt->dz, ztot_half, ztot;
     double maxglob = -1e20;
 
-    ztot      = opt->max - opt->min;
-    ztot_half = ztot / 2;
-
 #pragma omp parallel
     {
         try
@@ -731,7 +771,7 @@ static double calc_z(const double* profile, t_UmbrellaWindow* window, int nWindo
 
             for (i = i0; i < i1; ++i)
             {
-                double total = 0, temp, distance, U = 0;
+                double total = 0, temp;
                 int    j, k;
 
                 for (j = 0; j < window[i].nPull; ++j)
@@ -743,29 +783,7 @@ static double calc_z(const double* profile, t_UmbrellaWindow* window, int nWindo
                         {
                             continue;
                         }
-                        temp     = (1.0 * k + 0.5) * dz + min;
-                        distance = temp - window[i].pos[j]; /* distance to umbrella center */
-                        if (opt->bCycl)
-                        {                             /* in cyclic wham:             */
-                            if (distance > ztot_half) /*    |distance| < ztot_half   */
-                            {
-                                distance -= ztot;
-                            }
-                            else if (distance < -ztot_half)
-                            {
-                                distance += ztot;
-                            }
-                        }
-
-                        if (!opt->bTab)
-                        {
-                            U = 0.5 * window[i].k[j] * gmx::square(distance); /* harmonic potential assumed. */
-                        }
-                        else
-                        {
-                            U = tabulated_pot(distance, opt); /* Use tabulated potential     */
-                        }
-                        total += profile[k] * std::exp(-U / (gmx::c_boltz * opt->Temperature));
+                        total += profile[k] * std::exp(window[i].biasExponent[j][k]);
                     }
                     /* Avoid floating point exception if window is far outside min and max */
                     if (total != 0.0)
@@ -1425,6 +1443,7 @@ static void do_bootstrapping(const char*        fnres,
         bExact    = FALSE;
         maxchange = 1e20;
         std::memcpy(bsProfile, profile, opt->bins * sizeof(double)); /* use profile as guess */
+        setupBiasExponents(synthWindow, nAllPull, opt);
         do
         {
             if ((i % opt->stepUpdateContrib) == 0)
@@ -1441,7 +1460,7 @@ static void do_bootstrapping(const char*        fnres,
             }
             calc_profile(bsProfile, synthWindow, nAllPull, opt, bExact);
             i++;
-        } while ((maxchange = calc_z(bsProfile, synthWindow, nAllPull, opt, bExact)) > opt->Tolerance
+        } while ((maxchange = calc_z(bsProfile, synthWindow, nAllPull, bExact)) > opt->Tolerance
                  || !bExact);
         printf("\tConverged in %d iterations. Final maximum change %g\n", i, maxchange);
 
@@ -2750,7 +2769,8 @@ static void guessPotByIntegration(t_UmbrellaWindow* window, int nWindows, t_Umbr
     {
         pot[j] = std::exp(-pot[j] / (gmx::c_boltz * opt->Temperature));
     }
-    calc_z(pot, window, nWindows, opt, TRUE);
+    setupBiasExponents(window, nWindows, opt);
+    calc_z(pot, window, nWindows, TRUE);
 
     sfree(pot);
     sfree(f);
@@ -3343,6 +3363,7 @@ int gmx_wham(int argc, char* argv[])
     {
         opt.stepchange = 1;
     }
+    setupBiasExponents(window, nwins, &opt);
     i = 0;
     do
     {
@@ -3362,7 +3383,7 @@ int gmx_wham(int argc, char* argv[])
             printf("\t%4d) Maximum change %e\n", i, maxchange);
         }
         i++;
-    } while ((maxchange = calc_z(profile, window, nwins, &opt, bExact)) > opt.Tolerance || !bExact);
+    } while ((maxchange = calc_z(profile, window, nwins, bExact)) > opt.Tolerance || !bExact);
     printf("Converged in %d iterations. Final maximum change %g\n", i, maxchange);
 
     /* calc error from Kumar's formula */
@@ -54,6 +54,9 @@ class ArrayRefWithPadding;
 /*! \brief The non-bonded free-energy kernel
  *
  * Note that this uses a regular atom pair, not cluster pair, list.
+ * With \p useSimd the j-atoms of each i-entry are processed in SIMD width
+ * chunks using the gromacs/simd layer, for all soft-core types, when
+ * the SIMD setup supports real and 32-bit integer arithmetics.
  *
  * \throws InvalidInputError when an excluded pair is beyond the rcoulomb with reaction-field.
  */
@@ -62,6 +62,7 @@
 #include "gromacs/random/seed.h"
 #include "gromacs/random/threefry.h"
 #include "gromacs/random/uniformintdistribution.h"
+#include "gromacs/selection/nbsearch.h"
 #include "gromacs/topology/atoms.h"
 #include "gromacs/topology/index.h"
 #include "gromacs/topology/topology.h"
@@ -111,6 +112,46 @@ static bool groupsCloserThanCutoffWithPbc(t_pbc*                   pbc,
     return false;
 }
 
+/*! \brief Return whether any atom of a group is closer than a cutoff to the non-solvent atoms.
+ *
+ * The non-solvent atoms that were present from the start are found through a
+ * neighbor search, the ions that were placed since then are checked directly.
+ *
+ * \param[in] pbc the periodic boundary conditions
+ * \param[in] x atom coordinates
+ * \param[in] groupIndices the atom indices of the group to check
+ * \param[in] notSolventSearch neighbor search over the initial non-solvent atoms
+ * \param[in] placedIons the atom indices of the ions placed so far
+ * \param[in] minimumDistance the minimum required distance
+ * \returns true if any atom of the group is closer than minimumDistance to
+ *               a non-solvent atom or a placed ion.
+ */
+static bool groupCloserThanCutoffToNotSolvent(t_pbc*                           pbc,
+                                              rvec                             x[],
+                                              gmx::ArrayRef<const int>         groupIndices,
+                                              gmx::AnalysisNeighborhoodSearch* notSolventSearch,
+                                              gmx::ArrayRef<const int>         placedIons,
+                                              real                             minimumDistance)
+{
+    const real minimumDistance2 = minimumDistance * minimumDistance;
+
+    std::vector<gmx::RVec> groupX;
+    for (int atomIndex : groupIndices)
+    {
+        groupX.emplace_back(x[atomIndex]);
+    }
+    gmx::AnalysisNeighborhoodPairSearch pairSearch = notSolventSearch->startPairSearch(groupX);
+    gmx::AnalysisNeighborhoodPair       pair;
+    while (pairSearch.findNextPair(&pair))
+    {
+        if (pair.distance2() < minimumDistance2)
+        {
+            return true;
+        }
+    }
+    return groupsCloserThanCutoffWithPbc(pbc, x, groupIndices, placedIons, minimumDistance);
+}
+
 /*! \brief Calculate the solvent molecule atom indices from molecule number.
  *
  * \note the solvent group index has to be continuous
@@ -134,18 +175,19 @@ static std::vector<int> solventMoleculeIndices(int solventMoleculeNumber,
     return indices;
 }
 
-static void insert_ion(int                      nsa,
-                       std::vector<int>*        solventMoleculesForReplacement,
-                       int                      repl[],
-                       gmx::ArrayRef<const int> index,
-                       rvec                     x[],
-                       t_pbc*                   pbc,
-                       int                      sign,
-                       int                      q,
-                       const char*              ionname,
-                       t_atoms*                 atoms,
-                       real                     rmin,
-                       std::vector<int>*        notSolventGroup)
+static void insert_ion(int                              nsa,
+                       std::vector<int>*                solventMoleculesForReplacement,
+                       int                              repl[],
+                       gmx::ArrayRef<const int>         index,
+                       rvec                             x[],
+                       t_pbc*                           pbc,
+                       int                              sign,
+                       int                              q,
+                       const char*                      ionname,
+                       t_atoms*                         atoms,
+                       real                             rmin,
+                       gmx::AnalysisNeighborhoodSearch* notSolventSearch,
+                       std::vector<int>*                placedIons)
 {
     std::vector<int> solventMoleculeAtomsToBeReplaced =
             solventMoleculeIndices(solventMoleculesForReplacement->back(), nsa, index);
@@ -153,7 +195,12 @@ static void insert_ion(int                      nsa,
     if (rmin > 0.0)
     {
         // check for proximity to non-solvent
-        while (groupsCloserThanCutoffWithPbc(pbc, x, solventMoleculeAtomsToBeReplaced, *notSolventGroup, rmin)
+        while (groupCloserThanCutoffToNotSolvent(pbc,
+                                                 x,
+                                                 solventMoleculeAtomsToBeReplaced,
+                                                 notSolventSearch,
+                                                 *placedIons,
+                                                 rmin)
                && !solventMoleculesForReplacement->empty())
         {
             solventMoleculesForReplacement->pop_back();
@@ -174,7 +221,7 @@ static void insert_ion(int                      nsa,
             ionname);
 
     /* Replace solvent molecule charges with ion charge */
-    notSolventGroup->push_back(solventMoleculeAtomsToBeReplaced[0]);
+    placedIons->push_back(solventMoleculeAtomsToBeReplaced[0]);
     repl[solventMoleculesForReplacement->back()] = sign;
 
     // The first solvent molecule atom is replaced with an ion and the respective
@@ -662,6 +709,19 @@ int gmx_genion(int argc, char* argv[])
 
 
         std::vector<int> notSolventGroup = invertIndexGroup(atoms.nr, solventGroup);
+        std::vector<int> placedIons;
+
+        /* The non-solvent atoms do not move, so one search over them can be
+         * used for all ion placements.
+         */
+        gmx::AnalysisNeighborhood       nb;
+        gmx::AnalysisNeighborhoodSearch notSolventSearch;
+        if (rmin > 0.0)
+        {
+            nb.setCutoff(rmin);
+            gmx::AnalysisNeighborhoodPositions notSolventPositions(x, atoms.nr);
+            notSolventSearch = nb.initSearch(&pbc, notSolventPositions.indexed(notSolventGroup));
+        }
 
         std::vector<int> solventMoleculesForReplacement(nw);
         std::iota(std::begin(solventMoleculesForReplacement), std::end(solventMoleculesForReplacement), 0);
@@ -675,13 +735,35 @@ int gmx_genion(int argc, char* argv[])
         /* Now loop over the ions that have to be placed */
         while (p_num-- > 0)
         {
-            insert_ion(
-                    nsa, &solventMoleculesForReplacement, repl, solventGroup, x, &pbc, 1, p_q, p_name, &atoms, rmin, &notSolventGroup);
+            insert_ion(nsa,
+                       &solventMoleculesForReplacement,
+                       repl,
+                       solventGroup,
+                       x,
+                       &pbc,
+                       1,
+                       p_q,
+                       p_name,
+                       &atoms,
+                       rmin,
+                       &notSolventSearch,
+                       &placedIons);
         }
         while (n_num-- > 0)
         {
-            insert_ion(
-                    nsa, &solventMoleculesForReplacement, repl, solventGroup, x, &pbc, -1, n_q, n_name, &atoms, rmin, &notSolventGroup);
+            insert_ion(nsa,
+                       &solventMoleculesForReplacement,
+                       repl,
+                       solventGroup,
+                       x,
+                       &pbc,
+                       -1,
+                       n_q,
+                       n_name,
+                       &atoms,
+                       rmin,
+                       &notSolventSearch,
+                       &placedIons);
         }
         fprintf(stderr, "\n");
 
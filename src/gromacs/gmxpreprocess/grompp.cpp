@@ -373,7 +373,7 @@ static void check_bonds_timestep(const gmx_mtop_t* mtop, double dt, WarningHandl
     int  min_steps_warn = 5;
     int  min_steps_note = 10;
     int  ftype;
-    int  i, a1, a2, w_a1, w_a2, j;
+    int  i, a1, a2, w_a1, w_a2;
     real twopi2, limit2, fc, re, m1, m2, period2, w_period2;
     bool bFound, bWater, bWarn;
 
@@ -394,6 +394,26 @@ static void check_bonds_timestep(const gmx_mtop_t* mtop, double dt, WarningHandl
         const InteractionLists& ilist = moltype.ilist;
         const InteractionList&  ilc   = ilist[F_CONSTR];
         const InteractionList&  ils   = ilist[F_SETTLE];
+
+        /* Sorted list of constrained atom pairs, so that looking up whether
+         * a bond is constrained does not scale with the number of constraints.
+         */
+        std::vector<std::pair<int, int>> constrainedPairs;
+        auto addConstrainedPair = [&constrainedPairs](int ai, int aj) {
+            constrainedPairs.emplace_back(std::min(ai, aj), std::max(ai, aj));
+        };
+        for (int j = 0; j < ilc.size(); j += 3)
+        {
+            addConstrainedPair(ilc.iatoms[j + 1], ilc.iatoms[j + 2]);
+        }
+        for (int j = 0; j < ils.size(); j += 4)
+        {
+            addConstrainedPair(ils.iatoms[j + 1], ils.iatoms[j + 2]);
+            addConstrainedPair(ils.iatoms[j + 1], ils.iatoms[j + 3]);
+            addConstrainedPair(ils.iatoms[j + 2], ils.iatoms[j + 3]);
+        }
+        std::sort(constrainedPairs.begin(), constrainedPairs.end());
+
         for (ftype = 0; ftype < F_NRE; ftype++)
         {
             if (!(ftype == F_BONDS || ftype == F_G96BONDS || ftype == F_HARMONIC))
@@ -429,24 +449,9 @@ static void check_bonds_timestep(const gmx_mtop_t* mtop, double dt, WarningHandl
                 }
                 if (period2 < limit2)
                 {
-                    bFound = false;
-                    for (j = 0; j < ilc.size(); j += 3)
-                    {
-                        if ((ilc.iatoms[j + 1] == a1 && ilc.iatoms[j + 2] == a2)
-                            || (ilc.iatoms[j + 1] == a2 && ilc.iatoms[j + 2] == a1))
-                        {
-                            bFound = true;
-                        }
-                    }
-                    for (j = 0; j < ils.size(); j += 4)
-                    {
-                        if ((a1 == ils.iatoms[j + 1] || a1 == ils.iatoms[j + 2] || a1 == ils.iatoms[j + 3])
-                            && (a2 == ils.iatoms[j + 1] || a2 == ils.iatoms[j + 2]
-                                || a2 == ils.iatoms[j + 3]))
-                        {
-                            bFound = true;
-                        }
-                    }
+                    bFound = std::binary_search(constrainedPairs.begin(),
+                                                constrainedPairs.end(),
+                                                std::make_pair(std::min(a1, a2), std::max(a1, a2)));
                     if (!bFound && (w_moltype == nullptr || period2 < w_period2))
                     {
                         w_moltype = &moltype;
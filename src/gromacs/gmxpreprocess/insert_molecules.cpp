@@ -263,6 +263,12 @@ static void insert_mols(int                  nmol_insrt,
     int                                failed     = 0;
     gmx::UniformRealDistribution<real> dist;
 
+    /* The search over the existing atoms only changes when a molecule was
+     * inserted, so it is not re-initialized for every (failed) trial.
+     */
+    gmx::AnalysisNeighborhoodSearch search;
+    bool                            searchIsCurrent = false;
+
     while (mol < nmol_insrt && trial < ntry * nmol_insrt)
     {
         rvec offset_x;
@@ -297,8 +303,12 @@ static void insert_mols(int                  nmol_insrt,
         fflush(stderr);
 
         generate_trial_conf(x_insrt, offset_x, enum_rot, &rng, &x_n);
-        gmx::AnalysisNeighborhoodPositions pos(*x);
-        gmx::AnalysisNeighborhoodSearch    search = nb.initSearch(&pbc, pos);
+        if (!searchIsCurrent)
+        {
+            gmx::AnalysisNeighborhoodPositions pos(*x);
+            search          = nb.initSearch(&pbc, pos);
+            searchIsCurrent = true;
+        }
         if (isInsertionAllowed(
                     &search, exclusionDistances, x_n, exclusionDistances_insrt, *atoms, removableAtoms, &remover))
         {
@@ -307,6 +317,7 @@ static void insert_mols(int                  nmol_insrt,
                                       exclusionDistances_insrt.begin(),
                                       exclusionDistances_insrt.end());
             builder.mergeAtoms(atoms_insrt);
+            searchIsCurrent = false;
             ++mol;
             firstTrial = trial;
             fprintf(stderr, " success (now %d atoms)!\n", builder.currentAtomCount());
@@ -211,18 +211,18 @@ makeDisulfideBonds(t_atoms* pdba, t_symtab* symtab, rvec x[], bool bInteractive,
                 specialBondAtomIdxs.push_back(i);
             }
         }
-        /* distance matrix d[nspec][nspec] */
-        int                            nspec = specialBondAtomIdxs.size();
-        std::vector<std::vector<real>> d(nspec);
-        for (int i = 0; (i < nspec); i++)
+        /* The distances are computed when needed instead of stored in an
+         * nspec x nspec matrix, which gets very large for many chains.
+         */
+        int  nspec    = specialBondAtomIdxs.size();
+        auto distance = [x, &specialBondAtomIdxs](int i, int j) {
+            return std::sqrt(distance2(x[specialBondAtomIdxs[i]], x[specialBondAtomIdxs[j]]));
+        };
+        /* No special bond can be formed beyond 1.1 times the longest bond length */
+        real maxBondLength = 0;
+        for (const auto& bond : specialBonds)
         {
-            d[i].resize(nspec);
-            int ai = specialBondAtomIdxs[i];
-            for (int j = 0; (j < nspec); j++)
-            {
-                int aj  = specialBondAtomIdxs[j];
-                d[i][j] = std::sqrt(distance2(x[ai], x[aj]));
-            }
+            maxBondLength = std::max(maxBondLength, bond.length);
         }
         if (nspec > 1)
         {
@@ -267,7 +267,7 @@ makeDisulfideBonds(t_atoms* pdba, t_symtab* symtab, rvec x[], bool bInteractive,
                     int e2 = std::min(i, e);
                     for (int j = b; (j < e2); j++)
                     {
-                        fprintf(stderr, " %7.3f", d[i][j]);
+                        fprintf(stderr, " %7.3f", distance(i, j));
                     }
                     fprintf(stderr, "\n");
                 }
@@ -279,10 +279,15 @@ makeDisulfideBonds(t_atoms* pdba, t_symtab* symtab, rvec x[], bool bInteractive,
             int ai = specialBondAtomIdxs[i];
             for (int j = i + 1; (j < nspec); j++)
             {
-                int aj = specialBondAtomIdxs[j];
+                int  aj = specialBondAtomIdxs[j];
+                real d  = distance(i, j);
+                if (!(1.1 * maxBondLength > d))
+                {
+                    continue;
+                }
                 /* Ensure creation of at most nspec special bonds to avoid overflowing bonds[] */
                 if (bonds.size() < specialBondAtomIdxs.size()
-                    && is_bond(specialBonds, pdba, ai, aj, d[i][j], &index_sb, &bSwap))
+                    && is_bond(specialBonds, pdba, ai, aj, d, &index_sb, &bSwap))
                 {
                     fprintf(stderr,
                             "%s %s-%d %s-%d and %s-%d %s-%d%s",
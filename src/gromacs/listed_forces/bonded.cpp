@@ -2008,73 +2008,66 @@ pdihs(int             nbonds,
 
 #if GMX_SIMD_HAVE_REAL
 
-/* As pdihs above, but using SIMD to calculate multiple dihedrals at once */
-template<BondedKernelFlavor flavor>
-std::enable_if_t<flavor == BondedKernelFlavor::ForcesSimdWhenAvailable, real>
-pdihs(int             nbonds,
-      const t_iatom   forceatoms[],
-      const t_iparams forceparams[],
-      const rvec      x[],
-      rvec4           f[],
-      rvec gmx_unused fshift[],
-      const t_pbc*    pbc,
-      real gmx_unused lambda,
-      real gmx_unused* dvdlambda,
-      gmx::ArrayRef<const real> /*charge*/,
-      t_fcdata gmx_unused* fcd,
-      t_disresdata gmx_unused* disresdata,
-      t_oriresdata gmx_unused* oriresdata,
-      int gmx_unused* global_atom_index)
+/*! \brief Computes the forces of dihedrals with SIMD, without energies and virial
+ *
+ * The code common to all dihedral potentials is handled here:
+ * GMX_SIMD_REAL_WIDTH dihedrals at a time are gathered, their angles
+ * computed and the forces spread. The potential enters through
+ * \p getParameters, which returns the \p numParameters parameters of
+ * an interaction type, and through \p computeMinusDVdPhi, which returns
+ * -dV/dphi given phi and the parameters loaded in SIMD registers.
+ * Padding entries at the end get zero parameters, so all potentials
+ * should return zero force for zero parameters.
+ */
+template<int numParameters, typename ParameterGetter, typename DerivativeFunction>
+void dihedralForcesNoEnergySimd(int                nbonds,
+                                const t_iatom      forceatoms[],
+                                const t_iparams    forceparams[],
+                                const rvec         x[],
+                                rvec4              f[],
+                                const t_pbc*       pbc,
+                                ParameterGetter    getParameters,
+                                DerivativeFunction computeMinusDVdPhi)
 {
     const int                                nfa1 = 5;
-    int                                      i, iu, s;
-    int                                      type;
     alignas(GMX_SIMD_ALIGNMENT) std::int32_t ai[GMX_SIMD_REAL_WIDTH];
     alignas(GMX_SIMD_ALIGNMENT) std::int32_t aj[GMX_SIMD_REAL_WIDTH];
     alignas(GMX_SIMD_ALIGNMENT) std::int32_t ak[GMX_SIMD_REAL_WIDTH];
     alignas(GMX_SIMD_ALIGNMENT) std::int32_t al[GMX_SIMD_REAL_WIDTH];
-    alignas(GMX_SIMD_ALIGNMENT) real         buf[3 * GMX_SIMD_REAL_WIDTH];
-    real *                                   cp, *phi0, *mult;
-    SimdReal                                 deg2rad_S(gmx::c_deg2Rad);
+    alignas(GMX_SIMD_ALIGNMENT) real         buf[numParameters * GMX_SIMD_REAL_WIDTH];
     SimdReal                                 p_S, q_S;
-    SimdReal                                 phi0_S, phi_S;
+    SimdReal                                 phi_S;
     SimdReal                                 mx_S, my_S, mz_S;
     SimdReal                                 nx_S, ny_S, nz_S;
     SimdReal                                 nrkj_m2_S, nrkj_n2_S;
-    SimdReal                                 cp_S, mdphi_S, mult_S;
-    SimdReal                                 sin_S, cos_S;
-    SimdReal                                 mddphi_S;
-    SimdReal                                 sf_i_S, msf_l_S;
+    std::array<SimdReal, numParameters>      parameters_S;
     alignas(GMX_SIMD_ALIGNMENT) real         pbc_simd[9 * GMX_SIMD_REAL_WIDTH];
 
-    /* Extract aligned pointer for parameters and variables */
-    cp   = buf + 0 * GMX_SIMD_REAL_WIDTH;
-    phi0 = buf + 1 * GMX_SIMD_REAL_WIDTH;
-    mult = buf + 2 * GMX_SIMD_REAL_WIDTH;
-
     set_pbc_simd(pbc, pbc_simd);
 
     /* nbonds is the number of dihedrals times nfa1, here we step GMX_SIMD_REAL_WIDTH dihs */
-    for (i = 0; (i < nbonds); i += GMX_SIMD_REAL_WIDTH * nfa1)
+    for (int i = 0; (i < nbonds); i += GMX_SIMD_REAL_WIDTH * nfa1)
     {
         /* Collect atoms quadruplets for GMX_SIMD_REAL_WIDTH dihedrals.
          * iu indexes into forceatoms, we should not let iu go beyond nbonds.
          */
-        iu = i;
-        for (s = 0; s < GMX_SIMD_REAL_WIDTH; s++)
+        int iu = i;
+        for (int s = 0; s < GMX_SIMD_REAL_WIDTH; s++)
         {
-            type  = forceatoms[iu];
-            ai[s] = forceatoms[iu + 1];
-            aj[s] = forceatoms[iu + 2];
-            ak[s] = forceatoms[iu + 3];
-            al[s] = forceatoms[iu + 4];
+            const int type = forceatoms[iu];
+            ai[s]          = forceatoms[iu + 1];
+            aj[s]          = forceatoms[iu + 2];
+            ak[s]          = forceatoms[iu + 3];
+            al[s]          = forceatoms[iu + 4];
 
             /* At the end fill the arrays with the last atoms and 0 params */
             if (i + s * nfa1 < nbonds)
             {
-                cp[s]   = forceparams[type].pdihs.cpA;
-                phi0[s] = forceparams[type].pdihs.phiA;
-                mult[s] = forceparams[type].pdihs.mult;
+                const std::array<real, numParameters> parameters = getParameters(forceparams[type]);
+                for (int p = 0; p < numParameters; p++)
+                {
+                    buf[p * GMX_SIMD_REAL_WIDTH + s] = parameters[p];
+                }
 
                 if (iu + nfa1 < nbonds)
                 {
@@ -2083,9 +2076,10 @@ pdihs(int             nbonds,
             }
             else
             {
-                cp[s]   = 0;
-                phi0[s] = 0;
-                mult[s] = 0;
+                for (int p = 0; p < numParameters; p++)
+                {
+                    buf[p * GMX_SIMD_REAL_WIDTH + s] = 0;
+                }
             }
         }
 
@@ -2093,17 +2087,14 @@ pdihs(int             nbonds,
         dih_angle_simd(
                 x, ai, aj, ak, al, pbc_simd, &phi_S, &mx_S, &my_S, &mz_S, &nx_S, &ny_S, &nz_S, &nrkj_m2_S, &nrkj_n2_S, &p_S, &q_S);
 
-        cp_S   = load<SimdReal>(cp);
-        phi0_S = load<SimdReal>(phi0) * deg2rad_S;
-        mult_S = load<SimdReal>(mult);
-
-        mdphi_S = fms(mult_S, phi_S, phi0_S);
+        for (int p = 0; p < numParameters; p++)
+        {
+            parameters_S[p] = load<SimdReal>(buf + p * GMX_SIMD_REAL_WIDTH);
+        }
 
-        /* Calculate GMX_SIMD_REAL_WIDTH sines at once */
-        sincos(mdphi_S, &sin_S, &cos_S);
-        mddphi_S = cp_S * mult_S * sin_S;
-        sf_i_S   = mddphi_S * nrkj_m2_S;
-        msf_l_S  = mddphi_S * nrkj_n2_S;
+        const SimdReal mddphi_S = computeMinusDVdPhi(phi_S, parameters_S);
+        const SimdReal sf_i_S   = mddphi_S * nrkj_m2_S;
+        const SimdReal msf_l_S  = mddphi_S * nrkj_n2_S;
 
         /* After this m?_S will contain f[i] */
         mx_S = sf_i_S * mx_S;
@@ -2117,6 +2108,49 @@ pdihs(int             nbonds,
 
         do_dih_fup_noshiftf_simd(ai, aj, ak, al, p_S, q_S, mx_S, my_S, mz_S, nx_S, ny_S, nz_S, f);
     }
+}
+
+/* As pdihs above, but using SIMD to calculate multiple dihedrals at once */
+template<BondedKernelFlavor flavor>
+std::enable_if_t<flavor == BondedKernelFlavor::ForcesSimdWhenAvailable, real>
+pdihs(int             nbonds,
+      const t_iatom   forceatoms[],
+      const t_iparams forceparams[],
+      const rvec      x[],
+      rvec4           f[],
+      rvec gmx_unused fshift[],
+      const t_pbc*    pbc,
+      real gmx_unused lambda,
+      real gmx_unused* dvdlambda,
+      gmx::ArrayRef<const real> /*charge*/,
+      t_fcdata gmx_unused* fcd,
+      t_disresdata gmx_unused* disresdata,
+      t_oriresdata gmx_unused* oriresdata,
+      int gmx_unused* global_atom_index)
+{
+    dihedralForcesNoEnergySimd<3>(
+            nbonds,
+            forceatoms,
+            forceparams,
+            x,
+            f,
+            pbc,
+            [](const t_iparams& iparams) {
+                return std::array<real, 3>{ iparams.pdihs.cpA,
+                                            iparams.pdihs.phiA,
+                                            static_cast<real>(iparams.pdihs.mult) };
+            },
+            [](SimdReal phi_S, const std::array<SimdReal, 3>& parameters_S)
+            {
+                const SimdReal cp_S   = parameters_S[0];
+                const SimdReal phi0_S = parameters_S[1] * SimdReal(gmx::c_deg2Rad);
+                const SimdReal mult_S = parameters_S[2];
+
+                /* Calculate GMX_SIMD_REAL_WIDTH sines at once */
+                SimdReal sin_S, cos_S;
+                sincos(fms(mult_S, phi_S, phi0_S), &sin_S, &cos_S);
+                return cp_S * mult_S * sin_S;
+            });
 
     return 0;
 }
@@ -2251,24 +2285,73 @@ rbdihs(int             nbonds,
     return 0;
 }
 
+/* As idihs below, but using SIMD to calculate multiple dihedrals at once.
+ * This function can replace idihs() when no energy and virial are needed.
+ */
+template<BondedKernelFlavor flavor>
+std::enable_if_t<flavor == BondedKernelFlavor::ForcesSimdWhenAvailable, real>
+idihs(int             nbonds,
+      const t_iatom   forceatoms[],
+      const t_iparams forceparams[],
+      const rvec      x[],
+      rvec4           f[],
+      rvec gmx_unused fshift[],
+      const t_pbc*    pbc,
+      real gmx_unused lambda,
+      real gmx_unused* dvdlambda,
+      gmx::ArrayRef<const real> /*charge*/,
+      t_fcdata gmx_unused* fcd,
+      t_disresdata gmx_unused* disresdata,
+      t_oriresdata gmx_unused* oriresdata,
+      int gmx_unused* global_atom_index)
+{
+    dihedralForcesNoEnergySimd<2>(
+            nbonds,
+            forceatoms,
+            forceparams,
+            x,
+            f,
+            pbc,
+            [](const t_iparams& iparams) {
+                return std::array<real, 2>{ iparams.harmonic.krA, iparams.harmonic.rA };
+            },
+            [](SimdReal phi_S, const std::array<SimdReal, 2>& parameters_S)
+            {
+                const SimdReal pi_S(M_PI);
+                const SimdReal twoPi_S(2 * M_PI);
+                const SimdReal kk_S   = parameters_S[0];
+                const SimdReal phi0_S = parameters_S[1] * SimdReal(gmx::c_deg2Rad);
+
+                /* As make_dp_periodic(), put phi-phi0 in the range [-pi,pi) */
+                SimdReal dp_S = phi_S - phi0_S;
+                dp_S          = dp_S - selectByMask(twoPi_S, pi_S <= dp_S);
+                dp_S          = dp_S + selectByMask(twoPi_S, dp_S < -pi_S);
+
+                return -kk_S * dp_S;
+            });
+
+    return 0;
+}
+
 #endif // GMX_SIMD_HAVE_REAL
 
 
 template<BondedKernelFlavor flavor>
-real idihs(int             nbonds,
-           const t_iatom   forceatoms[],
-           const t_iparams forceparams[],
-           const rvec      x[],
-           rvec4           f[],
-           rvec            fshift[],
-           const t_pbc*    pbc,
-           real            lambda,
-           real*           dvdlambda,
-           gmx::ArrayRef<const real> /*charge*/,
-           t_fcdata gmx_unused* fcd,
-           t_disresdata gmx_unused* disresdata,
-           t_oriresdata gmx_unused* oriresdata,
-           int gmx_unused* global_atom_index)
+std::enable_if_t<flavor != BondedKernelFlavor::ForcesSimdWhenAvailable || !GMX_SIMD_HAVE_REAL, real>
+idihs(int             nbonds,
+      const t_iatom   forceatoms[],
+      const t_iparams forceparams[],
+      const rvec      x[],
+      rvec4           f[],
+      rvec            fshift[],
+      const t_pbc*    pbc,
+      real            lambda,
+      real*           dvdlambda,
+      gmx::ArrayRef<const real> /*charge*/,
+      t_fcdata gmx_unused* fcd,
+      t_disresdata gmx_unused* disresdata,
+      t_oriresdata gmx_unused* oriresdata,
+      int gmx_unused* global_atom_index)
 {
     int  i, type, ai, aj, ak, al;
     int  t1, t2, t3;
@@ -298,13 +298,15 @@ real calc_one_bond(int                                 thread,
                nice to account to its own subtimer, but first
                wallcycle needs to be extended to support calling from
                multiple threads. */
+            /* CMAP has no SIMD kernel, but without virial we can
+               skip the shift-force work by passing no shift forces. */
             v = cmap_dihs(nbn,
                           iatoms.data() + nb0,
                           iparams.data(),
                           &idef.cmap_grid,
                           x,
                           f,
-                          fshift,
+                          computeVirial(flavor) ? fshift : nullptr,
                           pbc,
                           lambda[static_cast<int>(efptFTYPE)],
                           &(dvdl[static_cast<int>(efptFTYPE)]),
@@ -557,7 +559,9 @@ void calc_listed(struct gmx_wallcycle*               wcycle,
 /*! \brief As calc_listed(), but only determines the potential energy
  * for the perturbed interactions.
  *
- * The shift forces in fr are not affected.
+ * The shift forces in fr are not affected. The forces and shift forces
+ * computed here are accumulated into the scratch buffers forceBufferLambda
+ * and shiftForceBufferLambda, which the caller clears before use.
  */
 void calc_listed_lambda(const InteractionDefinitions&       idef,
                         bonded_threading_t*                 bt,
@@ -592,10 +596,6 @@ void calc_listed_lambda(const InteractionDefinitions&       idef,
     }
 
     /* We already have the forces, so we use temp buffers here */
-    std::fill(forceBufferLambda.begin(), forceBufferLambda.end(), 0.0_real);
-    std::fill(shiftForceBufferLambda.begin(),
-              shiftForceBufferLambda.end(),
-              gmx::RVec{ 0.0_real, 0.0_real, 0.0_real });
     rvec4* f      = reinterpret_cast<rvec4*>(forceBufferLambda.data());
     rvec*  fshift = as_rvec_array(shiftForceBufferLambda.data());
 
@@ -773,6 +773,14 @@ void ListedForces::calculate(struct gmx_wallcycle*                     wcycle,
             {
                 gmx_incons("The bonded interactions are not sorted for free energy");
             }
+            /* The forces computed at the foreign lambdas are never used,
+             * so the buffers only need to be cleared once instead of once
+             * per lambda value, which is costly for large systems.
+             */
+            std::fill(forceBufferLambda_.begin(), forceBufferLambda_.end(), 0.0_real);
+            std::fill(shiftForceBufferLambda_.begin(),
+                      shiftForceBufferLambda_.end(),
+                      gmx::RVec{ 0.0_real, 0.0_real, 0.0_real });
             for (int i = 0; i < 1 + enerd->foreignLambdaTerms.numLambdas(); i++)
             {
                 gmx::EnumerationArray<FreeEnergyPerturbationCouplingType, real> lam_i;
@@ -50,7 +50,6 @@
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/real.h"
-#include "gromacs/utility/smalloc.h"
 
 real calc_similar_ind(gmx_bool bRho, int nind, const int* index, const real mass[], rvec x[], rvec xp[])
 {
@@ -116,7 +115,9 @@ real rhodev(int natoms, real mass[], rvec x[], rvec xp[])
 void calc_fit_R(int ndim, int natoms, const real* w_rls, const rvec* xp, rvec* x, matrix R)
 {
     int      c, r, n, j, i, irot, s;
-    double **omega, **om;
+    double   omegaData[2 * DIM][2 * DIM], omData[2 * DIM][2 * DIM];
+    double*  omega[2 * DIM];
+    double*  om[2 * DIM];
     double   d[2 * DIM], xnr, xpc;
     matrix   vh, vk, u;
     real     mn;
@@ -128,12 +129,13 @@ void calc_fit_R(int ndim, int natoms, const real* w_rls, const rvec* xp, rvec* x
         gmx_fatal(FARGS, "calc_fit_R called with ndim=%d instead of 3 or 2", ndim);
     }
 
-    snew(omega, 2 * ndim);
-    snew(om, 2 * ndim);
+    /* jacobi() takes arrays of row pointers, use stack storage for the rows
+     * to avoid heap allocations for every fit.
+     */
     for (i = 0; i < 2 * ndim; i++)
     {
-        snew(omega[i], 2 * ndim);
-        snew(om[i], 2 * ndim);
+        omega[i] = omegaData[i];
+        om[i]    = omData[i];
     }
 
     for (i = 0; i < 2 * ndim; i++)
@@ -252,14 +254,6 @@ void calc_fit_R(int ndim, int natoms, const real* w_rls, const rvec* xp, rvec* x
     {
         R[r][r] = 1;
     }
-
-    for (i = 0; i < 2 * ndim; i++)
-    {
-        sfree(omega[i]);
-        sfree(om[i]);
-    }
-    sfree(omega);
-    sfree(om);
 }
 
 void do_fit_ndim(int ndim, int natoms, real* w_rls, const rvec* xp, rvec* x)
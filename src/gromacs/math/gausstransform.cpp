@@ -378,23 +378,21 @@ void GaussTransform3D::Impl::add(const GaussianSpreadKernelParameters::PositionA
     const auto spreadX          = gauss1d_[XX].view();
     const IVec spreadGridOffset = spreadRange_ - closestLatticePoint;
 
-    // \todo optimize these loops if performance critical
-    // The looping strategy uses that the last, x-dimension is contiguous in the memory layout
+    // The looping strategy uses that the last, x-dimension is contiguous in the memory layout,
+    // so that the innermost loop runs over plain contiguous arrays and can be vectorized
+    const int    numSpreadX  = spreadRange.end()[XX] - spreadRange.begin()[XX];
+    const float* xPrefactors = spreadX.data() + spreadRange.begin()[XX] + spreadGridOffset[XX];
     for (int zLatticeIndex = spreadRange.begin()[ZZ]; zLatticeIndex < spreadRange.end()[ZZ]; ++zLatticeIndex)
     {
-        const auto zSlice = data_.asView()[zLatticeIndex];
-
         for (int yLatticeIndex = spreadRange.begin()[YY]; yLatticeIndex < spreadRange.end()[YY]; ++yLatticeIndex)
         {
-            const auto  ySlice      = zSlice[yLatticeIndex];
+            float*      xRow        = &data_(zLatticeIndex, yLatticeIndex, spreadRange.begin()[XX]);
             const float zyPrefactor = spreadZY(zLatticeIndex + spreadGridOffset[ZZ],
                                                yLatticeIndex + spreadGridOffset[YY]);
 
-            for (int xLatticeIndex = spreadRange.begin()[XX]; xLatticeIndex < spreadRange.end()[XX];
-                 ++xLatticeIndex)
+            for (int x = 0; x < numSpreadX; ++x)
             {
-                const float xPrefactor = spreadX[xLatticeIndex + spreadGridOffset[XX]];
-                ySlice[xLatticeIndex] += zyPrefactor * xPrefactor;
+                xRow[x] += zyPrefactor * xPrefactors[x];
             }
         }
     }
@@ -0,0 +1,255 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the asynchronous trajectory writer.
+ *
+ * \ingroup module_mdlib
+ */
+#include "gmxpre.h"
+
+#include "asynctrajectorywriter.h"
+
+#include <cstdlib>
+
+#include "gromacs/fileio/gmxfio.h"
+#include "gromacs/fileio/trrio.h"
+#include "gromacs/fileio/xtcio.h"
+#include "gromacs/math/vec.h"
+#include "gromacs/utility/fatalerror.h"
+#include "gromacs/utility/gmxassert.h"
+
+namespace gmx
+{
+
+namespace
+{
+
+/*! \brief Number of frame buffers
+ *
+ * With two buffers one frame can be filled while the previous one is written.
+ */
+constexpr int c_numFrameBuffers = 2;
+
+//! Copy \p natoms vectors from \p src to \p dest, returns whether \p src was present.
+bool copyVectors(const rvec* src, int natoms, std::vector<RVec>* dest)
+{
+    if (src == nullptr)
+    {
+        return false;
+    }
+    const RVec* begin = reinterpret_cast<const RVec*>(src);
+    dest->assign(begin, begin + natoms);
+    return true;
+}
+
+//! Return a pointer to the data of \p v when \p present, otherwise nullptr.
+const rvec* vectorsOrNull(bool present, const std::vector<RVec>& v)
+{
+    return present ? as_rvec_array(v.data()) : nullptr;
+}
+
+} // namespace
+
+AsyncTrajectoryWriter::AsyncTrajectoryWriter(t_fileio* trrFile,
+                                             t_fileio* xtcFile,
+                                             real      xtcPrecision) :
+    trrFile_(trrFile), xtcFile_(xtcFile), xtcPrecision_(xtcPrecision), frames_(c_numFrameBuffers)
+{
+    writer_ = std::thread([this]() { writeFrames(); });
+}
+
+AsyncTrajectoryWriter::~AsyncTrajectoryWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+    writer_.join();
+}
+
+bool AsyncTrajectoryWriter::isRequested()
+{
+    return std::getenv("GMX_ASYNC_TRAJECTORY_OUTPUT") != nullptr;
+}
+
+void AsyncTrajectoryWriter::writeTrrFrame(int64_t     step,
+                                          double      t,
+                                          real        lambda,
+                                          const rvec* box,
+                                          int         natoms,
+                                          const rvec* x,
+                                          const rvec* v,
+                                          const rvec* f)
+{
+    GMX_RELEASE_ASSERT(trrFile_ != nullptr, "Can only write TRR frames with a TRR file");
+    GMX_RELEASE_ASSERT(box != nullptr, "Asynchronous TRR frames need a box");
+
+    Frame* frame        = acquireFrame();
+    frame->isCompressed = false;
+    frame->step         = step;
+    frame->t            = t;
+    frame->lambda       = lambda;
+    copy_mat(box, frame->box);
+    frame->natoms = natoms;
+    frame->haveX  = copyVectors(x, natoms, &frame->x);
+    frame->haveV  = copyVectors(v, natoms, &frame->v);
+    frame->haveF  = copyVectors(f, natoms, &frame->f);
+    queueFrame();
+}
+
+void AsyncTrajectoryWriter::writeXtcFrame(int64_t              step,
+                                          double               t,
+                                          const rvec*          box,
+                                          ArrayRef<const RVec> x)
+{
+    GMX_RELEASE_ASSERT(xtcFile_ != nullptr, "Can only write XTC frames with an XTC file");
+
+    Frame* frame        = acquireFrame();
+    frame->isCompressed = true;
+    frame->step         = step;
+    frame->t            = t;
+    copy_mat(box, frame->box);
+    frame->natoms = x.ssize();
+    frame->haveX  = true;
+    frame->haveV  = false;
+    frame->haveF  = false;
+    frame->x.assign(x.begin(), x.end());
+    queueFrame();
+}
+
+void AsyncTrajectoryWriter::waitUntilWritten()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]() { return numQueued_ == 0; });
+    }
+    reportWriteErrors();
+}
+
+AsyncTrajectoryWriter::Frame* AsyncTrajectoryWriter::acquireFrame()
+{
+    int index;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]() { return numQueued_ < c_numFrameBuffers; });
+        index = (firstQueued_ + numQueued_) % c_numFrameBuffers;
+    }
+    reportWriteErrors();
+
+    // The writer thread only accesses queued buffers, so we can fill this one unlocked
+    return &frames_[index];
+}
+
+void AsyncTrajectoryWriter::queueFrame()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        numQueued_++;
+    }
+    condition_.notify_all();
+}
+
+void AsyncTrajectoryWriter::reportWriteErrors()
+{
+    bool xtcWriteFailed, trrFlushFailed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        xtcWriteFailed = xtcWriteFailed_;
+        trrFlushFailed = trrFlushFailed_;
+    }
+    if (xtcWriteFailed)
+    {
+        gmx_fatal(FARGS,
+                  "XTC error. This indicates you are out of disk space, or a "
+                  "simulation with major instabilities resulting in coordinates "
+                  "that are NaN or too large to be represented in the XTC format.\n");
+    }
+    if (trrFlushFailed)
+    {
+        gmx_file("Cannot write trajectory; maybe you are out of disk space?");
+    }
+}
+
+void AsyncTrajectoryWriter::writeFrames()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        condition_.wait(lock, [this]() { return numQueued_ > 0 || stop_; });
+        if (numQueued_ == 0)
+        {
+            return;
+        }
+        const Frame& frame = frames_[firstQueued_];
+        lock.unlock();
+
+        bool xtcWriteFailed = false;
+        bool trrFlushFailed = false;
+        if (frame.isCompressed)
+        {
+            xtcWriteFailed = (write_xtc(xtcFile_,
+                                        frame.natoms,
+                                        frame.step,
+                                        frame.t,
+                                        frame.box,
+                                        as_rvec_array(frame.x.data()),
+                                        xtcPrecision_)
+                              == 0);
+        }
+        else
+        {
+            gmx_trr_write_frame(trrFile_,
+                                frame.step,
+                                frame.t,
+                                frame.lambda,
+                                frame.box,
+                                frame.natoms,
+                                vectorsOrNull(frame.haveX, frame.x),
+                                vectorsOrNull(frame.haveV, frame.v),
+                                vectorsOrNull(frame.haveF, frame.f));
+            trrFlushFailed = (gmx_fio_flush(trrFile_) != 0);
+        }
+
+        lock.lock();
+        xtcWriteFailed_ = xtcWriteFailed_ || xtcWriteFailed;
+        trrFlushFailed_ = trrFlushFailed_ || trrFlushFailed;
+        firstQueued_    = (firstQueued_ + 1) % c_numFrameBuffers;
+        numQueued_--;
+        condition_.notify_all();
+    }
+}
+
+} // namespace gmx
@@ -0,0 +1,180 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Declares a writer that moves trajectory output off the MD critical path.
+ *
+ * \ingroup module_mdlib
+ */
+#ifndef GMX_MDLIB_ASYNCTRAJECTORYWRITER_H
+#define GMX_MDLIB_ASYNCTRAJECTORYWRITER_H
+
+#include <cstdint>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/classhelpers.h"
+#include "gromacs/utility/real.h"
+
+struct t_fileio;
+
+namespace gmx
+{
+
+/*! \internal \brief
+ * Writes TRR and XTC frames on a background thread.
+ *
+ * The frame data is copied into one of a bounded number of buffers,
+ * after which the caller can continue with the next MD steps while the
+ * frame is compressed and written. When all buffers hold frames that
+ * have not been written yet, the caller waits for the oldest one to be
+ * written. Frames are written in the order they were passed.
+ *
+ * Before anything depends on the contents or positions of the output
+ * files, in particular before writing a checkpoint, waitUntilWritten()
+ * must be called. Errors that occur while writing are reported by the
+ * next call on the calling thread.
+ */
+class AsyncTrajectoryWriter
+{
+public:
+    /*! \brief Start the writer thread.
+     *
+     * \param[in] trrFile       TRR file to write uncompressed frames to, can be nullptr.
+     * \param[in] xtcFile       XTC file to write compressed frames to, can be nullptr.
+     * \param[in] xtcPrecision  Precision of the XTC compression.
+     */
+    AsyncTrajectoryWriter(t_fileio* trrFile, t_fileio* xtcFile, real xtcPrecision);
+    //! Writes the pending frames and joins the writer thread.
+    ~AsyncTrajectoryWriter();
+    GMX_DISALLOW_COPY_MOVE_AND_ASSIGN(AsyncTrajectoryWriter);
+
+    /*! \brief Whether the user requested asynchronous trajectory writing.
+     *
+     * Set through the GMX_ASYNC_TRAJECTORY_OUTPUT environment variable.
+     */
+    static bool isRequested();
+
+    /*! \brief Queue a frame for the TRR file, as gmx_trr_write_frame().
+     *
+     * Each of \p x, \p v and \p f can be nullptr, they are copied
+     * before returning.
+     */
+    void writeTrrFrame(int64_t     step,
+                       double      t,
+                       real        lambda,
+                       const rvec* box,
+                       int         natoms,
+                       const rvec* x,
+                       const rvec* v,
+                       const rvec* f);
+
+    //! Queue a frame for the XTC file, \p x is copied before returning.
+    void writeXtcFrame(int64_t step, double t, const rvec* box, ArrayRef<const RVec> x);
+
+    /*! \brief Wait until all queued frames have been written and flushed.
+     *
+     * Issues a fatal error when writing one of the frames failed.
+     */
+    void waitUntilWritten();
+
+private:
+    //! Buffer holding a single frame to write.
+    struct Frame
+    {
+        //! Whether the frame goes to the XTC file, otherwise to the TRR file.
+        bool isCompressed = false;
+        //! Step of the frame.
+        int64_t step = 0;
+        //! Time of the frame.
+        double t = 0;
+        //! Lambda of the frame, only used for TRR.
+        real lambda = 0;
+        //! Box of the frame.
+        matrix box = { { 0 } };
+        //! Number of atoms.
+        int natoms = 0;
+        //! Whether the frame has coordinates, velocities and forces.
+        bool haveX = false, haveV = false, haveF = false;
+        //! Coordinates.
+        std::vector<RVec> x;
+        //! Velocities.
+        std::vector<RVec> v;
+        //! Forces.
+        std::vector<RVec> f;
+    };
+
+    //! Wait for a free buffer and return it, reports earlier errors.
+    Frame* acquireFrame();
+    //! Pass the buffer returned by acquireFrame() to the writer thread.
+    void queueFrame();
+    //! Issue a fatal error when writing previous frames failed.
+    void reportWriteErrors();
+    //! Main loop of the writer thread.
+    void writeFrames();
+
+    //! The TRR output file.
+    t_fileio* trrFile_;
+    //! The XTC output file.
+    t_fileio* xtcFile_;
+    //! Precision of the XTC compression.
+    real xtcPrecision_;
+    //! Frame buffers, used as a ring.
+    std::vector<Frame> frames_;
+    //! Index of the oldest queued frame.
+    int firstQueued_ = 0;
+    //! Number of queued frames, including the one being written.
+    int numQueued_ = 0;
+    //! Whether writing an XTC frame failed.
+    bool xtcWriteFailed_ = false;
+    //! Whether flushing the TRR file failed.
+    bool trrFlushFailed_ = false;
+    //! Whether the writer thread should stop.
+    bool stop_ = false;
+    //! Protects the members above that are modified after construction.
+    std::mutex mutex_;
+    //! Signals changes to the queue.
+    std::condition_variable condition_;
+    //! The writer thread.
+    std::thread writer_;
+};
+
+} // namespace gmx
+
+#endif
@@ -136,6 +136,10 @@ void init_parallel(MPI_Comm                    communicator,
                    gmx_mtop_t*                 mtop,
                    PartialDeserializedTprFile* partialDeserializedTpr)
 {
+    if (isMainRank)
+    {
+        serializeTprBodyForCommunication(partialDeserializedTpr, inputrec, mtop);
+    }
     bc_tpxheader(communicator, &partialDeserializedTpr->header);
     bc_tprCharBuffer(communicator, isMainRank, &partialDeserializedTpr->body);
     if (!isMainRank)
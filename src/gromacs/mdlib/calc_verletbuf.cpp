@@ -716,6 +716,14 @@ static real energyDriftAtomPair(bool                     isConstrained_i,
                                 real                     r_buffer,
                                 const pot_derivatives_t* der)
 {
+    if (der->pot == 0 && der->md1 == 0 && der->d2 == 0 && der->md3 == 0)
+    {
+        // All terms below are proportional to the derivatives, so we can
+        // skip the costly exp() and erfc() evaluations for, e.g., pairs
+        // without charge or without LJ and for the force error estimates
+        return 0;
+    }
+
     // For relatively small arguments erfc() is so small that if will be 0.0
     // when stored in a float. We set an argument limit of 8 (Erfc(8)=1e-29),
     // such that we can divide by erfc and have some space left for arithmetic.
@@ -809,21 +817,27 @@ static real energyDrift(gmx::ArrayRef<const VerletbufAtomtype> att,
         return drift_tot;
     }
 
+    // Get the thermal displacement variances for all atom types once,
+    // instead of once per atom type pair
+    std::vector<std::pair<real, real>> sigma2(att.size());
+    for (gmx::Index i = 0; i < att.ssize(); i++)
+    {
+        get_atom_sigma2(kT_fac, att[i].prop, &sigma2[i].first, &sigma2[i].second);
+    }
+
     // Here add up the contribution of all atom pairs in the system to
     // (estimated) energy drift by looping over all atom type pairs.
     for (gmx::Index i = 0; i < att.ssize(); i++)
     {
-        // Get the thermal displacement variance for the i-atom type
-        const AtomNonbondedAndKineticProperties& propI = att[i].prop;
-        real                                     s2i_2d, s2i_3d;
-        get_atom_sigma2(kT_fac, propI, &s2i_2d, &s2i_3d);
+        const AtomNonbondedAndKineticProperties& propI  = att[i].prop;
+        const real                               s2i_2d = sigma2[i].first;
+        const real                               s2i_3d = sigma2[i].second;
 
         for (gmx::Index j = i; j < att.ssize(); j++)
         {
-            // Get the thermal displacement variance for the j-atom type
-            const AtomNonbondedAndKineticProperties& propJ = att[j].prop;
-            real                                     s2j_2d, s2j_3d;
-            get_atom_sigma2(kT_fac, propJ, &s2j_2d, &s2j_3d);
+            const AtomNonbondedAndKineticProperties& propJ  = att[j].prop;
+            const real                               s2j_2d = sigma2[j].first;
+            const real                               s2j_3d = sigma2[j].second;
 
             /* Add up the up to four independent variances */
             real s2 = s2i_2d + s2i_3d + s2j_2d + s2j_3d;
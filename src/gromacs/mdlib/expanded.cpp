@@ -857,8 +857,7 @@ static int ChooseNewLambda(int               nlim,
 
     int                  i, ifep, minfep, maxfep, lamnew, lamtrial, starting_fep_state;
     real                 r1, r2, de, trialprob, tprob = 0;
-    double *             propose, *accept, *remainder;
-    double               pks;
+    double               pks = 0;
     real                 pnorm;
     gmx::ThreeFry2x64<0> rng(
             seed, gmx::RandomDomain::ExpandedEnsemble); // We only draw once, so zero bits internal counter is fine
@@ -892,9 +891,15 @@ static int ChooseNewLambda(int               nlim,
         }
     }
 
-    snew(propose, nlim);
-    snew(accept, nlim);
-    snew(remainder, nlim);
+    std::vector<double> propose(nlim);
+    std::vector<double> accept(nlim);
+    std::vector<double> remainder(nlim);
+
+    /* The Gibbs probabilities only depend on the lambda range, which
+     * changes between repeats only with a restricted range.
+     */
+    int gibbsMinfep = -1;
+    int gibbsMaxfep = -1;
 
     for (i = 0; i < expand->lmc_repeats; i++)
     {
@@ -930,7 +935,12 @@ static int ChooseNewLambda(int               nlim,
                 }
             }
 
-            GenerateGibbsProbabilities(weighted_lamee, p_k, &pks, minfep, maxfep);
+            if (minfep != gibbsMinfep || maxfep != gibbsMaxfep)
+            {
+                GenerateGibbsProbabilities(weighted_lamee, p_k, &pks, minfep, maxfep);
+                gibbsMinfep = minfep;
+                gibbsMaxfep = maxfep;
+            }
 
             if (expand->elmcmove == LambdaMoveCalculation::Gibbs)
             {
@@ -1152,10 +1162,6 @@ static int ChooseNewLambda(int               nlim,
 
     dfhist->Tij_empirical[starting_fep_state][lamnew] += 1.0;
 
-    sfree(propose);
-    sfree(accept);
-    sfree(remainder);
-
     return lamnew;
 }
 
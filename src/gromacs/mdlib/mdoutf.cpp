@@ -41,6 +41,7 @@
 #include <cstring>
 
 #include <filesystem>
+#include <future>
 #include <memory>
 #include <string>
 
@@ -50,10 +51,13 @@
 #include "gromacs/fileio/checkpoint.h"
 #include "gromacs/fileio/filetypes.h"
 #include "gromacs/fileio/gmxfio.h"
+#include "gromacs/fileio/h5md.h"
+#include "gromacs/fileio/h5mdtrajectorywriter.h"
 #include "gromacs/fileio/tngio.h"
 #include "gromacs/fileio/trrio.h"
 #include "gromacs/fileio/xtcio.h"
 #include "gromacs/math/vec.h"
+#include "gromacs/mdlib/asynctrajectorywriter.h"
 #include "gromacs/mdlib/energyoutput.h"
 #include "gromacs/mdrunutility/handlerestart.h"
 #include "gromacs/mdrunutility/multisim.h"
@@ -89,6 +93,11 @@ struct gmx_mdoutf
 {
     t_fileio*                      fp_trn;
     t_fileio*                      fp_xtc;
+    gmx::AsyncTrajectoryWriter*    asyncWriter; /* writes fp_trn and fp_xtc frames, can be null */
+    gmx::H5md*                     h5md; /* H5MD output, can be shared by all DD ranks */
+    gmx::H5mdTrajectoryWriter*     h5mdWriter;
+    gmx::H5md*                     h5mdCompressed; /* H5MD output of compressed positions */
+    gmx::H5mdTrajectoryWriter*     h5mdCompressedWriter;
     gmx_tng_trajectory_t           tng;
     gmx_tng_trajectory_t           tng_low_prec;
     int                            x_compression_precision; /* only used by XTC output */
@@ -109,9 +118,54 @@ struct gmx_mdoutf
     const gmx::MDModulesNotifiers* mdModulesNotifiers;
     bool                           simulationsShareState;
     MPI_Comm                       mainRanksComm;
+    bool                           finishCheckpointsInBackground;
+    std::future<std::string>       pendingCheckpoint; /* syncs the last checkpoint, if valid */
 };
 
 
+/*! \brief Open the H5MD trajectory \p filename for output to \p file with \p writer
+ *
+ * With domain decomposition and parallel HDF5, the file is shared by all
+ * ranks, which then write their home atoms directly. Otherwise only the
+ * main rank opens and writes the file.
+ */
+static void openH5mdOutput(gmx::H5md**                     file,
+                           gmx::H5mdTrajectoryWriter**     writer,
+                           FILE*                           fplog,
+                           const char*                     filename,
+                           const t_commrec*                cr,
+                           const t_inputrec*               ir,
+                           const gmx_mtop_t&               top_global,
+                           bool                            restartWithAppending,
+                           const gmx::H5mdWriterOptions&   options)
+{
+    if (restartWithAppending)
+    {
+        gmx_fatal(FARGS,
+                  "Appending to H5MD trajectory files is not supported, restart with -noappend");
+    }
+
+    const bool shareFile = haveDDAtomOrdering(*cr) && cr->dd->nnodes > 1
+                           && gmx::H5md::supportsParallelIO();
+    if (!shareFile && !MAIN(cr))
+    {
+        return;
+    }
+
+    char author[STRLEN];
+    gmx_getusername(author, STRLEN);
+    *file   = shareFile ? new gmx::H5md(filename, gmx::H5mdFileMode::Write, cr->dd->mpi_comm_all)
+                        : new gmx::H5md(filename, gmx::H5mdFileMode::Write);
+    *writer = new gmx::H5mdTrajectoryWriter(*file, top_global.natoms, ir->pbcType, author, options);
+    if (shareFile && fplog)
+    {
+        fprintf(fplog,
+                "Writing H5MD trajectory %s in parallel from all %d domain decomposition ranks\n",
+                filename,
+                cr->dd->nnodes);
+    }
+}
+
 gmx_mdoutf_t init_mdoutf(FILE*                          fplog,
                          int                            nfile,
                          const t_filenm                 fnm[],
@@ -133,14 +187,20 @@ gmx_mdoutf_t init_mdoutf(FILE*                          fplog,
     int          i;
     bool restartWithAppending = (startingBehavior == gmx::StartingBehavior::RestartWithAppending);
 
-    snew(of, 1);
-
-    of->fp_trn       = nullptr;
-    of->fp_ene       = nullptr;
-    of->fp_xtc       = nullptr;
-    of->tng          = nullptr;
-    of->tng_low_prec = nullptr;
-    of->fp_dhdl      = nullptr;
+    /* The pending checkpoint needs construction, so we can not use snew() */
+    of = new gmx_mdoutf();
+
+    of->fp_trn               = nullptr;
+    of->fp_ene               = nullptr;
+    of->fp_xtc               = nullptr;
+    of->asyncWriter          = nullptr;
+    of->h5md                 = nullptr;
+    of->h5mdWriter           = nullptr;
+    of->h5mdCompressed       = nullptr;
+    of->h5mdCompressedWriter = nullptr;
+    of->tng                  = nullptr;
+    of->tng_low_prec         = nullptr;
+    of->fp_dhdl              = nullptr;
 
     of->eIntegrator             = ir->eI;
     of->bExpanded               = ir->bExpanded;
@@ -158,6 +218,18 @@ gmx_mdoutf_t init_mdoutf(FILE*                          fplog,
     {
         of->mainRanksComm = ms->mainRanksComm_;
     }
+    /* The MPI barrier for shared states can not be called from another thread */
+    of->finishCheckpointsInBackground = (std::getenv("GMX_ASYNC_CHECKPOINT") != nullptr
+                                         && !simulationsShareState && !GMX_FAHCORE);
+    if (of->finishCheckpointsInBackground && fplog)
+    {
+        fprintf(fplog, "Checkpoint files will be synced to disk and renamed in the background\n");
+    }
+
+    const bool writeFullPrecisionOutput =
+            ((EI_DYNAMICS(ir->eI) || EI_ENERGY_MINIMIZATION(ir->eI))
+             && (!GMX_FAHCORE
+                 && !(EI_DYNAMICS(ir->eI) && ir->nstxout == 0 && ir->nstvout == 0 && ir->nstfout == 0)));
 
     if (MAIN(cr))
     {
@@ -168,7 +240,7 @@ gmx_mdoutf_t init_mdoutf(FILE*                          fplog,
         if (EI_DYNAMICS(ir->eI) && ir->nstxout_compressed > 0)
         {
             const char* filename;
-            filename = ftp2fn(efCOMPRESSED, nfile, fnm);
+            filename = ftp2fn(efMDRUNCOMPRESSED, nfile, fnm);
             switch (fn2ftp(filename))
             {
                 case efXTC: of->fp_xtc = open_xtc(filename, filemode); break;
@@ -180,15 +252,14 @@ gmx_mdoutf_t init_mdoutf(FILE*                          fplog,
                     }
                     bCiteTng = TRUE;
                     break;
+                case efH5MD: /* Opened below, as all ranks might write to it */ break;
                 default: gmx_incons("Invalid reduced precision file format");
             }
         }
-        if ((EI_DYNAMICS(ir->eI) || EI_ENERGY_MINIMIZATION(ir->eI))
-            && (!GMX_FAHCORE
-                && !(EI_DYNAMICS(ir->eI) && ir->nstxout == 0 && ir->nstvout == 0 && ir->nstfout == 0)))
+        if (writeFullPrecisionOutput)
         {
             const char* filename;
-            filename = ftp2fn(efTRN, nfile, fnm);
+            filename = ftp2fn(efMDRUNTRN, nfile, fnm);
             switch (fn2ftp(filename))
             {
                 case efTRR:
@@ -209,6 +280,7 @@ gmx_mdoutf_t init_mdoutf(FILE*                          fplog,
                     }
                     bCiteTng = TRUE;
                     break;
+                case efH5MD: /* Opened below, as all ranks might write to it */ break;
                 default: gmx_incons("Invalid full precision file format");
             }
         }
@@ -253,6 +325,56 @@ gmx_mdoutf_t init_mdoutf(FILE*                          fplog,
         {
             snew(of->f_global, top_global.natoms);
         }
+
+        if ((of->fp_trn || of->fp_xtc) && gmx::AsyncTrajectoryWriter::isRequested())
+        {
+            of->asyncWriter = new gmx::AsyncTrajectoryWriter(
+                    of->fp_trn, of->fp_xtc, of->x_compression_precision);
+            if (fplog)
+            {
+                fprintf(fplog, "Writing trajectory frames asynchronously on a separate thread\n");
+            }
+        }
+    }
+
+    if (EI_DYNAMICS(ir->eI) && ir->nstxout_compressed > 0
+        && fn2ftp(ftp2fn(efMDRUNCOMPRESSED, nfile, fnm)) == efH5MD)
+    {
+        gmx::H5mdWriterOptions options;
+        options.positionPrecision = ir->x_compression_precision;
+        for (int i = 0; i < top_global.natoms; i++)
+        {
+            if (getGroupType(top_global.groups, SimulationAtomGroupType::CompressedPositionOutput, i)
+                == 0)
+            {
+                options.selection.push_back(i);
+            }
+        }
+        if (gmx::ssize(options.selection) == top_global.natoms)
+        {
+            options.selection.clear();
+        }
+        openH5mdOutput(&of->h5mdCompressed,
+                       &of->h5mdCompressedWriter,
+                       fplog,
+                       ftp2fn(efMDRUNCOMPRESSED, nfile, fnm),
+                       cr,
+                       ir,
+                       top_global,
+                       restartWithAppending,
+                       options);
+    }
+    if (writeFullPrecisionOutput && fn2ftp(ftp2fn(efMDRUNTRN, nfile, fnm)) == efH5MD)
+    {
+        openH5mdOutput(&of->h5md,
+                       &of->h5mdWriter,
+                       fplog,
+                       ftp2fn(efMDRUNTRN, nfile, fnm),
+                       cr,
+                       ir,
+                       top_global,
+                       restartWithAppending,
+                       {});
     }
 
     if (bCiteTng)
@@ -290,12 +412,118 @@ static void mpiBarrierBeforeRename(const bool applyMpiBarrierBeforeRename, MPI_C
 #endif
     }
 }
+/*! \brief Syncs the checkpoint file \p fp and all output files to disk, closes \p fp
+ * and moves it from \p fntemp to \p fn
+ *
+ * \returns An error message when writing failed, an empty string otherwise
+ */
+static std::string finishCheckpointFile(t_fileio*   fp,
+                                        const char* fntemp,
+                                        const char* fn,
+                                        gmx_bool    bNumberAndKeep,
+                                        bool        applyMpiBarrierBeforeRename,
+                                        MPI_Comm    mpiBarrierCommunicator)
+{
+    /* we really, REALLY, want to make sure to physically write the checkpoint,
+       and all the files it depends on, out to disk. Because we've
+       opened the checkpoint with gmx_fio_open(), it's in our list
+       of open files.  */
+    t_fileio* ret = gmx_fio_all_output_fsync();
+
+    if (ret)
+    {
+        char buf[STRLEN];
+        sprintf(buf,
+                "Cannot fsync '%s'; maybe you are out of disk space?",
+                gmx_fio_getname(ret).string().c_str());
+
+        if (getenv(GMX_IGNORE_FSYNC_FAILURE_ENV) == nullptr)
+        {
+            return buf;
+        }
+        else
+        {
+            gmx_warning("%s", buf);
+        }
+    }
+
+    if (gmx_fio_close(fp) != 0)
+    {
+        return "Cannot read/write checkpoint; corrupt file, or maybe you are out of disk space?";
+    }
+
+    /* we don't move the checkpoint if the user specified they didn't want it,
+       or if the fsyncs failed */
+#if !GMX_NO_RENAME
+    if (!bNumberAndKeep && !ret)
+    {
+        char buf[1024];
+        // Add a barrier before renaming to reduce chance to get out of sync (#2440)
+        // Note: Checkpoint might only exist on some ranks, so put barrier before if clause (#3919)
+        mpiBarrierBeforeRename(applyMpiBarrierBeforeRename, mpiBarrierCommunicator);
+        if (gmx_fexist(fn))
+        {
+            /* Rename the previous checkpoint file */
+            std::strcpy(buf, fn);
+            buf[std::strlen(fn) - std::strlen(ftp2ext(fn2ftp(fn))) - 1] = '\0';
+            std::strcat(buf, "_prev");
+            std::strcat(buf, fn + std::strlen(fn) - std::strlen(ftp2ext(fn2ftp(fn))) - 1);
+            if (!GMX_FAHCORE)
+            {
+                /* we copy here so that if something goes wrong between now and
+                 * the rename below, there's always a state.cpt.
+                 * If renames are atomic (such as in POSIX systems),
+                 * this copying should be unneccesary.
+                 */
+                if (gmx_file_copy(fn, buf, FALSE) != 0)
+                {
+                    GMX_THROW(gmx::FileIOError(
+                            gmx::formatString("Cannot rename checkpoint file from %s to %s; maybe "
+                                              "you are out of disk space?",
+                                              fn,
+                                              buf)));
+                }
+            }
+            else
+            {
+                gmx_file_rename(fn, buf);
+            }
+        }
+
+        /* Rename the checkpoint file from the temporary to the final name */
+        mpiBarrierBeforeRename(applyMpiBarrierBeforeRename, mpiBarrierCommunicator);
+
+        try
+        {
+            gmx_file_rename(fntemp, fn);
+        }
+        catch (gmx::FileIOError const&)
+        {
+            // In this case we can be more helpful than the generic message from gmx_file_rename
+            GMX_THROW(gmx::FileIOError(
+                    "Cannot rename checkpoint file; maybe you are out of disk space?"));
+        }
+    }
+#else
+    GMX_UNUSED_VALUE(fntemp);
+    GMX_UNUSED_VALUE(fn);
+    GMX_UNUSED_VALUE(bNumberAndKeep);
+    GMX_UNUSED_VALUE(applyMpiBarrierBeforeRename);
+    GMX_UNUSED_VALUE(mpiBarrierCommunicator);
+#endif /* GMX_NO_RENAME */
+
+    return {};
+}
+
 /*! \brief Write a checkpoint to the filename
  *
  * Appends the _step<step>.cpt with bNumberAndKeep, otherwise moves
  * the previous checkpoint filename with suffix _prev.cpt.
+ *
+ * With \p finishInBackground, only the data is written here, syncing
+ * and renaming the files is done by the returned future.
  */
-static void write_checkpoint(const char*                     fn,
+static std::future<std::string> write_checkpoint(const char*                     fn,
                              gmx_bool                        bNumberAndKeep,
                              FILE*                           fplog,
                              const t_commrec*                cr,
@@ -312,13 +540,13 @@ static void write_checkpoint(const char*                     fn,
                              const gmx::MDModulesNotifiers&  mdModulesNotifiers,
                              gmx::WriteCheckpointDataHolder* modularSimulatorCheckpointData,
                              bool                            applyMpiBarrierBeforeRename,
-                             MPI_Comm                        mpiBarrierCommunicator)
+                             MPI_Comm                        mpiBarrierCommunicator,
+                             bool                            finishInBackground)
 {
     t_fileio* fp;
     char*     fntemp; /* the temporary checkpoint file name */
     int       npmenodes;
     char      buf[1024], suffix[5 + STEPSTRSIZE], sbuf[STEPSTRSIZE];
-    t_fileio* ret;
 
     if (haveDDAtomOrdering(*cr))
     {
@@ -416,86 +644,28 @@ static void write_checkpoint(const char*                     fn,
                           &outputfiles,
                           modularSimulatorCheckpointData);
 
-    /* we really, REALLY, want to make sure to physically write the checkpoint,
-       and all the files it depends on, out to disk. Because we've
-       opened the checkpoint with gmx_fio_open(), it's in our list
-       of open files.  */
-    ret = gmx_fio_all_output_fsync();
-
-    if (ret)
-    {
-        char buf[STRLEN];
-        sprintf(buf,
-                "Cannot fsync '%s'; maybe you are out of disk space?",
-                gmx_fio_getname(ret).string().c_str());
-
-        if (getenv(GMX_IGNORE_FSYNC_FAILURE_ENV) == nullptr)
-        {
-            gmx_file(buf);
-        }
-        else
-        {
-            gmx_warning("%s", buf);
-        }
-    }
-
-    if (gmx_fio_close(fp) != 0)
+    if (finishInBackground)
     {
-        gmx_file("Cannot read/write checkpoint; corrupt file, or maybe you are out of disk space?");
+        /* The data is in the file buffers now, so the state can change */
+        std::string tempFileName(fntemp);
+        std::string fileName(fn);
+        sfree(fntemp);
+        return std::async(std::launch::async, [=]() {
+            return finishCheckpointFile(fp,
+                                        tempFileName.c_str(),
+                                        fileName.c_str(),
+                                        bNumberAndKeep,
+                                        applyMpiBarrierBeforeRename,
+                                        mpiBarrierCommunicator);
+        });
     }
 
-    /* we don't move the checkpoint if the user specified they didn't want it,
-       or if the fsyncs failed */
-#if !GMX_NO_RENAME
-    if (!bNumberAndKeep && !ret)
+    const std::string errorMessage = finishCheckpointFile(
+            fp, fntemp, fn, bNumberAndKeep, applyMpiBarrierBeforeRename, mpiBarrierCommunicator);
+    if (!errorMessage.empty())
     {
-        // Add a barrier before renaming to reduce chance to get out of sync (#2440)
-        // Note: Checkpoint might only exist on some ranks, so put barrier before if clause (#3919)
-        mpiBarrierBeforeRename(applyMpiBarrierBeforeRename, mpiBarrierCommunicator);
-        if (gmx_fexist(fn))
-        {
-            /* Rename the previous checkpoint file */
-            std::strcpy(buf, fn);
-            buf[std::strlen(fn) - std::strlen(ftp2ext(fn2ftp(fn))) - 1] = '\0';
-            std::strcat(buf, "_prev");
-            std::strcat(buf, fn + std::strlen(fn) - std::strlen(ftp2ext(fn2ftp(fn))) - 1);
-            if (!GMX_FAHCORE)
-            {
-                /* we copy here so that if something goes wrong between now and
-                 * the rename below, there's always a state.cpt.
-                 * If renames are atomic (such as in POSIX systems),
-                 * this copying should be unneccesary.
-                 */
-                if (gmx_file_copy(fn, buf, FALSE) != 0)
-                {
-                    GMX_THROW(gmx::FileIOError(
-                            gmx::formatString("Cannot rename checkpoint file from %s to %s; maybe "
-                                              "you are out of disk space?",
-                                              fn,
-                                              buf)));
-                }
-            }
-            else
-            {
-                gmx_file_rename(fn, buf);
-            }
-        }
-
-        /* Rename the checkpoint file from the temporary to the final name */
-        mpiBarrierBeforeRename(applyMpiBarrierBeforeRename, mpiBarrierCommunicator);
-
-        try
-        {
-            gmx_file_rename(fntemp, fn);
-        }
-        catch (gmx::FileIOError const&)
-        {
-            // In this case we can be more helpful than the generic message from gmx_file_rename
-            GMX_THROW(gmx::FileIOError(
-                    "Cannot rename checkpoint file; maybe you are out of disk space?"));
-        }
+        gmx_file(errorMessage);
     }
-#endif /* GMX_NO_RENAME */
 
     sfree(fntemp);
 
@@ -515,6 +685,23 @@ static void write_checkpoint(const char*                     fn,
      */
     fcCheckpoint();
 #endif /* end GMX_FAHCORE block */
+
+    return {};
+}
+
+/*! \brief Waits until the checkpoint finished in the background, if any, is on disk */
+static void waitForPendingCheckpoint(gmx_mdoutf_t of)
+{
+    if (!of->pendingCheckpoint.valid())
+    {
+        return;
+    }
+    /* This also rethrows exceptions from renaming the files and leaves the future invalid */
+    const std::string errorMessage = of->pendingCheckpoint.get();
+    if (!errorMessage.empty())
+    {
+        gmx_file(errorMessage);
+    }
 }
 
 void mdoutf_write_checkpoint(gmx_mdoutf_t                    of,
@@ -526,6 +713,14 @@ void mdoutf_write_checkpoint(gmx_mdoutf_t                    of,
                              ObservablesHistory*             observablesHistory,
                              gmx::WriteCheckpointDataHolder* modularSimulatorCheckpointData)
 {
+    /* The checkpoint stores the positions of the output files,
+     * so all frames of earlier steps need to be on disk. */
+    if (of->asyncWriter)
+    {
+        of->asyncWriter->waitUntilWritten();
+    }
+    /* The previous checkpoint needs to be in place before we rename it */
+    waitForPendingCheckpoint(of);
     fflush_tng(of->tng);
     fflush_tng(of->tng_low_prec);
     /* Write the checkpoint file.
@@ -533,25 +728,26 @@ void mdoutf_write_checkpoint(gmx_mdoutf_t                    of,
      * renaming old and new checkpoint files to minimize the risk of
      * checkpoint files getting out of sync.
      */
-    gmx::IVec one_ivec = { 1, 1, 1 };
-    write_checkpoint(of->fn_cpt,
-                     of->bKeepAndNumCPT,
-                     fplog,
-                     cr,
-                     haveDDAtomOrdering(*cr) ? cr->dd->numCells : one_ivec,
-                     haveDDAtomOrdering(*cr) ? cr->dd->nnodes : cr->nnodes,
-                     of->eIntegrator,
-                     of->simulation_part,
-                     of->bExpanded,
-                     of->elamstats,
-                     step,
-                     t,
-                     state_global,
-                     observablesHistory,
-                     *(of->mdModulesNotifiers),
-                     modularSimulatorCheckpointData,
-                     of->simulationsShareState,
-                     of->mainRanksComm);
+    gmx::IVec one_ivec    = { 1, 1, 1 };
+    of->pendingCheckpoint = write_checkpoint(of->fn_cpt,
+                                             of->bKeepAndNumCPT,
+                                             fplog,
+                                             cr,
+                                             haveDDAtomOrdering(*cr) ? cr->dd->numCells : one_ivec,
+                                             haveDDAtomOrdering(*cr) ? cr->dd->nnodes : cr->nnodes,
+                                             of->eIntegrator,
+                                             of->simulation_part,
+                                             of->bExpanded,
+                                             of->elamstats,
+                                             step,
+                                             t,
+                                             state_global,
+                                             observablesHistory,
+                                             *(of->mdModulesNotifiers),
+                                             modularSimulatorCheckpointData,
+                                             of->simulationsShareState,
+                                             of->mainRanksComm,
+                                             of->finishCheckpointsInBackground);
 }
 
 void mdoutf_write_to_trajectory_files(FILE*                           fplog,
@@ -569,6 +765,21 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
 {
     const rvec* f_global;
 
+    /* With shared H5MD files, each rank writes its own x, v and f,
+     * so these only need to be collected for other output. */
+    const bool writeLocalH5mdFrame = (of->h5md != nullptr && of->h5md->isParallel());
+    const bool writeLocalH5mdCompressedFrame =
+            (of->h5mdCompressed != nullptr && of->h5mdCompressed->isParallel());
+    int collectMdofFlags = mdof_flags;
+    if (writeLocalH5mdFrame)
+    {
+        collectMdofFlags &= ~(MDOF_X | MDOF_V | MDOF_F);
+    }
+    if (writeLocalH5mdCompressedFrame)
+    {
+        collectMdofFlags &= ~MDOF_X_COMPRESSED;
+    }
+
     if (haveDDAtomOrdering(*cr))
     {
         if (mdof_flags & MDOF_CPT)
@@ -577,7 +788,7 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
         }
         else
         {
-            if (mdof_flags & (MDOF_X | MDOF_X_COMPRESSED))
+            if (collectMdofFlags & (MDOF_X | MDOF_X_COMPRESSED))
             {
                 auto globalXRef = MAIN(cr) ? state_global->x : gmx::ArrayRef<gmx::RVec>();
                 dd_collect_vec(cr->dd,
@@ -587,7 +798,7 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
                                state_local->x,
                                globalXRef);
             }
-            if (mdof_flags & MDOF_V)
+            if (collectMdofFlags & MDOF_V)
             {
                 auto globalVRef = MAIN(cr) ? state_global->v : gmx::ArrayRef<gmx::RVec>();
                 dd_collect_vec(cr->dd,
@@ -599,7 +810,7 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
             }
         }
         f_global = of->f_global;
-        if (mdof_flags & MDOF_F)
+        if (collectMdofFlags & MDOF_F)
         {
             auto globalFRef = MAIN(cr) ? gmx::arrayRefFromArray(
                                       reinterpret_cast<gmx::RVec*>(of->f_global), of->natoms_global)
@@ -620,6 +831,40 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
         f_global = as_rvec_array(f_local.data());
     }
 
+    if (writeLocalH5mdFrame && (mdof_flags & (MDOF_X | MDOF_V | MDOF_F)))
+    {
+        gmx::ArrayRef<const int> globalAtomIndices = dd_localStateGlobalAtomIndices(
+                *cr->dd, state_local->ddp_count, state_local->ddp_count_cg_gl, state_local->cg_gl);
+        const rvec* x = (mdof_flags & MDOF_X) ? state_local->x.rvec_array() : nullptr;
+        const rvec* v = (mdof_flags & MDOF_V) ? state_local->v.rvec_array() : nullptr;
+        const rvec* f = (mdof_flags & MDOF_F) ? as_rvec_array(f_local.data()) : nullptr;
+        of->h5mdWriter->writeLocalFrame(step, t, state_local->box, globalAtomIndices, x, v, f);
+    }
+    if (writeLocalH5mdCompressedFrame && (mdof_flags & MDOF_X_COMPRESSED))
+    {
+        gmx::ArrayRef<const int> globalAtomIndices = dd_localStateGlobalAtomIndices(
+                *cr->dd, state_local->ddp_count, state_local->ddp_count_cg_gl, state_local->cg_gl);
+        of->h5mdCompressedWriter->writeLocalFrame(step,
+                                                  t,
+                                                  state_local->box,
+                                                  globalAtomIndices,
+                                                  state_local->x.rvec_array(),
+                                                  nullptr,
+                                                  nullptr);
+    }
+    if (mdof_flags & MDOF_CPT)
+    {
+        /* Flushing is collective for shared files, so we do it here on all ranks */
+        if (of->h5md)
+        {
+            of->h5md->flush();
+        }
+        if (of->h5mdCompressed)
+        {
+            of->h5mdCompressed->flush();
+        }
+    }
+
     if (MAIN(cr))
     {
         if (mdof_flags & MDOF_CPT)
@@ -634,7 +879,19 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
             const rvec* v = (mdof_flags & MDOF_V) ? state_global->v.rvec_array() : nullptr;
             const rvec* f = (mdof_flags & MDOF_F) ? f_global : nullptr;
 
-            if (of->fp_trn)
+            if (of->asyncWriter && of->fp_trn)
+            {
+                of->asyncWriter->writeTrrFrame(
+                        step,
+                        t,
+                        state_local->lambda[FreeEnergyPerturbationCouplingType::Fep],
+                        state_local->box,
+                        natoms,
+                        x,
+                        v,
+                        f);
+            }
+            else if (of->fp_trn)
             {
                 gmx_trr_write_frame(of->fp_trn,
                                     step,
@@ -651,6 +908,15 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
                 }
             }
 
+            else if (of->h5mdWriter)
+            {
+                /* Shared files have been written by all ranks above */
+                if (!writeLocalH5mdFrame)
+                {
+                    of->h5mdWriter->writeFrame(step, t, state_local->box, x, v, f);
+                }
+            }
+
             /* If a TNG file is open for uncompressed coordinate output also write
                velocities and forces to it. */
             else if (of->tng)
@@ -682,7 +948,17 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
                                f);
             }
         }
-        if (mdof_flags & MDOF_X_COMPRESSED)
+        if ((mdof_flags & MDOF_X_COMPRESSED) && of->h5mdCompressedWriter)
+        {
+            /* The writer selects the compressed output group itself, and
+               shared files have been written by all ranks above */
+            if (!writeLocalH5mdCompressedFrame)
+            {
+                of->h5mdCompressedWriter->writeFrame(
+                        step, t, state_local->box, state_global->x.rvec_array(), nullptr, nullptr);
+            }
+        }
+        else if (mdof_flags & MDOF_X_COMPRESSED)
         {
             rvec* xxtc = nullptr;
 
@@ -709,8 +985,23 @@ void mdoutf_write_to_trajectory_files(FILE*                           fplog,
                     }
                 }
             }
-            if (write_xtc(of->fp_xtc, of->natoms_x_compressed, step, t, state_local->box, xxtc, of->x_compression_precision)
-                == 0)
+            if (of->asyncWriter && of->fp_xtc)
+            {
+                of->asyncWriter->writeXtcFrame(
+                        step,
+                        t,
+                        state_local->box,
+                        gmx::arrayRefFromArray(reinterpret_cast<const gmx::RVec*>(xxtc),
+                                               of->natoms_x_compressed));
+            }
+            else if (write_xtc(of->fp_xtc,
+                               of->natoms_x_compressed,
+                               step,
+                               t,
+                               state_local->box,
+                               xxtc,
+                               of->x_compression_precision)
+                     == 0)
             {
                 gmx_fatal(FARGS,
                           "XTC error. This indicates you are out of disk space, or a "
@@ -792,6 +1083,18 @@ void mdoutf_tng_close(gmx_mdoutf_t of)
 
 void done_mdoutf(gmx_mdoutf_t of)
 {
+    if (of->asyncWriter)
+    {
+        of->asyncWriter->waitUntilWritten();
+        delete of->asyncWriter;
+    }
+    /* This syncs the output files, so it needs to finish before we close them */
+    waitForPendingCheckpoint(of);
+    /* The writers need to be closed before the files */
+    delete of->h5mdWriter;
+    delete of->h5md;
+    delete of->h5mdCompressedWriter;
+    delete of->h5mdCompressed;
     if (of->fp_ene != nullptr)
     {
         done_ener_file(of->fp_ene);
@@ -817,7 +1120,7 @@ void done_mdoutf(gmx_mdoutf_t of)
     gmx_tng_close(&of->tng);
     gmx_tng_close(&of->tng_low_prec);
 
-    sfree(of);
+    delete of;
 }
 
 int mdoutf_get_tng_box_output_interval(gmx_mdoutf_t of)
@@ -151,6 +151,10 @@ void mdoutf_write_to_trajectory_files(FILE*                          fplog,
  * the global state has all required information. Currently, this is only used by
  * the modular checkpointing facility.
  *
+ * With the GMX_ASYNC_CHECKPOINT environment variable set, syncing the file to
+ * disk and renaming it is done on a separate thread, which the next call
+ * and done_mdoutf() wait for.
+ *
  * \param[in] of                              File handler to trajectory file.
  * \param[in] fplog                           File handler to log file.
  * \param[in] cr                              Communication record.
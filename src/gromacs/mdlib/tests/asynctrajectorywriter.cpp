@@ -0,0 +1,182 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the asynchronous trajectory writer.
+ *
+ * \ingroup module_mdlib
+ */
+#include "gmxpre.h"
+
+#include "gromacs/mdlib/asynctrajectorywriter.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/fileio/gmxfio.h"
+#include "gromacs/fileio/trrio.h"
+#include "gromacs/fileio/xtcio.h"
+#include "gromacs/math/vec.h"
+
+#include "testutils/testfilemanager.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! Number of atoms in the test frames.
+constexpr int c_natoms = 30;
+//! Number of frames written.
+constexpr int c_numFrames = 9;
+//! Precision of the XTC compression.
+constexpr real c_precision = 1000;
+
+//! Return the contents of binary file \p fileName.
+std::string fileContents(const std::string& fileName)
+{
+    std::ifstream stream(fileName, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+class AsyncTrajectoryWriterTest : public ::testing::Test
+{
+public:
+    AsyncTrajectoryWriterTest() : x_(c_natoms), v_(c_natoms), f_(c_natoms) {}
+
+    //! Fill the vectors and box for \p frame.
+    void prepareFrame(int frame)
+    {
+        for (int i = 0; i < c_natoms; i++)
+        {
+            x_[i] = { 0.1F * i + 0.01F * frame, 0.2F * i, 1.5F - 0.03F * frame };
+            v_[i] = { 0.5F * frame, -0.1F * i, 0.25F };
+            f_[i] = { -1.0F * i, 2.0F * frame, 0.125F * i };
+        }
+        clear_mat(box_);
+        box_[XX][XX] = 3 + 0.01 * frame;
+        box_[YY][YY] = 4;
+        box_[ZZ][ZZ] = 5;
+    }
+
+    //! Write all frames to \p trrFile and \p xtcFile, with \p writer when not nullptr.
+    void writeFrames(t_fileio* trrFile, t_fileio* xtcFile, AsyncTrajectoryWriter* writer)
+    {
+        for (int frame = 0; frame < c_numFrames; frame++)
+        {
+            prepareFrame(frame);
+            const int64_t step = 10 * frame;
+            const double  t    = 0.02 * frame;
+            // Alternate which vectors are present, as mdrun does with different output intervals
+            const rvec* v = (frame % 2 == 0) ? as_rvec_array(v_.data()) : nullptr;
+            const rvec* f = (frame % 3 == 0) ? as_rvec_array(f_.data()) : nullptr;
+            if (writer)
+            {
+                writer->writeTrrFrame(step, t, 0.5, box_, c_natoms, as_rvec_array(x_.data()), v, f);
+                writer->writeXtcFrame(step, t, box_, x_);
+            }
+            else
+            {
+                gmx_trr_write_frame(
+                        trrFile, step, t, 0.5, box_, c_natoms, as_rvec_array(x_.data()), v, f);
+                write_xtc(xtcFile, c_natoms, step, t, box_, as_rvec_array(x_.data()), c_precision);
+            }
+        }
+    }
+
+    TestFileManager   fileManager_;
+    std::vector<RVec> x_;
+    std::vector<RVec> v_;
+    std::vector<RVec> f_;
+    matrix            box_;
+};
+
+TEST_F(AsyncTrajectoryWriterTest, WritesSameFilesAsSynchronousOutput)
+{
+    const std::string syncTrr  = fileManager_.getTemporaryFilePath("sync.trr").string();
+    const std::string syncXtc  = fileManager_.getTemporaryFilePath("sync.xtc").string();
+    const std::string asyncTrr = fileManager_.getTemporaryFilePath("async.trr").string();
+    const std::string asyncXtc = fileManager_.getTemporaryFilePath("async.xtc").string();
+
+    {
+        t_fileio* trrFile = gmx_trr_open(syncTrr, "w");
+        t_fileio* xtcFile = open_xtc(syncXtc, "w");
+        writeFrames(trrFile, xtcFile, nullptr);
+        gmx_trr_close(trrFile);
+        close_xtc(xtcFile);
+    }
+    {
+        t_fileio*             trrFile = gmx_trr_open(asyncTrr, "w");
+        t_fileio*             xtcFile = open_xtc(asyncXtc, "w");
+        AsyncTrajectoryWriter writer(trrFile, xtcFile, c_precision);
+        writeFrames(trrFile, xtcFile, &writer);
+        writer.waitUntilWritten();
+        gmx_trr_close(trrFile);
+        close_xtc(xtcFile);
+    }
+
+    const std::string expectedTrr = fileContents(syncTrr);
+    const std::string expectedXtc = fileContents(syncXtc);
+    EXPECT_FALSE(expectedTrr.empty());
+    EXPECT_FALSE(expectedXtc.empty());
+    EXPECT_EQ(expectedTrr, fileContents(asyncTrr));
+    EXPECT_EQ(expectedXtc, fileContents(asyncXtc));
+}
+
+TEST_F(AsyncTrajectoryWriterTest, WaitUntilWrittenFlushesFrames)
+{
+    const std::string xtcName = fileManager_.getTemporaryFilePath("flush.xtc").string();
+
+    t_fileio*             xtcFile = open_xtc(xtcName, "w");
+    AsyncTrajectoryWriter writer(nullptr, xtcFile, c_precision);
+    prepareFrame(0);
+    writer.writeXtcFrame(0, 0, box_, x_);
+    writer.waitUntilWritten();
+    // A checkpoint written at this point records the file position,
+    // so the complete frame must have been passed to the file.
+    ASSERT_EQ(gmx_fio_flush(xtcFile), 0);
+    EXPECT_GT(gmx_fio_ftell(xtcFile), 0);
+    EXPECT_EQ(gmx_fio_ftell(xtcFile), static_cast<gmx_off_t>(fileContents(xtcName).size()));
+    close_xtc(xtcFile);
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
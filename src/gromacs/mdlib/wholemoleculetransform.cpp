@@ -83,6 +83,9 @@ void WholeMoleculeTransform::updateAtomOrder(ArrayRef<const int> globalAtomIndic
 
     const int globalEdgeAtomEnd = globalEdgeAtomBegin_ + graphGlobalAtomOrderEdges_.size();
     graph_.edges.clear();
+    // The traversal order of the graph depends on the edges, so it needs to be recomputed
+    graph_.shiftSettingEdges.clear();
+    graph_.shiftCheckingEdges.clear();
     for (const int globalAtomIndex : globalAtomIndices)
     {
         if (globalAtomIndex >= globalEdgeAtomBegin_ && globalAtomIndex < globalEdgeAtomEnd)
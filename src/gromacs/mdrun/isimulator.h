@@ -76,6 +76,7 @@ class ImdSession;
 class MDLogger;
 class MDAtoms;
 class ObservablesReducerBuilder;
+class PerformanceReport;
 class StopHandlerBuilder;
 struct MdrunOptions;
 class VirtualSitesHandler;
@@ -145,6 +146,7 @@ public:
                         const ReplicaExchangeParameters&    replExParams,
                         gmx_membed_t*                       membed,
                         gmx_walltime_accounting*            walltime_accounting,
+                        PerformanceReport*                  performanceReport,
                         std::unique_ptr<StopHandlerBuilder> stopHandlerBuilder,
                         bool                                doRerun) :
         fpLog_(fplog),
@@ -182,6 +184,7 @@ public:
         replExParams_(replExParams),
         membed_(membed),
         wallTimeAccounting_(walltime_accounting),
+        performanceReport_(performanceReport),
         stopHandlerBuilder_(std::move(stopHandlerBuilder)),
         doRerun_(doRerun)
     {
@@ -257,6 +260,8 @@ public:
     gmx_membed_t* membed_;
     //! Manages wall time accounting.
     gmx_walltime_accounting* wallTimeAccounting_;
+    //! Collects the machine-readable performance report, nullptr when not written.
+    PerformanceReport* performanceReport_;
     //! Registers stop conditions
     std::unique_ptr<StopHandlerBuilder> stopHandlerBuilder_;
     //! Whether we're doing a rerun.
@@ -105,8 +105,8 @@ public:
 
     //! Filename options to fill from command-line argument values.
     std::vector<t_filenm> filenames = { { { efTPR, nullptr, nullptr, ffREAD },
-                                          { efTRN, "-o", nullptr, ffWRITE },
-                                          { efCOMPRESSED, "-x", nullptr, ffOPTWR },
+                                          { efMDRUNTRN, "-o", nullptr, ffWRITE },
+                                          { efMDRUNCOMPRESSED, "-x", nullptr, ffOPTWR },
                                           { efCPT, "-cpi", nullptr, ffOPTRD | ffALLOW_MISSING },
                                           { efCPT, "-cpo", nullptr, ffOPTWR },
                                           { efSTO, "-c", "confout", ffWRITE },
@@ -135,7 +135,8 @@ public:
                                           { efTOP, "-mp", "membed", ffOPTRD },
                                           { efNDX, "-mn", "membed", ffOPTRD },
                                           { efXVG, "-if", "imdforces", ffOPTWR },
-                                          { efXVG, "-swap", "swapions", ffOPTWR } } };
+                                          { efXVG, "-swap", "swapions", ffOPTWR },
+                                          { efJSON, "-perf", "perf", ffOPTWR } } };
 
     //! Print a warning if any force is larger than this (in kJ/mol nm).
     real pforce = -1;
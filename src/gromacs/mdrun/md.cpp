@@ -148,6 +148,7 @@
 #include "gromacs/mdtypes/state_propagator_data_gpu.h"
 #include "gromacs/modularsimulator/energydata.h"
 #include "gromacs/nbnxm/gpu_data_mgmt.h"
+#include "gromacs/nbnxm/kernel_layout_tuning.h"
 #include "gromacs/nbnxm/nbnxm.h"
 #include "gromacs/pbcutil/pbc.h"
 #include "gromacs/pulling/output.h"
@@ -569,6 +570,19 @@ void gmx::LegacySimulator::do_md()
                 &pme_loadbal, cr_, mdLog_, *ir, state_->box, *fr_->ic, *fr_->nbv, fr_->pmedata, fr_->nbv->useGpu());
     }
 
+    /* The CPU non-bonded kernel layout tuning uses the step timings,
+     * so we only tune it when the PME tuning is not going to do that.
+     */
+    std::unique_ptr<KernelLayoutTuning> kernelLayoutTuning;
+    if (!fr_->nbv->useGpu() && !mdrunOptions_.reproducible
+        && !(bPMETune && pme_loadbal_is_active(pme_loadbal)))
+    {
+        const ArrayRef<const RVec> globalCoordinates =
+                MAIN(cr_) ? stateGlobal_->x : ArrayRef<const RVec>();
+        kernelLayoutTuning = makeKernelLayoutTuning(
+                mdLog_, *ir, *fr_, cr_, topGlobal_, globalCoordinates, state_->box, wallCycleCounters_);
+    }
+
     if (!ir->bContinuation)
     {
         if (state_->hasEntry(StateEntry::V))
@@ -905,6 +919,11 @@ void gmx::LegacySimulator::do_md()
                            simulationWork.useGpuPmePpCommunication);
         }
 
+        if (kernelLayoutTuning && kernelLayoutTuning->isActive() && bNStList)
+        {
+            kernelLayoutTuning->tune(mdLog_, cr_, fr_, wallCycleCounters_, step);
+        }
+
         wallcycle_start(wallCycleCounters_, WallCycleCounter::Step);
 
         bLastStep = (step_rel == ir->nsteps);
@@ -2200,7 +2219,7 @@ void gmx::LegacySimulator::do_md()
 
     if (bPMETune)
     {
-        pme_loadbal_done(pme_loadbal, fpLog_, mdLog_, fr_->nbv->useGpu());
+        pme_loadbal_done(pme_loadbal, fpLog_, mdLog_, fr_->nbv->useGpu(), performanceReport_);
     }
 
     done_shellfc(fpLog_, shellfc, step_rel);
@@ -52,6 +52,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <filesystem>
 #include <memory>
@@ -170,6 +171,7 @@
 #include "gromacs/taskassignment/taskassignment.h"
 #include "gromacs/taskassignment/usergpuids.h"
 #include "gromacs/timing/gpu_timing.h"
+#include "gromacs/timing/performancereport.h"
 #include "gromacs/timing/wallcycle.h"
 #include "gromacs/timing/wallcyclereporting.h"
 #include "gromacs/timing/walltime_accounting.h"
@@ -188,6 +190,7 @@
 #include "gromacs/utility/gmxassert.h"
 #include "gromacs/utility/gmxmpi.h"
 #include "gromacs/utility/keyvaluetree.h"
+#include "gromacs/utility/keyvaluetreebuilder.h"
 #include "gromacs/utility/logger.h"
 #include "gromacs/utility/loggerbuilder.h"
 #include "gromacs/utility/mpiinfo.h"
@@ -774,6 +777,68 @@ static TaskTarget findTaskTarget(const char* optionString)
     return returnValue;
 }
 
+//! Add the hardware and the task assignment of this run to \p report
+static void reportHardwareAndTasks(gmx::PerformanceReport*   report,
+                                   const gmx_hw_info_t&      hwinfo,
+                                   const t_commrec*          cr,
+                                   PmeRunMode                pmeRunMode,
+                                   const SimulationWorkload& simulationWork)
+{
+    static constexpr std::array<const char*, 4> c_pmeRunModeNames = {
+        "none", "cpu", "gpu", "mixed"
+    };
+
+    gmx::KeyValueTreeObjectBuilder hardware = report->section("hardware");
+    hardware.addValue<std::string>("cpu_brand", hwinfo.cpuInfo->brandString());
+    hardware.addValue<std::string>("simd", GMX_SIMD_STRING);
+    hardware.addValue<int>("physical_nodes", hwinfo.nphysicalnode);
+    hardware.addValue<int>("cores", hwinfo.ncore_tot);
+    hardware.addValue<int>("processing_units", hwinfo.nProcessingUnits_tot);
+    gmx::KeyValueTreeUniformArrayBuilder<std::string> devices =
+            hardware.addUniformArray<std::string>("devices");
+    for (const auto& deviceInfo : hwinfo.deviceInfoList)
+    {
+        devices.addValue(getDeviceInformationString(*deviceInfo));
+    }
+
+    gmx::KeyValueTreeObjectBuilder tasks = report->section("tasks");
+    tasks.addValue<int>("ranks", cr->nnodes);
+    tasks.addValue<int>("pme_ranks", cr->npmenodes);
+    tasks.addValue<int>("pp_threads_per_rank", gmx_omp_nthreads_get(ModuleMultiThread::Nonbonded));
+    tasks.addValue<int>("pme_threads_per_rank", gmx_omp_nthreads_get(ModuleMultiThread::Pme));
+    tasks.addValue<std::string>("pme_run_mode", c_pmeRunModeNames[static_cast<int>(pmeRunMode)]);
+    tasks.addValue<bool>("nonbonded_on_gpu", simulationWork.useGpuNonbonded);
+    tasks.addValue<bool>("pme_on_gpu", simulationWork.useGpuPme);
+    tasks.addValue<bool>("pme_fft_on_gpu", simulationWork.useGpuPmeFft);
+    tasks.addValue<bool>("bonded_on_gpu", simulationWork.useGpuBonded);
+    tasks.addValue<bool>("update_on_gpu", simulationWork.useGpuUpdate);
+    tasks.addValue<bool>("gpu_halo_exchange", simulationWork.useGpuHaloExchange);
+    tasks.addValue<bool>("gpu_pme_pp_communication", simulationWork.useGpuPmePpCommunication);
+}
+
+//! Add the simulation performance, as printed by print_perf(), to \p report
+static void reportPerformance(gmx::PerformanceReport* report,
+                              double                  timePerThread,
+                              double                  timePerNode,
+                              int64_t                 nsteps,
+                              double                  delta_t,
+                              double                  nbfs,
+                              double                  mflop)
+{
+    gmx::KeyValueTreeObjectBuilder performance = report->section("performance");
+    performance.addValue<int64_t>("steps", nsteps);
+    performance.addValue<double>("core_time_s", timePerThread);
+    performance.addValue<double>("wall_time_s", timePerNode);
+    performance.addValue<double>("nonbonded_interactions", nbfs);
+    performance.addValue<double>("mflop", mflop);
+    if (timePerNode > 0 && delta_t > 0)
+    {
+        const double simulatedTime = nsteps * delta_t;
+        performance.addValue<double>("ns_per_day", simulatedTime * 24 * 3.6 / timePerNode);
+        performance.addValue<double>("hours_per_ns", 1000 * timePerNode / (3600 * simulatedTime));
+    }
+}
+
 //! Finish run, aggregate data to print performance info.
 static void finish_run(FILE*                     fplog,
                        const gmx::MDLogger&      mdlog,
@@ -784,7 +849,9 @@ static void finish_run(FILE*                     fplog,
                        gmx_walltime_accounting_t walltime_accounting,
                        nonbonded_verlet_t*       nbv,
                        const gmx_pme_t*          pme,
-                       gmx_bool                  bWriteStat)
+                       gmx_bool                  bWriteStat,
+                       bool                      performanceReportRequested,
+                       gmx::PerformanceReport*   performanceReport)
 {
     double delta_t = 0;
     double nbfs = 0, mflop = 0;
@@ -858,9 +925,18 @@ static void finish_run(FILE*                     fplog,
         print_flop(fplog, nrnb_tot, &nbfs, &mflop);
     }
 
+    if (printReport && nbv != nullptr)
+    {
+        nbv->reportAtomPairStatistics(mdlog, performanceReport);
+    }
+
     if (thisRankHasDuty(cr, DUTY_PP) && haveDDAtomOrdering(*cr))
     {
         print_dd_statistics(cr, inputrec, fplog);
+        if (printReport && performanceReport)
+        {
+            report_dd_statistics(cr, inputrec, performanceReport);
+        }
     }
 
     /* TODO Move the responsibility for any scaling by thread counts
@@ -872,16 +948,28 @@ static void finish_run(FILE*                     fplog,
     wallcycle_scale_by_num_threads(
             wcycle, thisRankHasDuty(cr, DUTY_PME) && !thisRankHasDuty(cr, DUTY_PP), nthreads_pp, nthreads_pme);
     auto cycle_sum(wallcycle_sum(cr, wcycle));
+    /* The per-rank times are only used by the performance report with
+     * multiple ranks. The gather is collective, so the condition can not
+     * depend on printReport or performanceReport, which are only set on
+     * the main rank. */
+    WallcyclePerRank cyclesPerRank;
+    if (performanceReportRequested && EI_DYNAMICS(inputrec.eI) && cr->nnodes > 1)
+    {
+        cyclesPerRank =
+                wallcycle_gather_per_rank(cr, wcycle, nthreads_pp, nthreads_pme, elapsed_time);
+    }
 
     if (printReport)
     {
         auto* nbnxn_gpu_timings =
                 (nbv != nullptr && nbv->useGpu()) ? gpu_get_timings(nbv->gpuNbv()) : nullptr;
-        gmx_wallclock_gpu_pme_t pme_gpu_timings = {};
+        gmx_wallclock_gpu_pme_t  pme_gpu_timings     = {};
+        gmx_wallclock_gpu_pme_t* pme_gpu_timings_ptr = nullptr;
 
         if (pme_gpu_task_enabled(pme))
         {
             pme_gpu_get_timings(pme, &pme_gpu_timings);
+            pme_gpu_timings_ptr = &pme_gpu_timings;
         }
         wallcycle_print(fplog,
                         mdlog,
@@ -893,13 +981,35 @@ static void finish_run(FILE*                     fplog,
                         wcycle,
                         cycle_sum,
                         nbnxn_gpu_timings,
-                        &pme_gpu_timings);
+                        pme_gpu_timings_ptr);
 
         if (EI_DYNAMICS(inputrec.eI))
         {
             delta_t = inputrec.delta_t;
         }
 
+        if (performanceReport)
+        {
+            wallcycle_report(performanceReport,
+                             cr->nnodes,
+                             cr->npmenodes,
+                             nthreads_pp,
+                             nthreads_pme,
+                             elapsed_time_over_all_ranks,
+                             wcycle,
+                             cycle_sum,
+                             cyclesPerRank,
+                             nbnxn_gpu_timings,
+                             pme_gpu_timings_ptr);
+            reportPerformance(performanceReport,
+                              elapsed_time_over_all_threads_over_all_ranks,
+                              elapsed_time_over_all_ranks,
+                              walltime_accounting_get_nsteps_done_since_reset(walltime_accounting),
+                              delta_t,
+                              nbfs,
+                              mflop);
+        }
+
         if (fplog)
         {
             print_perf(fplog,
@@ -1788,6 +1898,14 @@ int Mdrunner::mdrunner()
     checkHardwareOversubscription(
             numThreadsOnThisRank, cr->nodeid, *hwinfo_->hardwareTopology, physicalNodeComm, mdlog);
 
+    std::unique_ptr<gmx::PerformanceReport> performanceReport;
+    if (isSimulationMainRank && opt2bSet("-perf", filenames.size(), filenames.data()))
+    {
+        performanceReport = std::make_unique<gmx::PerformanceReport>();
+        reportHardwareAndTasks(
+                performanceReport.get(), *hwinfo_, cr, pmeRunMode, runScheduleWork.simulationWork);
+    }
+
     // Enable Peer access between GPUs where available
     // Only for DD, only main PP rank needs to perform setup, and only if thread MPI plus
     // any of the GPU communication features are active.
@@ -2333,7 +2451,8 @@ int Mdrunner::mdrunner()
 
 
             simulatorBuilder.add(SimulatorEnv(fplog, cr, ms, mdlog, oenv, &observablesReducerBuilder));
-            simulatorBuilder.add(Profiling(&nrnb, walltime_accounting, wcycle.get()));
+            simulatorBuilder.add(
+                    Profiling(&nrnb, walltime_accounting, wcycle.get(), performanceReport.get()));
             simulatorBuilder.add(ConstraintsParam(
                     constr.get(),
                     enforcedRotation ? enforcedRotation->getLegacyEnfrot() : nullptr,
@@ -2405,7 +2524,13 @@ int Mdrunner::mdrunner()
                    walltime_accounting,
                    fr ? fr->nbv.get() : nullptr,
                    pmedata,
-                   EI_DYNAMICS(inputrec->eI) && !isMultiSim(ms));
+                   EI_DYNAMICS(inputrec->eI) && !isMultiSim(ms),
+                   opt2bSet("-perf", filenames.size(), filenames.data()),
+                   performanceReport.get());
+        if (performanceReport)
+        {
+            performanceReport->write(opt2fn("-perf", filenames.size(), filenames.data()));
+        }
     }
     GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
 
@@ -170,6 +170,7 @@ std::unique_ptr<ISimulator> SimulatorBuilder::build(bool useModularSimulator)
                                                       *replicaExchangeParameters_,
                                                       membedHolder_->membed(),
                                                       profiling_->wallTimeAccounting_,
+                                                      profiling_->performanceReport_,
                                                       std::move(stopHandlerBuilder_),
                                                       simulatorConfig_->mdrunOptions_.rerun),
                 std::move(modularSimulatorCheckpointData_)));
@@ -210,6 +211,7 @@ std::unique_ptr<ISimulator> SimulatorBuilder::build(bool useModularSimulator)
                                                                 *replicaExchangeParameters_,
                                                                 membedHolder_->membed(),
                                                                 profiling_->wallTimeAccounting_,
+                                                                profiling_->performanceReport_,
                                                                 std::move(stopHandlerBuilder_),
                                                                 simulatorConfig_->mdrunOptions_.rerun));
 }
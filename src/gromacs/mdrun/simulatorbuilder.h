@@ -79,6 +79,7 @@ class MDLogger;
 struct MDModulesNotifiers;
 struct MdrunOptions;
 class ObservablesReducerBuilder;
+class PerformanceReport;
 class ReadCheckpointDataHolder;
 enum class StartingBehavior;
 class StopHandlerBuilder;
@@ -185,8 +186,14 @@ class Profiling
 {
 public:
     //! Build profiling information collection.
-    Profiling(t_nrnb* nrnb, gmx_walltime_accounting* walltimeAccounting, gmx_wallcycle* wallCycle) :
-        nrnb_(nrnb), wallCycle_(wallCycle), wallTimeAccounting_(walltimeAccounting)
+    Profiling(t_nrnb*                  nrnb,
+              gmx_walltime_accounting* walltimeAccounting,
+              gmx_wallcycle*           wallCycle,
+              PerformanceReport*       performanceReport) :
+        nrnb_(nrnb),
+        wallCycle_(wallCycle),
+        wallTimeAccounting_(walltimeAccounting),
+        performanceReport_(performanceReport)
     {
     }
 
@@ -196,6 +203,8 @@ public:
     gmx_wallcycle* wallCycle_;
     //! Handle to wallcycle time accounting stuff.
     gmx_walltime_accounting* wallTimeAccounting_;
+    //! Handle to the machine-readable performance report, nullptr when not written.
+    PerformanceReport* performanceReport_;
 };
 
 /*! \brief
@@ -72,7 +72,8 @@ PmeLoadBalanceHelper::PmeLoadBalanceHelper(bool                 isVerbose,
                                            const MDLogger&      mdlog,
                                            const t_inputrec*    inputrec,
                                            gmx_wallcycle*       wcycle,
-                                           t_forcerec*          fr) :
+                                           t_forcerec*          fr,
+                                           PerformanceReport*   performanceReport) :
     pme_loadbal_(nullptr),
     nextNSStep_(-1),
     isVerbose_(isVerbose),
@@ -83,7 +84,8 @@ PmeLoadBalanceHelper::PmeLoadBalanceHelper(bool                 isVerbose,
     mdlog_(mdlog),
     inputrec_(inputrec),
     wcycle_(wcycle),
-    fr_(fr)
+    fr_(fr),
+    performanceReport_(performanceReport)
 {
 }
 
@@ -124,7 +126,7 @@ void PmeLoadBalanceHelper::run(gmx::Step step, gmx::Time gmx_unused time)
 
 void PmeLoadBalanceHelper::teardown()
 {
-    pme_loadbal_done(pme_loadbal_, fplog_, mdlog_, fr_->nbv->useGpu());
+    pme_loadbal_done(pme_loadbal_, fplog_, mdlog_, fr_->nbv->useGpu(), performanceReport_);
 }
 
 bool PmeLoadBalanceHelper::pmePrinting() const
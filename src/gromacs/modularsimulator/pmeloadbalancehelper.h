@@ -55,6 +55,7 @@ namespace gmx
 {
 class MDLogger;
 struct MdrunOptions;
+class PerformanceReport;
 class StatePropagatorData;
 class SimulationWorkload;
 
@@ -82,7 +83,8 @@ public:
                          const MDLogger&      mdlog,
                          const t_inputrec*    inputrec,
                          gmx_wallcycle*       wcycle,
-                         t_forcerec*          fr);
+                         t_forcerec*          fr,
+                         PerformanceReport*   performanceReport);
 
     //! Initialize the load balancing object
     void setup();
@@ -133,6 +135,8 @@ private:
     gmx_wallcycle* wcycle_;
     //! Parameters for force calculations.
     t_forcerec* fr_;
+    //! Collects the machine-readable performance report, nullptr when not written.
+    PerformanceReport* performanceReport_;
 };
 
 } // namespace gmx
@@ -347,8 +347,10 @@ void ModularSimulatorAlgorithm::populateTaskQueue()
      * All elements are owned by the ModularSimulatorAlgorithm, as is the task queue.
      * Elements can hence register lambdas capturing their `this` pointers without expecting
      * life time issues, as the task queue and the elements are in the same scope.
+     * It is wrapped in a std::function once here, rather than converting the lambda
+     * into a temporary RegisterRunFunction for every element and every step.
      */
-    auto registerRunFunction = [this](SimulatorRunFunction function) {
+    const RegisterRunFunction registerRunFunction = [this](SimulatorRunFunction function) {
         taskQueue_.emplace_back(std::move(function));
     };
 
@@ -588,7 +590,8 @@ ModularSimulatorAlgorithm ModularSimulatorAlgorithmBuilder::build()
                                                        legacySimulatorData_->mdLog_,
                                                        legacySimulatorData_->inputRec_,
                                                        legacySimulatorData_->wallCycleCounters_,
-                                                       legacySimulatorData_->fr_);
+                                                       legacySimulatorData_->fr_,
+                                                       legacySimulatorData_->performanceReport_);
         registerWithInfrastructureAndSignallers(algorithm.pmeLoadBalanceHelper_.get());
     }
 
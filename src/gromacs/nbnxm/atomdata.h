@@ -186,7 +186,13 @@ struct nbnxn_atomdata_t
     ~nbnxn_atomdata_t();
 
     /*! \internal
-     * \brief The actual atom data parameter values */
+     * \brief The actual atom data parameter values
+     *
+     * All parameters are stored in the precision of real. The SIMD kernels
+     * load them with plain and gather loads of SimdReal, so storing them
+     * in a 16-bit format would require load-and-convert operations for
+     * every SIMD implementation in the SIMD module.
+     */
     struct Params
     {
         /*! \brief Constructor
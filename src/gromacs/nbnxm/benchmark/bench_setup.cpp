@@ -49,12 +49,17 @@
 #include <cstdio>
 
 #include <algorithm>
+#include <condition_variable>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "thread_mpi/threads.h"
+
 #include "gromacs/gmxlib/nrnb.h"
 #include "gromacs/gpu_utils/hostallocator.h"
 #include "gromacs/math/units.h"
@@ -86,8 +91,10 @@
 #include "gromacs/utility/arrayref.h"
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/enumerationhelpers.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/logger.h"
 #include "gromacs/utility/range.h"
 
@@ -205,9 +212,8 @@ static LJCombinationRule convertLJCombinationRule(const NbnxmBenchMarkCombRule c
     return LJCombinationRule::None;
 }
 
-//! Sets up and returns a Nbnxm object for the given benchmark options and system
-static std::unique_ptr<nonbonded_verlet_t> setupNbnxmForBenchInstance(const NbnxmKernelBenchOptions& options,
-                                                                      const BenchmarkSystem& system)
+std::unique_ptr<nonbonded_verlet_t> setupNbnxmForBenchInstance(const NbnxmKernelBenchOptions& options,
+                                                               const BenchmarkSystem& system)
 {
     const auto pinPolicy =
             (options.useGpu ? PinningPolicy::PinnedIfSupported : PinningPolicy::CannotBePinned);
@@ -310,6 +316,27 @@ static void expandSimdOptionAndPushBack(const NbnxmKernelBenchOptions&        op
     }
 }
 
+//! Runs the non-bonded kernel once, with force clearing set by \p clearF
+static void runKernel(nonbonded_verlet_t*        nbv,
+                      const interaction_const_t& ic,
+                      const StepWorkload&        stepWork,
+                      const int                  clearF,
+                      const BenchmarkSystem&     system,
+                      gmx_enerdata_t*            enerd,
+                      t_nrnb*                    nrnb)
+{
+    nbv->dispatchNonbondedKernel(
+            InteractionLocality::Local,
+            ic,
+            stepWork,
+            clearF,
+            system.forceRec.shift_vec,
+            enerd->grpp.energyGroupPairTerms[system.forceRec.haveBuckingham ? NonBondedEnergyTerms::BuckinghamSR
+                                                                            : NonBondedEnergyTerms::LJSR],
+            enerd->grpp.energyGroupPairTerms[NonBondedEnergyTerms::CoulombSR],
+            nrnb);
+}
+
 //! Sets up and runs the requested benchmark instance and prints the results
 //
 // When \p doWarmup is true runs the warmup iterations instead
@@ -387,16 +414,7 @@ static void setupAndRunInstance(const BenchmarkSystem&         system,
     // Run pre-iteration to avoid cache misses
     for (int iter = 0; iter < options.numPreIterations; iter++)
     {
-        nbv->dispatchNonbondedKernel(
-                InteractionLocality::Local,
-                ic,
-                stepWork,
-                enbvClearFYes,
-                system.forceRec.shift_vec,
-                enerd.grpp.energyGroupPairTerms[system.forceRec.haveBuckingham ? NonBondedEnergyTerms::BuckinghamSR
-                                                                               : NonBondedEnergyTerms::LJSR],
-                enerd.grpp.energyGroupPairTerms[NonBondedEnergyTerms::CoulombSR],
-                &nrnb);
+        runKernel(nbv.get(), ic, stepWork, enbvClearFYes, system, &enerd, &nrnb);
     }
 
     const int numIterations = (doWarmup ? options.numWarmupIterations : options.numIterations);
@@ -406,16 +424,7 @@ static void setupAndRunInstance(const BenchmarkSystem&         system,
     for (int iter = 0; iter < numIterations; iter++)
     {
         // Run the kernel without force clearing
-        nbv->dispatchNonbondedKernel(
-                InteractionLocality::Local,
-                ic,
-                stepWork,
-                enbvClearFNo,
-                system.forceRec.shift_vec,
-                enerd.grpp.energyGroupPairTerms[system.forceRec.haveBuckingham ? NonBondedEnergyTerms::BuckinghamSR
-                                                                               : NonBondedEnergyTerms::LJSR],
-                enerd.grpp.energyGroupPairTerms[NonBondedEnergyTerms::CoulombSR],
-                &nrnb);
+        runKernel(nbv.get(), ic, stepWork, enbvClearFNo, system, &enerd, &nrnb);
     }
     cycles = gmx_cycles_read() - cycles;
     if (!doWarmup)
@@ -485,6 +494,171 @@ static void setupAndRunInstance(const BenchmarkSystem&         system,
     }
 }
 
+/*! \brief Pins the OpenMP threads of benchmark instance \p instance, when requested
+ *
+ * OpenMP thread t of instance i is pinned to logical core
+ * pinOffset + (i * numThreads + t) * pinStride. This should be called
+ * from the thread that runs the instance, since each thread that opens
+ * parallel regions gets its own team of OpenMP threads.
+ */
+static void pinInstanceThreads(const NbnxmKernelBenchOptions& options, const int instance)
+{
+    if (!options.pinThreads)
+    {
+        return;
+    }
+
+    if (tMPI_Thread_setaffinity_support() != TMPI_SETAFFINITY_SUPPORT_YES)
+    {
+        fprintf(stderr, "NOTE: Thread affinity setting is not supported, threads are not pinned\n");
+        return;
+    }
+
+    int numFailures = 0;
+#pragma omp parallel num_threads(options.numThreads) reduction(+ : numFailures)
+    {
+        const int thread = gmx_omp_get_thread_num();
+        const int core =
+                options.pinOffset + (instance * options.numThreads + thread) * options.pinStride;
+        if (tMPI_Thread_setaffinity_single(tMPI_Thread_self(), core) != 0)
+        {
+            numFailures++;
+        }
+    }
+    if (numFailures > 0)
+    {
+        fprintf(stderr,
+                "WARNING: Failed to pin %d thread(s) of instance %d\n",
+                numFailures,
+                instance);
+    }
+}
+
+/*! \brief Runs \p options.numInstances copies of a benchmark concurrently and prints the results
+ *
+ * Each instance runs on its own thread with its own Nbnxm setup and
+ * \p options.numThreads OpenMP threads, optionally pinned with
+ * pinInstanceThreads(). The timed iterations start simultaneously on
+ * all instances.
+ */
+static void setupAndRunConcurrentInstances(const BenchmarkSystem&         system,
+                                           const NbnxmKernelBenchOptions& options)
+{
+    const int numInstances = options.numInstances;
+
+    std::vector<gmx_cycles_t> cycles(numInstances);
+    std::vector<Index>        numPairs(numInstances);
+
+    std::mutex              mutex;
+    std::condition_variable allReady;
+    int                     numReady = 0;
+
+    auto runInstance = [&](const int instance)
+    {
+        try
+        {
+            // Pin first, so the setup allocates memory close to the cores
+            pinInstanceThreads(options, instance);
+
+            std::unique_ptr<nonbonded_verlet_t> nbv = setupNbnxmForBenchInstance(options, system);
+
+            interaction_const_t ic = setupInteractionConst(options);
+
+            t_nrnb nrnb = { 0 };
+
+            gmx_enerdata_t enerd(1, nullptr);
+
+            StepWorkload stepWork;
+            stepWork.computeForces = true;
+            stepWork.computeVirial = options.computeVirialAndEnergy;
+            stepWork.computeEnergy = options.computeVirialAndEnergy;
+
+            const int numUntimedIterations = options.numPreIterations + options.numWarmupIterations;
+            for (int iter = 0; iter < numUntimedIterations; iter++)
+            {
+                runKernel(nbv.get(), ic, stepWork, enbvClearFYes, system, &enerd, &nrnb);
+            }
+
+            const PairlistSet& pairlistSet =
+                    nbv->pairlistSets().pairlistSet(InteractionLocality::Local);
+            numPairs[instance] =
+                    pairlistSet.natpair_ljq_ + pairlistSet.natpair_lj_ + pairlistSet.natpair_q_;
+
+            // Wait until all instances are set up, so the timed parts overlap
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                numReady++;
+                if (numReady == numInstances)
+                {
+                    allReady.notify_all();
+                }
+                else
+                {
+                    allReady.wait(lock, [&]() { return numReady == numInstances; });
+                }
+            }
+
+            gmx_cycles_t start = gmx_cycles_read();
+            for (int iter = 0; iter < options.numIterations; iter++)
+            {
+                runKernel(nbv.get(), ic, stepWork, enbvClearFNo, system, &enerd, &nrnb);
+            }
+            cycles[instance] = gmx_cycles_read() - start;
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numInstances);
+    for (int instance = 0; instance < numInstances; instance++)
+    {
+        threads.emplace_back(runInstance, instance);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const EnumerationArray<NbnxmBenchMarkKernels, std::string> kernelNames = {
+        "auto", "no", "4xM", "2xMM"
+    };
+
+    const EnumerationArray<NbnxmBenchMarkCombRule, std::string> combruleNames = { "geom.",
+                                                                                  "LB",
+                                                                                  "none" };
+
+    // With -time we report in micro-seconds, otherwise in cycles
+    const double unitsPerCycle = (options.reportTime ? gmx_cycles_calibrate(1.0) * 1.e6 : 1.0);
+
+    double maxTime        = 0;
+    double totalNumPairs  = 0;
+    double sumOfPairRates = 0;
+    for (int instance = 0; instance < numInstances; instance++)
+    {
+        const double time      = static_cast<double>(cycles[instance]) * unitsPerCycle;
+        const double pairsRate = options.numIterations * numPairs[instance] / time;
+        fprintf(stdout,
+                "%-7s %-4s %-5s %-4s %8d %13.3f %13.4f\n",
+                options.coulombType == NbnxmBenchMarkCoulomb::Pme ? "Ewald" : "RF",
+                options.useHalfLJOptimization ? "half" : "all",
+                combruleNames[options.ljCombinationRule].c_str(),
+                kernelNames[options.nbnxmSimd].c_str(),
+                instance,
+                time / options.numIterations,
+                pairsRate);
+        maxTime = std::max(maxTime, time);
+        totalNumPairs += options.numIterations * static_cast<double>(numPairs[instance]);
+        sumOfPairRates += pairsRate;
+    }
+    fprintf(stdout,
+            "%-24s %8s %13.3f %13.4f  (sum over instances %.4f)\n",
+            "",
+            "all",
+            maxTime / options.numIterations,
+            totalNumPairs / maxTime,
+            sumOfPairRates);
+}
+
 void bench(const int sizeFactor, const NbnxmKernelBenchOptions& options)
 {
     // We don't want to call gmx_omp_nthreads_init(), so we init what we need
@@ -540,6 +714,17 @@ void bench(const int sizeFactor, const NbnxmKernelBenchOptions& options)
     fprintf(stdout, "System size:          %zu atoms\n", system.coordinates.size());
     fprintf(stdout, "Cut-off radius:       %g nm\n", options.pairlistCutoff);
     fprintf(stdout, "Number of threads:    %d\n", options.numThreads);
+    if (options.numInstances > 1)
+    {
+        fprintf(stdout, "Number of instances:  %d\n", options.numInstances);
+    }
+    if (options.pinThreads)
+    {
+        fprintf(stdout,
+                "Thread pinning:       offset %d stride %d\n",
+                options.pinOffset,
+                options.pinStride);
+    }
     fprintf(stdout, "Number of iterations: %d\n", options.numIterations);
     fprintf(stdout, "Compute energies:     %s\n", options.computeVirialAndEnergy ? "yes" : "no");
     if (options.coulombType != NbnxmBenchMarkCoulomb::ReactionField)
@@ -552,6 +737,28 @@ void bench(const int sizeFactor, const NbnxmKernelBenchOptions& options)
     }
     printf("\n");
 
+    if (options.numInstances > 1)
+    {
+        fprintf(stdout,
+                "Coulomb LJ   comb. SIMD instance %13s %13s\n",
+                options.reportTime ? "usec/it." : "cycles/it.",
+                options.reportTime ? "pairs/usec" : "pairs/cycle");
+
+        for (const auto& optionsInstance : optionsList)
+        {
+            setupAndRunConcurrentInstances(system, optionsInstance);
+        }
+
+        if (!options.outputFile.empty())
+        {
+            fclose(system.csv);
+        }
+
+        return;
+    }
+
+    pinInstanceThreads(options, 0);
+
     if (options.numWarmupIterations > 0)
     {
         setupAndRunInstance(system, optionsList[0], true);
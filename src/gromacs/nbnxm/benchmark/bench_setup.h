@@ -45,6 +45,7 @@
 #ifndef GMX_NBNXN_BENCH_SETUP_H
 #define GMX_NBNXN_BENCH_SETUP_H
 
+#include <memory>
 #include <string>
 
 #include "gromacs/utility/real.h"
@@ -52,6 +53,9 @@
 namespace gmx
 {
 
+struct BenchmarkSystem;
+struct nonbonded_verlet_t;
+
 //! Enum for selecting the SIMD kernel type for benchmarks
 enum class NbnxmBenchMarkKernels : int
 {
@@ -88,6 +92,14 @@ struct NbnxmKernelBenchOptions
     bool useGpu = false;
     //! The number of OpenMP threads to use
     int numThreads = 1;
+    //! The number of benchmark instances to run concurrently, each with numThreads threads
+    int numInstances = 1;
+    //! Whether to pin the OpenMP threads of each instance to cores
+    bool pinThreads = false;
+    //! The logical core index of the first thread of the first instance, used with pinThreads
+    int pinOffset = 0;
+    //! The logical core stride between pinned threads, used with pinThreads
+    int pinStride = 1;
     //! The SIMD type for the kernel
     NbnxmBenchMarkKernels nbnxmSimd = NbnxmBenchMarkKernels::SimdAuto;
     //! The LJ combination rule
@@ -126,6 +138,8 @@ struct NbnxmKernelBenchOptions
  * The simulated system is a box of 1000 SPC/E water molecules scaled
  * by the factor \p sizeFactor, which has to be a power of 2.
  * One or more benchmarks are run, as specified by \p options.
+ * With \p options.numInstances > 1, each benchmark is run concurrently
+ * on that number of independent instances.
  * Benchmark settings and timings are printed to stdout.
  *
  * \param[in] sizeFactor How much should the system size be increased.
@@ -133,6 +147,18 @@ struct NbnxmKernelBenchOptions
  */
 void bench(int sizeFactor, const NbnxmKernelBenchOptions& options);
 
+/*! \brief
+ * Sets up and returns a Nbnxm object for the given benchmark options and system
+ *
+ * The atoms of \p system are put on the grid and the local pairlist is
+ * constructed, so the returned object is ready for calling the kernels.
+ *
+ * \param[in] options How the benchmark will be run.
+ * \param[in] system  The system to set up the Nbnxm object for.
+ */
+std::unique_ptr<nonbonded_verlet_t> setupNbnxmForBenchInstance(const NbnxmKernelBenchOptions& options,
+                                                               const BenchmarkSystem& system);
+
 } // namespace gmx
 
 #endif
@@ -45,6 +45,13 @@
  * Each cell can hold one or more clusters of atoms, depending on the grid
  * geometry, which is set by the pair-list type.
  *
+ * Columns are stored with x as the major and y as the minor index and atoms
+ * are sorted along z within each column. The search and the pair-list
+ * generation index columns directly as x * numCells[YY] + y, so the
+ * i-clusters visited in sequence are z-neighbours within a column or lie in
+ * neighbouring y-columns. These mostly share the same j-clusters, which
+ * gives cache reuse similar to a space-filling-curve order.
+ *
  * \author Berk Hess <hess@kth.se>
  * \ingroup module_nbnxm
  */
@@ -0,0 +1,268 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief Implements the run-time tuning of the SIMD layout of the CPU non-bonded kernels
+ *
+ * \ingroup module_nbnxm
+ */
+
+#include "gmxpre.h"
+
+#include "kernel_layout_tuning.h"
+
+#include <cinttypes>
+#include <cstdlib>
+
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "gromacs/gmxlib/network.h"
+#include "gromacs/mdtypes/commrec.h"
+#include "gromacs/mdtypes/forcerec.h"
+#include "gromacs/mdtypes/inputrec.h"
+#include "gromacs/mdtypes/md_enums.h"
+#include "gromacs/timing/wallcycle.h"
+#include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/logger.h"
+#include "gromacs/utility/stringutil.h"
+
+#include "nbnxm_geometry.h"
+
+namespace gmx
+{
+
+/*! \brief The number of pair-list intervals to skip after switching layouts
+ *
+ * The first interval after a switch is slower due to allocation and
+ * caching effects. The first interval of the run is skipped as well.
+ */
+static constexpr int c_numSkippedIntervals = 1;
+
+//! The number of pair-list intervals to time per layout after skipping
+static constexpr int c_numTimedIntervals = 3;
+
+/*! \brief The relative performance gain required to move away from the initial layout
+ *
+ * This avoids switching based on noise in the timings when both layouts
+ * perform nearly equal.
+ */
+static constexpr double c_minRelativeGain = 0.02;
+
+//! Returns a string with the name and the cluster sizes of the kernel layout
+static std::string layoutDescription(const NbnxmKernelSetup& kernelSetup)
+{
+    return formatString("%s %dx%d",
+                        nbnxmKernelTypeToName(kernelSetup.kernelType),
+                        sc_iClusterSize(kernelSetup.kernelType),
+                        sc_jClusterSize(kernelSetup.kernelType));
+}
+
+KernelLayoutTuning::KernelLayoutTuning(const NbnxmKernelSetup& alternativeSetup,
+                                       const t_inputrec&       inputrec,
+                                       const t_forcerec&       forcerec,
+                                       const t_commrec*        cr,
+                                       const gmx_mtop_t&       mtop,
+                                       ArrayRef<const RVec>    coordinates,
+                                       matrix                  box,
+                                       gmx_wallcycle*          wcycle)
+{
+    timings_[0].kernelSetup = forcerec.nbv->kernelSetup();
+    timings_[1].kernelSetup = alternativeSetup;
+
+    alternative_ = init_nb_verlet_cpu(
+            alternativeSetup, inputrec, forcerec, cr, mtop, coordinates, box, wcycle);
+}
+
+KernelLayoutTuning::~KernelLayoutTuning() = default;
+
+void KernelLayoutTuning::switchLayout(t_forcerec* fr)
+{
+    // The pair-list radii might have been changed after setup
+    alternative_->changePairlistRadii(fr->nbv->pairlistOuterRadius(),
+                                      fr->nbv->pairlistInnerRadius());
+
+    std::swap(fr->nbv, alternative_);
+    current_ = 1 - current_;
+}
+
+void KernelLayoutTuning::tune(const MDLogger&  mdlog,
+                              const t_commrec* cr,
+                              t_forcerec*      fr,
+                              gmx_wallcycle*   wcycle,
+                              int64_t          step)
+{
+    if (!isActive_)
+    {
+        return;
+    }
+
+    int    numSteps = 0;
+    double cycles   = 0;
+    wallcycle_get(wcycle, WallCycleCounter::Step, &numSteps, &cycles);
+
+    const int numIntervalSteps = numSteps - numStepsPrevious_;
+    double    intervalCycles   = cycles - cyclesPrevious_;
+    numStepsPrevious_          = numSteps;
+    cyclesPrevious_            = cycles;
+
+    /* Nothing to account at the first search step or after the counters
+     * have been reset. This is the same on all ranks.
+     */
+    if (numIntervalSteps <= 0)
+    {
+        return;
+    }
+
+    if (PAR(cr))
+    {
+        gmx_sumd(1, &intervalCycles, cr);
+    }
+
+    LayoutTiming& timing = timings_[current_];
+    timing.numIntervals++;
+    if (timing.numIntervals > c_numSkippedIntervals)
+    {
+        const double cyclesPerStep = intervalCycles / numIntervalSteps;
+        if (timing.cyclesPerStep < 0 || cyclesPerStep < timing.cyclesPerStep)
+        {
+            timing.cyclesPerStep = cyclesPerStep;
+        }
+    }
+
+    if (timing.numIntervals < c_numSkippedIntervals + c_numTimedIntervals)
+    {
+        return;
+    }
+
+    if (timings_[1 - current_].numIntervals == 0)
+    {
+        // Time the other layout, starting at this search step
+        switchLayout(fr);
+
+        return;
+    }
+
+    // Both layouts have been timed, keep the initial layout unless the other is clearly faster
+    const bool alternativeIsFaster =
+            (timings_[1].cyclesPerStep * (1 + c_minRelativeGain) < timings_[0].cyclesPerStep);
+    const int fastest = alternativeIsFaster ? 1 : 0;
+    if (fastest != current_)
+    {
+        switchLayout(fr);
+    }
+    alternative_.reset();
+    isActive_ = false;
+
+    const double numRanks = cr->sizeOfMyGroupCommunicator;
+    GMX_LOG(mdlog.info)
+            .asParagraph()
+            .appendTextFormatted(
+                    "Step %" PRId64
+                    ": timed the non-bonded kernel layouts over %d pair-list intervals:\n"
+                    "  %-14s %8.3f M-cycles per step\n"
+                    "  %-14s %8.3f M-cycles per step\n"
+                    "Using the %s kernels for the rest of the run",
+                    step,
+                    c_numTimedIntervals,
+                    layoutDescription(timings_[0].kernelSetup).c_str(),
+                    timings_[0].cyclesPerStep * 1e-6 / numRanks,
+                    layoutDescription(timings_[1].kernelSetup).c_str(),
+                    timings_[1].cyclesPerStep * 1e-6 / numRanks,
+                    layoutDescription(timings_[fastest].kernelSetup).c_str());
+}
+
+std::unique_ptr<KernelLayoutTuning> makeKernelLayoutTuning(const MDLogger&      mdlog,
+                                                           const t_inputrec&    inputrec,
+                                                           const t_forcerec&    forcerec,
+                                                           const t_commrec*     cr,
+                                                           const gmx_mtop_t&    mtop,
+                                                           ArrayRef<const RVec> coordinates,
+                                                           matrix               box,
+                                                           gmx_wallcycle*       wcycle)
+{
+    if (getenv("GMX_NBNXN_TUNE_LAYOUT") == nullptr)
+    {
+        return nullptr;
+    }
+
+    const std::optional<NbnxmKernelSetup> alternativeSetup =
+            alternativeCpuKernelSetup(forcerec.nbv->kernelSetup());
+
+    const char* reason = nullptr;
+    if (!alternativeSetup)
+    {
+        reason = "this requires CPU SIMD non-bonded kernels with both the 4xM and 2xMM layouts";
+    }
+    else if (getenv("GMX_NBNXN_SIMD_4XN") != nullptr || getenv("GMX_NBNXN_SIMD_2XNN") != nullptr)
+    {
+        reason = "the kernel layout is set through the environment";
+    }
+    else if (inputrec.efep != FreeEnergyPerturbationType::No)
+    {
+        reason = "this is not supported with free-energy calculations";
+    }
+    else if (!wallcycle_have_counter() || wcycle == nullptr)
+    {
+        reason = "this requires cycle counters";
+    }
+    else if (inputrec.nstlist <= 0)
+    {
+        reason = "this requires a pair list that is updated";
+    }
+
+    if (reason != nullptr)
+    {
+        GMX_LOG(mdlog.info)
+                .asParagraph()
+                .appendTextFormatted("NOTE: Not tuning the non-bonded kernel layout, %s", reason);
+
+        return nullptr;
+    }
+
+    GMX_LOG(mdlog.info)
+            .asParagraph()
+            .appendTextFormatted(
+                    "Will time the %s and %s non-bonded kernel layouts during the first "
+                    "%d pair-list intervals",
+                    layoutDescription(forcerec.nbv->kernelSetup()).c_str(),
+                    layoutDescription(alternativeSetup.value()).c_str(),
+                    2 * (c_numSkippedIntervals + c_numTimedIntervals));
+
+    return std::make_unique<KernelLayoutTuning>(
+            alternativeSetup.value(), inputrec, forcerec, cr, mtop, coordinates, box, wcycle);
+}
+
+} // namespace gmx
@@ -0,0 +1,176 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \libinternal \file
+ *
+ * \brief Declares the run-time tuning of the SIMD layout of the CPU non-bonded kernels
+ *
+ * Both the 4xM and the 2xMM kernel layouts can be supported by a build.
+ * Which of the two is faster depends on the hardware, the system and
+ * the cut-off, so the static choice made at setup can be wrong.
+ * With the GMX_NBNXN_TUNE_LAYOUT environment variable set, both layouts
+ * are timed on the actual system during the first pair-list intervals
+ * of the run and the fastest one is used for the rest of the run.
+ *
+ * \inlibraryapi
+ * \ingroup module_nbnxm
+ */
+
+#ifndef NBNXM_KERNEL_LAYOUT_TUNING_H
+#define NBNXM_KERNEL_LAYOUT_TUNING_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "gromacs/math/vectypes.h"
+#include "gromacs/utility/arrayref.h"
+
+#include "nbnxm.h"
+
+struct gmx_mtop_t;
+struct gmx_wallcycle;
+struct t_commrec;
+struct t_forcerec;
+struct t_inputrec;
+
+namespace gmx
+{
+class MDLogger;
+
+/*! \libinternal
+ * \brief Times the 4xM and 2xMM CPU kernel layouts and switches to the fastest
+ *
+ * Timing uses the step cycle counts over whole pair-list intervals,
+ * so the cost of the pair search is included. The switch between the
+ * layouts happens just before a search step, where the atoms are put
+ * on the grid and the pair list is constructed anyhow.
+ */
+class KernelLayoutTuning
+{
+public:
+    /*! \brief Constructor, sets up the alternative kernel layout
+     *
+     * Should be called on all PP ranks. The parameters are as for
+     * init_nb_verlet_cpu().
+     */
+    KernelLayoutTuning(const NbnxmKernelSetup& alternativeSetup,
+                       const t_inputrec&       inputrec,
+                       const t_forcerec&       forcerec,
+                       const t_commrec*        cr,
+                       const gmx_mtop_t&       mtop,
+                       ArrayRef<const RVec>    coordinates,
+                       matrix                  box,
+                       gmx_wallcycle*          wcycle);
+
+    ~KernelLayoutTuning();
+
+    //! Returns whether the tuning is still ongoing
+    bool isActive() const { return isActive_; }
+
+    /*! \brief Accounts the last pair-list interval and switches layouts when needed
+     *
+     * Should be called on all PP ranks at every pair-search step,
+     * before the step cycle counter is started.
+     *
+     * \param[in]     mdlog  Logger used to report the decision
+     * \param[in]     cr     The communication record
+     * \param[in,out] fr     The force record, fr->nbv might be replaced
+     * \param[in]     wcycle The wallcycle counters
+     * \param[in]     step   The current step
+     */
+    void tune(const MDLogger&  mdlog,
+              const t_commrec* cr,
+              t_forcerec*      fr,
+              gmx_wallcycle*   wcycle,
+              int64_t          step);
+
+private:
+    //! The timing data for one kernel layout
+    struct LayoutTiming
+    {
+        //! The kernel setup
+        NbnxmKernelSetup kernelSetup;
+        //! The number of pair-list intervals run with this layout
+        int numIntervals = 0;
+        //! The lowest cycle count per step, summed over ranks, -1 when not measured
+        double cyclesPerStep = -1;
+    };
+
+    //! Swaps the layout of \p fr->nbv with the one of alternative_
+    void switchLayout(t_forcerec* fr);
+
+    //! The timings for the initial and the alternative layout
+    std::array<LayoutTiming, 2> timings_;
+    //! The index in timings_ of the layout currently in use
+    int current_ = 0;
+    //! The non-bonded setup that is currently not in use, nullptr when the tuning is done
+    std::unique_ptr<nonbonded_verlet_t> alternative_;
+    //! The step cycle count at the previous call
+    double cyclesPrevious_ = 0;
+    //! The step count at the previous call
+    int numStepsPrevious_ = 0;
+    //! Whether we are still tuning
+    bool isActive_ = true;
+};
+
+/*! \brief Returns a layout tuning object when requested and supported, nullptr otherwise
+ *
+ * Tuning is requested with the GMX_NBNXN_TUNE_LAYOUT environment variable
+ * and is supported with CPU SIMD kernels when both the 4xM and 2xMM layouts
+ * are available, no layout is forced through the environment, cycle
+ * counters are available and no free-energy calculation is performed.
+ * When tuning is requested, but not supported, a note is written to \p mdlog.
+ * Should be called on all PP ranks.
+ *
+ * \param[in] mdlog        Logger
+ * \param[in] inputrec     The input record
+ * \param[in] forcerec     The force record with the active Nbnxm setup
+ * \param[in] cr           The communication record
+ * \param[in] mtop         The global topology
+ * \param[in] coordinates  The global coordinates on the main rank, used for the density
+ * \param[in] box          The unit cell
+ * \param[in] wcycle       The wallcycle counters
+ */
+std::unique_ptr<KernelLayoutTuning> makeKernelLayoutTuning(const MDLogger&      mdlog,
+                                                           const t_inputrec&    inputrec,
+                                                           const t_forcerec&    forcerec,
+                                                           const t_commrec*     cr,
+                                                           const gmx_mtop_t&    mtop,
+                                                           ArrayRef<const RVec> coordinates,
+                                                           matrix               box,
+                                                           gmx_wallcycle*       wcycle);
+
+} // namespace gmx
+
+#endif /* NBNXM_KERNEL_LAYOUT_TUNING_H */
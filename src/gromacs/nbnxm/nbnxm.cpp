@@ -44,12 +44,18 @@
 
 #include "nbnxm.h"
 
+#include <cinttypes>
+
 #include "gromacs/domdec/domdec_zones.h"
 #include "gromacs/nbnxm/atomdata.h"
+#include "gromacs/timing/performancereport.h"
 #include "gromacs/timing/wallcycle.h"
+#include "gromacs/utility/keyvaluetreebuilder.h"
+#include "gromacs/utility/logger.h"
 #include "gromacs/utility/message_string_collector.h"
 
 #include "nbnxm_gpu.h"
+#include "pairlistset.h"
 #include "pairlistsets.h"
 #include "pairsearch.h"
 
@@ -218,6 +224,53 @@ void nonbonded_verlet_t::changePairlistRadii(real rlistOuter, real rlistInner) c
     pairlistSets_->changePairlistRadii(rlistOuter, rlistInner);
 }
 
+void nonbonded_verlet_t::changeInteractionCutoff(real interactionCutoff) const
+{
+    pairlistSets_->changeInteractionCutoff(interactionCutoff);
+}
+
+void nonbonded_verlet_t::reportAtomPairStatistics(const MDLogger&    mdlog,
+                                                  PerformanceReport* performanceReport) const
+{
+    const PairlistSets& pairlistSets = *pairlistSets_;
+
+    // Each search constructs the local and, with DD, the non-local lists
+    AtomPairStatistics stats =
+            pairlistSets.pairlistSet(InteractionLocality::Local).atomPairStatistics();
+    const int64_t numSamples = stats.numSamples;
+    if (pairlistSets.params().haveMultipleDomains_)
+    {
+        stats += pairlistSets.pairlistSet(InteractionLocality::NonLocal).atomPairStatistics();
+    }
+    if (numSamples == 0)
+    {
+        return;
+    }
+
+    GMX_LOG(mdlog.info)
+            .asParagraph()
+            .appendTextFormatted(
+                    "Pair-list atom-pair statistics of this rank over %" PRId64
+                    " list constructions:\n"
+                    "  average atom pairs per search: %.0f\n"
+                    "  %s",
+                    numSamples,
+                    stats.numUnmaskedPairs / static_cast<double>(numSamples),
+                    stats.formatPercentages().c_str());
+
+    if (performanceReport != nullptr)
+    {
+        KeyValueTreeObjectBuilder section = performanceReport->section("pairlist_statistics");
+        section.addValue<int64_t>("list_constructions", numSamples);
+        section.addValue<double>("atom_pairs_per_search",
+                                 stats.numUnmaskedPairs / static_cast<double>(numSamples));
+        section.addValue<double>("within_rlist_percent", stats.percentWithinRlist());
+        section.addValue<double>("within_cutoff_percent", stats.percentWithinCutoff());
+        section.addValue<double>("masked_percent", stats.percentMasked());
+        section.addValue<double>("j_cluster_reuse_percent", stats.percentReusedJClusters());
+    }
+}
+
 void nonbonded_verlet_t::setupGpuShortRangeWork(const ListedForcesGpu*    listedForcesGpu,
                                                 const InteractionLocality iLocality) const
 {
@@ -110,6 +110,7 @@
 #define GMX_NBNXM_NBNXM_H
 
 #include <memory>
+#include <optional>
 
 #include "gromacs/gpu_utils/devicebuffer_datatype.h"
 #include "gromacs/math/vectypes.h"
@@ -152,6 +153,7 @@ template<typename>
 class ListOfLists;
 class MDLogger;
 class ObservablesReducerBuilder;
+class PerformanceReport;
 template<typename>
 class Range;
 class StepWorkload;
@@ -384,6 +386,20 @@ public:
     //! Changes the pair-list outer and inner radius
     void changePairlistRadii(real rlistOuter, real rlistInner) const;
 
+    //! Changes the interaction cut-off used for the pair-list statistics
+    void changeInteractionCutoff(real interactionCutoff) const;
+
+    /*! \brief Writes the sampled atom-pair statistics of the pair lists to the log and report
+     *
+     * Does nothing when no statistics were sampled, which is the default.
+     * The statistics are summed over the local and non-local lists of this rank.
+     *
+     * \param[in] mdlog              Logger for the log file
+     * \param[in] performanceReport  Report to add the statistics to, can be nullptr
+     */
+    void reportAtomPairStatistics(const MDLogger&    mdlog,
+                                  PerformanceReport* performanceReport) const;
+
     //! Set up internal flags that indicate what type of short-range work there is.
     void setupGpuShortRangeWork(const ListedForcesGpu* listedForcesGpu, InteractionLocality iLocality) const;
 
@@ -436,6 +452,29 @@ std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const MDLogger&            md
                                                    matrix                     box,
                                                    gmx_wallcycle*             wcycle);
 
+/*! \brief Returns the kernel setup with the other SIMD layout, 4xM or 2xMM, for \p kernelSetup
+ *
+ * Returns std::nullopt when \p kernelSetup is not a SIMD setup or when
+ * only one of the two layouts is supported by this build.
+ */
+std::optional<NbnxmKernelSetup> alternativeCpuKernelSetup(const NbnxmKernelSetup& kernelSetup);
+
+/*! \brief Creates an Nbnxm object with CPU kernels for \p kernelSetup
+ *
+ * This is used for switching the kernel layout during a run, the
+ * current pairlist radii should be copied from the active object.
+ * Nothing is written to the log. Free-energy calculations are not
+ * supported.
+ */
+std::unique_ptr<nonbonded_verlet_t> init_nb_verlet_cpu(const NbnxmKernelSetup& kernelSetup,
+                                                       const t_inputrec&       inputrec,
+                                                       const t_forcerec&       forcerec,
+                                                       const t_commrec*        commrec,
+                                                       const gmx_mtop_t&       mtop,
+                                                       ArrayRef<const RVec>    coordinates,
+                                                       matrix                  box,
+                                                       gmx_wallcycle*          wcycle);
+
 /*! \brief As nbnxn_put_on_grid, but for the non-local atoms
  *
  * with domain decomposition. Should be called after calling
@@ -424,51 +424,37 @@ static LJCombinationRule chooseLJPmeCombinationRule(const t_forcerec& forcerec)
     return LJCombinationRule::None;
 }
 
-std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const gmx::MDLogger& mdlog,
-                                                   const t_inputrec&    inputrec,
-                                                   const t_forcerec&    forcerec,
-                                                   const t_commrec*     commrec,
-                                                   const gmx_hw_info_t& hardwareInfo,
-                                                   bool                 useGpuForNonbonded,
-                                                   const gmx::DeviceStreamManager* deviceStreamManager,
-                                                   const gmx_mtop_t&               mtop,
-                                                   gmx::ObservablesReducerBuilder* observablesReducerBuilder,
-                                                   gmx::ArrayRef<const gmx::RVec> coordinates,
-                                                   matrix                         box,
-                                                   gmx_wallcycle*                 wcycle)
+/*! \brief Creates an Nbnxm object for the given kernel setup
+ *
+ * The parameters are as for init_nb_verlet(), \p emulateGpu tells
+ * whether GPU kernels are emulated on the CPU.
+ */
+static std::unique_ptr<nonbonded_verlet_t> makeNbnxm(const gmx::MDLogger&    mdlog,
+                                                     const NbnxmKernelSetup& kernelSetup,
+                                                     const t_inputrec&       inputrec,
+                                                     const t_forcerec&       forcerec,
+                                                     const t_commrec*        commrec,
+                                                     bool                    useGpuForNonbonded,
+                                                     bool                    emulateGpu,
+                                                     const gmx::DeviceStreamManager* deviceStreamManager,
+                                                     const gmx_mtop_t&               mtop,
+                                                     gmx::ObservablesReducerBuilder* observablesReducerBuilder,
+                                                     gmx::ArrayRef<const gmx::RVec> coordinates,
+                                                     matrix                         box,
+                                                     gmx_wallcycle*                 wcycle)
 {
-    const bool emulateGpu = (getenv("GMX_EMULATE_GPU") != nullptr);
-
-    GMX_RELEASE_ASSERT(!(emulateGpu && useGpuForNonbonded),
-                       "When GPU emulation is active, there cannot be a GPU assignment");
-
-    NonbondedResource nonbondedResource;
-    if (useGpuForNonbonded)
-    {
-        nonbondedResource = NonbondedResource::Gpu;
-    }
-    else if (emulateGpu)
-    {
-        nonbondedResource = NonbondedResource::EmulateGpu;
-    }
-    else
-    {
-        nonbondedResource = NonbondedResource::Cpu;
-    }
-
     // This will later be obtained from the device information to get the optimal layout for the
     // device. For now we just use the one layout we have.
     const auto gpuPairlistLayout = sc_layoutType;
 
-    NbnxmKernelSetup kernelSetup = pick_nbnxn_kernel(
-            mdlog, forcerec.use_simd_kernels, hardwareInfo, gpuPairlistLayout, nonbondedResource, inputrec);
-
     const bool haveMultipleDomains = havePPDomainDecomposition(commrec);
 
     bool bFEP_NonBonded = (forcerec.efep != FreeEnergyPerturbationType::No)
                           && haveFepPerturbedNBInteractions(mtop);
     PairlistParams pairlistParams(
             kernelSetup.kernelType, gpuPairlistLayout, bFEP_NonBonded, inputrec.rlist, haveMultipleDomains);
+    pairlistParams.interactionCutoff = std::max(inputrec.rcoulomb, inputrec.rvdw);
+    pairlistParams.sampleAtomPairStatistics = (getenv("GMX_NBNXN_PAIR_STATISTICS") != nullptr);
 
     const real effectiveAtomDensity = computeEffectiveAtomDensity(
             coordinates, box, std::max(inputrec.rcoulomb, inputrec.rvdw), commrec->mpi_comm_mygroup);
@@ -558,6 +544,112 @@ std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const gmx::MDLogger& mdlog,
                                                 wcycle);
 }
 
+std::unique_ptr<nonbonded_verlet_t> init_nb_verlet(const gmx::MDLogger& mdlog,
+                                                   const t_inputrec&    inputrec,
+                                                   const t_forcerec&    forcerec,
+                                                   const t_commrec*     commrec,
+                                                   const gmx_hw_info_t& hardwareInfo,
+                                                   bool                 useGpuForNonbonded,
+                                                   const gmx::DeviceStreamManager* deviceStreamManager,
+                                                   const gmx_mtop_t&               mtop,
+                                                   gmx::ObservablesReducerBuilder* observablesReducerBuilder,
+                                                   gmx::ArrayRef<const gmx::RVec> coordinates,
+                                                   matrix                         box,
+                                                   gmx_wallcycle*                 wcycle)
+{
+    const bool emulateGpu = (getenv("GMX_EMULATE_GPU") != nullptr);
+
+    GMX_RELEASE_ASSERT(!(emulateGpu && useGpuForNonbonded),
+                       "When GPU emulation is active, there cannot be a GPU assignment");
+
+    NonbondedResource nonbondedResource;
+    if (useGpuForNonbonded)
+    {
+        nonbondedResource = NonbondedResource::Gpu;
+    }
+    else if (emulateGpu)
+    {
+        nonbondedResource = NonbondedResource::EmulateGpu;
+    }
+    else
+    {
+        nonbondedResource = NonbondedResource::Cpu;
+    }
+
+    // This will later be obtained from the device information to get the optimal layout for the
+    // device. For now we just use the one layout we have.
+    const auto gpuPairlistLayout = sc_layoutType;
+
+    NbnxmKernelSetup kernelSetup = pick_nbnxn_kernel(
+            mdlog, forcerec.use_simd_kernels, hardwareInfo, gpuPairlistLayout, nonbondedResource, inputrec);
+
+    return makeNbnxm(mdlog,
+                     kernelSetup,
+                     inputrec,
+                     forcerec,
+                     commrec,
+                     useGpuForNonbonded,
+                     emulateGpu,
+                     deviceStreamManager,
+                     mtop,
+                     observablesReducerBuilder,
+                     coordinates,
+                     box,
+                     wcycle);
+}
+
+std::optional<NbnxmKernelSetup> alternativeCpuKernelSetup(const NbnxmKernelSetup& kernelSetup)
+{
+    if (!(sc_haveNbnxmSimd4xmKernels && sc_haveNbnxmSimd2xmmKernels))
+    {
+        return std::nullopt;
+    }
+
+    NbnxmKernelSetup alternativeSetup = kernelSetup;
+    switch (kernelSetup.kernelType)
+    {
+        case NbnxmKernelType::Cpu4xN_Simd_4xN:
+            alternativeSetup.kernelType = NbnxmKernelType::Cpu4xN_Simd_2xNN;
+            break;
+        case NbnxmKernelType::Cpu4xN_Simd_2xNN:
+            alternativeSetup.kernelType = NbnxmKernelType::Cpu4xN_Simd_4xN;
+            break;
+        default: return std::nullopt;
+    }
+
+    return alternativeSetup;
+}
+
+std::unique_ptr<nonbonded_verlet_t> init_nb_verlet_cpu(const NbnxmKernelSetup& kernelSetup,
+                                                       const t_inputrec&       inputrec,
+                                                       const t_forcerec&       forcerec,
+                                                       const t_commrec*        commrec,
+                                                       const gmx_mtop_t&       mtop,
+                                                       ArrayRef<const RVec>    coordinates,
+                                                       matrix                  box,
+                                                       gmx_wallcycle*          wcycle)
+{
+    GMX_RELEASE_ASSERT(kernelTypeUsesSimplePairlist(kernelSetup.kernelType),
+                       "Can only set up CPU kernels here");
+    GMX_RELEASE_ASSERT(inputrec.efep == FreeEnergyPerturbationType::No,
+                       "Free-energy calculations are not supported here");
+
+    // Pass an empty logger, the setup has already been reported for the original object
+    return makeNbnxm(MDLogger(),
+                     kernelSetup,
+                     inputrec,
+                     forcerec,
+                     commrec,
+                     false,
+                     false,
+                     nullptr,
+                     mtop,
+                     nullptr,
+                     coordinates,
+                     box,
+                     wcycle);
+}
+
 nonbonded_verlet_t::nonbonded_verlet_t(std::unique_ptr<PairlistSets>     pairlistSets,
                                        std::unique_ptr<PairSearch>       pairSearch,
                                        std::unique_ptr<nbnxn_atomdata_t> nbat_in,
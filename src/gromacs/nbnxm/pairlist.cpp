@@ -39,14 +39,17 @@
 #include "config.h"
 
 #include <cassert>
+#include <cinttypes>
 #include <climits>
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <filesystem>
 #include <string>
 #include <type_traits>
@@ -80,6 +83,7 @@
 #include "gromacs/utility/listoflists.h"
 #include "gromacs/utility/range.h"
 #include "gromacs/utility/smalloc.h"
+#include "gromacs/utility/stringutil.h"
 
 #include "boundingbox.h"
 #include "boundingbox_simd.h"
@@ -431,7 +435,8 @@ static std::vector<NbnxnPairlistGpu> createGpuPairlists(int numLists)
 PairlistSet::PairlistSet(const PairlistParams& pairlistParams) :
     params_(pairlistParams),
     combineLists_(sc_isGpuPairListType[pairlistParams.pairlistType]), // Currently GPU lists are always combined
-    isCpuType_(!sc_isGpuPairListType[pairlistParams.pairlistType])
+    isCpuType_(!sc_isGpuPairListType[pairlistParams.pairlistType]),
+    useDynamicSearchSchedule_(isCpuType_ && getenv("GMX_NBNXN_DYNAMIC_SEARCH") != nullptr)
 {
 
     const int numLists = gmx_omp_nthreads_get(ModuleMultiThread::Nonbonded);
@@ -489,6 +494,194 @@ PairlistSet::PairlistSet(const PairlistParams& pairlistParams) :
     }
 }
 
+static RVec getCoordinate(const nbnxn_atomdata_t& nbat, const int a)
+{
+    RVec x;
+
+    switch (nbat.XFormat)
+    {
+        case nbatXYZQ:
+            x[XX] = nbat.x()[a * STRIDE_XYZQ];
+            x[YY] = nbat.x()[a * STRIDE_XYZQ + 1];
+            x[ZZ] = nbat.x()[a * STRIDE_XYZQ + 2];
+            break;
+        case nbatXYZ:
+            x[XX] = nbat.x()[a * STRIDE_XYZ];
+            x[YY] = nbat.x()[a * STRIDE_XYZ + 1];
+            x[ZZ] = nbat.x()[a * STRIDE_XYZ + 2];
+            break;
+        case nbatX4:
+        {
+            const int i = atom_to_x_index<c_packX4>(a);
+
+            x[XX] = nbat.x()[i + XX * c_packX4];
+            x[YY] = nbat.x()[i + YY * c_packX4];
+            x[ZZ] = nbat.x()[i + ZZ * c_packX4];
+            break;
+        }
+        case nbatX8:
+        {
+            const int i = atom_to_x_index<c_packX8>(a);
+
+            x[XX] = nbat.x()[i + XX * c_packX8];
+            x[YY] = nbat.x()[i + YY * c_packX8];
+            x[ZZ] = nbat.x()[i + ZZ * c_packX8];
+            break;
+        }
+        default: GMX_ASSERT(false, "Unsupported nbnxn_atomdata_t format");
+    }
+
+    return x;
+}
+
+AtomPairStatistics& AtomPairStatistics::operator+=(const AtomPairStatistics& other)
+{
+    numSamples += other.numSamples;
+    numUnmaskedPairs += other.numUnmaskedPairs;
+    numMaskedPairs += other.numMaskedPairs;
+    numPairsWithinRlist += other.numPairsWithinRlist;
+    numPairsWithinCutoff += other.numPairsWithinCutoff;
+    numJClusters += other.numJClusters;
+    numReusedJClusters += other.numReusedJClusters;
+
+    return *this;
+}
+
+//! Returns 100 times \p numerator divided by \p denominator, or 0 when the denominator is zero
+static double percentage(const int64_t numerator, const int64_t denominator)
+{
+    return 100 * numerator / std::max(static_cast<double>(denominator), 1.0);
+}
+
+double AtomPairStatistics::percentWithinRlist() const
+{
+    return percentage(numPairsWithinRlist, numUnmaskedPairs);
+}
+
+double AtomPairStatistics::percentWithinCutoff() const
+{
+    return percentage(numPairsWithinCutoff, numUnmaskedPairs);
+}
+
+double AtomPairStatistics::percentMasked() const
+{
+    return percentage(numMaskedPairs, numUnmaskedPairs + numMaskedPairs);
+}
+
+double AtomPairStatistics::percentReusedJClusters() const
+{
+    return percentage(numReusedJClusters, numJClusters);
+}
+
+std::string AtomPairStatistics::formatPercentages() const
+{
+    return formatString(
+            "within rlist: %.1f%%  within cut-off: %.1f%%  masked: %.1f%%  j-cluster reuse: %.1f%%",
+            percentWithinRlist(),
+            percentWithinCutoff(),
+            percentMasked(),
+            percentReusedJClusters());
+}
+
+/* Returns the statistics of the atom pairs in a CPU pair list
+ *
+ * Counts the atom pairs in the list that are within distance rl and within
+ * the interaction cut-off rc, the atom pairs that are masked out by exclusions
+ * and self-pair masks and the j-clusters that are also present in the list of
+ * the previous i-entry. Pairs involving filler atoms are not counted.
+ */
+static AtomPairStatistics computeAtomPairStatistics(const NbnxnPairlistCpu& nbl,
+                                                    const GridSet&          gridSet,
+                                                    const nbnxn_atomdata_t& nbat,
+                                                    const real              rl,
+                                                    const real              rc)
+{
+    matrix box;
+    gridSet.getBox(box);
+
+    ArrayRef<const int> atomIndices = gridSet.atomIndices();
+
+    const real rl2 = rl * rl;
+    const real rc2 = rc * rc;
+
+    // For each j-cluster the index of the last i-entry that had it in its list
+    std::vector<int> lastIEntryOfJCluster(atomIndices.ssize() / nbl.na_cj, -1);
+
+    AtomPairStatistics stats;
+    for (Index iEntry = 0; iEntry < gmx::ssize(nbl.ci); iEntry++)
+    {
+        const nbnxn_ci_t& ciEntry = nbl.ci[iEntry];
+
+        const int shiftIndex = ciEntry.shift & NBNXN_CI_SHIFT;
+        const int tx = shiftIndex % detail::c_nBoxX - c_dBoxX;
+        const int ty = (shiftIndex / detail::c_nBoxX) % detail::c_nBoxY - c_dBoxY;
+        const int tz = shiftIndex / (detail::c_nBoxX * detail::c_nBoxY) - c_dBoxZ;
+        RVec      shift;
+        for (int d = 0; d < DIM; d++)
+        {
+            shift[d] = tx * box[XX][d] + ty * box[YY][d] + tz * box[ZZ][d];
+        }
+
+        for (int cjIndex = ciEntry.cj_ind_start; cjIndex < ciEntry.cj_ind_end; cjIndex++)
+        {
+            const int cj = nbl.cj.cj(cjIndex);
+
+            stats.numJClusters++;
+            if (iEntry > 0 && lastIEntryOfJCluster[cj] == iEntry - 1)
+            {
+                stats.numReusedJClusters++;
+            }
+            lastIEntryOfJCluster[cj] = iEntry;
+
+            for (int i = 0; i < nbl.na_ci; i++)
+            {
+                const int ai = ciEntry.ci * nbl.na_ci + i;
+                if (atomIndices[ai] < 0)
+                {
+                    continue;
+                }
+                const RVec xi = getCoordinate(nbat, ai) + shift;
+                for (int j = 0; j < nbl.na_cj; j++)
+                {
+                    const int aj = cj * nbl.na_cj + j;
+                    if (atomIndices[aj] < 0)
+                    {
+                        continue;
+                    }
+                    if ((nbl.cj.excl(cjIndex) >> (i * nbl.na_cj + j)) & 1U)
+                    {
+                        stats.numUnmaskedPairs++;
+                        const real r2 = norm2(xi - getCoordinate(nbat, aj));
+                        if (r2 < rl2)
+                        {
+                            stats.numPairsWithinRlist++;
+                        }
+                        if (r2 < rc2)
+                        {
+                            stats.numPairsWithinCutoff++;
+                        }
+                    }
+                    else
+                    {
+                        stats.numMaskedPairs++;
+                    }
+                }
+            }
+        }
+    }
+
+    return stats;
+}
+
+/* Print atom-pair statistics of a CPU pair list, used for debug output */
+static void printAtomPairStatistics(FILE* fp, const AtomPairStatistics& stats)
+{
+    fprintf(fp,
+            "nbl atom pairs: %" PRId64 "  %s\n",
+            stats.numUnmaskedPairs,
+            stats.formatPercentages().c_str());
+}
+
 /* Print statistics of a pair list, used for debug output */
 template<PairlistType layoutType>
 static void print_nblist_statistics(FILE* fp, const NbnxnPairlistCpu& nbl, const GridSet& gridSet, const real rl)
@@ -1131,46 +1324,6 @@ static void setExclusionsForIEntry(const GridSet&          gridSet,
     }
 }
 
-static RVec getCoordinate(const nbnxn_atomdata_t& nbat, const int a)
-{
-    RVec x;
-
-    switch (nbat.XFormat)
-    {
-        case nbatXYZQ:
-            x[XX] = nbat.x()[a * STRIDE_XYZQ];
-            x[YY] = nbat.x()[a * STRIDE_XYZQ + 1];
-            x[ZZ] = nbat.x()[a * STRIDE_XYZQ + 2];
-            break;
-        case nbatXYZ:
-            x[XX] = nbat.x()[a * STRIDE_XYZ];
-            x[YY] = nbat.x()[a * STRIDE_XYZ + 1];
-            x[ZZ] = nbat.x()[a * STRIDE_XYZ + 2];
-            break;
-        case nbatX4:
-        {
-            const int i = atom_to_x_index<c_packX4>(a);
-
-            x[XX] = nbat.x()[i + XX * c_packX4];
-            x[YY] = nbat.x()[i + YY * c_packX4];
-            x[ZZ] = nbat.x()[i + ZZ * c_packX4];
-            break;
-        }
-        case nbatX8:
-        {
-            const int i = atom_to_x_index<c_packX8>(a);
-
-            x[XX] = nbat.x()[i + XX * c_packX8];
-            x[YY] = nbat.x()[i + YY * c_packX8];
-            x[ZZ] = nbat.x()[i + ZZ * c_packX8];
-            break;
-        }
-        default: GMX_ASSERT(false, "Unsupported nbnxn_atomdata_t format");
-    }
-
-    return x;
-}
-
 //! Returns the j/i cluster size ratio for the geometry of a grid
 static KernelLayoutClusterRatio layoutClusterRatio(const Grid::Geometry& geometry)
 {
@@ -2608,8 +2761,19 @@ static void balance_fep_lists(ArrayRef<std::unique_ptr<t_nblist>> fepLists, Arra
     }
 }
 
-/* Returns the next ci to be processes by our thread */
-static bool next_ci(const Grid& grid, int nth, int ci_block, int* ci_x, int* ci_y, int* ci_b, int* ci)
+/* Returns the next ci to be processes by our thread
+ *
+ * With nextCiBlock == nullptr, blocks are assigned round-robin over the threads.
+ * Otherwise the next block is taken from the shared counter nextCiBlock.
+ */
+static bool next_ci(const Grid&       grid,
+                    int               nth,
+                    int               ci_block,
+                    std::atomic<int>* nextCiBlock,
+                    int*              ci_x,
+                    int*              ci_y,
+                    int*              ci_b,
+                    int*              ci)
 {
     (*ci_b)++;
     (*ci)++;
@@ -2617,7 +2781,14 @@ static bool next_ci(const Grid& grid, int nth, int ci_block, int* ci_x, int* ci_
     if (*ci_b == ci_block)
     {
         /* Jump to the next block assigned to this task */
-        *ci += (nth - 1) * ci_block;
+        if (nextCiBlock)
+        {
+            *ci = nextCiBlock->fetch_add(1, std::memory_order_relaxed) * ci_block;
+        }
+        else
+        {
+            *ci += (nth - 1) * ci_block;
+        }
         *ci_b = 0;
     }
 
@@ -2680,7 +2851,10 @@ static float boundingbox_only_distance2(const Grid::Dimensions& iGridDims,
 #endif
 }
 
-static int get_ci_block_size(const Grid& iGrid, const bool haveMultipleDomains, const int numLists)
+static int get_ci_block_size(const Grid& iGrid,
+                             const bool  haveMultipleDomains,
+                             const bool  useDynamicSchedule,
+                             const int   numLists)
 {
     const int ci_block_enum      = 5;
     const int ci_block_denom     = 11;
@@ -2710,10 +2884,11 @@ static int get_ci_block_size(const Grid& iGrid, const bool haveMultipleDomains,
         ci_block = divideRoundUp(ci_block_min_atoms, numAtomsPerCell);
     }
 
-    /* Without domain decomposition
+    /* Without domain decomposition and static scheduling
      * or with less than 3 blocks per task, divide in nth blocks.
+     * With dynamic scheduling we need multiple blocks per task.
      */
-    if (!haveMultipleDomains || numLists * 3 * ci_block > iGrid.numCells())
+    if ((!haveMultipleDomains && !useDynamicSchedule) || numLists * 3 * ci_block > iGrid.numCells())
     {
         ci_block = divideRoundUp(iGrid.numCells(), numLists);
     }
@@ -2880,6 +3055,7 @@ static void nbnxn_make_pairlist_part(const GridSet&          gridSet,
                                      float                   nsubpair_tot_est,
                                      int                     th,
                                      int                     nth,
+                                     std::atomic<int>*       nextCiBlock,
                                      T*                      nbl,
                                      t_nblist*               nbl_fep)
 {
@@ -3024,7 +3200,7 @@ static void nbnxn_make_pairlist_part(const GridSet&          gridSet,
     int ci   = th * ci_block - 1;
     int ci_x = 0;
     int ci_y = 0;
-    while (next_ci(iGrid, nth, ci_block, &ci_x, &ci_y, &ci_b, &ci))
+    while (next_ci(iGrid, nth, ci_block, nextCiBlock, &ci_x, &ci_y, &ci_b, &ci))
     {
         if (c_listIsSimple && flags_i[ci] == 0)
         {
@@ -3789,8 +3965,15 @@ void PairlistSet::constructPairlists(InteractionLocality      locality,
                 searchCycleCounting->start(enbsCCsearch);
             }
 
-            const int ci_block =
-                    get_ci_block_size(iGrid, gridSet.domainSetup().haveMultipleDomains, numLists);
+            const int ci_block = get_ci_block_size(iGrid,
+                                                   gridSet.domainSetup().haveMultipleDomains,
+                                                   useDynamicSearchSchedule_,
+                                                   numLists);
+
+            /* With dynamic scheduling each thread starts with block th,
+             * as with static scheduling, and then takes the next free block.
+             */
+            std::atomic<int> nextCiBlock(numLists);
 
             /* With GPU: generate progressively smaller lists for
              * load balancing for local only or non-local with 2 zones.
@@ -3841,6 +4024,7 @@ void PairlistSet::constructPairlists(InteractionLocality      locality,
                                                  nsubpair_tot_est,
                                                  th,
                                                  numLists,
+                                                 useDynamicSearchSchedule_ ? &nextCiBlock : nullptr,
                                                  &cpuLists_[th],
                                                  fepListPtr);
                     }
@@ -3861,6 +4045,7 @@ void PairlistSet::constructPairlists(InteractionLocality      locality,
                                                  nsubpair_tot_est,
                                                  th,
                                                  numLists,
+                                                 nullptr,
                                                  &gpuLists_[th],
                                                  fepListPtr);
                     }
@@ -3981,6 +4166,28 @@ void PairlistSet::constructPairlists(InteractionLocality      locality,
         GMX_ASSERT(cpuLists_[0].ciOuter.empty(), "ciOuter is invalid so it should be empty");
     }
 
+    /* The atom-pair statistics are sampled on the final lists */
+    if (isCpuType_ && (debug || params_.sampleAtomPairStatistics))
+    {
+        for (const auto& cpuList : cpuLists_)
+        {
+            const AtomPairStatistics stats = computeAtomPairStatistics(
+                    cpuList, gridSet, *nbat, rlist, params_.interactionCutoff);
+            if (debug)
+            {
+                printAtomPairStatistics(debug, stats);
+            }
+            if (params_.sampleAtomPairStatistics)
+            {
+                atomPairStatistics_ += stats;
+            }
+        }
+        if (params_.sampleAtomPairStatistics)
+        {
+            atomPairStatistics_.numSamples++;
+        }
+    }
+
     /* If we have more than one list, they either got rebalancing (CPU)
      * or combined (GPU), so we should dump the final result to debug.
      */
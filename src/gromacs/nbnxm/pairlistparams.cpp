@@ -61,6 +61,8 @@ PairlistParams::PairlistParams(const NbnxmKernelType             kernelType,
     haveFep_(haveFep),
     rlistOuter(rlist),
     rlistInner(rlist),
+    interactionCutoff(rlist),
+    sampleAtomPairStatistics(false),
     haveMultipleDomains_(haveMultipleDomains),
     useDynamicPruning(false),
     mtsFactor(1),
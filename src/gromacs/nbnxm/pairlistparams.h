@@ -94,6 +94,10 @@ struct PairlistParams
     real rlistOuter;
     //! Cut-off of the smaller, inner pair-list
     real rlistInner;
+    //! The maximum of the Coulomb and Van der Waals cut-off, only used for statistics
+    real interactionCutoff;
+    //! Whether to sample atom-pair statistics of CPU pair lists at each search
+    bool sampleAtomPairStatistics;
     //! True when using DD with multiple domains
     bool haveMultipleDomains_;
     //! Are we using dynamic pair-list pruning
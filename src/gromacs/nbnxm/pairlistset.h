@@ -48,7 +48,10 @@
 #ifndef GMX_NBNXM_PAIRLISTSET_H
 #define GMX_NBNXM_PAIRLISTSET_H
 
+#include <cstdint>
+
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "gromacs/math/vectypes.h"
@@ -72,6 +75,43 @@ template<typename>
 class ListOfLists;
 class GridSet;
 
+/*! \internal
+ * \brief Counts of the atom pairs in CPU pair lists, used to judge the list efficiency
+ *
+ * Pairs involving filler atoms are not counted.
+ */
+struct AtomPairStatistics
+{
+    //! Adds the counts of \p other to this object
+    AtomPairStatistics& operator+=(const AtomPairStatistics& other);
+
+    //! Returns the percentage of unmasked pairs within the outer list cut-off
+    double percentWithinRlist() const;
+    //! Returns the percentage of unmasked pairs within the interaction cut-off
+    double percentWithinCutoff() const;
+    //! Returns the percentage of all pairs that are masked out
+    double percentMasked() const;
+    //! Returns the percentage of j-cluster entries reused from the previous i-entry
+    double percentReusedJClusters() const;
+    //! Returns the four percentages above formatted on a single line for output
+    std::string formatPercentages() const;
+
+    //! The number of pair-list constructions that were sampled
+    int64_t numSamples = 0;
+    //! The number of atom pairs that are not masked out
+    int64_t numUnmaskedPairs = 0;
+    //! The number of atom pairs masked out by exclusion and self-pair masks
+    int64_t numMaskedPairs = 0;
+    //! The number of unmasked atom pairs within the outer list cut-off
+    int64_t numPairsWithinRlist = 0;
+    //! The number of unmasked atom pairs within the interaction cut-off
+    int64_t numPairsWithinCutoff = 0;
+    //! The number of j-cluster entries in the lists
+    int64_t numJClusters = 0;
+    //! The number of j-cluster entries also present in the list of the previous i-entry
+    int64_t numReusedJClusters = 0;
+};
+
 /*! \internal
  * \brief An object that holds the local or non-local pairlists
  */
@@ -118,6 +158,9 @@ public:
     //! Returns the number of perturbed excluded pairs that are within distance rlist
     int numPerturbedExclusionsWithinRlist() const { return numPerturbedExclusionsWithinRlist_; }
 
+    //! Returns the atom-pair statistics summed over all sampled list constructions
+    const AtomPairStatistics& atomPairStatistics() const { return atomPairStatistics_; }
+
 private:
     //! List of pairlists in CPU layout
     std::vector<NbnxnPairlistCpu> cpuLists_;
@@ -131,10 +174,14 @@ private:
     bool combineLists_;
     //! Tells whether the lists is of CPU type, otherwise GPU type
     gmx_bool isCpuType_;
+    //! Whether threads take i-cluster blocks dynamically during search, only used with CPU lists
+    bool useDynamicSearchSchedule_;
     //! Lists for perturbed interactions in simple atom-atom layout
     std::vector<std::unique_ptr<t_nblist>> fepLists_;
     //! The number of excluded perturbed interaction within rlist
     int numPerturbedExclusionsWithinRlist_ = 0;
+    //! Atom-pair statistics, only sampled when requested in the pairlist parameters
+    AtomPairStatistics atomPairStatistics_;
 
 public:
     /* Pair counts for flop counting */
@@ -119,6 +119,12 @@ public:
         params_.rlistInner = rlistInner;
     }
 
+    //! Changes the interaction cut-off used for the pair-list statistics
+    void changeInteractionCutoff(real interactionCutoff)
+    {
+        params_.interactionCutoff = interactionCutoff;
+    }
+
     //! Returns the pair-list set for the given locality
     const PairlistSet& pairlistSet(InteractionLocality iLocality) const
     {
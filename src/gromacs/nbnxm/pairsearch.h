@@ -41,6 +41,12 @@
  * The actual gridding and pairlist generation is performed by the
  * GridSet/Grid and PairlistSet/Pairlist classes, respectively.
  *
+ * Note that the pairlist is always generated from scratch. At each search
+ * step the atoms are re-sorted over the grid cells and clusters, so cluster
+ * indices from a previous list do not refer to the same atoms and a list
+ * cannot be updated incrementally. Reuse of a list with a larger buffer is
+ * instead provided by dynamic pruning, see PairlistParams.
+ *
  * \author Berk Hess <hess@kth.se>
  *
  * \ingroup module_nbnxm
@@ -48,6 +48,7 @@
 #include "gromacs/nbnxm/atomdata.h"
 #include "gromacs/nbnxm/kernel_common.h"
 #include "gromacs/nbnxm/nbnxm.h"
+#include "gromacs/nbnxm/nbnxm_simd.h"
 
 #include "testutils/testasserts.h"
 
@@ -216,6 +217,38 @@ TEST(KernelSetupTest, getVdwKernelTypeAllCountThrows)
                                       LongRangeVdW::Count));
 }
 
+TEST(KernelSetupTest, alternativeCpuKernelSetupSwapsSimdLayouts)
+{
+    NbnxmKernelSetup kernelSetup;
+    kernelSetup.kernelType         = NbnxmKernelType::Cpu4xN_Simd_4xN;
+    kernelSetup.ewaldExclusionType = EwaldExclusionType::Analytical;
+
+    const auto alternativeSetup = alternativeCpuKernelSetup(kernelSetup);
+    if (sc_haveNbnxmSimd4xmKernels && sc_haveNbnxmSimd2xmmKernels)
+    {
+        ASSERT_TRUE(alternativeSetup.has_value());
+        EXPECT_EQ(alternativeSetup->kernelType, NbnxmKernelType::Cpu4xN_Simd_2xNN);
+        EXPECT_EQ(alternativeSetup->ewaldExclusionType, EwaldExclusionType::Analytical);
+
+        const auto backToOriginal = alternativeCpuKernelSetup(alternativeSetup.value());
+        ASSERT_TRUE(backToOriginal.has_value());
+        EXPECT_EQ(backToOriginal->kernelType, NbnxmKernelType::Cpu4xN_Simd_4xN);
+    }
+    else
+    {
+        EXPECT_FALSE(alternativeSetup.has_value());
+    }
+}
+
+TEST(KernelSetupTest, alternativeCpuKernelSetupNoneForPlainC)
+{
+    NbnxmKernelSetup kernelSetup;
+    kernelSetup.kernelType         = NbnxmKernelType::Cpu4x4_PlainC;
+    kernelSetup.ewaldExclusionType = EwaldExclusionType::Table;
+
+    EXPECT_FALSE(alternativeCpuKernelSetup(kernelSetup).has_value());
+}
+
 } // namespace
 } // namespace test
 } // namespace gmx
@@ -36,6 +36,7 @@
 
 #include <cstdio>
 
+#include <utility>
 #include <vector>
 
 #include "gromacs/math/vectypes.h"
@@ -91,6 +92,11 @@ struct t_graph
     std::vector<gmx::IVec> ishift;
     // Work buffer for coloring nodes
     std::vector<egCol> edgeColor;
+    // Edges (from, to) along which the shifts are set, in coloring order, computed on first use
+    // by mk_mshift; has to be cleared when the edges are modified
+    std::vector<std::pair<int, int>> shiftSettingEdges;
+    // The remaining directed edges, along which the consistency of the shifts is checked
+    std::vector<std::pair<int, int>> shiftCheckingEdges;
     // Tells how connected this graph is
     BondedParts parts = BondedParts::Single;
 };
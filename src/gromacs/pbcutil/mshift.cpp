@@ -577,47 +577,20 @@ static void mk_1shift_screw(const matrix box, const rvec hbox, const rvec xi, co
     }
 }
 
-static int mk_grey(ArrayRef<egCol> edgeColor,
-                   t_graph*        g,
-                   int*            AtomI,
-                   int             npbcdim,
-                   const matrix    box,
-                   const rvec      x[],
-                   int*            nerror)
+/* Makes all white neighbours of the black node *AtomI grey and stores
+ * the visited edges in the traversal lists of g.
+ * Returns the number of nodes made grey.
+ */
+static int mk_grey(ArrayRef<egCol> edgeColor, t_graph* g, int* AtomI)
 {
-    int      m, ng, ai, g0;
-    rvec     dx, hbox;
-    gmx_bool bTriclinic;
-    ivec     is_aj;
-    t_pbc    pbc;
-
-    for (m = 0; (m < DIM); m++)
-    {
-        hbox[m] = box[m][m] * 0.5;
-    }
-    bTriclinic = TRICLINIC(box);
-
-    g0 = g->edgeAtomBegin;
-    ng = 0;
-    ai = g0 + *AtomI;
+    const int g0 = g->edgeAtomBegin;
+    const int ai = g0 + *AtomI;
+    int       ng = 0;
 
     /* Loop over all the bonds */
     for (const int aj : g->edges[ai - g0])
     {
-        /* If there is a white one, make it grey and set pbc */
-        if (g->useScrewPbc)
-        {
-            mk_1shift_screw(box, hbox, x[ai], x[aj], g->ishift[ai], is_aj);
-        }
-        else if (bTriclinic)
-        {
-            mk_1shift_tric(npbcdim, box, hbox, x[ai], x[aj], g->ishift[ai], is_aj);
-        }
-        else
-        {
-            mk_1shift(npbcdim, hbox, x[ai], x[aj], g->ishift[ai], is_aj);
-        }
-
+        /* If there is a white one, make it grey and set pbc from ai */
         if (edgeColor[aj - g0] == egcolWhite)
         {
             if (aj - g0 < *AtomI)
@@ -626,34 +599,13 @@ static int mk_grey(ArrayRef<egCol> edgeColor,
             }
             edgeColor[aj - g0] = egcolGrey;
 
-            copy_ivec(is_aj, g->ishift[aj]);
+            g->shiftSettingEdges.emplace_back(ai, aj);
 
             ng++;
         }
-        else if ((is_aj[XX] != g->ishift[aj][XX]) || (is_aj[YY] != g->ishift[aj][YY])
-                 || (is_aj[ZZ] != g->ishift[aj][ZZ]))
+        else
         {
-            if (gmx_debug_at)
-            {
-                set_pbc(&pbc, PbcType::Unset, box);
-                pbc_dx(&pbc, x[ai], x[aj], dx);
-                fprintf(debug,
-                        "mk_grey: shifts for atom %d due to atom %d\n"
-                        "are (%d,%d,%d), should be (%d,%d,%d)\n"
-                        "dx = (%g,%g,%g)\n",
-                        aj + 1,
-                        ai + 1,
-                        is_aj[XX],
-                        is_aj[YY],
-                        is_aj[ZZ],
-                        g->ishift[aj][XX],
-                        g->ishift[aj][YY],
-                        g->ishift[aj][ZZ],
-                        dx[XX],
-                        dx[YY],
-                        dx[ZZ]);
-            }
-            (*nerror)++;
+            g->shiftCheckingEdges.emplace_back(ai, aj);
         }
     }
     return ng;
@@ -675,6 +627,67 @@ static gmx::Index first_colour(const int fC, const egCol Col, const t_graph* g,
     return -1;
 }
 
+/* Colors the graph to determine the order in which the shifts are set
+ * along the edges. This only depends on the connectivity, so this only
+ * needs to be done once for a graph.
+ */
+static void mk_traversal(t_graph* g)
+{
+    int                   nW, nG; /* Number of White and Grey nodes */
+    int gmx_used_in_debug nB;     /* Number of Black nodes */
+    int                   fW, fG; /* First of each category */
+
+    g->shiftSettingEdges.clear();
+    g->shiftCheckingEdges.clear();
+
+    std::fill(g->edgeColor.begin(), g->edgeColor.end(), egcolWhite);
+
+    nW = g->numConnectedAtoms;
+    nG = 0;
+    nB = 0;
+
+    fW = 0;
+
+    while (nW > 0)
+    {
+        GMX_ASSERT(nW + nG + nB == g->numConnectedAtoms, "Graph coloring inconsistency");
+        /* Find the first white, this will always be a larger
+         * number than before, because no nodes are made white
+         * in the loop
+         */
+        if ((fW = first_colour(fW, egcolWhite, g, g->edgeColor)) == -1)
+        {
+            gmx_fatal(FARGS, "No WHITE nodes found while nW=%d\n", nW);
+        }
+
+        /* Make the first white node grey */
+        g->edgeColor[fW] = egcolGrey;
+        nG++;
+        nW--;
+
+        /* Initial value for the first grey */
+        fG = fW;
+        while (nG > 0)
+        {
+            if ((fG = first_colour(fG, egcolGrey, g, g->edgeColor)) == -1)
+            {
+                gmx_fatal(FARGS, "No GREY nodes found while nG=%d\n", nG);
+            }
+
+            /* Make the first grey node black */
+            g->edgeColor[fG] = egcolBlack;
+            nB++;
+            nG--;
+
+            /* Make all the neighbours of this black node grey */
+            int ng = mk_grey(g->edgeColor, g, &fG);
+            /* ng is the number of white nodes made grey */
+            nG += ng;
+            nW -= ng;
+        }
+    }
+}
+
 /* Returns the maximum length of the graph edges for coordinates x */
 static real maxEdgeLength(const t_graph& g, PbcType pbcType, const matrix box, const rvec x[])
 {
@@ -699,13 +712,10 @@ static real maxEdgeLength(const t_graph& g, PbcType pbcType, const matrix box, c
 
 void mk_mshift(FILE* log, t_graph* g, PbcType pbcType, const matrix box, const rvec x[])
 {
-    static int            nerror_tot = 0;
-    int                   npbcdim;
-    int                   ng, i;
-    int                   nW, nG; /* Number of White and Grey nodes */
-    int gmx_used_in_debug nB;     /* Number of Black nodes */
-    int                   fW, fG; /* First of each category */
-    int                   nerror = 0;
+    static int nerror_tot = 0;
+    int        npbcdim;
+    int        i;
+    int        nerror = 0;
 
     g->useScrewPbc = (pbcType == PbcType::Screw);
 
@@ -733,52 +743,76 @@ void mk_mshift(FILE* log, t_graph* g, PbcType pbcType, const matrix box, const r
         return;
     }
 
-    std::fill(g->edgeColor.begin(), g->edgeColor.end(), egcolWhite);
-
-    nW = g->numConnectedAtoms;
-    nG = 0;
-    nB = 0;
-
-    fW = 0;
+    if (g->shiftSettingEdges.empty())
+    {
+        mk_traversal(g);
+    }
 
-    while (nW > 0)
+    rvec hbox;
+    for (int m = 0; (m < DIM); m++)
     {
-        GMX_ASSERT(nW + nG + nB == g->numConnectedAtoms, "Graph coloring inconsistency");
-        /* Find the first white, this will always be a larger
-         * number than before, because no nodes are made white
-         * in the loop
-         */
-        if ((fW = first_colour(fW, egcolWhite, g, g->edgeColor)) == -1)
+        hbox[m] = box[m][m] * 0.5;
+    }
+    const bool bTriclinic = TRICLINIC(box);
+
+    /* Computes in is_aj the shift of aj given the shift of ai */
+    const auto mk_shift = [&](int ai, int aj, int* is_aj) {
+        if (g->useScrewPbc)
         {
-            gmx_fatal(FARGS, "No WHITE nodes found while nW=%d\n", nW);
+            mk_1shift_screw(box, hbox, x[ai], x[aj], g->ishift[ai], is_aj);
+        }
+        else if (bTriclinic)
+        {
+            mk_1shift_tric(npbcdim, box, hbox, x[ai], x[aj], g->ishift[ai], is_aj);
         }
+        else
+        {
+            mk_1shift(npbcdim, hbox, x[ai], x[aj], g->ishift[ai], is_aj);
+        }
+    };
 
-        /* Make the first white node grey */
-        g->edgeColor[fW] = egcolGrey;
-        nG++;
-        nW--;
+    /* Set the periodicity along the spanning edges, in coloring order */
+    for (const auto& edge : g->shiftSettingEdges)
+    {
+        mk_shift(edge.first, edge.second, g->ishift[edge.second]);
+    }
 
-        /* Initial value for the first grey */
-        fG = fW;
-        while (nG > 0)
+    /* Check that the shifts are consistent along all other edges */
+    for (const auto& edge : g->shiftCheckingEdges)
+    {
+        const int ai = edge.first;
+        const int aj = edge.second;
+        ivec      is_aj;
+
+        mk_shift(ai, aj, is_aj);
+
+        if ((is_aj[XX] != g->ishift[aj][XX]) || (is_aj[YY] != g->ishift[aj][YY])
+            || (is_aj[ZZ] != g->ishift[aj][ZZ]))
         {
-            if ((fG = first_colour(fG, egcolGrey, g, g->edgeColor)) == -1)
+            if (gmx_debug_at)
             {
-                gmx_fatal(FARGS, "No GREY nodes found while nG=%d\n", nG);
-            }
-
-            /* Make the first grey node black */
-            g->edgeColor[fG] = egcolBlack;
-            nB++;
-            nG--;
+                t_pbc pbc;
+                rvec  dx;
 
-            /* Make all the neighbours of this black node grey
-             * and set their periodicity
-             */
-            ng = mk_grey(g->edgeColor, g, &fG, npbcdim, box, x, &nerror);
-            /* ng is the number of white nodes made grey */
-            nG += ng;
-            nW -= ng;
+                set_pbc(&pbc, PbcType::Unset, box);
+                pbc_dx(&pbc, x[ai], x[aj], dx);
+                fprintf(debug,
+                        "mk_grey: shifts for atom %d due to atom %d\n"
+                        "are (%d,%d,%d), should be (%d,%d,%d)\n"
+                        "dx = (%g,%g,%g)\n",
+                        aj + 1,
+                        ai + 1,
+                        is_aj[XX],
+                        is_aj[YY],
+                        is_aj[ZZ],
+                        g->ishift[aj][XX],
+                        g->ishift[aj][YY],
+                        g->ishift[aj][ZZ],
+                        dx[XX],
+                        dx[YY],
+                        dx[ZZ]);
+            }
+            nerror++;
         }
     }
     if (nerror > 0)
@@ -0,0 +1,88 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \libinternal \file
+ * \brief
+ * Declares gmx::PerformanceReport, a machine-readable summary of the
+ * performance of a simulation.
+ *
+ * \inlibraryapi
+ * \ingroup module_timing
+ */
+#ifndef GMX_TIMING_PERFORMANCEREPORT_H
+#define GMX_TIMING_PERFORMANCEREPORT_H
+
+#include <filesystem>
+#include <string>
+
+#include "gromacs/utility/keyvaluetreebuilder.h"
+
+namespace gmx
+{
+
+/*! \libinternal
+ * \brief Collects the performance data of a run in named sections and
+ * writes them as JSON.
+ *
+ * The modules that produce the human-readable performance summaries
+ * in the log file each add their own section, so the report contains
+ * the same data without tools needing to parse the log file. Only the
+ * rank writing the report has an object of this class, other ranks
+ * pass nullptr.
+ */
+class PerformanceReport
+{
+public:
+    /*! \brief Returns a builder for adding properties to the section \p name
+     *
+     * The section is created when it does not exist yet.
+     */
+    KeyValueTreeObjectBuilder section(const std::string& name);
+
+    /*! \brief Writes the report to \p filename
+     *
+     * Hands over the collected contents, so this should be called once,
+     * after all sections have been added.
+     *
+     * \throws FileIOError on any I/O error.
+     */
+    void write(const std::filesystem::path& filename);
+
+private:
+    //! The report contents
+    KeyValueTreeBuilder builder_;
+};
+
+} // namespace gmx
+
+#endif
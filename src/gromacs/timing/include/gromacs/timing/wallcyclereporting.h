@@ -40,6 +40,8 @@
 #include <cstdio>
 
 #include <array>
+#include <string>
+#include <vector>
 
 #include "gromacs/timing/wallcycle.h"
 #include "gromacs/utility/basedefinitions.h"
@@ -49,7 +51,8 @@ struct t_commrec;
 namespace gmx
 {
 class MDLogger;
-}
+class PerformanceReport;
+} // namespace gmx
 
 struct gmx_wallclock_gpu_nbnxn_t;
 struct gmx_wallclock_gpu_pme_t;
@@ -61,6 +64,27 @@ WallcycleCounts wallcycle_sum(const t_commrec* cr, gmx_wallcycle* wc);
 /* Return a vector of the sum of cycle counts over the nodes in
    cr->mpi_comm_mysim. */
 
+/*! \libinternal \brief Wall-clock times of the main counters for each rank of a simulation */
+struct WallcyclePerRank
+{
+    //! For each rank, whether it is a PME-only rank
+    std::vector<bool> isPmeOnlyRank;
+    //! For each rank, the name of the physical node it ran on
+    std::vector<std::string> nodeNames;
+    //! The wall-clock time in seconds, indexed by rank * sc_numWallCycleCounters + counter
+    std::vector<double> seconds;
+};
+
+WallcyclePerRank wallcycle_gather_per_rank(const t_commrec*     cr,
+                                           const gmx_wallcycle* wc,
+                                           int                  nth_pp,
+                                           int                  nth_pme,
+                                           double               elapsedTime);
+/* Return, on the main rank, the wall-clock time of each main counter
+   on each rank in cr->mpi_comm_mysim, together with the node names.
+   Should be called on all ranks after wallcycle_sum(), which makes the
+   counters exclusive. The result is empty on the other ranks. */
+
 void wallcycle_print(FILE*                            fplog,
                      const gmx::MDLogger&             mdlog,
                      int                              nnodes,
@@ -74,4 +98,20 @@ void wallcycle_print(FILE*                            fplog,
                      const gmx_wallclock_gpu_pme_t*   gpu_pme_t);
 /* Print the cycle and time accounting */
 
+void wallcycle_report(gmx::PerformanceReport*          report,
+                      int                              nnodes,
+                      int                              npme,
+                      int                              nth_pp,
+                      int                              nth_pme,
+                      double                           realtime,
+                      gmx_wallcycle*                   wc,
+                      const WallcycleCounts&           cyc_sum,
+                      const WallcyclePerRank&          perRank,
+                      const gmx_wallclock_gpu_nbnxn_t* gpu_nbnxn_t,
+                      const gmx_wallclock_gpu_pme_t*   gpu_pme_t);
+/* Add the cycle and time accounting, of all counters and GPU tasks,
+   to the timing and gpu_timing sections of report. With multiple ranks
+   in perRank, the per-rank times and their statistics over the ranks
+   are added as well. */
+
 #endif
@@ -41,6 +41,7 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <algorithm>
 #include <array>
 #include <filesystem>
 #include <memory>
@@ -51,6 +52,7 @@
 #include "gromacs/mdtypes/commrec.h"
 #include "gromacs/timing/cyclecounter.h"
 #include "gromacs/timing/gpu_timing.h"
+#include "gromacs/timing/performancereport.h"
 #include "gromacs/timing/wallcyclereporting.h"
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/cstringutil.h"
@@ -58,10 +60,12 @@
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
 #include "gromacs/utility/gmxmpi.h"
+#include "gromacs/utility/keyvaluetreebuilder.h"
 #include "gromacs/utility/logger.h"
 #include "gromacs/utility/smalloc.h"
 #include "gromacs/utility/snprintf.h"
 #include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/sysinfo.h"
 
 //! True if only the main rank should print debugging output
 static constexpr bool sc_onlyMainDebugPrints = true;
@@ -526,6 +530,86 @@ WallcycleCounts wallcycle_sum(const t_commrec* cr, gmx_wallcycle* wc)
     return cycles_sum;
 }
 
+WallcyclePerRank wallcycle_gather_per_rank(const t_commrec*     cr,
+                                           const gmx_wallcycle* wc,
+                                           int                  nth_pp,
+                                           int                  nth_pme,
+                                           double               elapsedTime)
+{
+    WallcyclePerRank perRank;
+    if (wc == nullptr)
+    {
+        return perRank;
+    }
+
+    /* Undo the thread scaling and convert to wall-clock time with the run time of this rank */
+    const bool isPmeOnlyRank = !thisRankHasDuty(cr, DUTY_PP);
+    const auto numThreads    = [&](WallCycleCounter key)
+    {
+        return (is_pme_counter(key) || (key == WallCycleCounter::Run && isPmeOnlyRank)) ? nth_pme
+                                                                                        : nth_pp;
+    };
+    const double runCycles = wc->wcc[WallCycleCounter::Run].c
+                             / static_cast<double>(numThreads(WallCycleCounter::Run));
+    std::array<double, sc_numWallCycleCounters> seconds;
+    for (auto key : keysOf(wc->wcc))
+    {
+        seconds[static_cast<int>(key)] =
+                (runCycles > 0) ? wc->wcc[key].c / (numThreads(key) * runCycles) * elapsedTime : 0;
+    }
+    constexpr int c_nodeNameLength = 256;
+    char          nodeName[c_nodeNameLength];
+    gmx_gethostname(nodeName, c_nodeNameLength);
+
+    const int  numRanks = cr->nnodes;
+    const bool isMain   = (cr->nodeid == MAINRANK(cr));
+    if (isMain)
+    {
+        perRank.isPmeOnlyRank.resize(numRanks);
+        perRank.nodeNames.resize(numRanks);
+        perRank.seconds.resize(numRanks * sc_numWallCycleCounters);
+    }
+    std::vector<int>  isPmeOnlyAll(isMain ? numRanks : 0);
+    std::vector<char> nodeNamesAll(isMain ? numRanks * c_nodeNameLength : 0);
+    int               isPmeOnlyInt = isPmeOnlyRank ? 1 : 0;
+#if GMX_MPI
+    if (numRanks > 1)
+    {
+        MPI_Gather(seconds.data(),
+                   sc_numWallCycleCounters,
+                   MPI_DOUBLE,
+                   perRank.seconds.data(),
+                   sc_numWallCycleCounters,
+                   MPI_DOUBLE,
+                   MAINRANK(cr),
+                   cr->mpi_comm_mysim);
+        MPI_Gather(
+                &isPmeOnlyInt, 1, MPI_INT, isPmeOnlyAll.data(), 1, MPI_INT, MAINRANK(cr), cr->mpi_comm_mysim);
+        MPI_Gather(nodeName,
+                   c_nodeNameLength,
+                   MPI_CHAR,
+                   nodeNamesAll.data(),
+                   c_nodeNameLength,
+                   MPI_CHAR,
+                   MAINRANK(cr),
+                   cr->mpi_comm_mysim);
+    }
+    else
+#endif
+    {
+        std::copy(seconds.begin(), seconds.end(), perRank.seconds.begin());
+        isPmeOnlyAll[0] = isPmeOnlyInt;
+        std::copy(nodeName, nodeName + c_nodeNameLength, nodeNamesAll.begin());
+    }
+    for (int rank = 0; rank < (isMain ? numRanks : 0); rank++)
+    {
+        perRank.isPmeOnlyRank[rank] = (isPmeOnlyAll[rank] != 0);
+        perRank.nodeNames[rank]     = &nodeNamesAll[rank * c_nodeNameLength];
+    }
+
+    return perRank;
+}
+
 static void
 print_cycles(FILE* fplog, double c2t, const char* name, int nnodes, int nthreads, int ncalls, double c_sum, double tot)
 {
@@ -637,6 +721,285 @@ static void print_header(FILE* fplog, int nrank_pp, int nth_pp, int nrank_pme, i
 }
 
 
+namespace
+{
+
+//! The accounting of one cycle counter, i.e. one line of the cycle accounting table
+struct CycleAccountingEntry
+{
+    //! The name of the counter
+    std::string name;
+    //! The conversion factor from cycles to seconds for the ranks that ran the counter
+    double c2t;
+    //! The number of ranks, -1 when not applicable
+    int numRanks;
+    //! The number of threads per rank, -1 when not applicable
+    int numThreads;
+    //! The number of calls, -1 when not applicable
+    int numCalls;
+    //! The cycles summed over all ranks
+    double cycles;
+};
+
+//! The cycle accounting that is printed to the log file and added to the performance report
+struct CycleAccounting
+{
+    //! The conversion factor from cycles to seconds for the whole run
+    double c2t = 0;
+    //! The counters, including the rest, in the order of the log file table
+    std::vector<CycleAccountingEntry> counters;
+    //! The breakdown of the PME mesh counters, empty when none were recorded
+    std::vector<CycleAccountingEntry> pmeMeshCounters;
+    //! The breakdown of the PP / PME activities, empty without cycle sub-counters
+    std::vector<CycleAccountingEntry> subCounters;
+};
+
+/*! \brief Adds an entry to \p entries, when \p cycles is positive
+ *
+ * Entries without cycles are not printed to the log file, so they are
+ * skipped here for both outputs.
+ */
+void addCycleAccountingEntry(std::vector<CycleAccountingEntry>* entries,
+                             const std::string&                 name,
+                             double                             c2t,
+                             int                                numRanks,
+                             int                                numThreads,
+                             int                                numCalls,
+                             double                             cycles)
+{
+    if (cycles > 0)
+    {
+        entries->push_back({ name, c2t, numRanks, numThreads, numCalls, cycles });
+    }
+}
+
+/*! \brief Returns the cycle accounting of the run
+ *
+ * Should only be called when \p tot is positive and the counts are valid.
+ */
+CycleAccounting computeCycleAccounting(int                    npp,
+                                       int                    npme,
+                                       int                    nth_pp,
+                                       int                    nth_pme,
+                                       double                 realtime,
+                                       const gmx_wallcycle*   wc,
+                                       const WallcycleCounts& cyc_sum,
+                                       double                 tot)
+{
+    const int nth_tot = npp * nth_pp + npme * nth_pme;
+
+    CycleAccounting accounting;
+    /* Conversion factor from cycles to seconds */
+    accounting.c2t      = realtime / tot;
+    const double c2t_pp = accounting.c2t * nth_tot / static_cast<double>(npp * nth_pp);
+    const double c2t_pme =
+            (npme > 0) ? accounting.c2t * nth_tot / static_cast<double>(npme * nth_pme) : 0;
+
+    double                                    tot_for_pp = 0;
+    gmx::EnumerationWrapper<WallCycleCounter> iter;
+    for (auto key = gmx::EnumerationIterator<WallCycleCounter>(WallCycleCounter::Domdec);
+         key != iter.end();
+         ++key)
+    {
+        if (is_pme_subcounter(*key))
+        {
+            /* Do not count these at all */
+        }
+        else if (npme > 0 && is_pme_counter(*key))
+        {
+            /* Timing information for PME-only nodes, with an asterisk
+             * so the reader of the table can know that the walltimes
+             * are not meant to add up. The asterisk still fits in the
+             * required maximum of 19 characters. */
+            addCycleAccountingEntry(&accounting.counters,
+                                    gmx::formatString("%s *", enumValuetoString(*key)),
+                                    c2t_pme,
+                                    npme,
+                                    nth_pme,
+                                    wc->wcc[*key].n,
+                                    cyc_sum[static_cast<int>(*key)]);
+        }
+        else
+        {
+            /* Timing information for a PP or PP+PME node */
+            addCycleAccountingEntry(&accounting.counters,
+                                    enumValuetoString(*key),
+                                    c2t_pp,
+                                    npp,
+                                    nth_pp,
+                                    wc->wcc[*key].n,
+                                    cyc_sum[static_cast<int>(*key)]);
+            tot_for_pp += cyc_sum[static_cast<int>(*key)];
+        }
+    }
+    if (!wc->wcc_all.empty())
+    {
+        for (auto i : keysOf(wc->wcc))
+        {
+            const int countI = static_cast<int>(i);
+            for (auto j : keysOf(wc->wcc))
+            {
+                const int countJ = static_cast<int>(j);
+                const std::string name =
+                        gmx::formatString("%-9.9s %-9.9s", enumValuetoString(i), enumValuetoString(j));
+                addCycleAccountingEntry(&accounting.counters,
+                                        name,
+                                        c2t_pp,
+                                        npp,
+                                        nth_pp,
+                                        wc->wcc_all[countI * sc_numWallCycleCounters + countJ].n,
+                                        wc->wcc_all[countI * sc_numWallCycleCounters + countJ].c);
+            }
+        }
+    }
+    const double tot_for_rest = tot * npp * nth_pp / static_cast<double>(nth_tot);
+    addCycleAccountingEntry(
+            &accounting.counters, "Rest", c2t_pp, npp, nth_pp, -1, tot_for_rest - tot_for_pp);
+
+    if (wc->wcc[WallCycleCounter::PmeMesh].n > 0 || wc->wcc[WallCycleCounter::PmeGpuMesh].n > 0)
+    {
+        // A workaround to not give a breakdown when no subcounters were recorded.
+        // TODO: figure out and record PME GPU counters (what to do with the waiting ones?)
+        for (auto key = gmx::EnumerationIterator<WallCycleCounter>(WallCycleCounter::Domdec);
+             key != iter.end();
+             key++)
+        {
+            if (is_pme_subcounter(*key) && wc->wcc[*key].n > 0)
+            {
+                addCycleAccountingEntry(&accounting.pmeMeshCounters,
+                                        enumValuetoString(*key),
+                                        npme > 0 ? c2t_pme : c2t_pp,
+                                        npme > 0 ? npme : npp,
+                                        nth_pme,
+                                        wc->wcc[*key].n,
+                                        cyc_sum[static_cast<int>(*key)]);
+            }
+        }
+    }
+
+    // NOLINTNEXTLINE(readability-misleading-indentation)
+    if constexpr (sc_useCycleSubcounters)
+    {
+        for (auto key : keysOf(wc->wcsc))
+        {
+            addCycleAccountingEntry(&accounting.subCounters,
+                                    enumValuetoString(key),
+                                    c2t_pp,
+                                    npp,
+                                    nth_pp,
+                                    wc->wcsc[key].n,
+                                    cyc_sum[sc_numWallCycleCounters + static_cast<int>(key)]);
+        }
+    }
+
+    return accounting;
+}
+
+//! The time spent in one GPU task
+struct GpuTaskTiming
+{
+    //! The name of the task
+    std::string name;
+    //! The number of calls
+    int numCalls;
+    //! The total time in ms
+    double timeMs;
+};
+
+//! The GPU timings that are printed to the log file and added to the performance report
+struct GpuAccounting
+{
+    //! The tasks in the force overlap, in the order of the log file table
+    std::vector<GpuTaskTiming> tasks;
+    //! The total time of the tasks in ms
+    double totalTimeMs = 0;
+    //! The dynamic pruning, which is not in the force overlap
+    GpuTaskTiming dynamicPruning;
+    //! The CPU time in ms of the force and PME mesh work that overlaps with the GPU tasks
+    double cpuOverlapTimeMs = 0;
+};
+
+//! Returns the GPU timings of the run, \p gpu_pme_t is nullptr when PME did not run on a GPU
+GpuAccounting computeGpuAccounting(double                           realtime,
+                                   const gmx_wallcycle*             wc,
+                                   double                           tot,
+                                   const gmx_wallclock_gpu_nbnxn_t& gpu_nbnxn_t,
+                                   const gmx_wallclock_gpu_pme_t*   gpu_pme_t)
+{
+    const char* k_log_str[2][2] = { { "Nonbonded F kernel", "Nonbonded F+ene k." },
+                                    { "Nonbonded F+prune k.", "Nonbonded F+ene+prune k." } };
+
+    GpuAccounting accounting;
+    accounting.tasks.push_back({ "Pair list H2D", gpu_nbnxn_t.pl_h2d_c, gpu_nbnxn_t.pl_h2d_t });
+    accounting.tasks.push_back({ "X / q H2D", gpu_nbnxn_t.nb_c, gpu_nbnxn_t.nb_h2d_t });
+    accounting.totalTimeMs += gpu_nbnxn_t.pl_h2d_t + gpu_nbnxn_t.nb_h2d_t + gpu_nbnxn_t.nb_d2h_t;
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            if (gpu_nbnxn_t.ktime[i][j].c)
+            {
+                accounting.tasks.push_back(
+                        { k_log_str[i][j], gpu_nbnxn_t.ktime[i][j].c, gpu_nbnxn_t.ktime[i][j].t });
+            }
+            accounting.totalTimeMs += gpu_nbnxn_t.ktime[i][j].t;
+        }
+    }
+    if (gpu_pme_t)
+    {
+        for (auto key : keysOf(gpu_pme_t->timing))
+        {
+            if (gpu_pme_t->timing[key].c)
+            {
+                accounting.tasks.push_back({ enumValuetoString(key),
+                                             static_cast<int>(gpu_pme_t->timing[key].c),
+                                             gpu_pme_t->timing[key].t });
+            }
+            accounting.totalTimeMs += gpu_pme_t->timing[key].t;
+        }
+    }
+    if (gpu_nbnxn_t.pruneTime.c)
+    {
+        accounting.tasks.push_back(
+                { "Pruning kernel", gpu_nbnxn_t.pruneTime.c, gpu_nbnxn_t.pruneTime.t });
+    }
+    accounting.totalTimeMs += gpu_nbnxn_t.pruneTime.t;
+    accounting.tasks.push_back({ "F D2H", gpu_nbnxn_t.nb_c, gpu_nbnxn_t.nb_d2h_t });
+
+    accounting.dynamicPruning = { "*Dynamic pruning",
+                                  gpu_nbnxn_t.dynamicPruneTime.c,
+                                  gpu_nbnxn_t.dynamicPruneTime.t };
+
+    accounting.cpuOverlapTimeMs = wc->wcc[WallCycleCounter::Force].c;
+    if (wc->wcc[WallCycleCounter::PmeMesh].n > 0)
+    {
+        accounting.cpuOverlapTimeMs += wc->wcc[WallCycleCounter::PmeMesh].c;
+    }
+    accounting.cpuOverlapTimeMs *= realtime * 1000 / tot; /* convert s to ms */
+
+    return accounting;
+}
+
+//! Prints \p entries with print_cycles
+void printCycleAccountingEntries(FILE*                                    fplog,
+                                 const std::vector<CycleAccountingEntry>& entries,
+                                 double                                   tot)
+{
+    for (const CycleAccountingEntry& entry : entries)
+    {
+        print_cycles(fplog,
+                     entry.c2t,
+                     entry.name.c_str(),
+                     entry.numRanks,
+                     entry.numThreads,
+                     entry.numCalls,
+                     entry.cycles,
+                     tot);
+    }
+}
+
+} // namespace
+
 void wallcycle_print(FILE*                            fplog,
                      const gmx::MDLogger&             mdlog,
                      int                              nnodes,
@@ -649,10 +1012,8 @@ void wallcycle_print(FILE*                            fplog,
                      const gmx_wallclock_gpu_nbnxn_t* gpu_nbnxn_t,
                      const gmx_wallclock_gpu_pme_t*   gpu_pme_t)
 {
-    double      tot, tot_for_pp, tot_for_rest, tot_cpu_overlap, gpu_cpu_ratio;
-    double      c2t, c2t_pp, c2t_pme = 0;
-    int         npp, nth_tot;
-    char        buf[STRLEN];
+    double      tot;
+    int         npp;
     const char* hline =
             "--------------------------------------------------------------------------------";
 
@@ -669,13 +1030,10 @@ void wallcycle_print(FILE*                            fplog,
     /* npme is the number of PME-only ranks used, and we always do PP work */
     GMX_ASSERT(npp > 0, "Number of particle-particle nodes must be >0");
 
-    nth_tot = npp * nth_pp + npme * nth_pme;
-
     /* When using PME-only nodes, the next line is valid for both
        PP-only and PME-only nodes because they started ewcRUN at the
        same time. */
-    tot        = cyc_sum[static_cast<int>(WallCycleCounter::Run)];
-    tot_for_pp = 0;
+    tot = cyc_sum[static_cast<int>(WallCycleCounter::Run)];
 
     if (tot <= 0.0)
     {
@@ -706,89 +1064,17 @@ void wallcycle_print(FILE*                            fplog,
         return;
     }
 
-
-    /* Conversion factor from cycles to seconds */
-    c2t    = realtime / tot;
-    c2t_pp = c2t * nth_tot / static_cast<double>(npp * nth_pp);
-    if (npme > 0)
-    {
-        c2t_pme = c2t * nth_tot / static_cast<double>(npme * nth_pme);
-    }
-    else
-    {
-        c2t_pme = 0;
-    }
+    const CycleAccounting accounting =
+            computeCycleAccounting(npp, npme, nth_pp, nth_pme, realtime, wc, cyc_sum, tot);
 
     fprintf(fplog, "\n      R E A L   C Y C L E   A N D   T I M E   A C C O U N T I N G\n\n");
 
     print_header(fplog, npp, nth_pp, npme, nth_pme);
 
     fprintf(fplog, "%s\n", hline);
-    gmx::EnumerationWrapper<WallCycleCounter> iter;
-    for (auto key = gmx::EnumerationIterator<WallCycleCounter>(WallCycleCounter::Domdec);
-         key != iter.end();
-         ++key)
-    {
-
-        if (is_pme_subcounter(*key))
-        {
-            /* Do not count these at all */
-        }
-        else if (npme > 0 && is_pme_counter(*key))
-        {
-            /* Print timing information for PME-only nodes, but add an
-             * asterisk so the reader of the table can know that the
-             * walltimes are not meant to add up. The asterisk still
-             * fits in the required maximum of 19 characters. */
-            std::string message = gmx::formatString("%s *", enumValuetoString(*key));
-            print_cycles(fplog,
-                         c2t_pme,
-                         message.c_str(),
-                         npme,
-                         nth_pme,
-                         wc->wcc[*key].n,
-                         cyc_sum[static_cast<int>(*key)],
-                         tot);
-        }
-        else
-        {
-            /* Print timing information when it is for a PP or PP+PME
-               node */
-            print_cycles(fplog,
-                         c2t_pp,
-                         enumValuetoString(*key),
-                         npp,
-                         nth_pp,
-                         wc->wcc[*key].n,
-                         cyc_sum[static_cast<int>(*key)],
-                         tot);
-            tot_for_pp += cyc_sum[static_cast<int>(*key)];
-        }
-    }
-    if (!wc->wcc_all.empty())
-    {
-        for (auto i : keysOf(wc->wcc))
-        {
-            const int countI = static_cast<int>(i);
-            for (auto j : keysOf(wc->wcc))
-            {
-                const int countJ = static_cast<int>(j);
-                snprintf(buf, 20, "%-9.9s %-9.9s", enumValuetoString(i), enumValuetoString(j));
-                print_cycles(fplog,
-                             c2t_pp,
-                             buf,
-                             npp,
-                             nth_pp,
-                             wc->wcc_all[countI * sc_numWallCycleCounters + countJ].n,
-                             wc->wcc_all[countI * sc_numWallCycleCounters + countJ].c,
-                             tot);
-            }
-        }
-    }
-    tot_for_rest = tot * npp * nth_pp / static_cast<double>(nth_tot);
-    print_cycles(fplog, c2t_pp, "Rest", npp, nth_pp, -1, tot_for_rest - tot_for_pp, tot);
+    printCycleAccountingEntries(fplog, accounting.counters, tot);
     fprintf(fplog, "%s\n", hline);
-    print_cycles(fplog, c2t, "Total", npp, nth_pp, -1, tot, tot);
+    print_cycles(fplog, accounting.c2t, "Total", npp, nth_pp, -1, tot, tot);
     fprintf(fplog, "%s\n", hline);
 
     if (npme > 0)
@@ -800,38 +1086,12 @@ void wallcycle_print(FILE*                            fplog,
                 hline);
     }
 
-    if (wc->wcc[WallCycleCounter::PmeMesh].n > 0 || wc->wcc[WallCycleCounter::PmeGpuMesh].n > 0)
+    if (!accounting.pmeMeshCounters.empty())
     {
-        // A workaround to not print breakdown when no subcounters were recorded.
-        // TODO: figure out and record PME GPU counters (what to do with the waiting ones?)
-        std::vector<WallCycleCounter> validPmeSubcounterIndices;
-        for (auto key = gmx::EnumerationIterator<WallCycleCounter>(WallCycleCounter::Domdec);
-             key != iter.end();
-             key++)
-        {
-            if (is_pme_subcounter(*key) && wc->wcc[*key].n > 0)
-            {
-                validPmeSubcounterIndices.push_back(*key);
-            }
-        }
-
-        if (!validPmeSubcounterIndices.empty())
-        {
-            fprintf(fplog, " Breakdown of PME mesh activities\n");
-            fprintf(fplog, "%s\n", hline);
-            for (auto i : validPmeSubcounterIndices)
-            {
-                print_cycles(fplog,
-                             npme > 0 ? c2t_pme : c2t_pp,
-                             enumValuetoString(i),
-                             npme > 0 ? npme : npp,
-                             nth_pme,
-                             wc->wcc[i].n,
-                             cyc_sum[static_cast<int>(i)],
-                             tot);
-            }
-            fprintf(fplog, "%s\n", hline);
-        }
+        fprintf(fplog, " Breakdown of PME mesh activities\n");
+        fprintf(fplog, "%s\n", hline);
+        printCycleAccountingEntries(fplog, accounting.pmeMeshCounters, tot);
+        fprintf(fplog, "%s\n", hline);
     }
 
     // NOLINTNEXTLINE(readability-misleading-indentation)
@@ -839,117 +1099,50 @@ void wallcycle_print(FILE*                            fplog,
     {
         fprintf(fplog, " Breakdown of PP / PME activities\n");
         fprintf(fplog, "%s\n", hline);
-        for (auto key : keysOf(wc->wcsc))
-        {
-            print_cycles(fplog,
-                         c2t_pp,
-                         enumValuetoString(key),
-                         npp,
-                         nth_pp,
-                         wc->wcsc[key].n,
-                         cyc_sum[sc_numWallCycleCounters + static_cast<int>(key)],
-                         tot);
-        }
+        printCycleAccountingEntries(fplog, accounting.subCounters, tot);
         fprintf(fplog, "%s\n", hline);
     }
 
     /* print GPU timing summary */
-    double tot_gpu = 0.0;
-    if (gpu_pme_t)
-    {
-        for (auto key : keysOf(gpu_pme_t->timing))
-        {
-            tot_gpu += gpu_pme_t->timing[key].t;
-        }
-    }
     if (gpu_nbnxn_t)
     {
-        const char* k_log_str[2][2] = { { "Nonbonded F kernel", "Nonbonded F+ene k." },
-                                        { "Nonbonded F+prune k.", "Nonbonded F+ene+prune k." } };
-        tot_gpu += gpu_nbnxn_t->pl_h2d_t + gpu_nbnxn_t->nb_h2d_t + gpu_nbnxn_t->nb_d2h_t;
-
-        /* add up the kernel timings */
-        for (int i = 0; i < 2; i++)
-        {
-            for (int j = 0; j < 2; j++)
-            {
-                tot_gpu += gpu_nbnxn_t->ktime[i][j].t;
-            }
-        }
-        tot_gpu += gpu_nbnxn_t->pruneTime.t;
-
-        tot_cpu_overlap = wc->wcc[WallCycleCounter::Force].c;
-        if (wc->wcc[WallCycleCounter::PmeMesh].n > 0)
-        {
-            tot_cpu_overlap += wc->wcc[WallCycleCounter::PmeMesh].c;
-        }
-        tot_cpu_overlap *= realtime * 1000 / tot; /* convert s to ms */
+        const GpuAccounting gpuAccounting =
+                computeGpuAccounting(realtime, wc, tot, *gpu_nbnxn_t, gpu_pme_t);
+        const double tot_gpu = gpuAccounting.totalTimeMs;
 
         fprintf(fplog, "\n GPU timings\n%s\n", hline);
         fprintf(fplog,
                 " Computing:                         Count  Wall t (s)      ms/step       %c\n",
                 '%');
         fprintf(fplog, "%s\n", hline);
-        print_gputimes(fplog, "Pair list H2D", gpu_nbnxn_t->pl_h2d_c, gpu_nbnxn_t->pl_h2d_t, tot_gpu);
-        print_gputimes(fplog, "X / q H2D", gpu_nbnxn_t->nb_c, gpu_nbnxn_t->nb_h2d_t, tot_gpu);
-
-        for (int i = 0; i < 2; i++)
-        {
-            for (int j = 0; j < 2; j++)
-            {
-                if (gpu_nbnxn_t->ktime[i][j].c)
-                {
-                    print_gputimes(fplog,
-                                   k_log_str[i][j],
-                                   gpu_nbnxn_t->ktime[i][j].c,
-                                   gpu_nbnxn_t->ktime[i][j].t,
-                                   tot_gpu);
-                }
-            }
-        }
-        if (gpu_pme_t)
+        for (const GpuTaskTiming& task : gpuAccounting.tasks)
         {
-            for (auto key : keysOf(gpu_pme_t->timing))
-            {
-                if (gpu_pme_t->timing[key].c)
-                {
-                    print_gputimes(fplog,
-                                   enumValuetoString(key),
-                                   gpu_pme_t->timing[key].c,
-                                   gpu_pme_t->timing[key].t,
-                                   tot_gpu);
-                }
-            }
+            print_gputimes(fplog, task.name.c_str(), task.numCalls, task.timeMs, tot_gpu);
         }
-        if (gpu_nbnxn_t->pruneTime.c)
-        {
-            print_gputimes(fplog, "Pruning kernel", gpu_nbnxn_t->pruneTime.c, gpu_nbnxn_t->pruneTime.t, tot_gpu);
-        }
-        print_gputimes(fplog, "F D2H", gpu_nbnxn_t->nb_c, gpu_nbnxn_t->nb_d2h_t, tot_gpu);
         fprintf(fplog, "%s\n", hline);
         print_gputimes(fplog, "Total ", gpu_nbnxn_t->nb_c, tot_gpu, tot_gpu);
         fprintf(fplog, "%s\n", hline);
-        if (gpu_nbnxn_t->dynamicPruneTime.c)
+        if (gpuAccounting.dynamicPruning.numCalls)
         {
             /* We print the dynamic pruning kernel timings after a separator
              * and avoid adding it to tot_gpu as this is not in the force
              * overlap. We print the fraction as relative to the rest.
              */
             print_gputimes(fplog,
-                           "*Dynamic pruning",
-                           gpu_nbnxn_t->dynamicPruneTime.c,
-                           gpu_nbnxn_t->dynamicPruneTime.t,
+                           gpuAccounting.dynamicPruning.name.c_str(),
+                           gpuAccounting.dynamicPruning.numCalls,
+                           gpuAccounting.dynamicPruning.timeMs,
                            tot_gpu);
             fprintf(fplog, "%s\n", hline);
         }
-        gpu_cpu_ratio = tot_gpu / tot_cpu_overlap;
+        const double gpu_cpu_ratio = tot_gpu / gpuAccounting.cpuOverlapTimeMs;
         if (gpu_nbnxn_t->nb_c > 0 && wc->wcc[WallCycleCounter::Force].n > 0)
         {
             fprintf(fplog,
                     "\nAverage per-step force GPU/CPU evaluation time ratio: %.3f ms/%.3f ms = "
                     "%.3f\n",
                     tot_gpu / gpu_nbnxn_t->nb_c,
-                    tot_cpu_overlap / wc->wcc[WallCycleCounter::Force].n,
+                    gpuAccounting.cpuOverlapTimeMs / wc->wcc[WallCycleCounter::Force].n,
                     gpu_cpu_ratio);
         }
 
@@ -1055,6 +1248,197 @@ void wallcycle_print(FILE*                            fplog,
     }
 }
 
+//! Adds the accounting of \p entries to \p array
+static void report_cycles(gmx::KeyValueTreeObjectArrayBuilder*     array,
+                          const std::vector<CycleAccountingEntry>& entries,
+                          double                                   tot)
+{
+    for (const CycleAccountingEntry& entry : entries)
+    {
+        gmx::KeyValueTreeObjectBuilder counter = array->addObject();
+        counter.addValue<std::string>("name", entry.name);
+        counter.addValue<int>("ranks", entry.numRanks);
+        counter.addValue<int>("threads", entry.numThreads);
+        counter.addValue<int>("calls", entry.numCalls);
+        counter.addValue<double>("wall_time_s", entry.cycles * entry.c2t);
+        counter.addValue<double>("giga_cycles", entry.cycles * 1e-9);
+        counter.addValue<double>("percent", 100. * entry.cycles / tot);
+    }
+}
+
+/*! \brief Adds the per-rank times of the main counters in \p perRank to \p timing
+ *
+ * For each counter, the time of every rank is listed, together with
+ * statistics over the ranks that ran the counter, so slow ranks and
+ * nodes can be identified.
+ */
+static void report_cycles_per_rank(gmx::KeyValueTreeObjectBuilder* timing,
+                                   const WallcyclePerRank&         perRank)
+{
+    const int numRanks = perRank.nodeNames.size();
+
+    gmx::KeyValueTreeObjectArrayBuilder ranks = timing->addObjectArray("ranks");
+    for (int rank = 0; rank < numRanks; rank++)
+    {
+        gmx::KeyValueTreeObjectBuilder rankObject = ranks.addObject();
+        rankObject.addValue<int>("rank", rank);
+        rankObject.addValue<std::string>("node", perRank.nodeNames[rank]);
+        rankObject.addValue<std::string>("duty", perRank.isPmeOnlyRank[rank] ? "pme" : "pp");
+    }
+
+    gmx::KeyValueTreeObjectArrayBuilder counters = timing->addObjectArray("per_rank_counters");
+    for (auto key : gmx::EnumerationWrapper<WallCycleCounter>{})
+    {
+        if (is_pme_subcounter(key))
+        {
+            continue;
+        }
+
+        std::vector<double> times(numRanks);
+        std::vector<double> activeTimes;
+        int                 slowestRank = 0;
+        for (int rank = 0; rank < numRanks; rank++)
+        {
+            times[rank] = perRank.seconds[rank * sc_numWallCycleCounters + static_cast<int>(key)];
+            if (times[rank] > 0)
+            {
+                activeTimes.push_back(times[rank]);
+            }
+            if (times[rank] > times[slowestRank])
+            {
+                slowestRank = rank;
+            }
+        }
+        /* As in the log file, counters without time are skipped */
+        if (activeTimes.empty())
+        {
+            continue;
+        }
+        std::sort(activeTimes.begin(), activeTimes.end());
+        double sum = 0;
+        for (double time : activeTimes)
+        {
+            sum += time;
+        }
+        const auto percentile = [&activeTimes](int percent)
+        {
+            /* The nearest-rank percentile */
+            const int index = (percent * activeTimes.size() + 99) / 100 - 1;
+            return activeTimes[std::max(index, 0)];
+        };
+
+        gmx::KeyValueTreeObjectBuilder counter = counters.addObject();
+        counter.addValue<std::string>("name", enumValuetoString(key));
+        counter.addValue<int>("active_ranks", activeTimes.size());
+        counter.addValue<double>("min_s", activeTimes.front());
+        counter.addValue<double>("mean_s", sum / activeTimes.size());
+        counter.addValue<double>("median_s", percentile(50));
+        counter.addValue<double>("p90_s", percentile(90));
+        counter.addValue<double>("max_s", activeTimes.back());
+        counter.addValue<int>("max_rank", slowestRank);
+        gmx::KeyValueTreeUniformArrayBuilder<double> rankTimes =
+                counter.addUniformArray<double>("wall_time_s");
+        for (double time : times)
+        {
+            rankTimes.addValue(time);
+        }
+    }
+}
+
+//! Adds the GPU task timing \p task to \p timings
+static void report_gputimes(gmx::KeyValueTreeObjectArrayBuilder* timings, const GpuTaskTiming& task)
+{
+    gmx::KeyValueTreeObjectBuilder timing = timings->addObject();
+    timing.addValue<std::string>("name", task.name);
+    timing.addValue<int>("calls", task.numCalls);
+    timing.addValue<double>("time_ms", task.timeMs);
+}
+
+void wallcycle_report(gmx::PerformanceReport*          report,
+                      int                              nnodes,
+                      int                              npme,
+                      int                              nth_pp,
+                      int                              nth_pme,
+                      double                           realtime,
+                      gmx_wallcycle*                   wc,
+                      const WallcycleCounts&           cyc_sum,
+                      const WallcyclePerRank&          perRank,
+                      const gmx_wallclock_gpu_nbnxn_t* gpu_nbnxn_t,
+                      const gmx_wallclock_gpu_pme_t*   gpu_pme_t)
+{
+    if (report == nullptr || wc == nullptr)
+    {
+        return;
+    }
+
+    const int    npp = nnodes - npme;
+    const double tot = cyc_sum[static_cast<int>(WallCycleCounter::Run)];
+
+    gmx::KeyValueTreeObjectBuilder timing = report->section("timing");
+    timing.addValue<int>("pp_ranks", npp);
+    timing.addValue<int>("pp_threads_per_rank", nth_pp);
+    timing.addValue<int>("pme_ranks", npme);
+    timing.addValue<int>("pme_threads_per_rank", nth_pme);
+    timing.addValue<double>("wall_time_s", realtime);
+    timing.addValue<double>("giga_cycles", tot * 1e-9);
+    timing.addValue<bool>("mpi_barrier_before_counters", wc->wc_barrier);
+    /* Same conditions as for printing the cycle accounting */
+    const bool haveValidCounts = (tot > 0.0 && !wc->haveInvalidCount);
+    timing.addValue<bool>("valid", haveValidCounts);
+    if (!haveValidCounts)
+    {
+        return;
+    }
+
+    const CycleAccounting accounting =
+            computeCycleAccounting(npp, npme, nth_pp, nth_pme, realtime, wc, cyc_sum, tot);
+
+    gmx::KeyValueTreeObjectArrayBuilder counters = timing.addObjectArray("counters");
+    report_cycles(&counters, accounting.counters, tot);
+    gmx::KeyValueTreeObjectArrayBuilder pmeMeshCounters =
+            timing.addObjectArray("pme_mesh_counters");
+    report_cycles(&pmeMeshCounters, accounting.pmeMeshCounters, tot);
+    // NOLINTNEXTLINE(readability-misleading-indentation)
+    if constexpr (sc_useCycleSubcounters)
+    {
+        gmx::KeyValueTreeObjectArrayBuilder subCounters = timing.addObjectArray("subcounters");
+        report_cycles(&subCounters, accounting.subCounters, tot);
+    }
+    if (perRank.nodeNames.size() > 1)
+    {
+        report_cycles_per_rank(&timing, perRank);
+    }
+
+    /* As in the log file, there are only GPU timings with nonbonded tasks on a GPU */
+    if (gpu_nbnxn_t == nullptr)
+    {
+        return;
+    }
+    const GpuAccounting gpuAccounting =
+            computeGpuAccounting(realtime, wc, tot, *gpu_nbnxn_t, gpu_pme_t);
+
+    gmx::KeyValueTreeObjectBuilder      gpuTiming = report->section("gpu_timing");
+    gmx::KeyValueTreeObjectArrayBuilder tasks     = gpuTiming.addObjectArray("tasks");
+    for (const GpuTaskTiming& task : gpuAccounting.tasks)
+    {
+        report_gputimes(&tasks, task);
+    }
+    gpuTiming.addValue<double>("total_time_ms", gpuAccounting.totalTimeMs);
+    /* Not part of the total, as it is not in the force overlap */
+    gpuTiming.addValue<int>("dynamic_pruning_calls", gpuAccounting.dynamicPruning.numCalls);
+    gpuTiming.addValue<double>("dynamic_pruning_time_ms", gpuAccounting.dynamicPruning.timeMs);
+    if (gpu_nbnxn_t->nb_c > 0 && wc->wcc[WallCycleCounter::Force].n > 0)
+    {
+        const int numForceSteps = wc->wcc[WallCycleCounter::Force].n;
+        gpuTiming.addValue<double>("gpu_time_per_step_ms",
+                                   gpuAccounting.totalTimeMs / gpu_nbnxn_t->nb_c);
+        gpuTiming.addValue<double>("cpu_time_per_step_ms",
+                                   gpuAccounting.cpuOverlapTimeMs / numForceSteps);
+        gpuTiming.addValue<double>("gpu_cpu_ratio",
+                                   gpuAccounting.totalTimeMs / gpuAccounting.cpuOverlapTimeMs);
+    }
+}
+
 int64_t wcycle_get_reset_counters(gmx_wallcycle* wc)
 {
     if (wc == nullptr)
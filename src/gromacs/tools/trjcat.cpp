@@ -779,7 +779,9 @@ int gmx_trjcat(int argc, char* argv[])
                 }
                 lasttime    = fr.time;
                 lastTimeSet = TRUE;
-                fpos        = gmx_fio_ftell(stfio);
+                // Reading restarts read-ahead, so we need to get the handle again
+                stfio = trx_get_fileio(status);
+                fpos  = gmx_fio_ftell(stfio);
                 close_trx(status);
                 trxout = open_trx(out_file, "r+");
                 if (gmx_fio_seek(trx_get_fileio(trxout), fpos))
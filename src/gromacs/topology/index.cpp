@@ -728,11 +728,24 @@ std::vector<IndexGroup> init_index(const char* gfile)
             }
             GMX_RELEASE_ASSERT(atomListPtr != nullptr,
                                "Here we should have a valid atom list pointer");
-            char* pt = line;
-            while (sscanf(pt, "%s", str) == 1)
+            // Parse the whitespace separated numbers in place, as calling
+            // sscanf() and strstr() for every number is slow for large groups
+            const char* pt = line;
+            while (true)
             {
-                atomListPtr->push_back(strtol(str, nullptr, 10) - 1);
-                pt = strstr(pt, str) + strlen(str);
+                while (std::isspace(static_cast<unsigned char>(*pt)))
+                {
+                    pt++;
+                }
+                if (*pt == '\0')
+                {
+                    break;
+                }
+                atomListPtr->push_back(strtol(pt, nullptr, 10) - 1);
+                while (*pt != '\0' && !std::isspace(static_cast<unsigned char>(*pt)))
+                {
+                    pt++;
+                }
             }
         }
     }
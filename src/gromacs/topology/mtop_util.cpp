@@ -152,7 +152,19 @@ gmx::EnumerationArray<ParticleType, int> gmx_mtop_particletype_count(const gmx_m
     return count;
 }
 
-static void atomcat(t_atoms* dest, const t_atoms* src, int copies, int maxres_renum, int* maxresnr)
+/*! \brief Appends \p copies copies of \p src to \p dest
+ *
+ * The arrays of \p dest are allocated for at least \p atomCapacity atoms and
+ * \p residueCapacity residues, so that repeated calls for building a system
+ * of known size do not reallocate and copy the growing arrays each time.
+ */
+static void atomcat(t_atoms*       dest,
+                    const t_atoms* src,
+                    int            copies,
+                    int            maxres_renum,
+                    int*           maxresnr,
+                    int            atomCapacity,
+                    int            residueCapacity)
 {
     int i = 0, j = 0, l = 0, size = 0;
     int srcnr  = src->nr;
@@ -177,7 +189,7 @@ static void atomcat(t_atoms* dest, const t_atoms* src, int copies, int maxres_re
 
     if (srcnr)
     {
-        size = destnr + copies * srcnr;
+        size = std::max(destnr + copies * srcnr, atomCapacity);
         srenew(dest->atom, size);
         srenew(dest->atomname, size);
         if (dest->haveType)
@@ -195,7 +207,7 @@ static void atomcat(t_atoms* dest, const t_atoms* src, int copies, int maxres_re
     }
     if (src->nres)
     {
-        size = dest->nres + copies * src->nres;
+        size = std::max(dest->nres + copies * src->nres, residueCapacity);
         srenew(dest->resinfo, size);
     }
 
@@ -267,6 +279,12 @@ t_atoms gmx_mtop_global_atoms(const gmx_mtop_t& mtop)
 
     init_t_atoms(&atoms, 0, FALSE);
 
+    int numResidues = 0;
+    for (const gmx_molblock_t& molb : mtop.molblock)
+    {
+        numResidues += molb.nmol * mtop.moltype[molb.type].atoms.nres;
+    }
+
     int maxresnr = mtop.maxResNumberNotRenumbered();
     for (const gmx_molblock_t& molb : mtop.molblock)
     {
@@ -274,7 +292,9 @@ t_atoms gmx_mtop_global_atoms(const gmx_mtop_t& mtop)
                 &mtop.moltype[molb.type].atoms,
                 molb.nmol,
                 mtop.maxResiduesPerMoleculeToTriggerRenumber(),
-                &maxresnr);
+                &maxresnr,
+                mtop.natoms,
+                numResidues);
     }
 
     return atoms;
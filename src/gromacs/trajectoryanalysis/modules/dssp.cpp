@@ -520,6 +520,13 @@ public:
 private:
     //! Function that parses information from a frame to determine hydrogen bonds (via energy or geometry calculation) patterns.
     void analyzeHydrogenBondsInFrame(const t_trxframe& fr, const t_pbc* pbc, bool nBSmode, real cutoff);
+    /*! \brief
+     * Function that fills hydrogenPositions_ with the donor hydrogen position of each residue.
+     *
+     * In DSSP hydrogen mode the hydrogen is placed from the previous residue's C=O bond, so doing
+     * this once per residue avoids repeating it for every residue pair that is checked.
+     */
+    void calculateHydrogenPositions(const t_trxframe& fr, const t_pbc* pbc);
     /*! \brief
      * Function that provides a simple test if a h-bond exists within two residues of specific indices.
      */
@@ -572,7 +579,7 @@ private:
      * if R is in A
      * Hbond exists if E < -0.5
      */
-    void calculateHBondEnergy(ResInfo* Donor, ResInfo* Acceptor, const t_trxframe& fr, const t_pbc* pbc);
+    float calculateHBondEnergy(const ResInfo& Donor, const ResInfo& Acceptor, const t_trxframe& fr, const t_pbc* pbc) const;
     /*! \brief
      * Function that checks if H-Bond exist according to HBOND algorithm
      * H-Bond exists if distance between Donor and Acceptor
@@ -580,13 +587,38 @@ private:
      * and Hydrogen-Donor-Acceptor angle
      * α is < 30°.
      */
-    void calculateHBondGeometry(ResInfo* Donor, ResInfo* Acceptor, const t_trxframe& fr, const t_pbc* pbc);
+    bool calculateHBondGeometry(const ResInfo& Donor, const ResInfo& Acceptor, const t_trxframe& fr, const t_pbc* pbc) const;
+    //! A pair of residues that was found to contribute to the h-bond patterns by testHBond().
+    struct HBondCandidate
+    {
+        //! Index of the donor residue in frameVector_.
+        std::size_t donor;
+        //! Index of the acceptor residue in frameVector_.
+        std::size_t acceptor;
+        //! H-bond energy, only used with the energy definition.
+        float energy;
+    };
+    /*! \brief
+     * Function that tests residues Donor and Acceptor with the h-bond definition in use and adds
+     * them to candidates when they contribute to the h-bond patterns.
+     *
+     * Does not modify the residues, so it can be called for different residues in parallel.
+     */
+    void testHBond(std::size_t                  Donor,
+                   std::size_t                  Acceptor,
+                   const t_trxframe&            fr,
+                   const t_pbc*                 pbc,
+                   std::vector<HBondCandidate>* candidates) const;
+    //! Function that adds an h-bond found by testHBond() to its donor and acceptor residues.
+    void addHBond(const HBondCandidate& candidate);
     //! Vector that contains h-bond pattern information-manipulating class for each residue in selection.
     std::vector<SecondaryStructuresData> secondaryStructuresStatusVector_;
     //! Vector of ResInfo struct that contains all important information from topology about residues in the protein structure.
     std::vector<ResInfo> topologyVector_;
     //! Vector of ResInfo. Each new frame information from topologyVector_ is copied to frameVector_ to provide frame information independency.
     std::vector<ResInfo> frameVector_;
+    //! Vector of donor hydrogen positions in the current frame, indexed like frameVector_.
+    std::vector<gmx::RVec> hydrogenPositions_;
     //! String that contains result of dssp calculations for output.
     std::string secondaryStructuresStringLine_;
     //! Constant float value of h-bond energy. If h-bond energy within residues is smaller than that value, then h-bond exists.
@@ -676,83 +708,156 @@ bool SecondaryStructures::topologyIsIncorrect() const
     return (topologyVector_.empty());
 }
 
+void SecondaryStructures::calculateHydrogenPositions(const t_trxframe& fr, const t_pbc* pbc)
+{
+    hydrogenPositions_.assign(frameVector_.size(), { 0, 0, 0 });
+    for (std::size_t i = 0; i < frameVector_.size(); ++i)
+    {
+        const ResInfo& residue = frameVector_[i];
+        if (!residue.hasIndex(BackboneAtomTypes::AtomH))
+        {
+            continue;
+        }
+        hydrogenPositions_[i] = fr.x[residue.getIndex(BackboneAtomTypes::AtomH)];
+        if (hMode_ == HydrogenMode::Dssp && residue.prevResi_ != nullptr
+            && residue.prevResi_->getIndex(BackboneAtomTypes::AtomC)
+            && residue.prevResi_->getIndex(BackboneAtomTypes::AtomO))
+        {
+            gmx::RVec prevCO = fr.x[residue.prevResi_->getIndex(BackboneAtomTypes::AtomC)];
+            prevCO -= fr.x[residue.prevResi_->getIndex(BackboneAtomTypes::AtomO)];
+            float prevCODist =
+                    calculateAtomicDistances(residue.prevResi_->getIndex(BackboneAtomTypes::AtomC),
+                                             residue.prevResi_->getIndex(BackboneAtomTypes::AtomO),
+                                             fr,
+                                             pbc);
+            hydrogenPositions_[i] += prevCO / prevCODist;
+        }
+    }
+}
+
 void SecondaryStructures::analyzeHydrogenBondsInFrame(const t_trxframe& fr, const t_pbc* pbc, bool nBSmode, real cutoff)
 {
+    calculateHydrogenPositions(fr, pbc);
     if (nBSmode)
     {
         std::vector<gmx::RVec> positionsCA;
+        positionsCA.reserve(frameVector_.size());
         for (std::size_t i = 0; i < frameVector_.size(); ++i)
         {
             positionsCA.emplace_back(fr.x[frameVector_[i].getIndex(BackboneAtomTypes::AtomCA)]);
         }
         AnalysisNeighborhood nb;
         nb.setCutoff(cutoff);
-        AnalysisNeighborhoodPositions       nbPos(positionsCA);
-        gmx::AnalysisNeighborhoodSearch     start      = nb.initSearch(pbc, nbPos);
-        gmx::AnalysisNeighborhoodPairSearch pairSearch = start.startPairSearch(nbPos);
-        gmx::AnalysisNeighborhoodPair       pair;
-        ResInfo*                            donor;
-        ResInfo*                            acceptor;
-        while (pairSearch.findNextPair(&pair))
+        AnalysisNeighborhoodPositions   nbPos(positionsCA);
+        gmx::AnalysisNeighborhoodSearch start = nb.initSearch(pbc, nbPos);
+        // The residues are searched in parallel, with the h-bonds found stored per residue.
+        // These are then added in residue order, so the results do not depend on the threading.
+        const int                                numResidues = frameVector_.size();
+        std::vector<std::vector<HBondCandidate>> candidates(numResidues);
+#pragma omp parallel for schedule(dynamic, 16)
+        for (int acceptor = 0; acceptor < numResidues; ++acceptor)
         {
-            if (pair.refIndex() < pair.testIndex())
-            {
-                donor    = &frameVector_[pair.refIndex()];
-                acceptor = &frameVector_[pair.testIndex()];
-            }
-            else
-            {
-                continue;
-            }
-            switch (hbDef_)
+            try
             {
-                case HBondDefinition::Energy:
-                    calculateHBondEnergy(donor, acceptor, fr, pbc);
-                    if (acceptor->info_ != donor->nextResi_->info_)
+                gmx::AnalysisNeighborhoodPairSearch pairSearch =
+                        start.startPairSearch(positionsCA[acceptor].as_vec());
+                gmx::AnalysisNeighborhoodPair pair;
+                while (pairSearch.findNextPair(&pair))
+                {
+                    const std::size_t donor = pair.refIndex();
+                    if (donor >= static_cast<std::size_t>(acceptor))
                     {
-                        calculateHBondEnergy(acceptor, donor, fr, pbc);
+                        continue;
                     }
-                    break;
-                case HBondDefinition::Geometry:
-                    calculateHBondGeometry(donor, acceptor, fr, pbc);
-                    if (acceptor->info_ != donor->nextResi_->info_)
+                    testHBond(donor, acceptor, fr, pbc, &candidates[acceptor]);
+                    if (frameVector_[acceptor].info_ != frameVector_[donor].nextResi_->info_)
                     {
-                        calculateHBondGeometry(acceptor, donor, fr, pbc);
+                        testHBond(acceptor, donor, fr, pbc, &candidates[acceptor]);
                     }
-                    break;
-                default: continue;
+                }
+            }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
+        for (const auto& residueCandidates : candidates)
+        {
+            for (const HBondCandidate& candidate : residueCandidates)
+            {
+                addHBond(candidate);
             }
         }
     }
     else
     {
-        for (std::size_t donor = 0; donor + 1 < frameVector_.size(); ++donor)
+        // The donors are handled in parallel, with the h-bonds found stored per donor.
+        // These are then added in donor order, so the results do not depend on the threading.
+        const int                                numResidues = frameVector_.size();
+        std::vector<std::vector<HBondCandidate>> candidates(numResidues);
+#pragma omp parallel for schedule(dynamic, 16)
+        for (int donor = 0; donor < numResidues - 1; ++donor)
         {
-            for (std::size_t acceptor = donor + 1; acceptor < frameVector_.size(); ++acceptor)
+            try
             {
-                switch (hbDef_)
+                for (int acceptor = donor + 1; acceptor < numResidues; ++acceptor)
                 {
-                    case HBondDefinition::Energy:
-                        calculateHBondEnergy(&frameVector_[donor], &frameVector_[acceptor], fr, pbc);
-                        if (acceptor != donor + 1)
-                        {
-                            calculateHBondEnergy(&frameVector_[acceptor], &frameVector_[donor], fr, pbc);
-                        }
-                        break;
-                    case HBondDefinition::Geometry:
-                        calculateHBondGeometry(&frameVector_[donor], &frameVector_[acceptor], fr, pbc);
-                        if (acceptor != donor + 1)
-                        {
-                            calculateHBondGeometry(&frameVector_[acceptor], &frameVector_[donor], fr, pbc);
-                        }
-                        break;
-                    default: continue;
+                    testHBond(donor, acceptor, fr, pbc, &candidates[donor]);
+                    if (acceptor != donor + 1)
+                    {
+                        testHBond(acceptor, donor, fr, pbc, &candidates[donor]);
+                    }
                 }
             }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
+        for (const auto& residueCandidates : candidates)
+        {
+            for (const HBondCandidate& candidate : residueCandidates)
+            {
+                addHBond(candidate);
+            }
         }
     }
 }
 
+void SecondaryStructures::testHBond(std::size_t                  donor,
+                                    std::size_t                  acceptor,
+                                    const t_trxframe&            fr,
+                                    const t_pbc*                 pbc,
+                                    std::vector<HBondCandidate>* candidates) const
+{
+    const ResInfo& donorResidue    = frameVector_[donor];
+    const ResInfo& acceptorResidue = frameVector_[acceptor];
+    if (donorResidue.isProline_
+        || !(acceptorResidue.hasIndex(BackboneAtomTypes::AtomC)
+             && acceptorResidue.hasIndex(BackboneAtomTypes::AtomO)
+             && donorResidue.hasIndex(BackboneAtomTypes::AtomN)
+             && donorResidue.hasIndex(BackboneAtomTypes::AtomH)))
+    {
+        return;
+    }
+    switch (hbDef_)
+    {
+        case HBondDefinition::Energy:
+            // The energy is only computed for residues with close CA atoms
+            if (calculateAtomicDistances(donorResidue.getIndex(BackboneAtomTypes::AtomCA),
+                                         acceptorResidue.getIndex(BackboneAtomTypes::AtomCA),
+                                         fr,
+                                         pbc)
+                < minimalCAdistance_)
+            {
+                candidates->push_back(
+                        { donor, acceptor, calculateHBondEnergy(donorResidue, acceptorResidue, fr, pbc) });
+            }
+            break;
+        case HBondDefinition::Geometry:
+            if (calculateHBondGeometry(donorResidue, acceptorResidue, fr, pbc))
+            {
+                candidates->push_back({ donor, acceptor, 0 });
+            }
+            break;
+        default: break;
+    }
+}
+
 
 bool SecondaryStructures::hasHBondBetween(std::size_t donor, std::size_t acceptor) const
 {
@@ -1322,175 +1427,110 @@ void SecondaryStructures::calculateBends(const t_trxframe& fr, const t_pbc* pbc)
     }
 }
 
-void SecondaryStructures::calculateHBondEnergy(ResInfo*          donor,
-                                               ResInfo*          acceptor,
-                                               const t_trxframe& fr,
-                                               const t_pbc*      pbc)
+float SecondaryStructures::calculateHBondEnergy(const ResInfo&    donor,
+                                                const ResInfo&    acceptor,
+                                                const t_trxframe& fr,
+                                                const t_pbc*      pbc) const
 {
-    if (!(donor->isProline_)
-        && (acceptor->hasIndex(BackboneAtomTypes::AtomC) && acceptor->hasIndex(BackboneAtomTypes::AtomO)
-            && donor->hasIndex(BackboneAtomTypes::AtomN) && donor->hasIndex(BackboneAtomTypes::AtomH)))
+    gmx::RVec atomH      = hydrogenPositions_[&donor - frameVector_.data()];
+    float distanceNO = calculateAtomicDistances(
+            donor.getIndex(BackboneAtomTypes::AtomN), acceptor.getIndex(BackboneAtomTypes::AtomO), fr, pbc);
+    float distanceNC = calculateAtomicDistances(
+            donor.getIndex(BackboneAtomTypes::AtomN), acceptor.getIndex(BackboneAtomTypes::AtomC), fr, pbc);
+    float distanceHO =
+            calculateAtomicDistances(atomH.as_vec(), acceptor.getIndex(BackboneAtomTypes::AtomO), fr, pbc);
+    float distanceHC =
+            calculateAtomicDistances(atomH.as_vec(), acceptor.getIndex(BackboneAtomTypes::AtomC), fr, pbc);
+    // Values are taken from original DSSP algorithm, file Secondary.cpp from https://github.com/PDB-REDO/libcifpp/releases/tag/v3.0.0
+    const float minEnergy           = -9.9;
+    const float minimalAtomDistance = 0.5;
+    const float kCouplingConstant   = 27.888;
+    if ((distanceNO < minimalAtomDistance) || (distanceHC < minimalAtomDistance)
+        || (distanceHO < minimalAtomDistance) || (distanceNC < minimalAtomDistance))
     {
-        if (calculateAtomicDistances(donor->getIndex(BackboneAtomTypes::AtomCA),
-                                     acceptor->getIndex(BackboneAtomTypes::AtomCA),
-                                     fr,
-                                     pbc)
-            < minimalCAdistance_)
-        {
-            float distanceHO = 0;
-            float distanceHC = 0;
-            float distanceNO = calculateAtomicDistances(donor->getIndex(BackboneAtomTypes::AtomN),
-                                                        acceptor->getIndex(BackboneAtomTypes::AtomO),
-                                                        fr,
-                                                        pbc);
-            float distanceNC = calculateAtomicDistances(donor->getIndex(BackboneAtomTypes::AtomN),
-                                                        acceptor->getIndex(BackboneAtomTypes::AtomC),
-                                                        fr,
-                                                        pbc);
-            if (hMode_ == HydrogenMode::Dssp)
-            {
-                if (donor->prevResi_ != nullptr && donor->prevResi_->getIndex(BackboneAtomTypes::AtomC)
-                    && donor->prevResi_->getIndex(BackboneAtomTypes::AtomO))
-                {
-                    gmx::RVec atomH  = fr.x[donor->getIndex(BackboneAtomTypes::AtomH)];
-                    gmx::RVec prevCO = fr.x[donor->prevResi_->getIndex(BackboneAtomTypes::AtomC)];
-                    prevCO -= fr.x[donor->prevResi_->getIndex(BackboneAtomTypes::AtomO)];
-                    float prevCODist = calculateAtomicDistances(
-                            donor->prevResi_->getIndex(BackboneAtomTypes::AtomC),
-                            donor->prevResi_->getIndex(BackboneAtomTypes::AtomO),
-                            fr,
-                            pbc);
-                    atomH += prevCO / prevCODist;
-                    distanceHO = calculateAtomicDistances(
-                            atomH, acceptor->getIndex(BackboneAtomTypes::AtomO), fr, pbc);
-                    distanceHC = calculateAtomicDistances(
-                            atomH, acceptor->getIndex(BackboneAtomTypes::AtomC), fr, pbc);
-                }
-                else
-                {
-                    distanceHO = distanceNO;
-                    distanceHC = distanceNC;
-                }
-            }
-            else
-            {
-                distanceHO = calculateAtomicDistances(donor->getIndex(BackboneAtomTypes::AtomH),
-                                                      acceptor->getIndex(BackboneAtomTypes::AtomO),
-                                                      fr,
-                                                      pbc);
-                distanceHC = calculateAtomicDistances(donor->getIndex(BackboneAtomTypes::AtomH),
-                                                      acceptor->getIndex(BackboneAtomTypes::AtomC),
-                                                      fr,
-                                                      pbc);
-            }
-            // Values are taken from original DSSP algorithm, file Secondary.cpp from https://github.com/PDB-REDO/libcifpp/releases/tag/v3.0.0
-            float       HbondEnergy         = 0;
-            const float minEnergy           = -9.9;
-            const float minimalAtomDistance = 0.5;
-            const float kCouplingConstant   = 27.888;
-            if ((distanceNO < minimalAtomDistance) || (distanceHC < minimalAtomDistance)
-                || (distanceHO < minimalAtomDistance) || (distanceNC < minimalAtomDistance))
-            {
-                HbondEnergy = minEnergy;
-            }
-            else
-            {
-                HbondEnergy =
-                        kCouplingConstant
-                        * ((1 / distanceNO) + (1 / distanceHC) - (1 / distanceHO) - (1 / distanceNC));
-            }
-            if (HbondEnergy < donor->acceptorEnergy_[0])
-            {
-                donor->acceptor_[1]       = donor->acceptor_[0];
-                donor->acceptorEnergy_[1] = donor->acceptorEnergy_[0];
-                donor->acceptor_[0]       = acceptor->info_;
-                donor->acceptorEnergy_[0] = HbondEnergy;
-            }
-            else if (HbondEnergy < donor->acceptorEnergy_[1])
-            {
-                donor->acceptor_[1]       = acceptor->info_;
-                donor->acceptorEnergy_[1] = HbondEnergy;
-            }
-
-            if (HbondEnergy < acceptor->donorEnergy_[0])
-            {
-                acceptor->donor_[1]       = acceptor->donor_[0];
-                acceptor->donorEnergy_[1] = acceptor->donorEnergy_[0];
-                acceptor->donor_[0]       = donor->info_;
-                acceptor->donorEnergy_[0] = HbondEnergy;
-            }
-            else if (HbondEnergy < acceptor->donorEnergy_[1])
-            {
-                acceptor->donor_[1]       = donor->info_;
-                acceptor->donorEnergy_[1] = HbondEnergy;
-            }
-        }
+        return minEnergy;
     }
+    return kCouplingConstant * ((1 / distanceNO) + (1 / distanceHC) - (1 / distanceHO) - (1 / distanceNC));
 }
 
-void SecondaryStructures::calculateHBondGeometry(ResInfo*          donor,
-                                                 ResInfo*          acceptor,
+bool SecondaryStructures::calculateHBondGeometry(const ResInfo&    donor,
+                                                 const ResInfo&    acceptor,
                                                  const t_trxframe& fr,
-                                                 const t_pbc*      pbc)
+                                                 const t_pbc*      pbc) const
 {
-    if (!(donor->isProline_)
-        && (acceptor->hasIndex(BackboneAtomTypes::AtomC) && acceptor->hasIndex(BackboneAtomTypes::AtomO)
-            && donor->hasIndex(BackboneAtomTypes::AtomN) && donor->hasIndex(BackboneAtomTypes::AtomH)))
+    gmx::RVec vectorNO = { 0, 0, 0 };
+    pbc_dx(pbc,
+           fr.x[acceptor.getIndex(BackboneAtomTypes::AtomO)],
+           fr.x[donor.getIndex(BackboneAtomTypes::AtomN)],
+           vectorNO.as_vec());
+    // Value is taken from the HBOND algorithm.
+    const float c_rMaxDistanceNM_ = 0.35;
+    if (vectorNO.norm() > c_rMaxDistanceNM_)
     {
-        gmx::RVec vectorNO = { 0, 0, 0 };
-        pbc_dx(pbc,
-               fr.x[acceptor->getIndex(BackboneAtomTypes::AtomO)],
-               fr.x[donor->getIndex(BackboneAtomTypes::AtomN)],
-               vectorNO.as_vec());
-        // Value is taken from the HBOND algorithm.
-        const float c_rMaxDistanceNM_ = 0.35;
-        if (vectorNO.norm() <= c_rMaxDistanceNM_)
+        return false;
+    }
+    const gmx::RVec& vectorH  = hydrogenPositions_[&donor - frameVector_.data()];
+    gmx::RVec        vectorNH = { 0, 0, 0 };
+    pbc_dx(pbc, vectorH, fr.x[donor.getIndex(BackboneAtomTypes::AtomN)], vectorNH.as_vec());
+    // Values are taken from the HBOND algorithm.
+    const float c_angleMaxDegree_ = 30;
+    const float degree            = gmx_angle(vectorNO, vectorNH) * gmx::c_rad2Deg;
+    return degree <= c_angleMaxDegree_;
+}
+
+void SecondaryStructures::addHBond(const HBondCandidate& candidate)
+{
+    ResInfo* donor    = &frameVector_[candidate.donor];
+    ResInfo* acceptor = &frameVector_[candidate.acceptor];
+    if (hbDef_ == HBondDefinition::Energy)
+    {
+        const float HbondEnergy = candidate.energy;
+        if (HbondEnergy < donor->acceptorEnergy_[0])
         {
-            gmx::RVec vectorH = fr.x[donor->getIndex(BackboneAtomTypes::AtomH)];
-            if (hMode_ == HydrogenMode::Dssp)
-            {
-                if (donor->prevResi_ != nullptr && donor->prevResi_->getIndex(BackboneAtomTypes::AtomC)
-                    && donor->prevResi_->getIndex(BackboneAtomTypes::AtomO))
-                {
+            donor->acceptor_[1]       = donor->acceptor_[0];
+            donor->acceptorEnergy_[1] = donor->acceptorEnergy_[0];
+            donor->acceptor_[0]       = acceptor->info_;
+            donor->acceptorEnergy_[0] = HbondEnergy;
+        }
+        else if (HbondEnergy < donor->acceptorEnergy_[1])
+        {
+            donor->acceptor_[1]       = acceptor->info_;
+            donor->acceptorEnergy_[1] = HbondEnergy;
+        }
 
-                    gmx::RVec prevCO = fr.x[donor->prevResi_->getIndex(BackboneAtomTypes::AtomC)];
-                    prevCO -= fr.x[donor->prevResi_->getIndex(BackboneAtomTypes::AtomO)];
-                    float prevCODist = calculateAtomicDistances(
-                            donor->prevResi_->getIndex(BackboneAtomTypes::AtomC),
-                            donor->prevResi_->getIndex(BackboneAtomTypes::AtomO),
-                            fr,
-                            pbc);
-                    vectorH += prevCO / prevCODist;
-                }
-            }
-            gmx::RVec vectorNH = { 0, 0, 0 };
-            pbc_dx(pbc, vectorH, fr.x[donor->getIndex(BackboneAtomTypes::AtomN)], vectorNH.as_vec());
-            // Values are taken from the HBOND algorithm.
-            float       degree            = 0;
-            const float c_angleMaxDegree_ = 30;
-            degree                        = gmx_angle(vectorNO, vectorNH) * gmx::c_rad2Deg;
-            if (degree <= c_angleMaxDegree_)
-            {
-                if (donor->acceptor_[0] == nullptr)
-                {
-                    donor->acceptor_[0] = acceptor->info_;
-                }
-                else if (donor->acceptor_[1] == nullptr)
-                {
-                    donor->acceptor_[1] = donor->acceptor_[0];
-                    donor->acceptor_[0] = acceptor->info_;
-                }
+        if (HbondEnergy < acceptor->donorEnergy_[0])
+        {
+            acceptor->donor_[1]       = acceptor->donor_[0];
+            acceptor->donorEnergy_[1] = acceptor->donorEnergy_[0];
+            acceptor->donor_[0]       = donor->info_;
+            acceptor->donorEnergy_[0] = HbondEnergy;
+        }
+        else if (HbondEnergy < acceptor->donorEnergy_[1])
+        {
+            acceptor->donor_[1]       = donor->info_;
+            acceptor->donorEnergy_[1] = HbondEnergy;
+        }
+    }
+    else
+    {
+        if (donor->acceptor_[0] == nullptr)
+        {
+            donor->acceptor_[0] = acceptor->info_;
+        }
+        else if (donor->acceptor_[1] == nullptr)
+        {
+            donor->acceptor_[1] = donor->acceptor_[0];
+            donor->acceptor_[0] = acceptor->info_;
+        }
 
-                if (acceptor->donor_[0] == nullptr)
-                {
-                    acceptor->donor_[0] = donor->info_;
-                }
-                else if (acceptor->donor_[1] == nullptr)
-                {
-                    acceptor->donor_[1] = acceptor->donor_[0];
-                    acceptor->donor_[0] = donor->info_;
-                }
-            }
+        if (acceptor->donor_[0] == nullptr)
+        {
+            acceptor->donor_[0] = donor->info_;
+        }
+        else if (acceptor->donor_[1] == nullptr)
+        {
+            acceptor->donor_[1] = acceptor->donor_[0];
+            acceptor->donor_[0] = donor->info_;
         }
     }
 }
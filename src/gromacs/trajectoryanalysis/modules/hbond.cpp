@@ -127,6 +127,19 @@ HBond HBond::operator!() const
     return HBond(this->acceptor, this->donor, true);
 }
 
+//! A hydrogen bond of one donor, as found by the pair search in Hbond::analyzeFrame()
+struct DonorHBond
+{
+    //! Index of the acceptor in the acceptor list
+    int acceptorIndex;
+    //! Atom index of the hydrogen
+    int hydrogen;
+    //! Donor-acceptor distance
+    real distanceDA;
+    //! Hydrogen-donor-acceptor angle in degrees
+    float degree;
+};
+
 //! Structure that contains storage information from different frames.
 struct HbondStorageFrame
 {
@@ -274,6 +287,7 @@ private:
     const float        c_angleMaxDegree_ = 30;
     HbondStorage       storage_;
 
+    AnalysisNeighborhood                     nb_;
     AnalysisData                             hbnum_;
     AnalysisData                             distances_;
     AnalysisData                             angles_;
@@ -709,6 +723,7 @@ void Hbond::initAnalysis(const TrajectoryAnalysisSettings& settings, const Topol
         linkDA(&targetInfo_);
     }
 
+    nb_.setCutoff(cutoff_);
     prepareForAnalysis(settings);
 }
 
@@ -743,11 +758,9 @@ void Hbond::analyzeFrame(int frnr, const t_trxframe& fr, t_pbc* pbc, TrajectoryA
     }
 
 
-    std::vector<HBond>   daMap;
-    AnalysisNeighborhood nb;
-    nb.setCutoff(cutoff_);
-    const t_info* infoTool1 = &refInfo_;
-    const t_info* infoTool2;
+    std::vector<HBond> daMap;
+    const t_info*      infoTool1 = &refInfo_;
+    const t_info*      infoTool2;
     if (isTwoDiffGroups_)
     {
         infoTool2 = &targetInfo_;
@@ -767,71 +780,97 @@ void Hbond::analyzeFrame(int frnr, const t_trxframe& fr, t_pbc* pbc, TrajectoryA
         {
             positionsDonor.emplace_back(fr.x[donor.ai]);
         }
-        AnalysisNeighborhoodPositions       nbPos(positionsAcceptor);
-        gmx::AnalysisNeighborhoodSearch     start      = nb.initSearch(pbc, nbPos);
-        gmx::AnalysisNeighborhoodPairSearch pairSearch = start.startPairSearch(positionsDonor);
-        gmx::AnalysisNeighborhoodPair       pair;
-        while (pairSearch.findNextPair(&pair))
+        AnalysisNeighborhoodPositions   nbPos(positionsAcceptor);
+        gmx::AnalysisNeighborhoodSearch start = nb_.initSearch(pbc, nbPos);
+
+        /* The donors are searched in parallel, with the hydrogen bonds
+         * found stored per donor. These are then processed in donor order,
+         * so the results do not depend on the threading.
+         */
+        const t_info*                        acceptorInfo = infoTool1;
+        const t_info*                        donorInfo    = infoTool2;
+        const int                            numDonors    = donorInfo->donors.size();
+        std::vector<std::vector<DonorHBond>> donorHBonds(numDonors);
+#pragma omp parallel for schedule(dynamic, 16)
+        for (int donorIndex = 0; donorIndex < numDonors; donorIndex++)
         {
-            if (infoTool1->acceptors[pair.refIndex()].ai == infoTool2->donors[pair.testIndex()].ai)
-            {
-                continue;
-            }
-            t_acceptor acceptor = infoTool1->acceptors[pair.refIndex()];
-            t_donor    donor    = infoTool2->donors[pair.testIndex()];
-            gmx::RVec  vectorDA = { 0, 0, 0 };
-            pbc_dx(pbc, fr.x[acceptor.ai], fr.x[donor.ai], vectorDA.as_vec());
-            if (vectorDA.norm() > c_rMaxNM_)
+            try
             {
-                continue;
-            }
-            else
-            {
-                for (const auto hIndex : donor.h_atoms)
+                const t_donor& donor = donorInfo->donors[donorIndex];
+                gmx::AnalysisNeighborhoodPairSearch pairSearch =
+                        start.startPairSearch(positionsDonor[donorIndex].as_vec());
+                gmx::AnalysisNeighborhoodPair pair;
+                while (pairSearch.findNextPair(&pair))
                 {
-                    gmx::RVec vectorDH = { 0, 0, 0 };
-                    float     degree   = 0;
-                    pbc_dx(pbc, fr.x[hIndex], fr.x[donor.ai], vectorDH.as_vec());
-                    degree = gmx_angle(vectorDA, vectorDH) * gmx::c_rad2Deg;
-                    if (degree <= c_angleMaxDegree_)
+                    const t_acceptor& acceptor = acceptorInfo->acceptors[pair.refIndex()];
+                    if (acceptor.ai == donor.ai)
                     {
-                        if (!isTwoDiffGroups_ && (acceptor.isAlsoDonor && acceptor.ai < donor.ai)
-                            && mergeHydrogens_)
-                        {
-                            daMap.emplace_back(acceptor.ai, donor.ai, true);
-                        }
-                        else if (mergeHydrogens_)
-                        {
-                            daMap.emplace_back(donor.ai, acceptor.ai, acceptor.isAlsoDonor);
-                        }
-                        else
+                        continue;
+                    }
+                    gmx::RVec vectorDA = { 0, 0, 0 };
+                    pbc_dx(pbc, fr.x[acceptor.ai], fr.x[donor.ai], vectorDA.as_vec());
+                    const real distanceDA = vectorDA.norm();
+                    if (distanceDA > c_rMaxNM_)
+                    {
+                        continue;
+                    }
+                    for (const auto hIndex : donor.h_atoms)
+                    {
+                        gmx::RVec vectorDH = { 0, 0, 0 };
+                        pbc_dx(pbc, fr.x[hIndex], fr.x[donor.ai], vectorDH.as_vec());
+                        const float degree = gmx_angle(vectorDA, vectorDH) * gmx::c_rad2Deg;
+                        if (degree <= c_angleMaxDegree_)
                         {
-                            daMap.emplace_back(donor.ai, acceptor.ai, acceptor.isAlsoDonor, hIndex);
+                            donorHBonds[donorIndex].push_back(
+                                    { pair.refIndex(), hIndex, distanceDA, degree });
                         }
+                    }
+                }
+            }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
 
-                        if (!fnmHbdistOut_.empty())
-                        {
-                            dhDist.setPoint(distIterator++, vectorDA.norm());
-                        }
+        for (int donorIndex = 0; donorIndex < numDonors; donorIndex++)
+        {
+            const t_donor& donor = donorInfo->donors[donorIndex];
+            for (const DonorHBond& hbond : donorHBonds[donorIndex])
+            {
+                const t_acceptor& acceptor = acceptorInfo->acceptors[hbond.acceptorIndex];
+                if (!isTwoDiffGroups_ && (acceptor.isAlsoDonor && acceptor.ai < donor.ai)
+                    && mergeHydrogens_)
+                {
+                    daMap.emplace_back(acceptor.ai, donor.ai, true);
+                }
+                else if (mergeHydrogens_)
+                {
+                    daMap.emplace_back(donor.ai, acceptor.ai, acceptor.isAlsoDonor);
+                }
+                else
+                {
+                    daMap.emplace_back(donor.ai, acceptor.ai, acceptor.isAlsoDonor, hbond.hydrogen);
+                }
 
-                        if (!fnmHbangOut_.empty())
-                        {
-                            dhAng.setPoint(angleIterator++, degree);
-                        }
-                        if (!fnmHbdanOut_.empty())
-                        {
-                            if (!isTwoDiffGroups_ && (acceptor.isAlsoDonor && acceptor.ai < donor.ai)
-                                && mergeHydrogens_)
-                            {
-                                donors.insert(acceptor.ai);
-                                acceptors.insert(donor.ai);
-                            }
-                            else
-                            {
-                                donors.insert(donor.ai);
-                                acceptors.insert(acceptor.ai);
-                            }
-                        }
+                if (!fnmHbdistOut_.empty())
+                {
+                    dhDist.setPoint(distIterator++, hbond.distanceDA);
+                }
+
+                if (!fnmHbangOut_.empty())
+                {
+                    dhAng.setPoint(angleIterator++, hbond.degree);
+                }
+                if (!fnmHbdanOut_.empty())
+                {
+                    if (!isTwoDiffGroups_ && (acceptor.isAlsoDonor && acceptor.ai < donor.ai)
+                        && mergeHydrogens_)
+                    {
+                        donors.insert(acceptor.ai);
+                        acceptors.insert(donor.ai);
+                    }
+                    else
+                    {
+                        donors.insert(donor.ai);
+                        acceptors.insert(acceptor.ai);
                     }
                 }
             }
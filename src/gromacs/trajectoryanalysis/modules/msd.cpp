@@ -51,7 +51,6 @@
 #include <functional>
 #include <limits>
 #include <memory>
-#include <numeric>
 #include <optional>
 #include <string>
 #include <vector>
@@ -111,22 +110,37 @@ constexpr double c_1DdiffusionDimensionFactor = 2.0;
  * observations at formerly observed time differences are added to those columns. Separate time lags
  * will likely have differing total data points.
  *
+ * Only the running sum and the number of data points are stored per column, so the memory use
+ * does not grow with the number of time origins.
+ *
  * Data columns per tau are accessed via operator[], which always guarantees
  * a column is initialized and returns an MsdColumProxy to the column that can push data.
  */
 class MsdData
 {
 public:
-    //! Proxy to a MsdData tau column vector. Supports only push_back.
+    //! Accumulated data of one tau column.
+    struct MsdColumn
+    {
+        //! Sum of the added data points
+        double sum = 0.0;
+        //! Number of added data points
+        int64_t count = 0;
+    };
+    //! Proxy to a MsdData tau column. Supports only push_back.
     class MsdColumnProxy
     {
     public:
-        MsdColumnProxy(std::vector<double>* column) : column_(column) {}
+        MsdColumnProxy(MsdColumn* column) : column_(column) {}
 
-        void push_back(double value) { column_->push_back(value); }
+        void push_back(double value)
+        {
+            column_->sum += value;
+            column_->count++;
+        }
 
     private:
-        std::vector<double>* column_;
+        MsdColumn* column_;
     };
     //! Returns a proxy to the column for the given tau index. Guarantees that the column is initialized.
     MsdColumnProxy operator[](size_t index)
@@ -147,8 +161,8 @@ public:
     [[nodiscard]] std::vector<real> averageMsds() const;
 
 private:
-    //! Results - first indexed by tau, then data points
-    std::vector<std::vector<double>> msds_;
+    //! Results - indexed by tau
+    std::vector<MsdColumn> msds_;
 };
 
 
@@ -156,15 +170,14 @@ std::vector<real> MsdData::averageMsds() const
 {
     std::vector<real> msdSums;
     msdSums.reserve(msds_.size());
-    for (gmx::ArrayRef<const double> msdValues : msds_)
+    for (const MsdColumn& column : msds_)
     {
-        if (msdValues.empty())
+        if (column.count == 0)
         {
             msdSums.push_back(0.0);
             continue;
         }
-        msdSums.push_back(std::accumulate(msdValues.begin(), msdValues.end(), 0.0, std::plus<>())
-                          / msdValues.size());
+        msdSums.push_back(column.sum / column.count);
     }
     return msdSums;
 }
@@ -725,32 +738,50 @@ void Msd::analyzeFrame(int gmx_unused                frameNumber,
 
         ArrayRef<const RVec> coords = msdData.coordinateManager_.buildCoordinates(sel, pbc);
 
-        // For each preceding frame, calculate tau and do comparison.
-        for (size_t i = firstValidFrame_; i < msdData.frames.size(); i++)
+        // Preceding frames are stored in order of increasing time, so the frames that are too
+        // far back for the maximum tau are at the start.
+        while (firstValidFrame_ < msdData.frames.size()
+               && time - (t0_ + trestart_ * firstValidFrame_) > maxTau_)
         {
+            // The (now empty) entry is no longer needed, so over time the outer vector will
+            // grow with extraneous empty elements persisting, but the alternative would require
+            // some more complicated remapping of tau to frame index.
+            msdData.frames[firstValidFrame_].clear();
+            firstValidFrame_++;
+        }
 
-            const double tau = time - (t0_ + trestart_ * i);
-            if (tau > maxTau_)
+        // Compare with each preceding frame. The frames are handled in parallel, with the
+        // per-particle sums stored per frame. These are then added to the tau columns in frame
+        // order, so the results do not depend on the threading.
+        const size_t        firstFrame   = std::min(firstValidFrame_, msdData.frames.size());
+        const int           numFrames    = msdData.frames.size() - firstFrame;
+        const size_t        numMolecules = molecules_.size();
+        std::vector<double> frameMsds(numFrames);
+        std::vector<double> moleculeMsds(numFrames * numMolecules);
+#pragma omp parallel for schedule(dynamic)
+        for (int f = 0; f < numFrames; f++)
+        {
+            const std::vector<RVec>& frameCoords = msdData.frames[firstFrame + f];
+            frameMsds[f]                         = calcMsd_(coords, frameCoords);
+            for (size_t molInd = 0; molInd < numMolecules; molInd++)
             {
-                // The (now empty) entry is no longer needed, so over time the outer vector will
-                // grow with extraneous empty elements persisting, but the alternative would require
-                // some more complicated remapping of tau to frame index.
-                msdData.frames[i].clear();
-                firstValidFrame_ = i + 1;
-                continue;
+                moleculeMsds[f * numMolecules + molInd] =
+                        calcMsd_(arrayRefFromArray(&coords[molInd], 1),
+                                 arrayRefFromArray(&frameCoords[molInd], 1));
             }
-            int64_t tauIndex = gmx::roundToInt64(tau / *dt_);
-            msdData.msds[tauIndex].push_back(calcMsd_(coords, msdData.frames[i]));
-
-            for (size_t molInd = 0; molInd < molecules_.size(); molInd++)
+        }
+        for (int f = 0; f < numFrames; f++)
+        {
+            const double  tau      = time - (t0_ + trestart_ * (firstFrame + f));
+            const int64_t tauIndex = gmx::roundToInt64(tau / *dt_);
+            msdData.msds[tauIndex].push_back(frameMsds[f]);
+            for (size_t molInd = 0; molInd < numMolecules; molInd++)
             {
                 molecules_[molInd].msdData[tauIndex].push_back(
-                        calcMsd_(arrayRefFromArray(&coords[molInd], 1),
-                                 arrayRefFromArray(&msdData.frames[i][molInd], 1)));
+                        moleculeMsds[f * numMolecules + molInd]);
             }
         }
 
-
         // We only store the frame for the future if it's a restart per -trestart.
         if (bRmod(time, t0_, trestart_))
         {
@@ -49,11 +49,14 @@
 #include <algorithm>
 #include <iterator>
 #include <numeric>
+#include <vector>
 
 #include "gromacs/random/threefry.h"
 #include "gromacs/random/uniformintdistribution.h"
 #include "gromacs/topology/topology.h"
 #include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/gmxomp.h"
 
 namespace gmx
 {
@@ -135,30 +138,65 @@ double ComputeDebyeScattering::computeIntensityZeroQ()
     }
 }
 
+void ComputeDebyeScattering::setPositionScatteringLengths(const Selection& sel)
+{
+    const int    posCount = sel.posCount();
+    const size_t numQ     = sfDepenOnQ_ ? qValues_.size() : 1;
+    positionScatteringLengths_.resize(posCount * numQ);
+    for (int i = 0; i < posCount; ++i)
+    {
+        const int atomIndex = sel.position(i).atomIndices()[0];
+        for (size_t qi = 0; qi < numQ; ++qi)
+        {
+            positionScatteringLengths_[i * numQ + qi] =
+                    getScatteringLength(atomIndex, sfDepenOnQ_ ? qValues_[qi] : 0);
+        }
+    }
+}
+
 void ComputeDebyeScattering::computeDirectPairDistancesHistogram(t_pbc* pbc, Selection sel)
 {
-    const int posCount = sel.posCount();
-    for (auto i = 0; i < posCount; ++i)
+    setPositionScatteringLengths(sel);
+
+    /* The rows of the pair matrix are distributed round-robin over the
+     * threads, which balances the triangular loop. Each thread fills its
+     * own histogram. These are added in thread order, so the result does
+     * not depend on the scheduling.
+     */
+    const int                        posCount   = sel.posCount();
+    const int                        numThreads = gmx_omp_get_max_threads();
+    std::vector<std::vector<double>> threadHistograms(numThreads);
+#pragma omp parallel num_threads(numThreads)
     {
-        const SelectionPosition& pos_i = sel.position(i);
-        for (auto j = i + 1; j < posCount; ++j)
+        try
         {
-            PairDistValue            pairDist{};
-            const SelectionPosition& pos_j = sel.position(j);
-            pairDist.atomI                 = sel.position(i).atomIndices()[0];
-            pairDist.atomJ                 = sel.position(j).atomIndices()[0];
-            RVec distance_ij;
-            if (pbc != nullptr)
+            std::vector<double>& histogram = threadHistograms[gmx_omp_get_thread_num()];
+            histogram.assign(numHistValues(), 0);
+#pragma omp for schedule(static, 1)
+            for (int i = 0; i < posCount; ++i)
             {
-                pbc_dx(pbc, pos_i.x(), pos_j.x(), distance_ij);
-            }
-            else
-            {
-                rvec_sub(pos_i.x(), pos_j.x(), distance_ij);
+                const SelectionPosition& pos_i = sel.position(i);
+                for (int j = i + 1; j < posCount; ++j)
+                {
+                    const SelectionPosition& pos_j = sel.position(j);
+                    RVec                     distance_ij;
+                    if (pbc != nullptr)
+                    {
+                        pbc_dx(pbc, pos_i.x(), pos_j.x(), distance_ij);
+                    }
+                    else
+                    {
+                        rvec_sub(pos_i.x(), pos_j.x(), distance_ij);
+                    }
+                    addPairToHist(i, j, distance_ij.norm(), &histogram);
+                }
             }
-            pairDist.distanceIJ = distance_ij.norm();
-            addPairToHist(pairDist);
         }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
+    for (const std::vector<double>& histogram : threadHistograms)
+    {
+        addToHist(histogram);
     }
 }
 
@@ -167,22 +205,22 @@ void ComputeDebyeScattering::computeMonteCarloPairDistancesHistogram(t_pbc*    p
                                                                      float     coverage,
                                                                      int       seed)
 {
+    setPositionScatteringLengths(sel);
+
     const size_t                   posCount = sel.posCount();
     DefaultRandomEngine            rng(seed);
     UniformIntDistribution<size_t> distribution(0, posCount - 1);
     auto numPairs = static_cast<size_t>(coverage * posCount * (posCount - 1) * 0.5);
+    std::vector<double>            histogram(numHistValues(), 0);
     for (size_t pair = 0; pair < numPairs; ++pair)
     {
-        PairDistValue pairDist{};
-        size_t        rand_i = distribution(rng);
-        size_t        rand_j = distribution(rng);
+        size_t rand_i = distribution(rng);
+        size_t rand_j = distribution(rng);
         if (rand_i != rand_j)
         {
             const SelectionPosition& pos_i = sel.position(rand_i);
             const SelectionPosition& pos_j = sel.position(rand_j);
-            pairDist.atomI                 = sel.position(rand_i).atomIndices()[0];
-            pairDist.atomJ                 = sel.position(rand_j).atomIndices()[0];
-            RVec distance_ij;
+            RVec                     distance_ij;
             if (pbc != nullptr)
             {
                 pbc_dx(pbc, pos_i.x(), pos_j.x(), distance_ij);
@@ -191,10 +229,10 @@ void ComputeDebyeScattering::computeMonteCarloPairDistancesHistogram(t_pbc*    p
             {
                 rvec_sub(pos_i.x(), pos_j.x(), distance_ij);
             }
-            pairDist.distanceIJ = distance_ij.norm();
-            addPairToHist(pairDist);
+            addPairToHist(rand_i, rand_j, distance_ij.norm(), &histogram);
         }
     }
+    addToHist(histogram);
 }
 
 void ComputeDebyeScattering::clearHist()
@@ -212,19 +250,52 @@ void ComputeDebyeScattering::clearHist()
     }
 }
 
-void ComputeDebyeScattering::addPairToHist(PairDistValue pair)
+size_t ComputeDebyeScattering::numHistValues() const
+{
+    return (sfDepenOnQ_ ? qValues_.size() : 1) * maxHIndex_;
+}
+
+void ComputeDebyeScattering::addPairToHist(size_t               positionI,
+                                           size_t               positionJ,
+                                           float                distance,
+                                           std::vector<double>* histogram) const
+{
+    size_t hidx_ = std::floor(distance / binWidth_);
+    if (sfDepenOnQ_)
+    {
+        const size_t  numQ     = qValues_.size();
+        const double* lengthsI = positionScatteringLengths_.data() + positionI * numQ;
+        const double* lengthsJ = positionScatteringLengths_.data() + positionJ * numQ;
+        for (size_t i = 0; i != numQ; ++i)
+        {
+            (*histogram)[i * maxHIndex_ + hidx_] += lengthsI[i] * lengthsJ[i];
+        }
+    }
+    else
+    {
+        (*histogram)[hidx_] +=
+                positionScatteringLengths_[positionI] * positionScatteringLengths_[positionJ];
+    }
+}
+
+void ComputeDebyeScattering::addToHist(const std::vector<double>& histogram)
 {
-    size_t hidx_ = std::floor(pair.distanceIJ / binWidth_);
     if (sfDepenOnQ_)
     {
         for (size_t i = 0; i != qValues_.size(); ++i)
         {
-            sfQDependDistValues_[i][hidx_] += getFormFactor(pair.atomI, pair.atomJ, qValues_[i]);
+            for (size_t h = 0; h != maxHIndex_; ++h)
+            {
+                sfQDependDistValues_[i][h] += histogram[i * maxHIndex_ + h];
+            }
         }
     }
     else
     {
-        sfDistValues_[hidx_] += getFormFactor(pair.atomI, pair.atomJ, 0);
+        for (size_t h = 0; h != maxHIndex_; ++h)
+        {
+            sfDistValues_[h] += histogram[h];
+        }
     }
 }
 
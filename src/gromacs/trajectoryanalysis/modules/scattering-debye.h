@@ -60,19 +60,6 @@
 namespace gmx
 {
 
-/*! \internal \brief
- * structure to store pair dist units
- */
-struct PairDistValue
-{
-    //! index of atom i
-    std::size_t atomI;
-    //! index of atom j
-    std::size_t atomJ;
-    //! distance between atoms i and j
-    float distanceIJ;
-};
-
 /*! \internal \brief
  * Base class for computing SANS and SAXS using Debye Method
  *
@@ -138,8 +125,26 @@ private:
     std::vector<double> sfDistValues_;
     //! List of sf*distance values in hist in case of SAXS when SF depend on Q
     std::vector<std::vector<double>> sfQDependDistValues_;
-    //! add atom pair for histogram
-    void addPairToHist(PairDistValue pair);
+    /*! \brief Scattering lengths of the selection positions
+     *
+     * Stored per position for all q values when these depend on q,
+     * so the pair loops do not need to look them up per pair.
+     */
+    std::vector<double> positionScatteringLengths_;
+    //! Sets positionScatteringLengths_ for the positions in \p sel
+    void setPositionScatteringLengths(const Selection& sel);
+    /*! \brief Returns the number of values in a histogram for addPairToHist()
+     *
+     * The values for all q are stored consecutively per q value.
+     */
+    size_t numHistValues() const;
+    //! Adds the pair of selection positions \p positionI and \p positionJ to \p histogram
+    void addPairToHist(size_t               positionI,
+                       size_t               positionJ,
+                       float                distance,
+                       std::vector<double>* histogram) const;
+    //! Adds \p histogram, filled by addPairToHist(), to the pair distance histogram
+    void addToHist(const std::vector<double>& histogram);
 
 protected:
     //! set if structure factor depend on Q value (e.g. for SAXS)
@@ -39,6 +39,7 @@
 #include <cstdio>
 
 #include <algorithm>
+#include <numeric>
 #include <vector>
 
 #include "gromacs/math/functions.h"
@@ -47,6 +48,7 @@
 #include "gromacs/pbcutil/pbc.h"
 #include "gromacs/selection/nbsearch.h"
 #include "gromacs/utility/basedefinitions.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
 #include "gromacs/utility/smalloc.h"
@@ -769,90 +771,114 @@ static void nsc_dclm_pbc(const rvec*                 coords,
     pos.indexed(constArrayRefFromArray(index, nat));
     AnalysisNeighborhoodSearch nbsearch(nb->initSearch(pbc, pos));
 
-    std::vector<int> wkdot(n_dot);
-
-    for (int i = 0; i < nat; ++i)
+    /* The atoms are processed in parallel, with the results stored per
+     * atom. These are then combined in atom order, so the results do not
+     * depend on the threading.
+     */
+    std::vector<real>             atomAreas(nat);
+    std::vector<real>             atomVolumes((mode & FLAG_VOLUME) ? nat : 0);
+    std::vector<std::vector<int>> atomFreeDots((mode & FLAG_DOTS) ? nat : 0);
+#pragma omp parallel
     {
-        const int                      iat  = index[i];
-        const real                     ai   = radius[iat];
-        const real                     aisq = ai * ai;
-        AnalysisNeighborhoodPairSearch pairSearch(nbsearch.startPairSearch(coords[iat]));
-        AnalysisNeighborhoodPair       pair;
-        std::fill(wkdot.begin(), wkdot.end(), 1);
-        int currDotCount = n_dot;
-        while (currDotCount > 0 && pairSearch.findNextPair(&pair))
+        try
         {
-            const int  jat = index[pair.refIndex()];
-            const real aj  = radius[jat];
-            const real d2  = pair.distance2();
-            if (iat == jat || d2 > gmx::square(ai + aj))
-            {
-                continue;
-            }
-            const rvec& dx     = pair.dx();
-            const real  refdot = (d2 + aisq - aj * aj) / (2 * ai);
-            // TODO: Consider whether micro-optimizations from the old
-            // implementation would be useful, compared to the complexity that
-            // they bring: instead of this direct loop, the neighbors were
-            // stored into a temporary array, the loop order was
-            // reversed (first over dots, then over neighbors), and for each
-            // dot, it was first checked whether the same neighbor that
-            // resulted in marking the previous dot covered would also cover
-            // this dot. This presumably plays together with sorting of the
-            // surface dots (done in make_unsp) to avoid some of the looping.
-            // Alternatively, we could keep a skip list here to avoid
-            // repeatedly looping over dots that have already marked as
-            // covered.
-            for (int j = 0; j < n_dot; ++j)
+            // Indices of the surface dots of the current atom that are not yet
+            // covered by any neighbor, in increasing order. Covered dots are removed
+            // from the list, so that later neighbors only loop over the remaining ones.
+            std::vector<int> freeDots(n_dot);
+
+#pragma omp for schedule(dynamic, 32)
+            for (int i = 0; i < nat; ++i)
             {
-                if (wkdot[j] && iprod(&xus[3 * j], dx) > refdot)
+                const int                      iat  = index[i];
+                const real                     ai   = radius[iat];
+                const real                     aisq = ai * ai;
+                AnalysisNeighborhoodPairSearch pairSearch(nbsearch.startPairSearch(coords[iat]));
+                AnalysisNeighborhoodPair       pair;
+                std::iota(freeDots.begin(), freeDots.end(), 0);
+                int currDotCount = n_dot;
+                while (currDotCount > 0 && pairSearch.findNextPair(&pair))
+                {
+                    const int  jat = index[pair.refIndex()];
+                    const real aj  = radius[jat];
+                    const real d2  = pair.distance2();
+                    if (iat == jat || d2 > gmx::square(ai + aj))
+                    {
+                        continue;
+                    }
+                    const rvec& dx     = pair.dx();
+                    const real  refdot = (d2 + aisq - aj * aj) / (2 * ai);
+                    // TODO: Consider whether micro-optimizations from the old
+                    // implementation would be useful, compared to the complexity that
+                    // they bring: the loop order was reversed (first over dots, then
+                    // over neighbors), and for each dot, it was first checked whether
+                    // the same neighbor that resulted in marking the previous dot
+                    // covered would also cover this dot. This presumably plays
+                    // together with sorting of the surface dots (done in make_unsp)
+                    // to avoid some of the looping.
+                    int newDotCount = 0;
+                    for (int k = 0; k < currDotCount; ++k)
+                    {
+                        const int j = freeDots[k];
+                        if (iprod(&xus[3 * j], dx) <= refdot)
+                        {
+                            freeDots[newDotCount++] = j;
+                        }
+                    }
+                    currDotCount = newDotCount;
+                }
+
+                atomAreas[i] = aisq * dotarea * currDotCount;
+                if (mode & FLAG_DOTS)
                 {
-                    --currDotCount;
-                    wkdot[j] = 0;
+                    atomFreeDots[i].assign(freeDots.begin(), freeDots.begin() + currDotCount);
+                }
+                if (mode & FLAG_VOLUME)
+                {
+                    real dx = 0.0, dy = 0.0, dz = 0.0;
+                    for (int k = 0; k < currDotCount; k++)
+                    {
+                        const int l = freeDots[k];
+                        dx          = dx + xus[3 * l];
+                        dy          = dy + xus[1 + 3 * l];
+                        dz          = dz + xus[2 + 3 * l];
+                    }
+                    atomVolumes[i] = aisq
+                                     * (dx * (coords[iat][XX] - xs) + dy * (coords[iat][YY] - ys)
+                                        + dz * (coords[iat][ZZ] - zs) + ai * currDotCount);
                 }
             }
         }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
 
-        const real a = aisq * dotarea * currDotCount;
-        area         = area + a;
+    for (int i = 0; i < nat; ++i)
+    {
+        area = area + atomAreas[i];
         if (mode & FLAG_ATOM_AREA)
         {
-            atom_area[i] = a;
+            atom_area[i] = atomAreas[i];
         }
-        const real xi = coords[iat][XX];
-        const real yi = coords[iat][YY];
-        const real zi = coords[iat][ZZ];
         if (mode & FLAG_DOTS)
         {
-            for (int l = 0; l < n_dot; l++)
+            const int  iat = index[i];
+            const real ai  = radius[iat];
+            for (const int l : atomFreeDots[i])
             {
-                if (wkdot[l])
+                lfnr++;
+                if (maxdots <= 3 * lfnr + 1)
                 {
-                    lfnr++;
-                    if (maxdots <= 3 * lfnr + 1)
-                    {
-                        maxdots = maxdots + n_dot * 3;
-                        srenew(dots, maxdots);
-                    }
-                    dots[3 * lfnr - 3] = ai * xus[3 * l] + xi;
-                    dots[3 * lfnr - 2] = ai * xus[1 + 3 * l] + yi;
-                    dots[3 * lfnr - 1] = ai * xus[2 + 3 * l] + zi;
+                    maxdots = maxdots + n_dot * 3;
+                    srenew(dots, maxdots);
                 }
+                dots[3 * lfnr - 3] = ai * xus[3 * l] + coords[iat][XX];
+                dots[3 * lfnr - 2] = ai * xus[1 + 3 * l] + coords[iat][YY];
+                dots[3 * lfnr - 1] = ai * xus[2 + 3 * l] + coords[iat][ZZ];
             }
         }
         if (mode & FLAG_VOLUME)
         {
-            real dx = 0.0, dy = 0.0, dz = 0.0;
-            for (int l = 0; l < n_dot; l++)
-            {
-                if (wkdot[l])
-                {
-                    dx = dx + xus[3 * l];
-                    dy = dy + xus[1 + 3 * l];
-                    dz = dz + xus[2 + 3 * l];
-                }
-            }
-            vol = vol + aisq * (dx * (xi - xs) + dy * (yi - ys) + dz * (zi - zs) + ai * currDotCount);
+            vol = vol + atomVolumes[i];
         }
     }
 
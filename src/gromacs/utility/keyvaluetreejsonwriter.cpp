@@ -0,0 +1,205 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Defines a function to write a key-value tree as JSON.
+ *
+ * \ingroup module_utility
+ */
+#include "gmxpre.h"
+
+#include "gromacs/utility/keyvaluetreejsonwriter.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+
+#include <string>
+
+#include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/keyvaluetree.h"
+#include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/textwriter.h"
+
+namespace gmx
+{
+
+namespace
+{
+
+//! Returns \p str as a quoted JSON string
+std::string quotedJsonString(const std::string& str)
+{
+    std::string result = "\"";
+    for (const char c : str)
+    {
+        switch (c)
+        {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    result += formatString("\\u%04x", static_cast<unsigned int>(c));
+                }
+                else
+                {
+                    result += c;
+                }
+        }
+    }
+    return result + "\"";
+}
+
+//! Returns \p value as JSON number, or null when not finite
+std::string jsonNumber(double value, const char* format)
+{
+    return std::isfinite(value) ? formatString(format, value) : std::string("null");
+}
+
+/*! \internal
+ * \brief Writes key-value tree values as JSON, with nested values indented
+ */
+class JsonWriter
+{
+public:
+    //! Creates a writer that writes to \p writer
+    explicit JsonWriter(TextWriter* writer) : writer_(writer) {}
+
+    //! Writes \p object, with its closing brace indented by \p indentation spaces
+    void writeObject(const KeyValueTreeObject& object, int indentation)
+    {
+        if (object.properties().empty())
+        {
+            writer_->writeString("{}");
+            return;
+        }
+        writer_->writeLine("{");
+        bool first = true;
+        for (const auto& prop : object.properties())
+        {
+            if (!first)
+            {
+                writer_->writeLine(",");
+            }
+            writer_->writeString(std::string(indentation + 2, ' '));
+            writer_->writeString(quotedJsonString(prop.key()) + ": ");
+            writeValue(prop.value(), indentation + 2);
+            first = false;
+        }
+        writer_->writeLine();
+        writer_->writeString(std::string(indentation, ' ') + "}");
+    }
+
+private:
+    //! Writes \p array, with its closing bracket indented by \p indentation spaces
+    void writeArray(const KeyValueTreeArray& array, int indentation)
+    {
+        if (array.values().empty())
+        {
+            writer_->writeString("[]");
+            return;
+        }
+        writer_->writeLine("[");
+        bool first = true;
+        for (const auto& value : array.values())
+        {
+            if (!first)
+            {
+                writer_->writeLine(",");
+            }
+            writer_->writeString(std::string(indentation + 2, ' '));
+            writeValue(value, indentation + 2);
+            first = false;
+        }
+        writer_->writeLine();
+        writer_->writeString(std::string(indentation, ' ') + "]");
+    }
+
+    //! Writes \p value, nested at \p indentation spaces
+    void writeValue(const KeyValueTreeValue& value, int indentation)
+    {
+        if (value.isObject())
+        {
+            writeObject(value.asObject(), indentation);
+        }
+        else if (value.isArray())
+        {
+            writeArray(value.asArray(), indentation);
+        }
+        else if (value.isType<bool>())
+        {
+            writer_->writeString(value.cast<bool>() ? "true" : "false");
+        }
+        else if (value.isType<int>())
+        {
+            writer_->writeString(formatString("%d", value.cast<int>()));
+        }
+        else if (value.isType<int64_t>())
+        {
+            writer_->writeString(formatString("%" PRId64, value.cast<int64_t>()));
+        }
+        else if (value.isType<float>())
+        {
+            writer_->writeString(jsonNumber(value.cast<float>(), "%.7g"));
+        }
+        else if (value.isType<double>())
+        {
+            writer_->writeString(jsonNumber(value.cast<double>(), "%.15g"));
+        }
+        else if (value.isType<std::string>())
+        {
+            writer_->writeString(quotedJsonString(value.cast<std::string>()));
+        }
+        else
+        {
+            GMX_THROW(NotImplementedError("Unsupported value type in JSON output"));
+        }
+    }
+
+    //! The writer the JSON is written to
+    TextWriter* writer_;
+};
+
+} // namespace
+
+void writeKeyValueTreeAsJson(TextWriter* writer, const KeyValueTreeObject& tree)
+{
+    JsonWriter(writer).writeObject(tree, 0);
+    writer->writeLine();
+}
+
+} // namespace gmx
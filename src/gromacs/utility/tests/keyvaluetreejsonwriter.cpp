@@ -0,0 +1,114 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for writing key-value trees as JSON.
+ *
+ * \ingroup module_utility
+ */
+#include "gmxpre.h"
+
+#include "gromacs/utility/keyvaluetreejsonwriter.h"
+
+#include <cstdint>
+
+#include <limits>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/utility/keyvaluetree.h"
+#include "gromacs/utility/keyvaluetreebuilder.h"
+#include "gromacs/utility/stringstream.h"
+#include "gromacs/utility/textwriter.h"
+
+#include "testutils/stringtest.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+class KeyValueTreeJsonWriterTest : public gmx::test::StringTestBase
+{
+public:
+    void checkOutput(const KeyValueTreeObject& tree)
+    {
+        StringOutputStream stream;
+        TextWriter         writer(&stream);
+        writeKeyValueTreeAsJson(&writer, tree);
+        checkText(stream.toString(), "Output");
+    }
+};
+
+TEST_F(KeyValueTreeJsonWriterTest, WritesEmptyObject)
+{
+    KeyValueTreeBuilder builder;
+    checkOutput(builder.build());
+}
+
+TEST_F(KeyValueTreeJsonWriterTest, WritesSimpleValues)
+{
+    KeyValueTreeBuilder builder;
+    auto                root = builder.rootObject();
+    root.addValue<bool>("bool", true);
+    root.addValue<int>("int", -3);
+    root.addValue<int64_t>("int64", 12345678901234);
+    root.addValue<float>("float", 1.5F);
+    root.addValue<double>("double", 0.125);
+    root.addValue<double>("nan", std::numeric_limits<double>::quiet_NaN());
+    root.addValue<std::string>("string", "quote \" backslash \\ newline \n");
+    checkOutput(builder.build());
+}
+
+TEST_F(KeyValueTreeJsonWriterTest, WritesNestedValues)
+{
+    KeyValueTreeBuilder builder;
+    auto                root   = builder.rootObject();
+    auto                object = root.addObject("object");
+    object.addValue<int>("a", 1);
+    object.addObject("empty");
+    root.addUniformArray<int>("array", { 1, 2, 3 });
+    root.addUniformArray<int>("emptyArray");
+    auto objects = root.addObjectArray("objects");
+    objects.addObject().addValue<std::string>("name", "first");
+    objects.addObject().addValue<std::string>("name", "second");
+    checkOutput(builder.build());
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
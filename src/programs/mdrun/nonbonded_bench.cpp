@@ -56,6 +56,7 @@
 #include "gromacs/utility/arrayref.h"
 #include "gromacs/utility/arraysize.h"
 #include "gromacs/utility/enumerationhelpers.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/real.h"
 
 namespace gmx
@@ -117,6 +118,19 @@ void NonbondedBenchmark::initOptions(IOptionsContainer* options, ICommandLineOpt
         "Thread affinity is important, especially with SMT and shared",
         "caches. Affinities can be set through the OpenMP library using",
         "the GOMP_CPU_AFFINITY environment variable.[PAR]",
+        "To assess the throughput of a node running multiple independent",
+        "simulations, the [TT]-ninst[tt] option runs the given number of",
+        "instances of each benchmark concurrently, each with its own copy",
+        "of the system and [TT]-nt[tt] OpenMP threads. The timed iterations",
+        "start simultaneously on all instances. The tool reports the time",
+        "per iteration and the pair throughput for each instance, and the",
+        "aggregate throughput of all instances. With [TT]-pin[tt], OpenMP",
+        "thread t of instance i is pinned to logical core",
+        "[TT]-pinoffset[tt] + (i * [TT]-nt[tt] + t) * [TT]-pinstride[tt],",
+        "so instances use consecutive, non-overlapping sets of cores.",
+        "Without [TT]-pin[tt], use e.g. [TT]taskset[tt] to restrict the",
+        "process to the cores of interest. No csv output is written in",
+        "this mode.[PAR]",
         "The benchmark tool times one or more kernels by running them",
         "repeatedly for a number of iterations set by the [TT]-iter[tt]",
         "option. An initial kernel call is done to avoid additional initial",
@@ -175,6 +189,20 @@ void NonbondedBenchmark::initOptions(IOptionsContainer* options, ICommandLineOpt
             IntegerOption("size").store(&sizeFactor_).description("The system size is 3000 atoms times this value"));
     options->addOption(
             IntegerOption("nt").store(&benchmarkOptions_.numThreads).description("The number of OpenMP threads to use"));
+    options->addOption(IntegerOption("ninst")
+                               .store(&benchmarkOptions_.numInstances)
+                               .description("The number of benchmark instances to run concurrently"));
+    options->addOption(BooleanOption("pin")
+                               .store(&benchmarkOptions_.pinThreads)
+                               .description("Pin the OpenMP threads of each instance to cores"));
+    options->addOption(
+            IntegerOption("pinoffset")
+                    .store(&benchmarkOptions_.pinOffset)
+                    .description("The logical core to pin the first thread to, with -pin"));
+    options->addOption(
+            IntegerOption("pinstride")
+                    .store(&benchmarkOptions_.pinStride)
+                    .description("The logical core stride between pinned threads, with -pin"));
     options->addOption(EnumOption<NbnxmBenchMarkKernels>("simd")
                                .store(&benchmarkOptions_.nbnxmSimd)
                                .enumValue(c_nbnxmSimdStrings)
@@ -224,6 +252,16 @@ void NonbondedBenchmark::initOptions(IOptionsContainer* options, ICommandLineOpt
 
 void NonbondedBenchmark::optionsFinished()
 {
+    if (benchmarkOptions_.numInstances < 1)
+    {
+        GMX_THROW(InvalidInputError("The number of instances should be at least 1"));
+    }
+    if (benchmarkOptions_.pinOffset < 0 || benchmarkOptions_.pinStride < 1)
+    {
+        GMX_THROW(InvalidInputError(
+                "The pin offset should be non-negative and the pin stride at least 1"));
+    }
+
     // We compute the Ewald coefficient here to avoid a dependency of the Nbnxm on the Ewald module
     const real ewald_rtol          = 1e-5;
     benchmarkOptions_.ewaldcoeff_q = calc_ewaldcoeff_q(benchmarkOptions_.pairlistCutoff, ewald_rtol);
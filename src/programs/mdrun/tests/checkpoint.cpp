@@ -51,9 +51,11 @@
 
 #include <gtest/gtest.h>
 
+#include "gromacs/utility/path.h"
 #include "gromacs/utility/strconvert.h"
 #include "gromacs/utility/stringutil.h"
 
+#include "testutils/setenv.h"
 #include "testutils/simulationdatabase.h"
 #include "testutils/testasserts.h"
 #include "testutils/testfilemanager.h"
@@ -178,5 +180,49 @@ INSTANTIATE_TEST_SUITE_P(DISABLED_CheckpointCoordinatesAreSane,
                                             ::testing::Values("no")));
 #endif
 
+//! Convenience typedef
+typedef MdrunTestFixture AsyncCheckpointTest;
+
+TEST_F(AsyncCheckpointTest, FinishesCheckpointsInTheBackground)
+{
+    const int numSteps       = 16;
+    auto      mdpFieldValues = prepareMdpFieldValues("spc2", "md", "no", "no");
+    mdpFieldValues["nsteps"]  = toString(numSteps);
+    mdpFieldValues["nstxout"] = toString(numSteps);
+    mdpFieldValues["nstvout"] = toString(numSteps);
+    mdpFieldValues["nstfout"] = toString(0);
+    runner_.useTopGroAndNdxFromDatabase("spc2");
+    runner_.useStringAsMdpFile(prepareMdpFileContents(mdpFieldValues));
+    runGrompp(&runner_);
+
+    const char* asyncCheckpointEnv = "GMX_ASYNC_CHECKPOINT";
+    gmxSetenv(asyncCheckpointEnv, "1", 1);
+    // Checkpointing at every global communication step means that each
+    // checkpoint has to wait for the previous one to be renamed
+    runMdrun(&runner_, { { "-cpt", "0" } });
+    gmxUnsetenv(asyncCheckpointEnv);
+
+    std::filesystem::path previousCptFileName = runner_.cptOutputFileName_;
+    previousCptFileName.replace_filename(previousCptFileName.stem().string() + "_prev.cpt");
+    EXPECT_TRUE(File::exists(previousCptFileName, File::returnFalseOnError))
+            << previousCptFileName << " was not found";
+
+    // The final checkpoint needs to be in place when mdrun returns
+    TrajectoryFrameMatchSettings trajectoryMatchSettings{ true,
+                                                          true,
+                                                          true,
+                                                          ComparisonConditions::MustCompare,
+                                                          ComparisonConditions::MustCompare,
+                                                          ComparisonConditions::NoComparison,
+                                                          MaxNumFrames::compareAllFrames() };
+    const TrajectoryTolerances trajectoryTolerances{
+        defaultRealTolerance(), defaultRealTolerance(), defaultRealTolerance(), defaultRealTolerance()
+    };
+    CheckpointCoordinatesSanityChecks::compareCptAndTrr(
+            runner_.fullPrecisionTrajectoryFileName_,
+            runner_.cptOutputFileName_,
+            { trajectoryMatchSettings, trajectoryTolerances });
+}
+
 } // namespace
 } // namespace gmx::test
@@ -75,6 +75,17 @@ TEST(NonbondedBenchTest, BasicEndToEndTest)
                       &gmx::NonbondedBenchmarkInfo::create, &cmdline));
 }
 
+TEST(NonbondedBenchTest, ConcurrentInstancesEndToEndTest)
+{
+    const char* const command[] = { "nonbonded-benchmark" };
+    CommandLine       cmdline(command);
+    cmdline.addOption("-iter", 1);
+    cmdline.addOption("-ninst", 2);
+    EXPECT_EQ(0,
+              gmx::test::CommandLineTestHelper::runModuleFactory(
+                      &gmx::NonbondedBenchmarkInfo::create, &cmdline));
+}
+
 } // namespace
 } // namespace test
 } // namespace gmx
@@ -0,0 +1,262 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2019- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests the JSON performance report written by mdrun -perf
+ *
+ * \ingroup module_mdrun_integration_tests
+ */
+
+#include "gmxpre.h"
+
+#include <cctype>
+
+#include <map>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/textreader.h"
+
+#include "testutils/cmdlinetest.h"
+
+#include "moduletest.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+/*! \brief Minimal JSON parser that flattens a document to its leaf values
+ *
+ * Each scalar value is stored with its path, where object keys and
+ * array indices are joined with '/', e.g. "timing/counters/0/name".
+ * String values are stored without quotes. Throws InvalidInputError
+ * when the input is not valid JSON.
+ */
+class FlatJsonParser
+{
+public:
+    //! Parses \p json and returns its leaf values
+    static std::map<std::string, std::string> parse(const std::string& json)
+    {
+        FlatJsonParser parser(json);
+        parser.parseValue("");
+        parser.skipWhitespace();
+        parser.check(parser.pos_ == json.size(), "trailing characters");
+        return parser.values_;
+    }
+
+private:
+    explicit FlatJsonParser(const std::string& json) : json_(json) {}
+
+    void check(bool condition, const char* what) const
+    {
+        if (!condition)
+        {
+            GMX_THROW(InvalidInputError(
+                    formatString("Invalid JSON at offset %zu: %s", pos_, what)));
+        }
+    }
+    void skipWhitespace()
+    {
+        while (pos_ < json_.size() && std::isspace(json_[pos_]))
+        {
+            pos_++;
+        }
+    }
+    //! Skips whitespace and returns whether the next character is \p c, consuming it if so
+    bool accept(char c)
+    {
+        skipWhitespace();
+        if (pos_ < json_.size() && json_[pos_] == c)
+        {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+    std::string parseString()
+    {
+        check(accept('"'), "expected a string");
+        std::string result;
+        while (true)
+        {
+            check(pos_ < json_.size(), "unterminated string");
+            const char c = json_[pos_++];
+            check(static_cast<unsigned char>(c) >= 0x20, "control character in string");
+            if (c == '"')
+            {
+                return result;
+            }
+            if (c == '\\')
+            {
+                check(pos_ < json_.size(), "unterminated escape");
+                const char escaped = json_[pos_++];
+                check(std::string("\"\\/bfnrtu").find(escaped) != std::string::npos,
+                      "invalid escape");
+                if (escaped == 'u')
+                {
+                    for (int i = 0; i < 4; i++)
+                    {
+                        check(pos_ < json_.size() && std::isxdigit(json_[pos_]),
+                              "invalid \\u escape");
+                        pos_++;
+                    }
+                }
+                result += escaped;
+            }
+            else
+            {
+                result += c;
+            }
+        }
+    }
+    void parseValue(const std::string& path)
+    {
+        skipWhitespace();
+        check(pos_ < json_.size(), "expected a value");
+        if (accept('{'))
+        {
+            if (!accept('}'))
+            {
+                do
+                {
+                    const std::string key = parseString();
+                    check(accept(':'), "expected ':'");
+                    parseValue(path.empty() ? key : path + "/" + key);
+                } while (accept(','));
+                check(accept('}'), "expected '}'");
+            }
+        }
+        else if (accept('['))
+        {
+            if (!accept(']'))
+            {
+                int index = 0;
+                do
+                {
+                    parseValue(formatString("%s/%d", path.c_str(), index++));
+                } while (accept(','));
+                check(accept(']'), "expected ']'");
+            }
+        }
+        else if (json_[pos_] == '"')
+        {
+            values_[path] = parseString();
+        }
+        else
+        {
+            const size_t start = pos_;
+            const std::string delimiters = ",}] \t\r\n";
+            while (pos_ < json_.size() && delimiters.find(json_[pos_]) == std::string::npos)
+            {
+                pos_++;
+            }
+            const std::string token = json_.substr(start, pos_ - start);
+            if (token != "true" && token != "false" && token != "null")
+            {
+                size_t numParsed = 0;
+                try
+                {
+                    std::stod(token, &numParsed);
+                }
+                catch (const std::exception&)
+                {
+                    numParsed = 0;
+                }
+                check(!token.empty() && numParsed == token.size(), "invalid literal");
+            }
+            values_[path] = token;
+        }
+    }
+
+    const std::string&                 json_;
+    size_t                             pos_ = 0;
+    std::map<std::string, std::string> values_;
+};
+
+//! Returns whether \p values has a key that starts with \p prefix
+bool hasKeyWithPrefix(const std::map<std::string, std::string>& values, const std::string& prefix)
+{
+    auto it = values.lower_bound(prefix);
+    return it != values.end() && startsWith(it->first, prefix);
+}
+
+//! Test fixture for mdrun -perf
+using MdrunPerformanceReport = MdrunTestFixture;
+
+TEST_F(MdrunPerformanceReport, WritesValidJsonForCpuRun)
+{
+    runner_.useStringAsMdpFile(R"(cutoff-scheme = Verlet
+                                  verlet-buffer-tolerance = 0.005
+                                  nsteps = 20
+                                  )");
+    runner_.useTopGroAndNdxFromDatabase("spc2");
+    ASSERT_EQ(0, runner_.callGrompp());
+
+    const std::string perfFileName = fileManager_.getTemporaryFilePath("perf.json").string();
+    CommandLine       mdrunCaller;
+    mdrunCaller.addOption("-nb", "cpu");
+    mdrunCaller.addOption("-perf", perfFileName);
+    ASSERT_EQ(0, runner_.callMdrun(mdrunCaller));
+
+    std::map<std::string, std::string> values;
+    ASSERT_NO_THROW(values = FlatJsonParser::parse(TextReader::readFileToString(perfFileName)));
+
+    // The steps are counted as in the log file, which includes step 0
+    EXPECT_EQ("21", values["performance/steps"]);
+    EXPECT_EQ("false", values["tasks/nonbonded_on_gpu"]);
+    EXPECT_TRUE(hasKeyWithPrefix(values, "hardware/"));
+    ASSERT_TRUE(values.count("timing/valid"));
+    if (values["timing/valid"] == "true")
+    {
+        EXPECT_TRUE(hasKeyWithPrefix(values, "timing/counters/0/"));
+        for (int i = 0; values.count(formatString("timing/counters/%d/name", i)); i++)
+        {
+            EXPECT_GT(std::stod(values[formatString("timing/counters/%d/giga_cycles", i)]), 0)
+                    << "Counters without cycles should not be reported";
+        }
+    }
+    // Without GPU tasks there are no GPU timings
+    EXPECT_FALSE(hasKeyWithPrefix(values, "gpu_timing/"));
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
@@ -0,0 +1,195 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the micro-benchmarks of the listed-forces kernels.
+ */
+#include "gmxpre.h"
+
+#include <cmath>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/listed_forces/bonded.h"
+#include "gromacs/math/units.h"
+#include "gromacs/math/paddedvector.h"
+#include "gromacs/math/vectypes.h"
+#include "gromacs/pbcutil/ishift.h"
+#include "gromacs/topology/idef.h"
+#include "gromacs/topology/ifunc.h"
+#include "gromacs/utility/alignedallocator.h"
+#include "gromacs/utility/real.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmarks
+{
+
+namespace
+{
+
+//! The number of atoms in the chain the interactions act on
+constexpr int c_numAtoms = 10000;
+
+/*! \internal
+ * \brief Interactions of one type along a chain of atoms, with output buffers
+ */
+struct BondedSystem
+{
+    //! Sets up all interactions of \p ftype between consecutive atoms
+    BondedSystem(int ftype, const t_iparams& parameters);
+
+    //! The interaction type
+    int ftype;
+    //! The parameters of the only interaction type used
+    t_iparams iparams;
+    //! The interaction parameter type and atom indices
+    std::vector<t_iatom> iatoms;
+    //! Coordinates, padded for SIMD access
+    PaddedVector<RVec> x;
+    //! Forces with four components per atom, aligned for SIMD access
+    std::vector<real, AlignedAllocator<real>> f;
+    //! Shift forces
+    rvec fshift[c_numShiftVectors];
+    //! Charges, not used by these interaction types
+    std::vector<real> charge;
+};
+
+BondedSystem::BondedSystem(const int ftype, const t_iparams& parameters) :
+    ftype(ftype),
+    iparams(parameters),
+    x(c_numAtoms),
+    f(4 * c_numAtoms),
+    fshift{ { 0 } },
+    charge(c_numAtoms)
+{
+    // A helix with bond lengths, angles and dihedrals in the usual ranges
+    const real radius = 0.1;
+    const real step   = 100 * gmx::c_deg2Rad;
+    const real pitch  = 0.1;
+    for (int i = 0; i < c_numAtoms; i++)
+    {
+        x[i] = { radius * std::cos(i * step), radius * std::sin(i * step), i * pitch };
+    }
+
+    const int numAtomsPerInteraction = NRAL(ftype);
+    for (int i = 0; i + numAtomsPerInteraction <= c_numAtoms; i++)
+    {
+        iatoms.push_back(0);
+        for (int a = 0; a < numAtomsPerInteraction; a++)
+        {
+            iatoms.push_back(i + a);
+        }
+    }
+}
+
+//! Returns a benchmark of \p ftype with \p parameters using kernel \p flavor
+MicroBenchmark bondedBenchmark(const int                ftype,
+                               const t_iparams&         parameters,
+                               const BondedKernelFlavor flavor,
+                               const std::string&       flavorName)
+{
+    MicroBenchmark benchmark;
+    benchmark.name = std::string("bonded/") + interaction_function[ftype].name + "/" + flavorName
+                     + "/" + std::to_string(c_numAtoms);
+    // There is an interaction starting at every atom that has enough atoms following it
+    benchmark.itemsPerIteration = c_numAtoms - NRAL(ftype) + 1;
+    benchmark.setup             = [ftype, parameters, flavor]()
+    {
+        auto system = std::make_shared<BondedSystem>(ftype, parameters);
+        return [system, flavor]()
+        {
+            real dvdlambda = 0;
+            calculateSimpleBond(system->ftype,
+                                system->iatoms.size(),
+                                system->iatoms.data(),
+                                &system->iparams,
+                                as_rvec_array(system->x.data()),
+                                reinterpret_cast<rvec4*>(system->f.data()),
+                                system->fshift,
+                                nullptr,
+                                0,
+                                &dvdlambda,
+                                system->charge,
+                                nullptr,
+                                nullptr,
+                                nullptr,
+                                nullptr,
+                                flavor);
+        };
+    };
+    return benchmark;
+}
+
+} // namespace
+
+std::vector<MicroBenchmark> bondedBenchmarks()
+{
+    t_iparams bonds       = {};
+    bonds.harmonic.rA     = 0.15;
+    bonds.harmonic.krA    = 3e5;
+    t_iparams angles      = {};
+    angles.harmonic.rA    = 110;
+    angles.harmonic.krA   = 400;
+    t_iparams pdihs       = {};
+    pdihs.pdihs.phiA      = 0;
+    pdihs.pdihs.cpA       = 5;
+    pdihs.pdihs.mult      = 3;
+    t_iparams rbdihs      = {};
+    rbdihs.rbdihs.rbcA[0] = 9.28;
+    rbdihs.rbdihs.rbcA[1] = 12.16;
+    rbdihs.rbdihs.rbcA[2] = -13.12;
+    rbdihs.rbdihs.rbcA[3] = -3.06;
+    rbdihs.rbdihs.rbcA[4] = 26.24;
+
+    std::vector<MicroBenchmark> benchmarks;
+    for (const auto& [ftype, parameters] : { std::pair<int, t_iparams>{ F_BONDS, bonds },
+                                             std::pair<int, t_iparams>{ F_ANGLES, angles },
+                                             std::pair<int, t_iparams>{ F_PDIHS, pdihs },
+                                             std::pair<int, t_iparams>{ F_RBDIHS, rbdihs } })
+    {
+        benchmarks.push_back(bondedBenchmark(
+                ftype, parameters, BondedKernelFlavor::ForcesSimdWhenAvailable, "forces"));
+        benchmarks.push_back(bondedBenchmark(
+                ftype, parameters, BondedKernelFlavor::ForcesAndVirialAndEnergy, "energy_virial"));
+    }
+    return benchmarks;
+}
+
+} // namespace microbenchmarks
+} // namespace gmx
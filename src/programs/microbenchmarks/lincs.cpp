@@ -0,0 +1,257 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the micro-benchmarks of the LINCS constraint kernel.
+ *
+ * The system is set up with the test data class of the constraint unit
+ * tests, in the same way as the LINCS test runner does.
+ */
+#include "gmxpre.h"
+
+#include <cmath>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gromacs/math/units.h"
+#include "gromacs/math/vectypes.h"
+#include "gromacs/mdlib/constr.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
+#include "gromacs/mdlib/lincs.h"
+#include "gromacs/mdlib/tests/constrtestdata.h"
+#include "gromacs/mdtypes/commrec.h"
+#include "gromacs/mdtypes/md_enums.h"
+#include "gromacs/utility/listoflists.h"
+#include "gromacs/utility/real.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmarks
+{
+
+namespace
+{
+
+//! The number of atoms in each chain
+constexpr int c_numAtomsPerChain = 10;
+//! The number of chains
+constexpr int c_numChains = 1000;
+//! The number of atoms in the system
+constexpr int c_numAtoms = c_numChains * c_numAtomsPerChain;
+//! The number of constraints in the system
+constexpr int c_numConstraints = c_numChains * (c_numAtomsPerChain - 1);
+//! The constrained bond length
+constexpr real c_bondLength = 0.153;
+
+//! Returns the constraint test data for chains of atoms with all bonds constrained
+std::unique_ptr<test::ConstraintsTestData> makeChainsTestData(const bool computeVirial)
+{
+    const int  numChainsPerDim = static_cast<int>(std::ceil(std::cbrt(c_numChains)));
+    const real chainSpacing    = 0.5;
+    // Zig-zag chains with a bond angle of about 111 degrees
+    const real halfBondAngle = 0.5 * 111 * c_deg2Rad;
+    const real dx            = c_bondLength * std::sin(halfBondAngle);
+    const real dy            = c_bondLength * std::cos(halfBondAngle);
+    const RVec bondVector[2] = { { dx, dy, 0 }, { dx, -dy, 0 } };
+    // Perturbations of the coordinates, as an update would generate
+    const real deltas[] = { 0.005, -0.005, 0.01, -0.01 };
+
+    std::vector<real> masses;
+    std::vector<int>  constraints;
+    std::vector<RVec> x;
+    std::vector<RVec> xPrime;
+    std::vector<RVec> v(c_numAtoms, { 0, 0, 0 });
+    int               numPerturbed = 0;
+    for (int c = 0; c < c_numChains; c++)
+    {
+        RVec position = { chainSpacing * (c % numChainsPerDim),
+                          chainSpacing * ((c / numChainsPerDim) % numChainsPerDim),
+                          chainSpacing * (c / (numChainsPerDim * numChainsPerDim)) };
+        for (int a = 0; a < c_numAtomsPerChain; a++)
+        {
+            const int atom = c * c_numAtomsPerChain + a;
+            if (a > 0)
+            {
+                position += bondVector[a % 2];
+                constraints.push_back(0);
+                constraints.push_back(atom - 1);
+                constraints.push_back(atom);
+            }
+            masses.push_back(12.011);
+            x.push_back(position);
+            RVec perturbed = position;
+            for (int d = 0; d < DIM; d++)
+            {
+                perturbed[d] += deltas[numPerturbed % 4];
+                numPerturbed++;
+            }
+            xPrime.push_back(perturbed);
+        }
+    }
+
+    // Default LINCS settings: 1 iteration, expansion order 4
+    return std::make_unique<test::ConstraintsTestData>("Chains of constrained atoms",
+                                                       c_numAtoms,
+                                                       masses,
+                                                       constraints,
+                                                       std::vector<real>{ c_bondLength },
+                                                       computeVirial,
+                                                       false,
+                                                       0,
+                                                       0.002,
+                                                       x,
+                                                       xPrime,
+                                                       v,
+                                                       0.0001,
+                                                       false,
+                                                       1,
+                                                       4,
+                                                       30);
+}
+
+/*! \internal
+ * \brief LINCS set up for the constraint test data
+ */
+struct LincsSystem
+{
+    //! Sets up LINCS for \p testData
+    explicit LincsSystem(std::unique_ptr<test::ConstraintsTestData> testData);
+    ~LincsSystem();
+
+    //! The system
+    std::unique_ptr<test::ConstraintsTestData> testData;
+    //! Communication record with a single rank
+    t_commrec cr;
+    //! The LINCS setup
+    Lincs* lincsd;
+};
+
+LincsSystem::LincsSystem(std::unique_ptr<test::ConstraintsTestData> testDataToUse) :
+    testData(std::move(testDataToUse))
+{
+    const bool                    haveDynamics = EI_DYNAMICS(testData->ir_.eI);
+    std::vector<ListOfLists<int>> at2con_mt;
+    for (const gmx_moltype_t& moltype : testData->mtop_.moltype)
+    {
+        at2con_mt.push_back(make_at2con(
+                moltype, testData->mtop_.ffparams.iparams, flexibleConstraintTreatment(haveDynamics)));
+    }
+    lincsd = init_lincs(nullptr,
+                        testData->mtop_,
+                        testData->nflexcon_,
+                        at2con_mt,
+                        false,
+                        testData->ir_.nLincsIter,
+                        testData->ir_.nProjOrder,
+                        nullptr);
+    set_lincs(*testData->idef_,
+              testData->numAtoms_,
+              testData->invmass_,
+              testData->lambda_,
+              haveDynamics,
+              &cr,
+              lincsd);
+}
+
+LincsSystem::~LincsSystem()
+{
+    done_lincs(lincsd);
+}
+
+//! Returns a benchmark of LINCS, optionally with velocity and virial updates
+MicroBenchmark lincsBenchmark(const bool updateVelocitiesAndVirial)
+{
+    MicroBenchmark benchmark;
+    benchmark.name = std::string("lincs/") + (updateVelocitiesAndVirial ? "v_virial" : "x") + "/"
+                     + std::to_string(c_numAtoms);
+    benchmark.itemsPerIteration = c_numConstraints;
+    // LINCS uses a fixed number of iterations, so repeatedly constraining
+    // the same, already constrained, coordinates costs the same.
+    benchmark.setup = [updateVelocitiesAndVirial]()
+    {
+        auto system = std::make_shared<LincsSystem>(makeChainsTestData(updateVelocitiesAndVirial));
+        return [system, updateVelocitiesAndVirial]()
+        {
+            test::ConstraintsTestData* testData  = system->testData.get();
+            const matrix               box       = { { 0 } };
+            int                        warncount = 0;
+            constrain_lincs(false,
+                            testData->ir_,
+                            0,
+                            system->lincsd,
+                            testData->invmass_,
+                            &system->cr,
+                            nullptr,
+                            testData->x_.arrayRefWithPadding(),
+                            testData->xPrime_.arrayRefWithPadding(),
+                            testData->xPrime2_.arrayRefWithPadding().unpaddedArrayRef(),
+                            box,
+                            nullptr,
+                            false,
+                            0,
+                            &testData->dHdLambda_,
+                            updateVelocitiesAndVirial ? testData->invdt_ : 0,
+                            updateVelocitiesAndVirial
+                                    ? testData->v_.arrayRefWithPadding().unpaddedArrayRef()
+                                    : ArrayRef<RVec>(),
+                            updateVelocitiesAndVirial,
+                            testData->virialScaled_,
+                            ConstraintVariable::Positions,
+                            &testData->nrnb_,
+                            std::numeric_limits<int>::max(),
+                            &warncount,
+                            nullptr);
+        };
+    };
+    return benchmark;
+}
+
+} // namespace
+
+std::vector<MicroBenchmark> lincsBenchmarks()
+{
+    // We don't want to call gmx_omp_nthreads_init(), so we init what we need
+    gmx_omp_nthreads_set(ModuleMultiThread::Lincs, 1);
+
+    return { lincsBenchmark(false), lincsBenchmark(true) };
+}
+
+} // namespace microbenchmarks
+} // namespace gmx
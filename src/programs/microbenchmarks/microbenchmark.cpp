@@ -0,0 +1,145 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the runner of the GROMACS micro-benchmarks.
+ */
+#include "gmxpre.h"
+
+#include "microbenchmark.h"
+
+#include "config.h"
+
+#include <cstdint>
+#include <ctime>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "gromacs/utility/baseversion.h"
+#include "gromacs/utility/keyvaluetree.h"
+#include "gromacs/utility/keyvaluetreebuilder.h"
+#include "gromacs/utility/keyvaluetreejsonwriter.h"
+#include "gromacs/utility/stringutil.h"
+#include "gromacs/utility/sysinfo.h"
+#include "gromacs/utility/textwriter.h"
+
+namespace gmx
+{
+namespace microbenchmarks
+{
+
+MicroBenchmarkResult runMicroBenchmark(const MicroBenchmark& benchmark, const double minTime)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const std::function<void()> kernel = benchmark.setup();
+
+    // Warm up the caches and let the kernel allocate what it needs
+    kernel();
+
+    std::int64_t iterations = 1;
+    while (true)
+    {
+        const std::clock_t cpuStart  = std::clock();
+        const auto         wallStart = Clock::now();
+        for (std::int64_t i = 0; i < iterations; i++)
+        {
+            kernel();
+        }
+        const std::chrono::duration<double> wallTime = Clock::now() - wallStart;
+        const double cpuTime = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+        if (wallTime.count() >= minTime || iterations >= (std::int64_t(1) << 40))
+        {
+            MicroBenchmarkResult result;
+            result.name           = benchmark.name;
+            result.iterations     = iterations;
+            result.realTime       = 1e9 * wallTime.count() / iterations;
+            result.cpuTime        = 1e9 * cpuTime / iterations;
+            result.itemsPerSecond = benchmark.itemsPerIteration * iterations / wallTime.count();
+            return result;
+        }
+
+        // Aim for 1.4 times the minimum time, but do not grow too fast
+        // from very short, and therefore imprecise, timings
+        const double scale = (wallTime.count() > 0 ? 1.4 * minTime / wallTime.count() : 10);
+
+        const auto nextIterations = static_cast<std::int64_t>(iterations * std::min(scale, 10.0));
+        iterations                = std::max(iterations + 1, nextIterations);
+    }
+}
+
+void writeJsonReport(FILE* fp, const std::vector<MicroBenchmarkResult>& results)
+{
+    char hostName[256];
+    if (gmx_gethostname(hostName, sizeof(hostName)) != 0)
+    {
+        hostName[0] = '\0';
+    }
+
+    KeyValueTreeBuilder       builder;
+    KeyValueTreeObjectBuilder root    = builder.rootObject();
+    KeyValueTreeObjectBuilder context = root.addObject("context");
+    // The formatted time is null-terminated within a larger buffer and ends with a newline
+    context.addValue<std::string>("date", stripString(gmx_format_current_time().c_str()));
+    context.addValue<std::string>("host_name", hostName);
+    context.addValue<int>("num_cpus", std::thread::hardware_concurrency());
+    context.addValue<std::string>("gromacs_version", gmx_version());
+    context.addValue<std::string>("simd", GMX_SIMD_STRING);
+    context.addValue<std::string>("precision", GMX_DOUBLE ? "double" : "mixed");
+
+    KeyValueTreeObjectArrayBuilder benchmarks = root.addObjectArray("benchmarks");
+    for (const MicroBenchmarkResult& result : results)
+    {
+        KeyValueTreeObjectBuilder benchmark = benchmarks.addObject();
+        benchmark.addValue<std::string>("name", result.name);
+        benchmark.addValue<std::string>("run_name", result.name);
+        benchmark.addValue<std::string>("run_type", "iteration");
+        benchmark.addValue<int64_t>("iterations", result.iterations);
+        benchmark.addValue<double>("real_time", result.realTime);
+        benchmark.addValue<double>("cpu_time", result.cpuTime);
+        benchmark.addValue<std::string>("time_unit", "ns");
+        benchmark.addValue<double>("items_per_second", result.itemsPerSecond);
+    }
+
+    TextWriter writer(fp);
+    writeKeyValueTreeAsJson(&writer, builder.build());
+}
+
+} // namespace microbenchmarks
+} // namespace gmx
@@ -0,0 +1,151 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Declares the registry and runner of the GROMACS micro-benchmarks.
+ *
+ * Each benchmark repeatedly calls a single kernel on data that is set up
+ * beforehand, so only the kernel is timed. Where possible, the data comes
+ * from the systems of the unit tests and of gmx nonbonded-benchmark. The results are written in the
+ * same JSON layout as Google Benchmark writes, so that existing tools for
+ * comparing benchmark runs can be used.
+ */
+#ifndef GMX_PROGRAMS_MICROBENCHMARKS_MICROBENCHMARK_H
+#define GMX_PROGRAMS_MICROBENCHMARKS_MICROBENCHMARK_H
+
+#include <cstdint>
+#include <cstdio>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gmx
+{
+namespace microbenchmarks
+{
+
+/*! \internal
+ * \brief A kernel to benchmark
+ */
+struct MicroBenchmark
+{
+    //! Name, of the form kernel/variant/system size
+    std::string name;
+    //! The number of items, e.g. interactions or atoms, processed per kernel call
+    std::int64_t itemsPerIteration;
+    /*! \brief Sets up the data and returns a function that calls the kernel once
+     *
+     * Only called for benchmarks that are run, so that listing and selecting
+     * benchmarks does not set up any systems. The data the kernel works on
+     * is owned by the returned function object.
+     */
+    std::function<std::function<void()>()> setup;
+};
+
+//! Returns data of type \p T that is set up on the first call
+template<typename T>
+using SharedSetup = std::function<std::shared_ptr<T>()>;
+
+/*! \brief Returns a function that returns the result of \p create, calling it only once
+ *
+ * Lets several benchmarks share data that is only set up when the first of them is run.
+ */
+template<typename T>
+SharedSetup<T> sharedSetup(std::function<std::shared_ptr<T>()> create)
+{
+    auto data = std::make_shared<std::shared_ptr<T>>();
+    return [data, create]()
+    {
+        if (*data == nullptr)
+        {
+            *data = create();
+        }
+        return *data;
+    };
+}
+
+//! Returns the benchmarks of the listed-forces kernels
+std::vector<MicroBenchmark> bondedBenchmarks();
+
+//! Returns the benchmarks of the SETTLE constraint kernels
+std::vector<MicroBenchmark> settleBenchmarks();
+
+//! Returns the benchmarks of the LINCS constraint kernel
+std::vector<MicroBenchmark> lincsBenchmarks();
+
+//! Returns the benchmarks of the leap-frog update
+std::vector<MicroBenchmark> updateBenchmarks();
+
+//! Returns the benchmarks of the PME spread and gather kernels
+std::vector<MicroBenchmark> pmeBenchmarks();
+
+//! Returns the benchmarks of the nbnxm gridding and pair search
+std::vector<MicroBenchmark> pairSearchBenchmarks();
+
+//! Returns the benchmarks of the XTC coordinate (de)quantization kernels
+std::vector<MicroBenchmark> xtcBenchmarks();
+
+/*! \internal
+ * \brief The timing of a benchmark
+ */
+struct MicroBenchmarkResult
+{
+    //! Name of the benchmark
+    std::string name;
+    //! The number of kernel calls that were timed
+    std::int64_t iterations;
+    //! Wall-clock time per kernel call in nanoseconds
+    double realTime;
+    //! CPU time per kernel call in nanoseconds
+    double cpuTime;
+    //! The number of items processed per second of wall-clock time
+    double itemsPerSecond;
+};
+
+/*! \brief Sets up and times \p benchmark
+ *
+ * After setup, the kernel is called once for warm-up, after which the number
+ * of calls is increased until they take at least \p minTime seconds.
+ */
+MicroBenchmarkResult runMicroBenchmark(const MicroBenchmark& benchmark, double minTime);
+
+//! Writes \p results as Google Benchmark compatible JSON to \p fp
+void writeJsonReport(FILE* fp, const std::vector<MicroBenchmarkResult>& results);
+
+} // namespace microbenchmarks
+} // namespace gmx
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the gmx-microbenchmarks binary.
+ *
+ * Accepts the Google Benchmark options --benchmark_filter,
+ * --benchmark_min_time, --benchmark_out and --benchmark_list_tests, so
+ * that scripts written for Google Benchmark binaries can drive it.
+ */
+#include "gmxpre.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <string>
+#include <vector>
+
+#include "gromacs/commandline/cmdlineinit.h"
+#include "gromacs/utility/basedefinitions.h"
+#include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/futil.h"
+#include "gromacs/utility/stringutil.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+class CommandLineProgramContext;
+} // namespace gmx
+
+namespace
+{
+
+//! The options controlling which benchmarks are run and how
+struct Options
+{
+    //! Only benchmarks with a name containing this are run
+    std::string filter;
+    //! The minimum time in seconds to run each benchmark for
+    double minTime = 0.5;
+    //! File name for the JSON report, stdout when empty
+    std::string outputFile;
+    //! Whether to only list the benchmarks
+    bool listOnly = false;
+};
+
+//! Parses the command line into \c Options, throws on unknown options
+Options parseOptions(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        const std::string value    = argument.substr(argument.find('=') + 1);
+        if (gmx::startsWith(argument, "--benchmark_filter="))
+        {
+            options.filter = value;
+        }
+        else if (gmx::startsWith(argument, "--benchmark_min_time="))
+        {
+            // Google Benchmark allows a trailing unit, only seconds are supported
+            options.minTime = std::strtod(gmx::stripSuffixIfPresent(value, "s").c_str(), nullptr);
+        }
+        else if (gmx::startsWith(argument, "--benchmark_out="))
+        {
+            options.outputFile = value;
+        }
+        else if (argument == "--benchmark_list_tests" || argument == "--benchmark_list_tests=true")
+        {
+            options.listOnly = true;
+        }
+        else
+        {
+            GMX_THROW(gmx::InvalidInputError(gmx::formatString(
+                    "Unknown option '%s'. Supported are --benchmark_filter=<substring>, "
+                    "--benchmark_min_time=<seconds>, --benchmark_out=<file> and "
+                    "--benchmark_list_tests",
+                    argument.c_str())));
+        }
+    }
+    return options;
+}
+
+//! Runs the selected benchmarks, returns the exit code
+int runMicroBenchmarks(const Options& options)
+{
+    using namespace gmx::microbenchmarks;
+
+    std::vector<MicroBenchmark> benchmarks;
+    for (const auto& set : { bondedBenchmarks(),
+                             settleBenchmarks(),
+                             lincsBenchmarks(),
+                             updateBenchmarks(),
+                             pmeBenchmarks(),
+                             pairSearchBenchmarks(),
+                             xtcBenchmarks() })
+    {
+        for (const auto& benchmark : set)
+        {
+            if (benchmark.name.find(options.filter) != std::string::npos)
+            {
+                benchmarks.push_back(benchmark);
+            }
+        }
+    }
+
+    if (options.listOnly)
+    {
+        for (const auto& benchmark : benchmarks)
+        {
+            std::printf("%s\n", benchmark.name.c_str());
+        }
+        return 0;
+    }
+
+    // With the report on stdout, the table goes to stderr to keep the JSON valid
+    FILE* tableFile = options.outputFile.empty() ? stderr : stdout;
+    std::fprintf(tableFile,
+                 "%-36s %14s %14s %12s %14s\n",
+                 "Benchmark",
+                 "Time (ns)",
+                 "CPU (ns)",
+                 "Iterations",
+                 "Items/s");
+    std::vector<MicroBenchmarkResult> results;
+    for (const auto& benchmark : benchmarks)
+    {
+        results.push_back(runMicroBenchmark(benchmark, options.minTime));
+        const auto& result = results.back();
+        std::fprintf(tableFile,
+                     "%-36s %14.0f %14.0f %12lld %14.4g\n",
+                     result.name.c_str(),
+                     result.realTime,
+                     result.cpuTime,
+                     static_cast<long long>(result.iterations),
+                     result.itemsPerSecond);
+    }
+
+    if (options.outputFile.empty())
+    {
+        writeJsonReport(stdout, results);
+    }
+    else
+    {
+        FILE* fp = gmx_ffopen(options.outputFile, "w");
+        writeJsonReport(fp, results);
+        gmx_ffclose(fp);
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    gmx::CommandLineProgramContext& context = gmx::initForCommandLine(&argc, &argv);
+    GMX_UNUSED_VALUE(context);
+    try
+    {
+        int rc = runMicroBenchmarks(parseOptions(argc, argv));
+        gmx::finalizeForCommandLine();
+        return rc;
+    }
+    catch (const std::exception& ex)
+    {
+        gmx::printFatalErrorMessage(stderr, ex);
+        return gmx::processExceptionAtExitForCommandLine(ex);
+    }
+}
@@ -0,0 +1,184 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the micro-benchmarks of the nbnxm gridding and pair search.
+ *
+ * Uses the water system and the Nbnxm setup of gmx nonbonded-benchmark.
+ */
+#include "gmxpre.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gromacs/gmxlib/nrnb.h"
+#include "gromacs/math/vec.h"
+#include "gromacs/math/vectypes.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
+#include "gromacs/mdtypes/locality.h"
+#include "gromacs/nbnxm/benchmark/bench_setup.h"
+#include "gromacs/nbnxm/benchmark/bench_system.h"
+#include "gromacs/nbnxm/nbnxm.h"
+#include "gromacs/nbnxm/nbnxm_simd.h"
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/range.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmarks
+{
+
+namespace
+{
+
+//! The size factor of the nonbonded-benchmark water system
+constexpr int c_systemSizeFactor = 8;
+//! The number of atoms in the water system
+constexpr int c_numAtoms = 3000 * c_systemSizeFactor;
+
+/*! \internal
+ * \brief An Nbnxm object set up for the nonbonded-benchmark water system
+ */
+struct PairSearchSystem
+{
+    //! Sets up Nbnxm for \p system with the pairlist layout of kernel \p simd
+    PairSearchSystem(std::shared_ptr<const BenchmarkSystem> system, NbnxmBenchMarkKernels simd);
+
+    //! Puts all atoms on the grid
+    void putAtomsOnGrid();
+
+    //! The water system, shared between the pairlist layouts
+    std::shared_ptr<const BenchmarkSystem> system;
+    //! The Nbnxm object
+    std::unique_ptr<nonbonded_verlet_t> nbv;
+    //! Flop and cost accounting, not used
+    t_nrnb nrnb;
+};
+
+PairSearchSystem::PairSearchSystem(std::shared_ptr<const BenchmarkSystem> system,
+                                   const NbnxmBenchMarkKernels            simd) :
+    system(std::move(system))
+{
+    NbnxmKernelBenchOptions options;
+    options.nbnxmSimd = simd;
+    nbv               = setupNbnxmForBenchInstance(options, *this->system);
+}
+
+void PairSearchSystem::putAtomsOnGrid()
+{
+    const int  numAtoms    = system->coordinates.size();
+    const RVec lowerCorner = { 0, 0, 0 };
+    const RVec upperCorner = { system->box[XX][XX], system->box[YY][YY], system->box[ZZ][ZZ] };
+    nbv->putAtomsOnGrid(system->box,
+                        0,
+                        lowerCorner,
+                        upperCorner,
+                        nullptr,
+                        { 0, numAtoms },
+                        numAtoms,
+                        numAtoms / det(system->box),
+                        system->atomInfoAllVdw,
+                        system->coordinates,
+                        nullptr);
+}
+
+//! Returns the benchmarks of gridding and pair search with the pairlist layout of \p simd
+std::vector<MicroBenchmark> layoutBenchmarks(const SharedSetup<const BenchmarkSystem>& system,
+                                             const NbnxmBenchMarkKernels simd,
+                                             const std::string&          layoutName)
+{
+    const auto searchSystem = sharedSetup<PairSearchSystem>(
+            [system, simd]() { return std::make_shared<PairSearchSystem>(system(), simd); });
+    const std::string sizeName = std::to_string(c_numAtoms);
+
+    MicroBenchmark grid;
+    grid.name              = "pairsearch/grid/" + layoutName + "/" + sizeName;
+    grid.itemsPerIteration = c_numAtoms;
+    grid.setup             = [searchSystem]()
+    { return [searchSystem = searchSystem()]() { searchSystem->putAtomsOnGrid(); }; };
+
+    // Gridding is deterministic, so repeatedly searching the same grid costs the same
+    MicroBenchmark pairlist;
+    pairlist.name              = "pairsearch/pairlist/" + layoutName + "/" + sizeName;
+    pairlist.itemsPerIteration = c_numAtoms;
+    pairlist.setup             = [searchSystem]()
+    {
+        auto system = searchSystem();
+        system->putAtomsOnGrid();
+        return [system]()
+        {
+            system->nbv->constructPairlist(
+                    InteractionLocality::Local, system->system->excls, 0, &system->nrnb);
+        };
+    };
+
+    return { grid, pairlist };
+}
+
+} // namespace
+
+std::vector<MicroBenchmark> pairSearchBenchmarks()
+{
+    // We don't want to call gmx_omp_nthreads_init(), so we init what we need
+    gmx_omp_nthreads_set(ModuleMultiThread::Pairsearch, 1);
+    gmx_omp_nthreads_set(ModuleMultiThread::Nonbonded, 1);
+
+    const auto system = sharedSetup<const BenchmarkSystem>(
+            []() {
+                return std::make_shared<const BenchmarkSystem>(c_systemSizeFactor, std::string());
+            });
+
+    std::vector<MicroBenchmark> benchmarks =
+            layoutBenchmarks(system, NbnxmBenchMarkKernels::SimdNo, "4x4");
+#if GMX_HAVE_NBNXM_SIMD_4XM
+    for (const auto& benchmark : layoutBenchmarks(system, NbnxmBenchMarkKernels::Simd4XM, "4xM"))
+    {
+        benchmarks.push_back(benchmark);
+    }
+#endif
+#if GMX_HAVE_NBNXM_SIMD_2XMM
+    for (const auto& benchmark : layoutBenchmarks(system, NbnxmBenchMarkKernels::Simd2XMM, "2xMM"))
+    {
+        benchmarks.push_back(benchmark);
+    }
+#endif
+    return benchmarks;
+}
+
+} // namespace microbenchmarks
+} // namespace gmx
@@ -0,0 +1,214 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the micro-benchmarks of the PME spread and gather kernels.
+ *
+ * The setup follows the CPU code path of the PME unit tests.
+ */
+#include "gmxpre.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/domdec/domdec.h"
+#include "gromacs/ewald/ewald_utils.h"
+#include "gromacs/ewald/pme.h"
+#include "gromacs/ewald/pme_gather.h"
+#include "gromacs/ewald/pme_grid.h"
+#include "gromacs/ewald/pme_internal.h"
+#include "gromacs/ewald/pme_spread.h"
+#include "gromacs/fft/calcgrid.h"
+#include "gromacs/math/boxmatrix.h"
+#include "gromacs/math/vectypes.h"
+#include "gromacs/mdtypes/commrec.h"
+#include "gromacs/mdtypes/inputrec.h"
+#include "gromacs/mdtypes/md_enums.h"
+#include "gromacs/nbnxm/benchmark/bench_system.h"
+#include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/logger.h"
+#include "gromacs/utility/real.h"
+#include "gromacs/utility/unique_cptr.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmarks
+{
+
+namespace
+{
+
+//! The size factor of the nonbonded-benchmark water system
+constexpr int c_systemSizeFactor = 8;
+//! The number of atoms in the water system
+constexpr int c_numAtoms = 3000 * c_systemSizeFactor;
+//! The PME interpolation order
+constexpr int c_pmeOrder = 4;
+//! The PME grid spacing in nm
+constexpr real c_gridSpacing = 0.12;
+
+//! Owning pointer to PME data
+using PmePointer = unique_cptr<gmx_pme_t, gmx_pme_destroy>;
+
+/*! \internal
+ * \brief The water system of gmx nonbonded-benchmark with CPU PME set up for it
+ */
+struct PmeSystem
+{
+    PmeSystem();
+
+    //! The water system with charges
+    BenchmarkSystem system;
+    //! The PME setup
+    PmePointer pme;
+    //! The PME mesh force output
+    std::vector<RVec> forces;
+};
+
+PmeSystem::PmeSystem() :
+    system(c_systemSizeFactor, std::string()), forces(system.coordinates.size())
+{
+    GMX_RELEASE_ASSERT(static_cast<int>(system.coordinates.size()) == c_numAtoms,
+                       "The water system should have the expected number of atoms");
+
+    t_inputrec inputRec;
+    inputRec.coulombtype = CoulombInteractionType::Pme;
+    inputRec.epsilon_r   = 1.0;
+    inputRec.pme_order   = c_pmeOrder;
+    inputRec.nkx         = 0;
+    inputRec.nky         = 0;
+    inputRec.nkz         = 0;
+    calcFftGrid(nullptr,
+                system.box,
+                c_gridSpacing,
+                minimalPmeGridSize(c_pmeOrder),
+                &inputRec.nkx,
+                &inputRec.nky,
+                &inputRec.nkz);
+
+    t_commrec     commrec;
+    NumPmeDomains numPmeDomains = { 1, 1 };
+    pme.reset(gmx_pme_init(&commrec,
+                           numPmeDomains,
+                           &inputRec,
+                           system.box,
+                           1.0,
+                           false,
+                           false,
+                           true,
+                           calc_ewaldcoeff_q(1.0, 1e-5),
+                           0,
+                           1,
+                           PmeRunMode::CPU,
+                           nullptr,
+                           nullptr,
+                           nullptr,
+                           nullptr,
+                           MDLogger(),
+                           nullptr));
+    invertBoxMatrix(system.box, pme->recipbox);
+
+    PmeAtomComm* atc = &pme->atc[0];
+    atc->x           = system.coordinates;
+    atc->coefficient = system.charges;
+    gmx_pme_reinit_atoms(pme.get(), system.coordinates.size(), system.charges, {});
+    atc->f = forces;
+    // This is normally done by the serial spline computation
+    atc->spline[0].n = atc->numAtoms();
+
+    // Compute the splines and the grid that the gather kernel uses
+    spread_on_grid(pme.get(), atc, &pme->gridsCoulomb[0], true, true, true);
+    wrap_periodic_pmegrid(pme.get(), pme->gridsCoulomb[0].pmeGrids.grid.grid);
+    copy_pmegrid_to_fftgrid(pme.get(), &pme->gridsCoulomb[0]);
+}
+
+//! Returns a benchmark of spreading charges, optionally computing the splines first
+MicroBenchmark spreadBenchmark(const SharedSetup<PmeSystem>& pmeSystem, const bool computeSplines)
+{
+    MicroBenchmark benchmark;
+    benchmark.name = std::string("pme/spread/") + (computeSplines ? "splines_spread" : "spread")
+                     + "/" + std::to_string(c_numAtoms);
+    benchmark.itemsPerIteration = c_numAtoms;
+    benchmark.setup             = [pmeSystem, computeSplines]()
+    {
+        return [system = pmeSystem(), computeSplines]()
+        {
+            gmx_pme_t*      pme   = system->pme.get();
+            PmeAndFftGrids& grids = pme->gridsCoulomb[0];
+            spread_on_grid(pme, &pme->atc[0], &grids, computeSplines, true, true);
+            wrap_periodic_pmegrid(pme, grids.pmeGrids.grid.grid);
+            copy_pmegrid_to_fftgrid(pme, &grids);
+        };
+    };
+    return benchmark;
+}
+
+//! Returns a benchmark of gathering the forces from the grid
+MicroBenchmark gatherBenchmark(const SharedSetup<PmeSystem>& pmeSystem)
+{
+    MicroBenchmark benchmark;
+    benchmark.name              = "pme/gather/" + std::to_string(c_numAtoms);
+    benchmark.itemsPerIteration = c_numAtoms;
+    benchmark.setup             = [pmeSystem]()
+    {
+        return [system = pmeSystem()]()
+        {
+            gmx_pme_t*      pme     = system->pme.get();
+            PmeAndFftGrids& grids   = pme->gridsCoulomb[0];
+            PmeAtomComm*    atc     = &pme->atc[0];
+            ArrayRef<real>  pmegrid = grids.pmeGrids.grid.grid;
+            copy_fftgrid_to_pmegrid(pme, &grids, pme->nthread, 0);
+            unwrap_periodic_pmegrid(pme, pmegrid);
+            gather_f_bsplines(pme, pmegrid, true, atc, &atc->spline[0], 1.0);
+        };
+    };
+    return benchmark;
+}
+
+} // namespace
+
+std::vector<MicroBenchmark> pmeBenchmarks()
+{
+    // The kernels only modify the grids and forces, so they can share the setup
+    const auto pmeSystem = sharedSetup<PmeSystem>([]() { return std::make_shared<PmeSystem>(); });
+    return { spreadBenchmark(pmeSystem, true),
+             spreadBenchmark(pmeSystem, false),
+             gatherBenchmark(pmeSystem) };
+}
+
+} // namespace microbenchmarks
+} // namespace gmx
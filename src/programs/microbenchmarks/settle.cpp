@@ -0,0 +1,194 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the micro-benchmarks of the SETTLE constraint kernel.
+ */
+#include "gmxpre.h"
+
+#include <cmath>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/math/paddedvector.h"
+#include "gromacs/math/units.h"
+#include "gromacs/math/vectypes.h"
+#include "gromacs/mdlib/settle.h"
+#include "gromacs/topology/idef.h"
+#include "gromacs/topology/ifunc.h"
+#include "gromacs/topology/topology.h"
+#include "gromacs/utility/real.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmarks
+{
+
+namespace
+{
+
+//! The number of water molecules along each dimension of the grid
+constexpr int c_numWatersPerDim = 20;
+//! The total number of water molecules
+constexpr int c_numWaters = c_numWatersPerDim * c_numWatersPerDim * c_numWatersPerDim;
+//! The O-H distance of SPC/E water
+constexpr real c_dOH = 0.1;
+//! The H-H distance of SPC/E water
+constexpr real c_dHH = 0.1633;
+//! The oxygen mass
+constexpr real c_oxygenMass = 15.9994;
+//! The hydrogen mass
+constexpr real c_hydrogenMass = 1.008;
+
+/*! \internal
+ * \brief A grid of rigid water molecules after an unconstrained update
+ */
+struct SettleSystem
+{
+    SettleSystem();
+
+    //! The topology, only used to set up \c settled
+    gmx_mtop_t mtop;
+    //! The SETTLE setup
+    std::unique_ptr<SettleData> settled;
+    //! Constrained reference coordinates
+    PaddedVector<RVec> x;
+    //! Unconstrained updated coordinates
+    PaddedVector<RVec> xPrime;
+    //! Velocities
+    PaddedVector<RVec> v;
+    //! The constraint virial contribution
+    tensor virial = { { 0 } };
+};
+
+SettleSystem::SettleSystem() :
+    x(3 * c_numWaters), xPrime(3 * c_numWaters), v(3 * c_numWaters)
+{
+    const real spacing     = 0.31;
+    const real halfHHAngle = std::asin(0.5 * c_dHH / c_dOH);
+    // Perturbations of the coordinates, as an update would generate
+    const real deltas[] = { 0.01, -0.01, 0.02, -0.02 };
+
+    mtop.moltype.resize(1);
+    mtop.molblock.resize(1);
+    mtop.molblock[0].type    = 0;
+    mtop.molblock[0].nmol    = 1;
+    std::vector<int>& iatoms = mtop.moltype[0].ilist[F_SETTLE].iatoms;
+    std::vector<real> masses;
+    std::vector<real> inverseMasses;
+    int               numPerturbed = 0;
+    for (int w = 0; w < c_numWaters; w++)
+    {
+        const RVec oxygen = { spacing * (w % c_numWatersPerDim),
+                              spacing * ((w / c_numWatersPerDim) % c_numWatersPerDim),
+                              spacing * (w / (c_numWatersPerDim * c_numWatersPerDim)) };
+        // Vary the orientation of the molecules
+        const real rotation = w * 37 * gmx::c_deg2Rad;
+        x[3 * w]            = oxygen;
+        for (int h = 0; h < 2; h++)
+        {
+            const real angle = rotation + (h == 0 ? -halfHHAngle : halfHHAngle);
+            x[3 * w + 1 + h] = oxygen + RVec{ c_dOH * std::cos(angle), c_dOH * std::sin(angle), 0 };
+        }
+
+        iatoms.push_back(0);
+        for (int a = 0; a < 3; a++)
+        {
+            iatoms.push_back(3 * w + a);
+            masses.push_back(a == 0 ? c_oxygenMass : c_hydrogenMass);
+            inverseMasses.push_back(1 / masses.back());
+            for (int d = 0; d < DIM; d++)
+            {
+                xPrime[3 * w + a][d] = x[3 * w + a][d] + deltas[numPerturbed % 4];
+                numPerturbed++;
+            }
+        }
+    }
+
+    t_iparams iparams;
+    iparams.settle.doh = c_dOH;
+    iparams.settle.dhh = c_dHH;
+    mtop.ffparams.iparams.push_back(iparams);
+
+    settled = std::make_unique<SettleData>(mtop);
+    settled->setConstraints(
+            mtop.moltype[0].ilist[F_SETTLE], 3 * c_numWaters, masses, inverseMasses);
+}
+
+//! Returns a benchmark of SETTLE, optionally with velocity and virial updates
+MicroBenchmark settleBenchmark(const bool updateVelocitiesAndVirial)
+{
+    MicroBenchmark benchmark;
+    benchmark.name = std::string("settle/") + (updateVelocitiesAndVirial ? "v_virial" : "x") + "/"
+                     + std::to_string(c_numWaters);
+    benchmark.itemsPerIteration = c_numWaters;
+    // The SETTLE algorithm is not iterative, so repeatedly constraining
+    // the same, already constrained, coordinates costs the same.
+    benchmark.setup = [updateVelocitiesAndVirial]()
+    {
+        auto system = std::make_shared<SettleSystem>();
+        return [system, updateVelocitiesAndVirial]()
+        {
+            bool errorHasOccurred = false;
+            auto v                = updateVelocitiesAndVirial ? system->v.arrayRefWithPadding()
+                                                              : ArrayRefWithPadding<RVec>();
+            csettle(*system->settled,
+                    1,
+                    0,
+                    nullptr,
+                    system->x.arrayRefWithPadding(),
+                    system->xPrime.arrayRefWithPadding(),
+                    500,
+                    v,
+                    updateVelocitiesAndVirial,
+                    system->virial,
+                    &errorHasOccurred);
+        };
+    };
+    return benchmark;
+}
+
+} // namespace
+
+std::vector<MicroBenchmark> settleBenchmarks()
+{
+    return { settleBenchmark(false), settleBenchmark(true) };
+}
+
+} // namespace microbenchmarks
+} // namespace gmx
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the micro-benchmarks of the leap-frog update.
+ *
+ * The system is set up with the test data class of the leap-frog unit
+ * tests, in the same way as the CPU leap-frog test runner does.
+ */
+#include "gmxpre.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/math/vectypes.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
+#include "gromacs/mdlib/tests/leapfrogtestdata.h"
+#include "gromacs/mdlib/update.h"
+#include "gromacs/mdtypes/md_enums.h"
+#include "gromacs/mdtypes/state.h"
+#include "gromacs/utility/real.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmarks
+{
+
+namespace
+{
+
+//! The number of atoms to update
+constexpr int c_numAtoms = 100000;
+
+/*! \brief Returns a benchmark of the leap-frog update
+ *
+ * \param[in] variantName       Name of the variant, used in the benchmark name
+ * \param[in] numTCoupleGroups  The number of T-coupling groups, 0 for no T-coupling
+ * \param[in] nstpcouple        The Parrinello-Rahman coupling period, 0 for no P-coupling
+ */
+MicroBenchmark updateBenchmark(const std::string& variantName,
+                               const int          numTCoupleGroups,
+                               const int          nstpcouple)
+{
+    MicroBenchmark benchmark;
+    benchmark.name = "update/leapfrog/" + variantName + "/" + std::to_string(c_numAtoms);
+    benchmark.itemsPerIteration = c_numAtoms;
+    // With step 0, the coupling is applied at every call
+    benchmark.setup = [numTCoupleGroups, nstpcouple]()
+    {
+        const rvec v0       = { 1.0, -0.5, 2.0 };
+        const rvec f0       = { 0.5, 1.0, -1.5 };
+        auto       testData = std::make_shared<test::LeapFrogTestData>(
+                c_numAtoms, 0.002, v0, f0, numTCoupleGroups, nstpcouple);
+        testData->state_.x.resizeWithPadding(c_numAtoms);
+        testData->state_.v.resizeWithPadding(c_numAtoms);
+        for (int i = 0; i < c_numAtoms; i++)
+        {
+            testData->state_.x[i] = testData->x_[i];
+            testData->state_.v[i] = testData->v_[i];
+        }
+
+        return [testData]()
+        {
+            testData->update_->update_coords(testData->inputRecord_,
+                                             0,
+                                             testData->mdAtoms_.homenr,
+                                             testData->mdAtoms_.havePartiallyFrozenAtoms,
+                                             testData->mdAtoms_.ptype,
+                                             testData->mdAtoms_.invmass,
+                                             testData->mdAtoms_.invMassPerDim,
+                                             &testData->state_,
+                                             testData->f_,
+                                             &testData->forceCalculationData_,
+                                             &testData->kineticEnergyData_,
+                                             testData->velocityScalingMatrix_,
+                                             etrtNONE,
+                                             nullptr,
+                                             false);
+            testData->update_->finish_update(testData->inputRecord_,
+                                             testData->mdAtoms_.havePartiallyFrozenAtoms,
+                                             testData->mdAtoms_.homenr,
+                                             &testData->state_,
+                                             nullptr,
+                                             false);
+        };
+    };
+    return benchmark;
+}
+
+} // namespace
+
+std::vector<MicroBenchmark> updateBenchmarks()
+{
+    // We don't want to call gmx_omp_nthreads_init(), so we init what we need
+    gmx_omp_nthreads_set(ModuleMultiThread::Update, 1);
+
+    return { updateBenchmark("plain", 0, 0),
+             updateBenchmark("tcouple", 2, 0),
+             updateBenchmark("tcouple_pcouple", 2, 1) };
+}
+
+} // namespace microbenchmarks
+} // namespace gmx
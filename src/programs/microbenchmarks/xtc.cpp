@@ -0,0 +1,125 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 1991- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the micro-benchmarks of the XTC coordinate quantization.
+ */
+#include "gmxpre.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gromacs/fileio/xdrf.h"
+
+#include "microbenchmark.h"
+
+namespace gmx
+{
+namespace microbenchmarks
+{
+
+namespace
+{
+
+//! The number of atoms in a frame
+constexpr int c_numAtoms = 100000;
+//! The precision of the coordinates, the default of the mdp option compressed-x-precision
+constexpr float c_precision = 1000;
+
+/*! \internal
+ * \brief Coordinates of a frame in both float and integer representation
+ */
+struct XtcFrame
+{
+    XtcFrame();
+
+    //! The float coordinates
+    std::vector<float> coordinates;
+    //! The quantized coordinates
+    std::vector<int> quantized;
+};
+
+XtcFrame::XtcFrame() : coordinates(3 * c_numAtoms), quantized(3 * c_numAtoms)
+{
+    // Deterministic coordinates spread over a 10 nm box
+    unsigned int value = 1;
+    for (auto& coordinate : coordinates)
+    {
+        value      = value * 1664525U + 1013904223U;
+        coordinate = (value >> 8U) * (10.0F / (1U << 24U));
+    }
+    xtc_quantize_coordinates(coordinates.data(), coordinates.size(), c_precision, quantized.data());
+}
+
+} // namespace
+
+std::vector<MicroBenchmark> xtcBenchmarks()
+{
+    // Both kernels use the same frame, which is set up when the first of them is run
+    const auto frame = sharedSetup<XtcFrame>([]() { return std::make_shared<XtcFrame>(); });
+
+    MicroBenchmark quantize;
+    quantize.name              = "xtc/quantize/" + std::to_string(c_numAtoms);
+    quantize.itemsPerIteration = c_numAtoms;
+    quantize.setup             = [frame]()
+    {
+        return [frame = frame()]()
+        {
+            xtc_quantize_coordinates(frame->coordinates.data(),
+                                     frame->coordinates.size(),
+                                     c_precision,
+                                     frame->quantized.data());
+        };
+    };
+
+    MicroBenchmark dequantize;
+    dequantize.name              = "xtc/dequantize/" + std::to_string(c_numAtoms);
+    dequantize.itemsPerIteration = c_numAtoms;
+    dequantize.setup             = [frame]()
+    {
+        return [frame = frame()]()
+        {
+            xtc_dequantize_coordinates(frame->quantized.data(),
+                                       frame->quantized.size(),
+                                       1 / c_precision,
+                                       frame->coordinates.data());
+        };
+    };
+
+    return { quantize, dequantize };
+}
+
+} // namespace microbenchmarks
+} // namespace gmx